@@ -11,6 +11,8 @@
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
 #include <rte_ip.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 
 #define	PRINT_USAGE_START	"%s [EAL options] --\n"
 
@@ -41,6 +43,8 @@
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
+#define	OPT_INCR		"incr"
+#define	OPT_BLD_THREADS		"bldthreads"
 
 #define	TRACE_DEFAULT_NUM	0x10000
 #define	TRACE_STEP_MAX		0x1000
@@ -48,6 +52,9 @@
 
 #define	RULE_NUM		0x10000
 
+/* number of incremental updates between two compactions. */
+#define	INCR_COMPACT_NUM	0x40
+
 #define COMMENT_LEAD_CHAR	'#'
 
 enum {
@@ -113,9 +120,15 @@ static struct {
 	uint32_t            iter_num;
 	uint32_t            verbose;
 	uint32_t            ipv6;
+	uint32_t            incr_num;
+	uint32_t            bld_threads;
 	struct acl_alg      alg;
 	uint32_t            used_traces;
 	void               *traces;
+	uint32_t            rule_sz;
+	uint32_t            used_rules;
+	uint8_t            *rules;
+	struct rte_rcu_qsbr *qsbr;
 	struct rte_acl_ctx *acx;
 } config = {
 	.bld_categories = 3,
@@ -950,17 +963,61 @@ add_cb_rules(FILE *f, struct rte_acl_ctx *ctx)
 				i, rc, strerror(-rc));
 			return rc;
 		}
+
+		/* keep a copy to update on the fly. */
+		if (config.rules != NULL)
+			memcpy(config.rules +
+				config.used_rules++ * config.rule_sz,
+				&v, config.rule_sz);
 	}
 
 	return 0;
 }
 
+static void
+incr_init(void)
+{
+	int ret;
+	size_t sz;
+	struct rte_acl_incr_param iprm;
+
+	config.rule_sz = prm.rule_size;
+	sz = (size_t)prm.max_rule_num * prm.rule_size;
+	config.rules = rte_zmalloc_socket(APP_NAME, sz, RTE_CACHE_LINE_SIZE,
+			SOCKET_ID_ANY);
+	if (config.rules == NULL)
+		rte_exit(EXIT_FAILURE, "Cannot allocate %zu bytes for "
+			"requested %u number of rules\n",
+			sz, prm.max_rule_num);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	config.qsbr = rte_zmalloc_socket(APP_NAME, sz, RTE_CACHE_LINE_SIZE,
+			SOCKET_ID_ANY);
+	if (config.qsbr == NULL)
+		rte_exit(EXIT_FAILURE, "Cannot allocate %zu bytes for "
+			"RCU QSBR variable\n", sz);
+
+	ret = rte_rcu_qsbr_init(config.qsbr, RTE_MAX_LCORE);
+	if (ret != 0)
+		rte_exit(ret, "failed to init RCU QSBR variable\n");
+
+	memset(&iprm, 0, sizeof(iprm));
+	iprm.v = config.qsbr;
+
+	ret = rte_acl_incr_enable(config.acx, &iprm);
+	if (ret != 0)
+		rte_exit(ret, "failed to enable incremental updates "
+			"for ACL context\n");
+}
+
 static void
 acx_init(void)
 {
 	int ret;
 	FILE *f;
+	uint64_t tm;
 	struct rte_acl_config cfg;
+	struct rte_acl_build_param bprm;
 
 	memset(&cfg, 0, sizeof(cfg));
 
@@ -986,6 +1043,9 @@ acx_init(void)
 	if (config.acx == NULL)
 		rte_exit(rte_errno, "failed to create ACL context\n");
 
+	if (config.incr_num != 0)
+		incr_init();
+
 	/* set default classify method for this context. */
 	if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
 		ret = rte_acl_set_ctx_classify(config.acx, config.alg.alg);
@@ -1007,11 +1067,18 @@ acx_init(void)
 	fclose(f);
 
 	/* perform build. */
-	ret = rte_acl_build(config.acx, &cfg);
+	memset(&bprm, 0, sizeof(bprm));
+	bprm.num_threads = config.bld_threads;
+
+	tm = rte_rdtsc_precise();
+	ret = rte_acl_build_mt(config.acx, &cfg, &bprm);
+	tm = rte_rdtsc_precise() - tm;
 
 	dump_verbose(DUMP_NONE, stdout,
-		"rte_acl_build(%u) finished with %d\n",
-		config.bld_categories, ret);
+		"rte_acl_build(%u) with %u extra threads finished with %d, "
+		"%" PRIu64 " cycles (%.2Lf sec)\n",
+		config.bld_categories, config.bld_threads, ret,
+		tm, (long double)tm / rte_get_timer_hz());
 
 	rte_acl_dump(config.acx);
 
@@ -1044,6 +1111,9 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 			rte_exit(ret, "classify for ipv%c_5tuples returns %d\n",
 				config.ipv6 ? '6' : '4', ret);
 
+		if (config.qsbr != NULL)
+			rte_rcu_qsbr_quiescent(config.qsbr, rte_lcore_id());
+
 		for (r = 0, j = 0; j != n; j++) {
 			for (k = 0; k != categories; k++, r++) {
 				dump_verbose(DUMP_PKT, stdout,
@@ -1070,6 +1140,12 @@ search_ip5tuples(__rte_unused void *arg)
 	long double st;
 
 	lcore = rte_lcore_id();
+
+	if (config.qsbr != NULL) {
+		rte_rcu_qsbr_thread_register(config.qsbr, lcore);
+		rte_rcu_qsbr_thread_online(config.qsbr, lcore);
+	}
+
 	start = rte_rdtsc_precise();
 	pkt = 0;
 
@@ -1080,6 +1156,11 @@ search_ip5tuples(__rte_unused void *arg)
 
 	tm = rte_rdtsc_precise() - start;
 
+	if (config.qsbr != NULL) {
+		rte_rcu_qsbr_thread_offline(config.qsbr, lcore);
+		rte_rcu_qsbr_thread_unregister(config.qsbr, lcore);
+	}
+
 	st = (long double)tm / rte_get_timer_hz();
 	dump_verbose(DUMP_NONE, stdout,
 		"%s  @lcore %u: %" PRIu32 " iterations, %" PRIu64 " pkts, %"
@@ -1092,6 +1173,53 @@ search_ip5tuples(__rte_unused void *arg)
 	return 0;
 }
 
+/*
+ * Delete and add back random rules, while worker lcores classify.
+ */
+static void
+update_rules(void)
+{
+	int ret;
+	uint32_t i, k, n;
+	uint64_t start, tm;
+	long double st;
+	const struct rte_acl_rule *rule;
+
+	k = 0;
+	n = 0;
+	start = rte_rdtsc_precise();
+
+	for (i = 0; i != config.incr_num; i++) {
+
+		if ((i & 1) == 0)
+			k = rte_rand_max(config.used_rules);
+
+		rule = (const struct rte_acl_rule *)
+			(config.rules + k * config.rule_sz);
+
+		if ((i & 1) == 0)
+			ret = rte_acl_incr_del_rules(config.acx, rule, 1);
+		else
+			ret = rte_acl_incr_add_rules(config.acx, rule, 1);
+		if (ret != 0)
+			rte_exit(ret, "incremental update #%u failed\n", i);
+
+		if ((i + 1) % INCR_COMPACT_NUM == 0 &&
+				rte_acl_incr_compact(config.acx) == 0)
+			n++;
+	}
+
+	tm = rte_rdtsc_precise() - start;
+
+	st = (long double)tm / rte_get_timer_hz();
+	dump_verbose(DUMP_NONE, stdout,
+		"%s  @lcore %u: %" PRIu32 " updates, %" PRIu32 " compactions, "
+		"%" PRIu64 " cycles (%.2Lf sec), "
+		"%.2Lf cycles/update, %.2Lf updates/sec\n",
+		__func__, rte_lcore_id(), i, n, tm, st,
+		(i == 0) ? 0 : (long double)tm / i, i / st);
+}
+
 static unsigned long
 get_ulong_opt(const char *opt, const char *name, size_t min, size_t max)
 {
@@ -1194,7 +1322,11 @@ print_usage(const char *prgname)
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
-		"[--" OPT_IPV6 "(=4B | 8B) <IPv6 rules and trace files>]\n",
+		"[--" OPT_IPV6 "(=4B | 8B) <IPv6 rules and trace files>]\n"
+		"[--" OPT_INCR "=<number of rule updates to perform "
+			"on the fly, while worker lcores classify>]\n"
+		"[--" OPT_BLD_THREADS "=<number of extra threads "
+			"to build ACL context with>]\n",
 		prgname, RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
 		buf);
@@ -1217,6 +1349,8 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
 		config.alg.name);
 	fprintf(f, "%s:%u\n", OPT_IPV6, config.ipv6);
+	fprintf(f, "%s:%u\n", OPT_INCR, config.incr_num);
+	fprintf(f, "%s:%u\n", OPT_BLD_THREADS, config.bld_threads);
 }
 
 static void
@@ -1227,6 +1361,10 @@ check_config(void)
 		rte_exit(-EINVAL, "mandatory option %s is not specified\n",
 			OPT_RULE_FILE);
 	}
+
+	if (config.incr_num != 0 && rte_lcore_count() < 2)
+		rte_exit(-EINVAL, "option %s requires at least one "
+			"worker lcore\n", OPT_INCR);
 }
 
 
@@ -1246,6 +1384,8 @@ get_input_opts(int argc, char **argv)
 		{OPT_VERBOSE, 1, 0, 0},
 		{OPT_SEARCH_ALG, 1, 0, 0},
 		{OPT_IPV6, 2, 0, 0},
+		{OPT_INCR, 1, 0, 0},
+		{OPT_BLD_THREADS, 1, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -1297,6 +1437,13 @@ get_input_opts(int argc, char **argv)
 			config.ipv6 = IPV6_FRMT_U32;
 			if (optarg != NULL)
 				get_ipv6_opt(optarg, lgopts[opt_idx].name);
+		} else if (strcmp(lgopts[opt_idx].name, OPT_INCR) == 0) {
+			config.incr_num = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, UINT32_MAX);
+		} else if (strcmp(lgopts[opt_idx].name,
+				OPT_BLD_THREADS) == 0) {
+			config.bld_threads = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, UINT32_MAX);
 		}
 	}
 	config.trace_sz = config.ipv6 ? sizeof(struct ipv6_5tuple) :
@@ -1331,10 +1478,16 @@ main(int argc, char **argv)
 	RTE_LCORE_FOREACH_WORKER(lcore)
 		 rte_eal_remote_launch(search_ip5tuples, NULL, lcore);
 
-	search_ip5tuples(NULL);
+	/* main lcore updates the rules, while workers classify. */
+	if (config.incr_num != 0)
+		update_rules();
+	else
+		search_ip5tuples(NULL);
 
 	rte_eal_mp_wait_lcore();
 
 	rte_acl_free(config.acx);
+	rte_free(config.rules);
+	rte_free(config.qsbr);
 	return 0;
 }
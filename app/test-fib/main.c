@@ -45,6 +45,7 @@
 #define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE)
 #define SHUFFLE_FLAG		(1 << 7)
 #define DRY_RUN_FLAG		(1 << 8)
+#define BULK_FLAG		(1 << 9)
 
 static char *distrib_string;
 static char line[LINE_MAX];
@@ -628,6 +629,7 @@ print_usage(void)
 		"[-c <do comparison with LPM library>]\n"
 		"[-6 <do tests with ipv6 (default ipv4)>]\n"
 		"[-s <shuffle randomly generated routes>]\n"
+		"[-k <add and delete routes with the bulk API>]\n"
 		"[-a <check nexthops for all ipv4 address space"
 		"(only valid with -c)>]\n"
 		"[-b <fib algorithm>]\n\tavailable options for ipv4\n"
@@ -688,7 +690,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:skv:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -742,6 +744,9 @@ parse_opts(int argc, char **argv)
 		case 's':
 			config.flags |= SHUFFLE_FLAG;
 			break;
+		case 'k':
+			config.flags |= BULK_FLAG;
+			break;
 		case 'c':
 			config.flags |= CMP_FLAG;
 			break;
@@ -834,18 +839,21 @@ print_depth_err(void)
 static int
 run_v4(void)
 {
-	uint64_t start, acc;
+	uint64_t start, acc, tsc;
 	uint64_t def_nh = 0;
 	struct rte_fib *fib;
 	struct rte_fib_conf conf = {0};
 	struct rt_rule_4 *rt;
-	uint32_t i, j, k;
+	uint32_t i, j, k, m;
 	int ret = 0;
 	struct rte_lpm	*lpm = NULL;
 	struct rte_lpm_config lpm_conf;
 	uint32_t *tbl4 = config.lookup_tbl;
 	uint64_t fib_nh[BURST_SZ];
 	uint32_t lpm_nh[BURST_SZ];
+	uint32_t *bulk_ips = NULL;
+	uint8_t *bulk_depths = NULL;
+	uint64_t *bulk_nhs = NULL;
 
 	rt = (struct rt_rule_4 *)config.rt;
 
@@ -896,21 +904,55 @@ run_v4(void)
 		}
 	}
 
+	if (config.flags & BULK_FLAG) {
+		bulk_ips = rte_malloc(NULL, sizeof(*bulk_ips) *
+			config.nb_routes, 0);
+		bulk_depths = rte_malloc(NULL, config.nb_routes, 0);
+		bulk_nhs = rte_malloc(NULL, sizeof(*bulk_nhs) *
+			config.nb_routes, 0);
+		if ((bulk_ips == NULL) || (bulk_depths == NULL) ||
+				(bulk_nhs == NULL)) {
+			printf("Can not alloc bulk route arrays\n");
+			return -ENOMEM;
+		}
+		for (i = 0; i < config.nb_routes; i++) {
+			bulk_ips[i] = rt[i].addr;
+			bulk_depths[i] = rt[i].depth;
+			bulk_nhs[i] = rt[i].nh;
+		}
+	}
+
+	acc = 0;
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++) {
-			ret = rte_fib_add(fib, rt[i + j].addr, rt[i + j].depth,
-				rt[i + j].nh);
-			if (unlikely(ret != 0)) {
-				printf("Can not add a route to FIB, err %d\n",
+		if (config.flags & BULK_FLAG) {
+			j = (config.nb_routes - i) / k;
+			ret = rte_fib_add_bulk(fib, bulk_ips + i,
+				bulk_depths + i, bulk_nhs + i, j);
+			if (unlikely(ret != (int)j)) {
+				ret = (ret < 0) ? ret : -rte_errno;
+				printf("Can not add routes to FIB, err %d\n",
 					ret);
 				return -ret;
 			}
+		} else {
+			for (j = 0; j < (config.nb_routes - i) / k; j++) {
+				ret = rte_fib_add(fib, rt[i + j].addr,
+					rt[i + j].depth, rt[i + j].nh);
+				if (unlikely(ret != 0)) {
+					printf("Can not add a route to FIB, "
+						"err %d\n", ret);
+					return -ret;
+				}
+			}
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
+		tsc = rte_rdtsc_precise() - start;
+		acc += tsc;
+		printf("AVG FIB add %"PRIu64"\n", tsc / j);
 		i += j;
 	}
+	printf("FIB table load %"PRIu64" cycles, %.3f ms\n", acc,
+		(double)acc * 1000 / rte_get_tsc_hz());
 
 	if (config.flags & CMP_FLAG) {
 		lpm_conf.max_rules = config.nb_routes * 2;
@@ -986,8 +1028,21 @@ run_v4(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++)
-			rte_fib_delete(fib, rt[i + j].addr, rt[i + j].depth);
+		if (config.flags & BULK_FLAG) {
+			j = (config.nb_routes - i) / k;
+			/* skip the duplicated routes already deleted */
+			for (m = 0; m < j; m++) {
+				ret = rte_fib_delete_bulk(fib, bulk_ips + i + m,
+					bulk_depths + i + m, j - m);
+				if (ret < 0)
+					break;
+				m += ret;
+			}
+		} else {
+			for (j = 0; j < (config.nb_routes - i) / k; j++)
+				rte_fib_delete(fib, rt[i + j].addr,
+					rt[i + j].depth);
+		}
 
 		printf("AVG FIB delete %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
@@ -1007,6 +1062,10 @@ run_v4(void)
 		}
 	}
 
+	rte_free(bulk_ips);
+	rte_free(bulk_depths);
+	rte_free(bulk_nhs);
+
 	return 0;
 }
 
@@ -1034,18 +1093,21 @@ dump_rt_6(struct rt_rule_6 *rt)
 static int
 run_v6(void)
 {
-	uint64_t start, acc;
+	uint64_t start, acc, tsc;
 	uint64_t def_nh = 0;
 	struct rte_fib6 *fib;
 	struct rte_fib6_conf conf = {0};
 	struct rt_rule_6 *rt;
-	uint32_t i, j, k;
+	uint32_t i, j, k, m;
 	int ret = 0;
 	struct rte_lpm6	*lpm = NULL;
 	struct rte_lpm6_config lpm_conf;
 	uint8_t *tbl6;
 	uint64_t fib_nh[BURST_SZ];
 	int32_t lpm_nh[BURST_SZ];
+	uint8_t (*bulk_ips)[16] = NULL;
+	uint8_t *bulk_depths = NULL;
+	uint64_t *bulk_nhs = NULL;
 
 	rt = (struct rt_rule_6 *)config.rt;
 	tbl6 = config.lookup_tbl;
@@ -1091,21 +1153,55 @@ run_v6(void)
 		}
 	}
 
+	if (config.flags & BULK_FLAG) {
+		bulk_ips = rte_malloc(NULL, sizeof(*bulk_ips) *
+			config.nb_routes, 0);
+		bulk_depths = rte_malloc(NULL, config.nb_routes, 0);
+		bulk_nhs = rte_malloc(NULL, sizeof(*bulk_nhs) *
+			config.nb_routes, 0);
+		if ((bulk_ips == NULL) || (bulk_depths == NULL) ||
+				(bulk_nhs == NULL)) {
+			printf("Can not alloc bulk route arrays\n");
+			return -ENOMEM;
+		}
+		for (i = 0; i < config.nb_routes; i++) {
+			memcpy(bulk_ips[i], rt[i].addr, sizeof(bulk_ips[i]));
+			bulk_depths[i] = rt[i].depth;
+			bulk_nhs[i] = rt[i].nh;
+		}
+	}
+
+	acc = 0;
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++) {
-			ret = rte_fib6_add(fib, rt[i + j].addr,
-				rt[i + j].depth, rt[i + j].nh);
-			if (unlikely(ret != 0)) {
-				printf("Can not add a route to FIB, err %d\n",
+		if (config.flags & BULK_FLAG) {
+			j = (config.nb_routes - i) / k;
+			ret = rte_fib6_add_bulk(fib, bulk_ips + i,
+				bulk_depths + i, bulk_nhs + i, j);
+			if (unlikely(ret != (int)j)) {
+				ret = (ret < 0) ? ret : -rte_errno;
+				printf("Can not add routes to FIB, err %d\n",
 					ret);
 				return -ret;
 			}
+		} else {
+			for (j = 0; j < (config.nb_routes - i) / k; j++) {
+				ret = rte_fib6_add(fib, rt[i + j].addr,
+					rt[i + j].depth, rt[i + j].nh);
+				if (unlikely(ret != 0)) {
+					printf("Can not add a route to FIB, "
+						"err %d\n", ret);
+					return -ret;
+				}
+			}
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
+		tsc = rte_rdtsc_precise() - start;
+		acc += tsc;
+		printf("AVG FIB add %"PRIu64"\n", tsc / j);
 		i += j;
 	}
+	printf("FIB table load %"PRIu64" cycles, %.3f ms\n", acc,
+		(double)acc * 1000 / rte_get_tsc_hz());
 
 	if (config.flags & CMP_FLAG) {
 		lpm_conf.max_rules = config.nb_routes * 2;
@@ -1185,8 +1281,21 @@ run_v6(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++)
-			rte_fib6_delete(fib, rt[i + j].addr, rt[i + j].depth);
+		if (config.flags & BULK_FLAG) {
+			j = (config.nb_routes - i) / k;
+			/* skip the duplicated routes already deleted */
+			for (m = 0; m < j; m++) {
+				ret = rte_fib6_delete_bulk(fib, bulk_ips + i + m,
+					bulk_depths + i + m, j - m);
+				if (ret < 0)
+					break;
+				m += ret;
+			}
+		} else {
+			for (j = 0; j < (config.nb_routes - i) / k; j++)
+				rte_fib6_delete(fib, rt[i + j].addr,
+					rt[i + j].depth);
+		}
 
 		printf("AVG FIB delete %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
@@ -1205,6 +1314,11 @@ run_v6(void)
 			i += j;
 		}
 	}
+
+	rte_free(bulk_ips);
+	rte_free(bulk_depths);
+	rte_free(bulk_nhs);
+
 	return 0;
 }
 
@@ -459,6 +459,183 @@ test_classify(void)
 	return ret;
 }
 
+/*
+ * Test incremental updates: rules added to and deleted from
+ * a built context have to give the same results as the full build.
+ */
+static int
+test_classify_incr(void)
+{
+	int32_t ret;
+	uint32_t i, n;
+	struct rte_acl_ctx *acx;
+	struct rte_acl_param prm;
+	struct rte_acl_incr_param iprm;
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+
+	prm = acl_param;
+	prm.name = "acl_incr";
+	prm.max_rule_num = RTE_DIM(acl_test_rules);
+
+	acx = rte_acl_create(&prm);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	/* keep delta small to exercise the compaction on update. */
+	memset(&iprm, 0, sizeof(iprm));
+	iprm.max_delta_rules = 8;
+
+	ret = rte_acl_incr_enable(acx, &iprm);
+	if (ret != 0) {
+		printf("Line %i: Enabling incremental updates failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	for (i = 0; i != RTE_DIM(rules); i++)
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, rules + i);
+
+	/* build with the first half of the rules, add the rest on the fly. */
+	n = RTE_DIM(rules) / 2;
+	ret = test_classify_buid(acx, acl_test_rules, n);
+	if (ret != 0)
+		goto err;
+
+	for (i = n; i != RTE_DIM(rules) && ret == 0; i++)
+		ret = rte_acl_incr_add_rules(acx,
+			(const struct rte_acl_rule *)(rules + i), 1);
+	if (ret != 0) {
+		printf("Line %i: Adding rule #%u on the fly failed!\n",
+			__LINE__, i);
+		goto err;
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: classify after incremental add failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* context is full. */
+	ret = rte_acl_incr_add_rules(acx,
+		(const struct rte_acl_rule *)rules, 1);
+	if (ret != -ENOMEM) {
+		printf("Line %i: Adding rule into full context "
+			"should fail!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	/* delete main rules one by one, then put them back at once. */
+	for (i = 0, ret = 0; i != n && ret == 0; i++)
+		ret = rte_acl_incr_del_rules(acx,
+			(const struct rte_acl_rule *)(rules + i), 1);
+	if (ret != 0) {
+		printf("Line %i: Deleting rule #%u failed!\n", __LINE__, i);
+		goto err;
+	}
+
+	ret = rte_acl_incr_del_rules(acx,
+		(const struct rte_acl_rule *)rules, 1);
+	if (ret != -ENOENT) {
+		printf("Line %i: Deleting missing rule should fail!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_incr_add_rules(acx,
+		(const struct rte_acl_rule *)rules, n);
+	if (ret != 0) {
+		printf("Line %i: Adding rules on the fly failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: classify after incremental delete failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* fold everything into the main tries. */
+	ret = rte_acl_incr_compact(acx);
+	if (ret != 0) {
+		printf("Line %i: Compacting ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		printf("Line %i: classify after compaction failed!\n",
+			__LINE__);
+
+err:
+	rte_acl_free(acx);
+	return ret;
+}
+
+/*
+ * Test multi-threaded build: it has to produce the same
+ * classify results as the single-threaded one.
+ */
+static int
+test_build_mt(void)
+{
+	int32_t ret;
+	uint32_t i;
+	struct rte_acl_ctx *acx;
+	struct rte_acl_config cfg;
+	struct rte_acl_build_param bprm;
+
+	static const uint32_t num_threads[] = {0, 1, 2, 4};
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules,
+		RTE_DIM(acl_test_rules));
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	/* test rules get split into several tries, so workers get the job. */
+	for (i = 0; i != RTE_DIM(num_threads); i++) {
+
+		memset(&bprm, 0, sizeof(bprm));
+		bprm.num_threads = num_threads[i];
+
+		ret = rte_acl_build_mt(acx, &cfg, &bprm);
+		if (ret != 0) {
+			printf("Line %i: Building ACL context with %u threads "
+				"failed!\n", __LINE__, num_threads[i]);
+			break;
+		}
+
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+		if (ret != 0) {
+			printf("Line %i: classify after build with %u threads "
+				"failed!\n", __LINE__, num_threads[i]);
+			break;
+		}
+	}
+
+err:
+	rte_acl_free(acx);
+	return ret;
+}
+
 static int
 test_build_ports_range(void)
 {
@@ -1737,6 +1914,10 @@ test_acl(void)
 		return -1;
 	if (test_classify() < 0)
 		return -1;
+	if (test_classify_incr() < 0)
+		return -1;
+	if (test_build_mt() < 0)
+		return -1;
 	if (test_build_ports_range() < 0)
 		return -1;
 	if (test_convert() < 0)
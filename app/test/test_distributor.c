@@ -86,7 +86,7 @@ clear_packet_count(void)
 static int
 handle_work(void *arg)
 {
-	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_mbuf *buf[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
 	struct worker_params *wp = arg;
 	struct rte_distributor *db = wp->dist;
 	unsigned int num;
@@ -305,7 +305,7 @@ sanity_test(struct worker_params *wp, struct rte_mempool *p)
 static int
 handle_work_with_free_mbufs(void *arg)
 {
-	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_mbuf *buf[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
 	struct worker_params *wp = arg;
 	struct rte_distributor *d = wp->dist;
 	unsigned int i;
@@ -374,7 +374,7 @@ sanity_test_with_mbuf_alloc(struct worker_params *wp, struct rte_mempool *p)
 static int
 handle_work_for_shutdown_test(void *arg)
 {
-	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_mbuf *buf[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
 	struct worker_params *wp = arg;
 	struct rte_distributor *d = wp->dist;
 	unsigned int num;
@@ -591,7 +591,7 @@ test_flush_with_worker_shutdown(struct worker_params *wp,
 static int
 handle_and_mark_work(void *arg)
 {
-	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_mbuf *buf[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
 	struct worker_params *wp = arg;
 	struct rte_distributor *db = wp->dist;
 	unsigned int num, i;
@@ -781,6 +781,55 @@ int test_error_distributor_create_numworkers(void)
 }
 
 
+static
+int test_error_distributor_create_conf(void)
+{
+	struct rte_distributor_conf conf = {
+		.num_workers = rte_lcore_count() - 1,
+	};
+	struct rte_distributor *d;
+
+	d = rte_distributor_create_conf("test_conf", rte_socket_id(), NULL);
+	if (d != NULL || rte_errno != EINVAL) {
+		printf("ERROR: No error on create_conf() with NULL conf\n");
+		return -1;
+	}
+
+	conf.burst_size = RTE_DIST_BURST_SIZE_MAX + 8;
+	d = rte_distributor_create_conf("test_conf", rte_socket_id(), &conf);
+	if (d != NULL || rte_errno != EINVAL) {
+		printf("ERROR: No error on create_conf() burst_size > MAX\n");
+		return -1;
+	}
+
+	conf.burst_size = 12;
+	d = rte_distributor_create_conf("test_conf", rte_socket_id(), &conf);
+	if (d != NULL || rte_errno != EINVAL) {
+		printf("ERROR: No error on create_conf() burst_size not a multiple of 8\n");
+		return -1;
+	}
+
+	conf.burst_size = 16;
+	conf.ring_size = 8;
+	conf.flags = RTE_DIST_F_WORKER_RINGS;
+	d = rte_distributor_create_conf("test_conf", rte_socket_id(), &conf);
+	if (d != NULL || rte_errno != EINVAL) {
+		printf("ERROR: No error on create_conf() ring_size < burst_size\n");
+		return -1;
+	}
+
+	conf.ring_size = 0;
+	conf.flags = ~RTE_DIST_F_WORKER_RINGS;
+	d = rte_distributor_create_conf("test_conf", rte_socket_id(), &conf);
+	if (d != NULL || rte_errno != EINVAL) {
+		printf("ERROR: No error on create_conf() with invalid flags\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
 /* Useful function which ensures that all worker functions terminate */
 static void
 quit_workers(struct worker_params *wp, struct rte_mempool *p)
@@ -824,7 +873,12 @@ test_distributor(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
-	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dbc;
+	static struct rte_distributor *dr;
+	static struct rte_distributor *dist[4];
+	static const char * const dist_names[] = {
+		"single", "burst", "burst 16", "worker rings",
+	};
 	static struct rte_mempool *p;
 	int i;
 
@@ -872,6 +926,33 @@ test_distributor(void)
 		rte_distributor_clear_returns(ds);
 	}
 
+	if (dbc == NULL) {
+		struct rte_distributor_conf conf = {
+			.num_workers = rte_lcore_count() - 1,
+			.burst_size = 16,
+		};
+
+		dbc = rte_distributor_create_conf("Test_dist_burst16",
+				rte_socket_id(), &conf);
+		if (dbc == NULL) {
+			printf("Error creating burst 16 distributor\n");
+			return -1;
+		}
+
+		conf.flags = RTE_DIST_F_WORKER_RINGS;
+		dr = rte_distributor_create_conf("Test_dist_ring",
+				rte_socket_id(), &conf);
+		if (dr == NULL) {
+			printf("Error creating ring distributor\n");
+			return -1;
+		}
+	} else {
+		rte_distributor_flush(dbc);
+		rte_distributor_clear_returns(dbc);
+		rte_distributor_flush(dr);
+		rte_distributor_clear_returns(dr);
+	}
+
 	const unsigned nb_bufs = (511 * rte_lcore_count()) < BIG_BATCH ?
 			(BIG_BATCH * 2) - 1 : (511 * rte_lcore_count());
 	if (p == NULL) {
@@ -885,16 +966,14 @@ test_distributor(void)
 
 	dist[0] = ds;
 	dist[1] = db;
+	dist[2] = dbc;
+	dist[3] = dr;
 
-	for (i = 0; i < 2; i++) {
+	for (i = 0; i < (int)RTE_DIM(dist); i++) {
 
 		worker_params.dist = dist[i];
-		if (i)
-			strlcpy(worker_params.name, "burst",
-					sizeof(worker_params.name));
-		else
-			strlcpy(worker_params.name, "single",
-					sizeof(worker_params.name));
+		strlcpy(worker_params.name, dist_names[i],
+				sizeof(worker_params.name));
 
 		rte_eal_mp_remote_launch(handle_work,
 				&worker_params, SKIP_MAIN);
@@ -938,7 +1017,8 @@ test_distributor(void)
 	}
 
 	if (test_error_distributor_create_numworkers() == -1 ||
-			test_error_distributor_create_name() == -1) {
+			test_error_distributor_create_name() == -1 ||
+			test_error_distributor_create_conf() == -1) {
 		printf("rte_distributor_create parameter check tests failed");
 		return -1;
 	}
@@ -23,12 +23,38 @@ test_distributor_perf(void)
 
 #include <rte_distributor.h>
 #include <rte_pause.h>
+#include <rte_vect.h>
 
 #define ITER_POWER_CL 25 /* log 2 of how many iterations  for Cache Line test */
 #define ITER_POWER 21 /* log 2 of how many iterations we do when timing. */
 #define BURST 64
 #define BIG_BATCH 1024
 
+/*
+ * Burst distributors compared with each other, the flow matching kernel
+ * is picked at creation time within the given SIMD bitwidth.
+ */
+static const struct {
+	const char *name;
+	const char *mz_name;
+	unsigned int burst_size;
+	uint32_t flags;
+	uint16_t simd_bitwidth;
+} perf_modes[] = {
+	{"burst mode, scalar match", "Test_burst_sc", 8, 0,
+		RTE_VECT_SIMD_DISABLED},
+	{"burst mode, 128-bit match", "Test_burst_128", 8, 0,
+		RTE_VECT_SIMD_128},
+	{"burst mode, 256-bit match", "Test_burst_256", 8, 0,
+		RTE_VECT_SIMD_256},
+	{"burst mode, 512-bit match", "Test_burst_512", 8, 0,
+		RTE_VECT_SIMD_512},
+	{"burst mode, burst size 32", "Test_burst_32", 32, 0,
+		RTE_VECT_SIMD_MAX},
+	{"worker rings mode", "Test_rings", 16, RTE_DIST_F_WORKER_RINGS,
+		RTE_VECT_SIMD_MAX},
+};
+
 /* static vars - zero initialized by default */
 static volatile int quit;
 static volatile unsigned worker_idx;
@@ -122,9 +148,9 @@ handle_work(void *arg)
 	unsigned int num = 0;
 	int i;
 	unsigned int id = __atomic_fetch_add(&worker_idx, 1, __ATOMIC_RELAXED);
-	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct rte_mbuf *buf[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
 
-	for (i = 0; i < 8; i++)
+	for (i = 0; i < RTE_DIST_BURST_SIZE_MAX; i++)
 		buf[i] = NULL;
 
 	num = rte_distributor_get_pkt(d, id, buf, buf, num);
@@ -210,12 +236,35 @@ quit_workers(struct rte_distributor *d, struct rte_mempool *p)
 	worker_idx = 0;
 }
 
+/* Create the distributor of a perf mode, with the match kernel it asks for */
+static struct rte_distributor *
+create_perf_mode(unsigned int mode)
+{
+	struct rte_distributor_conf conf = {
+		.num_workers = rte_lcore_count() - 1,
+		.burst_size = perf_modes[mode].burst_size,
+		.flags = perf_modes[mode].flags,
+	};
+	uint16_t bitwidth = rte_vect_get_max_simd_bitwidth();
+	struct rte_distributor *d;
+
+	if (rte_vect_set_max_simd_bitwidth(perf_modes[mode].simd_bitwidth) != 0)
+		printf("Cannot change max SIMD bitwidth, using %u\n", bitwidth);
+	d = rte_distributor_create_conf(perf_modes[mode].mz_name,
+			rte_socket_id(), &conf);
+	rte_vect_set_max_simd_bitwidth(bitwidth);
+
+	return d;
+}
+
 static int
 test_distributor_perf(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
+	static struct rte_distributor *dm[RTE_DIM(perf_modes)];
 	static struct rte_mempool *p;
+	unsigned int i;
 
 	if (rte_lcore_count() < 2) {
 		printf("Not enough cores for distributor_perf_autotest, expecting at least 2\n");
@@ -249,6 +298,19 @@ test_distributor_perf(void)
 		rte_distributor_clear_returns(db);
 	}
 
+	for (i = 0; i < RTE_DIM(perf_modes); i++) {
+		if (dm[i] == NULL) {
+			dm[i] = create_perf_mode(i);
+			if (dm[i] == NULL) {
+				printf("Error creating %s distributor\n",
+						perf_modes[i].name);
+				return -1;
+			}
+		} else {
+			rte_distributor_clear_returns(dm[i]);
+		}
+	}
+
 	const unsigned nb_bufs = (511 * rte_lcore_count()) < BIG_BATCH ?
 			(BIG_BATCH * 2) - 1 : (511 * rte_lcore_count());
 	if (p == NULL) {
@@ -272,6 +334,15 @@ test_distributor_perf(void)
 		return -1;
 	quit_workers(db, p);
 
+	for (i = 0; i < RTE_DIM(perf_modes); i++) {
+		printf("=== Performance test of distributor (%s) ===\n",
+				perf_modes[i].name);
+		rte_eal_mp_remote_launch(handle_work, dm[i], SKIP_MAIN);
+		if (perf_test(dm[i], p) < 0)
+			return -1;
+		quit_workers(dm[i], p);
+	}
+
 	return 0;
 }
 
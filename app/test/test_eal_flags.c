@@ -866,6 +866,9 @@ test_no_huge_flag(void)
 	/* With --no-huge and --huge-worker-stack=512 (should fail) */
 	const char * const argv6[] = {prgname, prefix, no_huge,
 			"--huge-worker-stack=512"};
+	/* With --no-huge and --huge-fault-threads (should fail) */
+	const char * const argv7[] = {prgname, prefix, no_huge,
+			"--huge-fault-threads=2"};
 
 	if (launch_proc(argv1) != 0) {
 		printf("Error - process did not run ok with --no-huge flag\n");
@@ -898,6 +901,10 @@ test_no_huge_flag(void)
 		printf("Error - process run ok with --no-huge and --huge-worker-stack=size flags");
 		return -1;
 	}
+	if (launch_proc(argv7) == 0) {
+		printf("Error - process run ok with --no-huge and --huge-fault-threads flags");
+		return -1;
+	}
 	return 0;
 }
 
@@ -20,10 +20,13 @@ test_efd(void)
 #include <rte_random.h>
 #include <rte_debug.h>
 #include <rte_ip.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 
 #define EFD_TEST_KEY_LEN 8
 #define TABLE_SIZE (1 << 21)
 #define ITERATIONS 3
+#define MW_KEYS_PER_LCORE 8192
 
 #if RTE_EFD_VALUE_NUM_BITS == 32
 #define VALUE_BITMASK 0xffffffff
@@ -325,6 +328,191 @@ static int test_five_keys(void)
 	return 0;
 }
 
+/*
+ * Insert, update and delete keys with rte_efd_update_bulk()
+ */
+static int test_update_bulk(void)
+{
+	struct rte_efd_table *handle;
+	const void *key_array[5];
+	efd_value_t values[5], result[5];
+	efd_value_t prev_value;
+	int status[5];
+	unsigned int i;
+	printf("Entering %s\n", __func__);
+
+	handle = rte_efd_create("test_update_bulk", TABLE_SIZE,
+			sizeof(struct flow_key),
+			efd_get_all_sockets_bitmask(), test_socket_id);
+	TEST_ASSERT_NOT_NULL(handle, "Error creating the efd table\n");
+
+	for (i = 0; i < 5; i++) {
+		key_array[i] = &keys[i];
+		values[i] = mrand48() & VALUE_BITMASK;
+	}
+
+	/* Add the first four keys */
+	TEST_ASSERT_EQUAL(rte_efd_update_bulk(handle, test_socket_id, 4,
+			key_array, values, status), 4,
+			"Error inserting the keys");
+	for (i = 0; i < 4; i++)
+		TEST_ASSERT_SUCCESS(status[i], "Error inserting key %u", i);
+
+	rte_efd_lookup_bulk(handle, test_socket_id, 4, key_array, result);
+	for (i = 0; i < 4; i++)
+		TEST_ASSERT_EQUAL(result[i], values[i],
+				"bulk: failed to find key. Expected %d, got %d",
+				values[i], result[i]);
+
+	/* Update, with the first key of the burst updated twice */
+	for (i = 0; i < 4; i++)
+		values[i] = (values[i] + 1) & VALUE_BITMASK;
+	key_array[4] = &keys[0];
+	values[4] = (values[0] + 1) & VALUE_BITMASK;
+	TEST_ASSERT_EQUAL(rte_efd_update_bulk(handle, test_socket_id, 5,
+			key_array, values, NULL), 5,
+			"Error updating the keys");
+
+	TEST_ASSERT_EQUAL(rte_efd_lookup(handle, test_socket_id, &keys[0]),
+			values[4], "failed to find the last value of the key");
+	for (i = 1; i < 4; i++)
+		TEST_ASSERT_EQUAL(rte_efd_lookup(handle, test_socket_id,
+				&keys[i]), values[i], "failed to find key");
+
+	TEST_ASSERT_EQUAL(rte_efd_update_bulk(handle, test_socket_id,
+			RTE_EFD_BURST_MAX + 1, key_array, values, NULL), -EINVAL,
+			"Bulk update of more than RTE_EFD_BURST_MAX keys "
+			"should fail");
+
+	/* Delete */
+	values[0] = values[4];
+	for (i = 0; i < 4; i++) {
+		TEST_ASSERT_SUCCESS(rte_efd_delete(handle, test_socket_id,
+				&keys[i], &prev_value),
+				"failed to delete key");
+		TEST_ASSERT_EQUAL(prev_value, values[i],
+				"failed to delete the expected value");
+	}
+	TEST_ASSERT_FAIL(rte_efd_delete(handle, test_socket_id, &keys[4],
+			NULL), "key never inserted should not exist");
+
+	rte_efd_free(handle);
+
+	return 0;
+}
+
+static struct rte_efd_table *mw_handle;
+static uint32_t mw_errors;
+
+static void
+mw_key(uint8_t *key, unsigned int lcore_idx, uint32_t i)
+{
+	uint32_t k[2] = {lcore_idx, i};
+
+	memcpy(key, k, EFD_TEST_KEY_LEN);
+}
+
+static efd_value_t
+mw_value(unsigned int lcore_idx, uint32_t i, uint32_t round)
+{
+	return (lcore_idx * 7 + i + round) & VALUE_BITMASK;
+}
+
+/*
+ * Writer inserting its own keys, updating them in bursts
+ * and deleting half of them, concurrently with the other lcores
+ */
+static int
+test_mw_writer(__rte_unused void *arg)
+{
+	unsigned int lcore_idx = rte_lcore_index(rte_lcore_id());
+	uint8_t key_buf[RTE_EFD_BURST_MAX][EFD_TEST_KEY_LEN];
+	const void *key_list[RTE_EFD_BURST_MAX];
+	efd_value_t value_list[RTE_EFD_BURST_MAX];
+	efd_value_t prev_value;
+	uint32_t i, j, errors = 0;
+
+	for (i = 0; i < MW_KEYS_PER_LCORE; i++) {
+		mw_key(key_buf[0], lcore_idx, i);
+		if (rte_efd_update(mw_handle, test_socket_id, key_buf[0],
+				mw_value(lcore_idx, i, 0)) ==
+					RTE_EFD_UPDATE_FAILED)
+			errors++;
+	}
+
+	for (i = 0; i < MW_KEYS_PER_LCORE; i += RTE_EFD_BURST_MAX) {
+		for (j = 0; j < RTE_EFD_BURST_MAX; j++) {
+			mw_key(key_buf[j], lcore_idx, i + j);
+			key_list[j] = key_buf[j];
+			value_list[j] = mw_value(lcore_idx, i + j, 1);
+		}
+		if (rte_efd_update_bulk(mw_handle, test_socket_id,
+				RTE_EFD_BURST_MAX, key_list, value_list,
+				NULL) != RTE_EFD_BURST_MAX)
+			errors++;
+	}
+
+	for (i = 1; i < MW_KEYS_PER_LCORE; i += 2) {
+		mw_key(key_buf[0], lcore_idx, i);
+		if (rte_efd_delete(mw_handle, test_socket_id, key_buf[0],
+				&prev_value) != 0 ||
+				prev_value != mw_value(lcore_idx, i, 1))
+			errors++;
+	}
+
+	__atomic_fetch_add(&mw_errors, errors, __ATOMIC_RELAXED);
+	return 0;
+}
+
+/*
+ * Several lcores updating a table created with RTE_EFD_F_MULTI_WRITER
+ */
+static int test_multi_writer(void)
+{
+	uint8_t key[EFD_TEST_KEY_LEN];
+	unsigned int lcore_idx;
+	uint32_t i;
+	printf("Entering %s with %u writers\n", __func__, rte_lcore_count());
+
+	TEST_ASSERT_NULL(rte_efd_create_flags("test_multi_writer", TABLE_SIZE,
+			EFD_TEST_KEY_LEN, efd_get_all_sockets_bitmask(),
+			test_socket_id, ~RTE_EFD_F_MULTI_WRITER),
+			"Creating an EFD table with invalid flags should fail");
+
+	mw_handle = rte_efd_create_flags("test_multi_writer",
+			MW_KEYS_PER_LCORE * rte_lcore_count(), EFD_TEST_KEY_LEN,
+			efd_get_all_sockets_bitmask(), test_socket_id,
+			RTE_EFD_F_MULTI_WRITER);
+	TEST_ASSERT_NOT_NULL(mw_handle, "Error creating the efd table\n");
+
+	mw_errors = 0;
+	rte_eal_mp_remote_launch(test_mw_writer, NULL, CALL_MAIN);
+	rte_eal_mp_wait_lcore();
+
+	if (mw_errors != 0) {
+		rte_efd_free(mw_handle);
+		printf("%u concurrent updates failed\n", mw_errors);
+		return -1;
+	}
+
+	for (lcore_idx = 0; lcore_idx < rte_lcore_count(); lcore_idx++) {
+		for (i = 0; i < MW_KEYS_PER_LCORE; i += 2) {
+			mw_key(key, lcore_idx, i);
+			if (rte_efd_lookup(mw_handle, test_socket_id, key) !=
+					mw_value(lcore_idx, i, 1)) {
+				rte_efd_free(mw_handle);
+				printf("Lost key %u of lcore %u\n", i,
+					lcore_idx);
+				return -1;
+			}
+		}
+	}
+
+	rte_efd_free(mw_handle);
+
+	return 0;
+}
+
 /*
  * Test to see the average table utilization (entries added/max entries)
  * before hitting a random entry that cannot be added
@@ -463,6 +651,10 @@ test_efd(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_update_bulk() < 0)
+		return -1;
+	if (test_multi_writer() < 0)
+		return -1;
 	if (test_efd_creation_with_bad_parameters() < 0)
 		return -1;
 	if (test_average_table_utilization() < 0)
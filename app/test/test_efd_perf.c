@@ -17,6 +17,7 @@ test_efd_perf(void)
 #include <stdio.h>
 #include <inttypes.h>
 
+#include <rte_launch.h>
 #include <rte_lcore.h>
 #include <rte_cycles.h>
 #include <rte_malloc.h>
@@ -31,6 +32,11 @@ test_efd_perf(void)
 #define MAX_ENTRIES (1 << 19)
 #define KEYS_TO_ADD (MAX_ENTRIES * 3 / 4) /* 75% table utilization */
 #define NUM_LOOKUPS (KEYS_TO_ADD * 5) /* Loop among keys added, several times */
+/* Key size index used by the concurrent lookup and update test */
+#define MT_KEYSIZE_IDX 2
+#define MT_STABLE_KEYS (KEYS_TO_ADD / 2) /* Keys only looked up */
+#define MT_WRITER_ROUNDS 4 /* Times each writer updates its keys */
+#define MT_IDLE_PASSES 5 /* Lookups of the stable keys without writers */
 
 #if RTE_EFD_VALUE_NUM_BITS == 32
 #define VALUE_BITMASK 0xffffffff
@@ -65,6 +71,7 @@ struct efd_perf_params {
 	struct rte_efd_table *efd_table;
 	uint32_t key_size;
 	unsigned int cycle;
+	uint32_t flags;
 };
 
 static uint32_t hashtest_key_lens[] = {
@@ -166,9 +173,10 @@ setup_keys_and_data(struct efd_perf_params *params, unsigned int cycle)
 	/* Shuffle the random values again */
 	shuffle_input_keys(params);
 
-	params->efd_table = rte_efd_create("test_efd_perf",
+	params->efd_table = rte_efd_create_flags("test_efd_perf",
 			MAX_ENTRIES, params->key_size,
-			efd_get_all_sockets_bitmask(), test_socket_id);
+			efd_get_all_sockets_bitmask(), test_socket_id,
+			params->flags);
 	TEST_ASSERT_NOT_NULL(params->efd_table, "Error creating the efd table\n");
 
 	return 0;
@@ -338,6 +346,7 @@ run_all_tbl_perf_tests(void)
 	fflush(stdout);
 
 	test_socket_id = rte_socket_id();
+	params.flags = 0;
 
 	for (i = 0; i < NUM_KEYSIZES; i++) {
 
@@ -381,6 +390,171 @@ run_all_tbl_perf_tests(void)
 	return 0;
 }
 
+static struct rte_efd_table *mt_table;
+static uint32_t mt_writers_done;
+static uint64_t mt_update_cycles;
+
+/*
+ * Writer updating its share of the non stable keys MT_WRITER_ROUNDS times,
+ * in bursts
+ */
+static int
+mt_writer(void *arg)
+{
+	const unsigned int nb_writers = rte_lcore_count() - 1;
+	const uint32_t slice = (KEYS_TO_ADD - MT_STABLE_KEYS) / nb_writers;
+	const uint32_t first = MT_STABLE_KEYS + (uintptr_t)arg * slice;
+	efd_value_t values[RTE_EFD_BURST_MAX];
+	const void *keys_burst[RTE_EFD_BURST_MAX];
+	uint32_t round, i, j, n;
+	uint64_t start_tsc;
+	int ret = 0;
+
+	start_tsc = rte_rdtsc();
+	for (round = 0; round < MT_WRITER_ROUNDS; round++) {
+		for (i = 0; i < slice; i += n) {
+			n = RTE_MIN(slice - i, (uint32_t)RTE_EFD_BURST_MAX);
+			for (j = 0; j < n; j++) {
+				keys_burst[j] = keys[first + i + j];
+				values[j] = (data[first + i + j] + round) &
+						VALUE_BITMASK;
+			}
+			if (rte_efd_update_bulk(mt_table, test_socket_id, n,
+					keys_burst, values, NULL) != (int)n)
+				ret = -1;
+		}
+	}
+
+	__atomic_fetch_add(&mt_update_cycles, rte_rdtsc() - start_tsc,
+			__ATOMIC_RELAXED);
+	__atomic_fetch_add(&mt_writers_done, 1, __ATOMIC_RELEASE);
+
+	return ret;
+}
+
+/*
+ * Look the stable keys up in bursts, at least min_passes times
+ * and until all the writers are done, return the number of lookups
+ */
+static uint64_t
+mt_reader(unsigned int nb_writers, unsigned int min_passes)
+{
+	efd_value_t result[RTE_EFD_BURST_MAX];
+	const void *keys_burst[RTE_EFD_BURST_MAX];
+	unsigned int pass = 0;
+	uint64_t lookups = 0;
+	uint32_t i, k;
+
+	while (pass < min_passes || __atomic_load_n(&mt_writers_done,
+			__ATOMIC_ACQUIRE) != nb_writers) {
+		for (i = 0; i < MT_STABLE_KEYS; i += RTE_EFD_BURST_MAX) {
+			for (k = 0; k < RTE_EFD_BURST_MAX; k++)
+				keys_burst[k] = keys[i + k];
+			rte_efd_lookup_bulk(mt_table, test_socket_id,
+					RTE_EFD_BURST_MAX, keys_burst, result);
+		}
+		lookups += MT_STABLE_KEYS;
+		pass++;
+	}
+
+	return lookups;
+}
+
+/*
+ * Measure the bulk lookup throughput of the main lcore
+ * while the other lcores update a multi-writer table
+ */
+static int
+run_mt_lookup_update_perf(void)
+{
+	const unsigned int nb_writers = rte_lcore_count() - 1;
+	uint64_t start_tsc, idle_cycles, busy_cycles, idle_lookups, lookups;
+	efd_value_t values[RTE_EFD_BURST_MAX];
+	const void *keys_burst[RTE_EFD_BURST_MAX];
+	struct efd_perf_params params;
+	unsigned int lcore_id;
+	uint32_t i, k, first;
+	uintptr_t writer = 0;
+	int ret = 0;
+
+	if (nb_writers == 0) {
+		printf("At least 2 lcores are needed to update the table "
+				"during lookups, skipping\n");
+		return 0;
+	}
+
+	params.flags = RTE_EFD_F_MULTI_WRITER;
+	if (setup_keys_and_data(&params, MT_KEYSIZE_IDX) < 0) {
+		printf("Could not create keys/data/table\n");
+		return -1;
+	}
+	mt_table = params.efd_table;
+
+	/* Insert all the keys, the writers will update the non stable ones */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < KEYS_TO_ADD; i += RTE_EFD_BURST_MAX) {
+		for (k = 0; k < RTE_EFD_BURST_MAX; k++) {
+			keys_burst[k] = keys[i + k];
+			values[k] = data[i + k];
+		}
+		if (rte_efd_update_bulk(mt_table, test_socket_id,
+				RTE_EFD_BURST_MAX, keys_burst, values,
+				NULL) != RTE_EFD_BURST_MAX)
+			return exit_with_fail("bulk adds", &params, 0);
+	}
+	printf("\nBulk add with key size %u: %"PRIu64" cycles/key\n",
+			params.key_size, (rte_rdtsc() - start_tsc) / KEYS_TO_ADD);
+
+	__atomic_store_n(&mt_writers_done, 0, __ATOMIC_RELAXED);
+	start_tsc = rte_rdtsc();
+	idle_lookups = mt_reader(0, MT_IDLE_PASSES);
+	idle_cycles = rte_rdtsc() - start_tsc;
+
+	__atomic_store_n(&mt_update_cycles, 0, __ATOMIC_RELAXED);
+	start_tsc = rte_rdtsc();
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(mt_writer, (void *)writer++, lcore_id);
+	lookups = mt_reader(nb_writers, 0);
+	busy_cycles = rte_rdtsc() - start_tsc;
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+	if (ret < 0)
+		return exit_with_fail("concurrent updates", &params, 0);
+
+	/* All keys must map to their last value */
+	first = MT_STABLE_KEYS + (KEYS_TO_ADD - MT_STABLE_KEYS) /
+			nb_writers * nb_writers;
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		efd_value_t expected = data[i];
+
+		if (i >= MT_STABLE_KEYS && i < first)
+			expected = (data[i] + MT_WRITER_ROUNDS - 1) &
+					VALUE_BITMASK;
+		if (rte_efd_lookup(mt_table, test_socket_id, keys[i]) !=
+				expected)
+			return exit_with_fail("lookups after updates",
+					&params, i);
+	}
+
+	printf("Lookup_bulk with %u writers: %.1f cycles/lookup "
+			"(%.1f without writers)\n",
+			nb_writers, (double)busy_cycles / lookups,
+			(double)idle_cycles / idle_lookups);
+	printf("Update_bulk: %.1f cycles/update per writer, "
+			"%.2f Mupdates/s in total\n",
+			(double)mt_update_cycles /
+				((first - MT_STABLE_KEYS) * MT_WRITER_ROUNDS),
+			(double)(first - MT_STABLE_KEYS) * MT_WRITER_ROUNDS *
+				rte_get_tsc_hz() / busy_cycles / 1e6);
+
+	perform_frees(&params);
+
+	return 0;
+}
+
 static int
 test_efd_perf(void)
 {
@@ -388,6 +562,9 @@ test_efd_perf(void)
 	if (run_all_tbl_perf_tests() < 0)
 		return -1;
 
+	if (run_mt_lookup_update_perf() < 0)
+		return -1;
+
 	return 0;
 }
 
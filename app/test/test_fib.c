@@ -7,9 +7,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
 #include <rte_log.h>
 #include <rte_fib.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 
@@ -21,6 +24,8 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_bulk(void);
+static int32_t test_rcu_qsbr(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
@@ -376,6 +381,212 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Same sequence as check_fib(), with the routes of each step
+ * added and deleted in one bulk call
+ */
+static int
+check_fib_bulk(struct rte_fib *fib)
+{
+	uint64_t def_nh = 100;
+	uint32_t ip_arr[RTE_FIB_MAXDEPTH];
+	uint32_t ip_add = RTE_IPV4(128, 0, 0, 0);
+	uint32_t i, ip_missing = RTE_IPV4(127, 255, 255, 255);
+	uint32_t ips[RTE_FIB_MAXDEPTH];
+	uint8_t depths[RTE_FIB_MAXDEPTH];
+	uint64_t nhs[RTE_FIB_MAXDEPTH];
+	int ret;
+
+	for (i = 0; i < RTE_FIB_MAXDEPTH; i++) {
+		ip_arr[i] = ip_add + (1ULL << i) - 1;
+		ips[i] = ip_add;
+	}
+
+	/* ascending depths */
+	for (i = 0; i < RTE_FIB_MAXDEPTH; i++) {
+		depths[i] = i + 1;
+		nhs[i] = i + 1;
+	}
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == RTE_FIB_MAXDEPTH, "Failed to add routes\n");
+	ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh,
+		RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	ret = rte_fib_delete_bulk(fib, ips, depths + 1, RTE_FIB_MAXDEPTH - 1);
+	RTE_TEST_ASSERT(ret == RTE_FIB_MAXDEPTH - 1,
+		"Failed to delete routes\n");
+	ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh, 1);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	/* processing stops at the first missing route */
+	ret = rte_fib_delete_bulk(fib, ips, depths, 2);
+	RTE_TEST_ASSERT((ret == 1) && (rte_errno == ENOENT),
+		"Unexpected delete of a missing route\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	/* descending depths, with next hops replaced in the same batch */
+	for (i = 0; i < RTE_FIB_MAXDEPTH; i++) {
+		depths[i] = RTE_FIB_MAXDEPTH - i;
+		nhs[i] = def_nh + 1;
+	}
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == RTE_FIB_MAXDEPTH, "Failed to add routes\n");
+	for (i = 0; i < RTE_FIB_MAXDEPTH; i++)
+		nhs[i] = RTE_FIB_MAXDEPTH - i;
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == RTE_FIB_MAXDEPTH, "Failed to add routes\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh,
+		RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	ret = rte_fib_delete_bulk(fib, ips, depths, RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == RTE_FIB_MAXDEPTH, "Failed to delete routes\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check bulk add and delete for all FIB types
+ */
+int32_t
+test_bulk(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint32_t ip = RTE_IPV4(10, 0, 0, 0);
+	uint8_t depth = RTE_FIB_MAXDEPTH + 1;
+	uint64_t nh = 1;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 100;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for DUMMY type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_1B;
+	config.dir24_8.num_tbl8 = 127;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for DIR24_8_1B type\n");
+	rte_fib_free(fib);
+
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_8B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for DIR24_8_8B type\n");
+
+	/* invalid parameters */
+	ret = rte_fib_add_bulk(NULL, &ip, &depth, &nh, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib_add_bulk(fib, &ip, &depth, NULL, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib_delete_bulk(fib, NULL, &depth, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib_add_bulk(fib, &ip, &depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == 0) && (rte_errno == EINVAL),
+		"Call succeeded with invalid depth\n");
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check RCU QSBR configuration, and that the tbl8 groups released
+ * through the defer queue are reused
+ */
+int32_t
+test_rcu_qsbr(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, ip;
+	int ret;
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+		RTE_CACHE_LINE_SIZE);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for QSBR\n");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	rcu_cfg.v = qsv;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 100;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -ENOTSUP, "Unexpected QSBR for DUMMY type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_1B;
+	config.dir24_8.num_tbl8 = 127;
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_rcu_qsbr_add(fib, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL, "QSBR added with invalid config\n");
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR\n");
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -EEXIST, "QSBR added twice\n");
+
+	/* use more tbl8 groups than available, one at a time */
+	for (i = 0; i < 4 * config.dir24_8.num_tbl8; i++) {
+		ip = RTE_IPV4(10, 0, 0, 1) + (i << 8);
+		ret = rte_fib_add(fib, ip, 32, 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib_delete(fib, ip, 32);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for defer queue mode\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for defer queue mode\n");
+	rte_fib_free(fib);
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_SYNC;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for blocking mode\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for blocking mode\n");
+	rte_fib_free(fib);
+
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -386,6 +597,8 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_bulk),
+	TEST_CASE(test_rcu_qsbr),
 	TEST_CASES_END()
 	}
 };
@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_memory.h>
 #include <rte_log.h>
 #include <rte_rib6.h>
@@ -22,10 +23,13 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_bulk(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
 #define MAX_TBL8	(1 << 15)
+#define MAX_POPTRIE_NODES	(1 << 15)
+#define MAX_POPTRIE_LEAVES	(1 << 15)
 
 /*
  * Check that rte_fib6_create fails gracefully for incorrect user input
@@ -64,7 +68,7 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB6_TRIE + 1;
+	config.type = RTE_FIB6_POPTRIE + 1;
 	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
@@ -83,6 +87,19 @@ test_create_invalid(void)
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = 0;
+	config.poptrie.num_leaves = MAX_POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	config.poptrie.num_nodes = MAX_POPTRIE_NODES;
+	config.poptrie.num_leaves = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
 	return TEST_SUCCESS;
 }
 
@@ -382,6 +399,138 @@ test_lookup(void)
 		"Check_fib fails for TRIE_8B type\n");
 	rte_fib6_free(fib);
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = MAX_POPTRIE_NODES;
+	config.poptrie.num_leaves = MAX_POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE type\n");
+
+	ret = rte_fib6_select_lookup(fib, RTE_FIB6_LOOKUP_POPTRIE_SCALAR);
+	RTE_TEST_ASSERT(ret == 0, "Failed to select scalar lookup\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE scalar lookup\n");
+
+	/* vector lookup is only available on some platforms */
+	ret = rte_fib6_select_lookup(fib,
+		RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512);
+	if (ret == 0) {
+		ret = check_fib(fib);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_fib fails for POPTRIE vector lookup\n");
+	}
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Add and delete routes for one supernet with all possible depths
+ * in bulk calls, and check the lookup after each call
+ */
+static int
+check_fib_bulk(struct rte_fib6 *fib)
+{
+	uint64_t def_nh = 100;
+	uint8_t ip_arr[RTE_FIB6_MAXDEPTH][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t ips[RTE_FIB6_MAXDEPTH][RTE_FIB6_IPV6_ADDR_SIZE] = { {0} };
+	uint8_t ip_missing[1][RTE_FIB6_IPV6_ADDR_SIZE] = { {255} };
+	uint8_t depths[RTE_FIB6_MAXDEPTH];
+	uint64_t nhs[RTE_FIB6_MAXDEPTH];
+	uint32_t i, j;
+	int ret;
+
+	ip_missing[0][0] = 127;
+	for (i = 0; i < RTE_FIB6_MAXDEPTH; i++) {
+		ips[i][0] = 128;
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++) {
+			ip_arr[i][j] = ips[i][j] |
+				~get_msk_part(RTE_FIB6_MAXDEPTH - i, j);
+		}
+		depths[i] = i + 1;
+		nhs[i] = i + 1;
+	}
+
+	ret = rte_fib6_add_bulk(fib, ips, depths, nhs, RTE_FIB6_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == RTE_FIB6_MAXDEPTH, "Failed to add routes\n");
+	ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh,
+		RTE_FIB6_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	ret = rte_fib6_delete_bulk(fib, ips, depths + 1,
+		RTE_FIB6_MAXDEPTH - 1);
+	RTE_TEST_ASSERT(ret == RTE_FIB6_MAXDEPTH - 1,
+		"Failed to delete routes\n");
+	ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh, 1);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	/* processing stops at the first missing route */
+	ret = rte_fib6_delete_bulk(fib, ips, depths, 2);
+	RTE_TEST_ASSERT((ret == 1) && (rte_errno == ENOENT),
+		"Unexpected delete of a missing route\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check bulk add and delete for all FIB types
+ */
+int32_t
+test_bulk(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint8_t ip[1][RTE_FIB6_IPV6_ADDR_SIZE] = { {0} };
+	uint8_t depth = RTE_FIB6_MAXDEPTH + 1;
+	uint64_t nh = 1;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 100;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for DUMMY type\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for TRIE_4B type\n");
+
+	/* invalid parameters */
+	ret = rte_fib6_add_bulk(NULL, ip, &depth, &nh, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib6_delete_bulk(fib, ip, NULL, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib6_add_bulk(fib, ip, &depth, &nh, 1);
+	RTE_TEST_ASSERT((ret == 0) && (rte_errno == EINVAL),
+		"Call succeeded with invalid depth\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = MAX_POPTRIE_NODES;
+	config.poptrie.num_leaves = MAX_POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib_bulk(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib_bulk fails for POPTRIE type\n");
+	rte_fib6_free(fib);
+
 	return TEST_SUCCESS;
 }
 
@@ -395,6 +544,7 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_bulk),
 	TEST_CASES_END()
 	}
 };
@@ -10,6 +10,7 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_fib6.h>
 
 #include "test.h"
@@ -26,6 +27,8 @@
 #define ITERATIONS (1 << 10)
 #define BATCH_SIZE 100000
 #define NUMBER_TBL8S                                           (1 << 16)
+#define NUMBER_POPTRIE_NODES	(1 << 20)
+#define NUMBER_POPTRIE_LEAVES	(1 << 20)
 
 static void
 print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
@@ -63,40 +66,43 @@ get_max_nh(uint8_t nh_sz)
 	return ((1ULL << (bits_in_nh(nh_sz) - 1)) - 1);
 }
 
+/* Total number of bytes allocated from the DPDK heaps */
+static size_t
+get_heap_alloc_sz(void)
+{
+	struct rte_malloc_socket_stats stats;
+	unsigned int i;
+	size_t sz = 0;
+
+	for (i = 0; i < rte_socket_count(); i++) {
+		if (rte_malloc_get_socket_stats(rte_socket_id_by_idx(i),
+				&stats) == 0)
+			sz += stats.heap_allocsz_bytes;
+	}
+	return sz;
+}
+
 static int
-test_fib6_perf(void)
+measure_fib6(struct rte_fib6_conf *conf, const char *type_name,
+	const enum rte_fib6_lookup_type *lookup_types,
+	const char * const *lookup_names, unsigned int num_lookup_types)
 {
 	struct rte_fib6 *fib = NULL;
-	struct rte_fib6_conf conf;
 	uint64_t begin, total_time;
-	unsigned int i, j;
+	unsigned int i, j, k;
 	uint64_t next_hop_add;
+	size_t heap_sz;
 	int status = 0;
 	int64_t count = 0;
-	uint8_t ip_batch[NUM_IPS_ENTRIES][16];
-	uint64_t next_hops[NUM_IPS_ENTRIES];
+	static uint8_t ip_batch[NUM_IPS_ENTRIES][16];
+	static uint64_t next_hops[NUM_IPS_ENTRIES];
 
-	conf.type = RTE_FIB6_TRIE;
-	conf.default_nh = 0;
-	conf.max_routes = 1000000;
-	conf.rib_ext_sz = 0;
-	conf.trie.nh_sz = RTE_FIB6_TRIE_4B;
-	conf.trie.num_tbl8 = RTE_MIN(get_max_nh(conf.trie.nh_sz), 1000000U);
-
-	rte_srand(rte_rdtsc());
+	printf("\n%s FIB\n", type_name);
 
-	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
-
-	print_route_distribution(large_route_table,
-		(uint32_t)NUM_ROUTE_ENTRIES);
-
-	/* Only generate IPv6 address of each item in large IPS table,
-	 * here next_hop is not needed.
-	 */
-	generate_large_ips_table(0);
-
-	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &conf);
+	heap_sz = get_heap_alloc_sz();
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, conf);
 	TEST_FIB_ASSERT(fib != NULL);
+	heap_sz = get_heap_alloc_sz() - heap_sz;
 
 	/* Measure add. */
 	begin = rte_rdtsc();
@@ -113,28 +119,39 @@ test_fib6_perf(void)
 	printf("Unique added entries = %d\n", status);
 	printf("Average FIB Add: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
-
-	/* Measure bulk Lookup */
-	total_time = 0;
-	count = 0;
+	printf("FIB memory footprint: %zu bytes\n", heap_sz);
 
 	for (i = 0; i < NUM_IPS_ENTRIES; i++)
 		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
 
-	for (i = 0; i < ITERATIONS; i++) {
-
-		/* Lookup per batch */
-		begin = rte_rdtsc();
-		rte_fib6_lookup_bulk(fib, ip_batch, next_hops, NUM_IPS_ENTRIES);
-		total_time += rte_rdtsc() - begin;
-
-		for (j = 0; j < NUM_IPS_ENTRIES; j++)
-			if (next_hops[j] == 0)
-				count++;
-	}
-	printf("BULK FIB Lookup: %.1f cycles (fails = %.1f%%)\n",
+	for (k = 0; k < num_lookup_types; k++) {
+		if (rte_fib6_select_lookup(fib, lookup_types[k]) != 0) {
+			printf("%s lookup is not supported\n",
+				lookup_names[k]);
+			continue;
+		}
+
+		/* Measure bulk Lookup */
+		total_time = 0;
+		count = 0;
+
+		for (i = 0; i < ITERATIONS; i++) {
+
+			/* Lookup per batch */
+			begin = rte_rdtsc();
+			rte_fib6_lookup_bulk(fib, ip_batch, next_hops,
+				NUM_IPS_ENTRIES);
+			total_time += rte_rdtsc() - begin;
+
+			for (j = 0; j < NUM_IPS_ENTRIES; j++)
+				if (next_hops[j] == 0)
+					count++;
+		}
+		printf("BULK FIB Lookup (%s): %.1f cycles (fails = %.1f%%)\n",
+			lookup_names[k],
 			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
 			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
+	}
 
 	/* Delete */
 	status = 0;
@@ -156,4 +173,57 @@ test_fib6_perf(void)
 	return 0;
 }
 
+static int
+test_fib6_perf(void)
+{
+	struct rte_fib6_conf conf;
+	const enum rte_fib6_lookup_type trie_lookups[] = {
+		RTE_FIB6_LOOKUP_TRIE_SCALAR,
+		RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512,
+	};
+	const char * const trie_lookup_names[] = {
+		"scalar",
+		"AVX512",
+	};
+	const enum rte_fib6_lookup_type poptrie_lookups[] = {
+		RTE_FIB6_LOOKUP_POPTRIE_SCALAR,
+		RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512,
+	};
+	const char * const poptrie_lookup_names[] = {
+		"scalar",
+		"AVX512 VPOPCNTDQ",
+	};
+
+	rte_srand(rte_rdtsc());
+
+	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
+
+	print_route_distribution(large_route_table,
+		(uint32_t)NUM_ROUTE_ENTRIES);
+
+	/* Only generate IPv6 address of each item in large IPS table,
+	 * here next_hop is not needed.
+	 */
+	generate_large_ips_table(0);
+
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB6_TRIE;
+	conf.default_nh = 0;
+	conf.max_routes = 1000000;
+	conf.rib_ext_sz = 0;
+	conf.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	conf.trie.num_tbl8 = RTE_MIN(get_max_nh(conf.trie.nh_sz), 1000000U);
+
+	if (measure_fib6(&conf, "TRIE", trie_lookups, trie_lookup_names,
+			RTE_DIM(trie_lookups)) != 0)
+		return -1;
+
+	conf.type = RTE_FIB6_POPTRIE;
+	conf.poptrie.num_nodes = NUMBER_POPTRIE_NODES;
+	conf.poptrie.num_leaves = NUMBER_POPTRIE_LEAVES;
+
+	return measure_fib6(&conf, "POPTRIE", poptrie_lookups,
+		poptrie_lookup_names, RTE_DIM(poptrie_lookups));
+}
+
 REGISTER_TEST_COMMAND(fib6_perf_autotest, test_fib6_perf);
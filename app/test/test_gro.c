@@ -0,0 +1,484 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_ether.h>
+#include <rte_gro.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+
+#include "test.h"
+
+#define NUM_MBUFS	128
+#define MBUF_DATA_SIZE	(RTE_PKTMBUF_HEADROOM + 512)
+#define PAYLOAD_LEN	100
+#define MAX_PKTS	16
+
+/* Header lengths of the test packets */
+#define ETH_LEN		sizeof(struct rte_ether_hdr)
+#define IPV4_LEN	sizeof(struct rte_ipv4_hdr)
+#define IPV6_LEN	sizeof(struct rte_ipv6_hdr)
+#define TCP_LEN		sizeof(struct rte_tcp_hdr)
+#define VXLAN_OUTER_LEN	(ETH_LEN + IPV6_LEN + sizeof(struct rte_udp_hdr) + \
+			 sizeof(struct rte_vxlan_hdr))
+
+static struct rte_mempool *pkt_pool;
+
+/* Description of a test packet */
+struct pkt_desc {
+	/* VxLAN encapsulated in an outer IPv6 header */
+	uint8_t vxlan;
+	/* inner or only IP version is 6 */
+	uint8_t ipv6;
+	/* flow number, it makes the addresses and the ports */
+	uint8_t flow;
+	uint8_t tcp_flags;
+	uint32_t seq;
+	uint16_t len;
+};
+
+/*
+ * Build a TCP packet. The payload bytes are the low bytes of their
+ * TCP sequence number, so a merged packet can be checked byte by byte.
+ */
+static struct rte_mbuf *
+build_pkt(const struct pkt_desc *d)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_vxlan_hdr *vxlan_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_mbuf *m;
+	uint16_t l3_len, outer_len, i;
+	uint8_t *p;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	l3_len = d->ipv6 ? IPV6_LEN : IPV4_LEN;
+	outer_len = d->vxlan ? VXLAN_OUTER_LEN : 0;
+	p = (uint8_t *)rte_pktmbuf_append(m, outer_len + ETH_LEN + l3_len +
+			TCP_LEN + d->len);
+	if (p == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(p, 0, m->data_len);
+
+	if (d->vxlan) {
+		eth_hdr = (struct rte_ether_hdr *)p;
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(m->data_len -
+				ETH_LEN - IPV6_LEN);
+		ipv6_hdr->proto = IPPROTO_UDP;
+		ipv6_hdr->src_addr[0] = 0x20;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0x20;
+		ipv6_hdr->dst_addr[15] = 2;
+		udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+		udp_hdr->src_port = rte_cpu_to_be_16(49152);
+		udp_hdr->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+		udp_hdr->dgram_len = ipv6_hdr->payload_len;
+		vxlan_hdr = (struct rte_vxlan_hdr *)(udp_hdr + 1);
+		vxlan_hdr->vx_flags = rte_cpu_to_be_32(0x08000000);
+		vxlan_hdr->vx_vni = rte_cpu_to_be_32(42 << 8);
+		p += outer_len;
+
+		m->outer_l2_len = ETH_LEN;
+		m->outer_l3_len = IPV6_LEN;
+		m->l2_len = sizeof(*udp_hdr) + sizeof(*vxlan_hdr) + ETH_LEN;
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+			RTE_PTYPE_L4_UDP | RTE_PTYPE_TUNNEL_VXLAN |
+			RTE_PTYPE_INNER_L2_ETHER | RTE_PTYPE_INNER_L4_TCP |
+			(d->ipv6 ? RTE_PTYPE_INNER_L3_IPV6 :
+			 RTE_PTYPE_INNER_L3_IPV4);
+	} else {
+		m->l2_len = ETH_LEN;
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L4_TCP |
+			(d->ipv6 ? RTE_PTYPE_L3_IPV6 : RTE_PTYPE_L3_IPV4);
+	}
+	m->l3_len = l3_len;
+	m->l4_len = TCP_LEN;
+
+	eth_hdr = (struct rte_ether_hdr *)p;
+	if (d->ipv6) {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(TCP_LEN + d->len);
+		ipv6_hdr->proto = IPPROTO_TCP;
+		ipv6_hdr->hop_limits = 64;
+		ipv6_hdr->src_addr[0] = 0xfd;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0xfd;
+		ipv6_hdr->dst_addr[15] = 2 + d->flow;
+		tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
+	} else {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(IPV4_LEN + TCP_LEN +
+				d->len);
+		ipv4_hdr->fragment_offset =
+			rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+		ipv4_hdr->time_to_live = 64;
+		ipv4_hdr->next_proto_id = IPPROTO_TCP;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2) +
+				d->flow);
+		tcp_hdr = (struct rte_tcp_hdr *)(ipv4_hdr + 1);
+	}
+	tcp_hdr->src_port = rte_cpu_to_be_16(1024);
+	tcp_hdr->dst_port = rte_cpu_to_be_16(80);
+	tcp_hdr->sent_seq = rte_cpu_to_be_32(d->seq);
+	tcp_hdr->recv_ack = rte_cpu_to_be_32(1);
+	tcp_hdr->data_off = TCP_LEN << 2;
+	tcp_hdr->tcp_flags = d->tcp_flags;
+
+	p = (uint8_t *)(tcp_hdr + 1);
+	for (i = 0; i < d->len; i++)
+		p[i] = (uint8_t)(d->seq + i);
+
+	return m;
+}
+
+static int
+build_pkts(const struct pkt_desc *descs, uint16_t nb, struct rte_mbuf **pkts)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb; i++) {
+		pkts[i] = build_pkt(&descs[i]);
+		if (pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(pkts, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Check that a packet carries the payload of the seq_start to
+ * seq_start + len sequence range, and that its IP, and outer IPv6
+ * and UDP for VxLAN, length fields match the packet length.
+ */
+static int
+check_pkt(struct rte_mbuf *m, const struct pkt_desc *d, uint32_t seq_start,
+		uint32_t len, uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint32_t hdr_len, outer_len, i;
+	uint8_t buf[MAX_PKTS * PAYLOAD_LEN];
+	const uint8_t *data;
+	uint8_t *iph;
+
+	outer_len = d->vxlan ? VXLAN_OUTER_LEN : 0;
+	hdr_len = outer_len + ETH_LEN + m->l3_len + TCP_LEN;
+	TEST_ASSERT_EQUAL(m->pkt_len, hdr_len + len,
+			"Wrong packet length %u, expected %u",
+			m->pkt_len, hdr_len + len);
+	TEST_ASSERT_EQUAL(m->nb_segs, nb_segs,
+			"Wrong segment number %u, expected %u",
+			m->nb_segs, nb_segs);
+
+	if (d->vxlan) {
+		ipv6_hdr = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *,
+				ETH_LEN);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv6_hdr->payload_len),
+				m->pkt_len - ETH_LEN - IPV6_LEN,
+				"Wrong outer IPv6 payload length");
+		udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(udp_hdr->dgram_len),
+				m->pkt_len - ETH_LEN - IPV6_LEN,
+				"Wrong outer UDP length");
+	}
+
+	iph = rte_pktmbuf_mtod_offset(m, uint8_t *, outer_len + ETH_LEN);
+	if (d->ipv6) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)iph;
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv6_hdr->payload_len),
+				TCP_LEN + len, "Wrong IPv6 payload length");
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)iph;
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv4_hdr->total_length),
+				IPV4_LEN + TCP_LEN + len,
+				"Wrong IPv4 total length");
+	}
+	tcp_hdr = (struct rte_tcp_hdr *)(iph + m->l3_len);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp_hdr->sent_seq), seq_start,
+			"Wrong TCP sequence number");
+
+	data = rte_pktmbuf_read(m, hdr_len, len, buf);
+	TEST_ASSERT_NOT_NULL(data, "Cannot read the payload");
+	for (i = 0; i < len; i++)
+		TEST_ASSERT_EQUAL(data[i], (uint8_t)(seq_start + i),
+				"Wrong payload byte at offset %u", i);
+
+	return TEST_SUCCESS;
+}
+
+/* Find the output packet of a flow, NULL if there is none. */
+static struct rte_mbuf *
+find_flow_pkt(struct rte_mbuf **pkts, uint16_t nb, const struct pkt_desc *d)
+{
+	struct rte_tcp_hdr *tcp_hdr;
+	uint32_t offset;
+	uint8_t *iph;
+	uint16_t i;
+
+	offset = (d->vxlan ? VXLAN_OUTER_LEN : 0) + ETH_LEN;
+	for (i = 0; i < nb; i++) {
+		iph = rte_pktmbuf_mtod_offset(pkts[i], uint8_t *, offset);
+		if (d->vxlan != !!RTE_ETH_IS_TUNNEL_PKT(pkts[i]->packet_type))
+			continue;
+		if ((iph[0] >> 4) != (d->ipv6 ? 6 : 4))
+			continue;
+		if (d->ipv6 ? (iph[offsetof(struct rte_ipv6_hdr, dst_addr) +
+					15] != 2 + d->flow) :
+				(iph[offsetof(struct rte_ipv4_hdr, dst_addr) +
+					3] != 2 + d->flow))
+			continue;
+		tcp_hdr = (struct rte_tcp_hdr *)(iph + pkts[i]->l3_len);
+		if (tcp_hdr->tcp_flags == RTE_TCP_ACK_FLAG)
+			return pkts[i];
+	}
+	return NULL;
+}
+
+/*
+ * Merge the packets of two flows with rte_gro_reassemble_burst(),
+ * the second segment of the first flow arrives first, so the first
+ * one is prepended to it and the third one appended.
+ */
+static int
+test_gro_burst(uint64_t gro_types, uint8_t vxlan, uint8_t ipv6)
+{
+	struct pkt_desc descs[] = {
+		{vxlan, ipv6, 0, RTE_TCP_ACK_FLAG, 1000 + PAYLOAD_LEN,
+			PAYLOAD_LEN},
+		{vxlan, ipv6, 1, RTE_TCP_ACK_FLAG, 5000, PAYLOAD_LEN},
+		{vxlan, ipv6, 0, RTE_TCP_ACK_FLAG, 1000, PAYLOAD_LEN},
+		{vxlan, ipv6, 0, RTE_TCP_ACK_FLAG, 1000 + 2 * PAYLOAD_LEN,
+			PAYLOAD_LEN},
+		{vxlan, ipv6, 1, RTE_TCP_ACK_FLAG, 5000 + PAYLOAD_LEN,
+			PAYLOAD_LEN},
+		/* PSH is set, the packet is returned unprocessed */
+		{vxlan, ipv6, 0, RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG,
+			1000 + 3 * PAYLOAD_LEN, PAYLOAD_LEN},
+	};
+	struct rte_gro_param param = {
+		.gro_types = gro_types,
+		.max_flow_num = 4,
+		.max_item_per_flow = 4,
+	};
+	struct rte_mbuf *pkts[RTE_DIM(descs)], *m;
+	uint16_t nb;
+	int ret;
+
+	TEST_ASSERT_SUCCESS(build_pkts(descs, RTE_DIM(descs), pkts),
+			"Cannot build the packets");
+
+	nb = rte_gro_reassemble_burst(pkts, RTE_DIM(descs), &param);
+	ret = TEST_FAILED;
+	if (nb != 3) {
+		printf("%u packets after GRO, expected 3\n", nb);
+		goto out;
+	}
+
+	m = find_flow_pkt(pkts, nb, &descs[0]);
+	if (m == NULL || check_pkt(m, &descs[0], 1000, 3 * PAYLOAD_LEN, 3))
+		goto out;
+	m = find_flow_pkt(pkts, nb, &descs[1]);
+	if (m == NULL || check_pkt(m, &descs[1], 5000, 2 * PAYLOAD_LEN, 2))
+		goto out;
+	ret = TEST_SUCCESS;
+
+out:
+	rte_pktmbuf_free_bulk(pkts, nb);
+	return ret;
+}
+
+static int
+test_gro_tcp6_burst(void)
+{
+	return test_gro_burst(RTE_GRO_TCP_IPV6, 0, 1);
+}
+
+static int
+test_gro_vxlan6_tcp4_burst(void)
+{
+	return test_gro_burst(RTE_GRO_IPV6_VXLAN_TCP_IPV4, 1, 0);
+}
+
+static int
+test_gro_vxlan6_tcp6_burst(void)
+{
+	return test_gro_burst(RTE_GRO_IPV6_VXLAN_TCP_IPV6 |
+			RTE_GRO_IPV6_VXLAN_TCP_IPV4, 1, 1);
+}
+
+/*
+ * Merge the packets of all the new types in a GRO context, across
+ * several calls of rte_gro_reassemble(), and check that a type which
+ * isn't enabled is left alone.
+ */
+static int
+test_gro_ctx(void)
+{
+	struct pkt_desc descs[] = {
+		{0, 1, 0, RTE_TCP_ACK_FLAG, 0, PAYLOAD_LEN},
+		{1, 0, 0, RTE_TCP_ACK_FLAG, 0, PAYLOAD_LEN},
+		{1, 1, 0, RTE_TCP_ACK_FLAG, 0, PAYLOAD_LEN},
+		{0, 0, 0, RTE_TCP_ACK_FLAG, 0, PAYLOAD_LEN},
+	};
+	struct pkt_desc d;
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV6 | RTE_GRO_IPV6_VXLAN_TCP_IPV4 |
+			RTE_GRO_IPV6_VXLAN_TCP_IPV6,
+		.max_flow_num = 4,
+		.max_item_per_flow = 8,
+		.socket_id = rte_socket_id(),
+	};
+	struct rte_mbuf *pkts[RTE_DIM(descs)], *out[MAX_PKTS], *m;
+	uint16_t nb, nb_out = 0, rnd, i;
+	void *ctx;
+	int ret = TEST_FAILED;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "Cannot create GRO context");
+
+	for (rnd = 0; rnd < 4; rnd++) {
+		for (i = 0; i < RTE_DIM(descs); i++) {
+			d = descs[i];
+			d.seq = rnd * PAYLOAD_LEN;
+			pkts[i] = build_pkt(&d);
+			if (pkts[i] == NULL) {
+				rte_pktmbuf_free_bulk(pkts, i);
+				goto out;
+			}
+		}
+		nb = rte_gro_reassemble(pkts, RTE_DIM(descs), ctx);
+		/* Only the TCP/IPv4 packet is returned. */
+		rte_pktmbuf_free_bulk(pkts, nb);
+		if (nb != 1) {
+			printf("%u packets unprocessed, expected 1\n", nb);
+			goto out;
+		}
+	}
+
+	if (rte_gro_get_pkt_count(ctx) != 3) {
+		printf("%"PRIu64" packets in GRO context, expected 3\n",
+			rte_gro_get_pkt_count(ctx));
+		goto out;
+	}
+	nb_out = rte_gro_timeout_flush(ctx, 0, param.gro_types, out,
+			RTE_DIM(out));
+	if (nb_out != 3) {
+		printf("%u packets flushed, expected 3\n", nb_out);
+		goto out;
+	}
+	for (i = 0; i < 3; i++) {
+		m = find_flow_pkt(out, nb_out, &descs[i]);
+		if (m == NULL || check_pkt(m, &descs[i], 0, 4 * PAYLOAD_LEN, 4))
+			goto out;
+	}
+	ret = TEST_SUCCESS;
+
+out:
+	rte_pktmbuf_free_bulk(out, nb_out);
+	rte_gro_ctx_destroy(ctx);
+	return ret;
+}
+
+/* TCP/IPv6 packets with extension headers are not merged. */
+static int
+test_gro_tcp6_ext_hdr(void)
+{
+	struct pkt_desc descs[] = {
+		{0, 1, 0, RTE_TCP_ACK_FLAG, 0, PAYLOAD_LEN},
+		{0, 1, 0, RTE_TCP_ACK_FLAG, PAYLOAD_LEN, PAYLOAD_LEN},
+	};
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV6,
+		.max_flow_num = 1,
+		.max_item_per_flow = 2,
+	};
+	struct rte_mbuf *pkts[RTE_DIM(descs)];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t nb, i;
+
+	TEST_ASSERT_SUCCESS(build_pkts(descs, RTE_DIM(descs), pkts),
+			"Cannot build the packets");
+	for (i = 0; i < RTE_DIM(descs); i++) {
+		ipv6_hdr = rte_pktmbuf_mtod_offset(pkts[i],
+				struct rte_ipv6_hdr *, ETH_LEN);
+		ipv6_hdr->proto = IPPROTO_HOPOPTS;
+		pkts[i]->packet_type = RTE_PTYPE_L2_ETHER |
+			RTE_PTYPE_L3_IPV6_EXT | RTE_PTYPE_L4_TCP;
+	}
+
+	nb = rte_gro_reassemble_burst(pkts, RTE_DIM(descs), &param);
+	rte_pktmbuf_free_bulk(pkts, nb);
+	TEST_ASSERT_EQUAL(nb, RTE_DIM(descs),
+			"Packets with extension headers were merged");
+
+	return TEST_SUCCESS;
+}
+
+static int
+testsuite_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("GRO_MBUF_POOL", NUM_MBUFS, 0, 0,
+			MBUF_DATA_SIZE, SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return TEST_FAILED;
+	}
+	return TEST_SUCCESS;
+}
+
+static void
+testsuite_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite gro_testsuite = {
+	.suite_name = "GRO Unit Test Suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_gro_tcp6_burst),
+		TEST_CASE(test_gro_vxlan6_tcp4_burst),
+		TEST_CASE(test_gro_vxlan6_tcp6_burst),
+		TEST_CASE(test_gro_ctx),
+		TEST_CASE(test_gro_tcp6_ext_hdr),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gro(void)
+{
+	return unit_test_suite_runner(&gro_testsuite);
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
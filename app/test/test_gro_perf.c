@@ -0,0 +1,256 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_gro.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+
+#include "test.h"
+
+#define BURST_SIZE	32
+/* Packets per flow, the second one of a flow is merged with the first. */
+#define PKTS_PER_FLOW	2
+#define PAYLOAD_LEN	64
+#define MBUF_DATA_SIZE	(RTE_PKTMBUF_HEADROOM + 256)
+
+static const uint32_t flow_nums[] = {1024, 4096, 16384, UINT16_MAX};
+
+static const struct {
+	const char *name;
+	uint64_t gro_type;
+} perf_types[] = {
+	{"TCP/IPv4", RTE_GRO_TCP_IPV4},
+	{"UDP/IPv4", RTE_GRO_UDP_IPV4},
+	{"TCP/IPv6", RTE_GRO_TCP_IPV6},
+};
+
+/* Fill the TCP header of the packet of round rnd of flow. */
+static void
+fill_tcp_hdr(struct rte_tcp_hdr *tcp_hdr, uint32_t flow, uint32_t rnd)
+{
+	tcp_hdr->src_port = rte_cpu_to_be_16(1024 + (flow & 0x7fff));
+	tcp_hdr->dst_port = rte_cpu_to_be_16(80 + (flow >> 15));
+	tcp_hdr->sent_seq = rte_cpu_to_be_32(rnd * PAYLOAD_LEN);
+	tcp_hdr->data_off = sizeof(*tcp_hdr) << 2;
+	tcp_hdr->tcp_flags = RTE_TCP_ACK_FLAG;
+}
+
+/* Build the TCP/IPv6 packet of round rnd of flow. */
+static void
+fill_pkt6(struct rte_mbuf *m, uint32_t flow, uint32_t rnd)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+
+	rte_pktmbuf_reset(m);
+	eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+		sizeof(*eth_hdr) + sizeof(*ipv6_hdr) + sizeof(*tcp_hdr) +
+		PAYLOAD_LEN);
+	memset(eth_hdr, 0, m->data_len);
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+	ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(sizeof(*tcp_hdr) +
+		PAYLOAD_LEN);
+	ipv6_hdr->proto = IPPROTO_TCP;
+	ipv6_hdr->src_addr[0] = 0xfd;
+	ipv6_hdr->src_addr[15] = 1;
+	ipv6_hdr->dst_addr[0] = 0xfd;
+	ipv6_hdr->dst_addr[14] = flow >> 8;
+	ipv6_hdr->dst_addr[15] = flow;
+
+	tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
+	fill_tcp_hdr(tcp_hdr, flow, rnd);
+
+	m->l2_len = sizeof(*eth_hdr);
+	m->l3_len = sizeof(*ipv6_hdr);
+	m->l4_len = sizeof(*tcp_hdr);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+		RTE_PTYPE_L4_TCP;
+}
+
+/*
+ * Build the packet of round rnd of flow. TCP packets of a flow follow
+ * each other in sequence, UDP ones are the fragments of a datagram.
+ */
+static void
+fill_pkt(struct rte_mbuf *m, uint64_t gro_type, uint32_t flow, uint32_t rnd)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint16_t l4_len, frag;
+	int udp = gro_type == RTE_GRO_UDP_IPV4;
+
+	if (gro_type == RTE_GRO_TCP_IPV6) {
+		fill_pkt6(m, flow, rnd);
+		return;
+	}
+
+	l4_len = udp ? 0 : sizeof(*tcp_hdr);
+	rte_pktmbuf_reset(m);
+	eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+		sizeof(*eth_hdr) + sizeof(*ipv4_hdr) + l4_len + PAYLOAD_LEN);
+	memset(eth_hdr, 0, m->data_len);
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+	ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+	ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+		l4_len + PAYLOAD_LEN);
+	ipv4_hdr->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ipv4_hdr->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 1, 0, 0) + flow);
+
+	m->l2_len = sizeof(*eth_hdr);
+	m->l3_len = sizeof(*ipv4_hdr);
+	m->l4_len = l4_len;
+
+	if (udp) {
+		ipv4_hdr->next_proto_id = IPPROTO_UDP;
+		ipv4_hdr->packet_id = rte_cpu_to_be_16(flow);
+		frag = rnd * PAYLOAD_LEN / RTE_IPV4_HDR_OFFSET_UNITS;
+		if (rnd != PKTS_PER_FLOW - 1)
+			frag |= RTE_IPV4_HDR_MF_FLAG;
+		ipv4_hdr->fragment_offset = rte_cpu_to_be_16(frag);
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+			RTE_PTYPE_L4_UDP;
+		return;
+	}
+
+	ipv4_hdr->next_proto_id = IPPROTO_TCP;
+	ipv4_hdr->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+	tcp_hdr = (struct rte_tcp_hdr *)(ipv4_hdr + 1);
+	fill_tcp_hdr(tcp_hdr, flow, rnd);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_TCP;
+}
+
+static int
+run_gro_perf(struct rte_mempool *mp, uint32_t type, uint32_t nb_flows)
+{
+	struct rte_gro_param param = {0};
+	struct rte_mbuf **pkts, **out;
+	uint64_t tsc, reassemble_tsc[PKTS_PER_FLOW], flush_tsc = 0;
+	uint32_t i, j, idx, nb_pkts, nb_out = 0;
+	uint16_t nb, left;
+	void *ctx;
+	int ret = -1;
+
+	nb_pkts = nb_flows * PKTS_PER_FLOW;
+	pkts = rte_malloc(NULL, sizeof(*pkts) * nb_pkts, 0);
+	out = rte_malloc(NULL, sizeof(*out) * nb_flows, 0);
+	if (pkts == NULL || out == NULL) {
+		printf("Cannot allocate packet arrays\n");
+		goto free_pkts;
+	}
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, nb_pkts) != 0) {
+		printf("Cannot allocate %u mbufs\n", nb_pkts);
+		goto free_pkts;
+	}
+
+	/* The flows are interleaved, as seen by a high fan-in server. */
+	for (i = 0; i < PKTS_PER_FLOW; i++)
+		for (j = 0; j < nb_flows; j++)
+			fill_pkt(pkts[i * nb_flows + j],
+				perf_types[type].gro_type, j, i);
+
+	param.gro_types = perf_types[type].gro_type;
+	param.max_flow_num = nb_flows;
+	param.max_item_per_flow = 1;
+	param.socket_id = rte_socket_id();
+	ctx = rte_gro_ctx_create(&param);
+	if (ctx == NULL) {
+		printf("Cannot create GRO context\n");
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		goto free_pkts;
+	}
+
+	for (i = 0; i < PKTS_PER_FLOW; i++) {
+		tsc = rte_rdtsc_precise();
+		for (j = 0; j < nb_flows; j += nb) {
+			idx = i * nb_flows + j;
+			nb = RTE_MIN(nb_flows - j, (uint32_t)BURST_SIZE);
+			left = rte_gro_reassemble(&pkts[idx], nb, ctx);
+			/* Every packet is expected to be stored or merged. */
+			if (left != 0) {
+				printf("%u packets not processed by GRO\n",
+					left);
+				rte_pktmbuf_free_bulk(&pkts[idx], left);
+				rte_pktmbuf_free_bulk(&pkts[idx + nb],
+					nb_pkts - idx - nb);
+				goto flush;
+			}
+		}
+		reassemble_tsc[i] = rte_rdtsc_precise() - tsc;
+	}
+	ret = 0;
+
+flush:
+	do {
+		tsc = rte_rdtsc_precise();
+		nb = rte_gro_timeout_flush(ctx, 0, param.gro_types, out,
+			RTE_MIN(nb_flows, (uint32_t)UINT16_MAX));
+		flush_tsc += rte_rdtsc_precise() - tsc;
+		rte_pktmbuf_free_bulk(out, nb);
+		nb_out += nb;
+	} while (nb != 0);
+	rte_gro_ctx_destroy(ctx);
+
+	if (ret != 0)
+		goto free_pkts;
+	if (nb_out != nb_flows) {
+		printf("%u packets flushed, expected %u\n", nb_out, nb_flows);
+		ret = -1;
+		goto free_pkts;
+	}
+
+	printf("%s %5u flows: insert %.1f, merge %.1f, "
+		"flush %.1f cycles/pkt\n",
+		perf_types[type].name, nb_flows,
+		(double)reassemble_tsc[0] / nb_flows,
+		(double)reassemble_tsc[1] / nb_flows,
+		(double)flush_tsc / nb_flows);
+
+free_pkts:
+	rte_free(pkts);
+	rte_free(out);
+	return ret;
+}
+
+static int
+test_gro_perf(void)
+{
+	struct rte_mempool *mp;
+	uint32_t i, j;
+	int ret = 0;
+
+	mp = rte_pktmbuf_pool_create("GRO_PERF_POOL",
+		UINT16_MAX * PKTS_PER_FLOW, 0, 0, MBUF_DATA_SIZE,
+		SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Cannot create mbuf pool, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	for (i = 0; i < RTE_DIM(flow_nums) && ret == 0; i++)
+		for (j = 0; j < RTE_DIM(perf_types) && ret == 0; j++)
+			ret = run_gro_perf(mp, j, flow_nums[i]);
+
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gro_perf_autotest, test_gro_perf);
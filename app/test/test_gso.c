@@ -0,0 +1,471 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_gso.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+
+#include "test.h"
+
+#define NUM_MBUFS	128
+#define MBUF_DATA_SIZE	(RTE_PKTMBUF_HEADROOM + 2048)
+#define PAYLOAD_LEN	1500
+#define GSO_SIZE	600
+#define MAX_SEGS	8
+
+/* Header lengths of the test packets */
+#define ETH_LEN		sizeof(struct rte_ether_hdr)
+#define IPV4_LEN	sizeof(struct rte_ipv4_hdr)
+#define IPV6_LEN	sizeof(struct rte_ipv6_hdr)
+#define TCP_LEN		sizeof(struct rte_tcp_hdr)
+#define UDP_LEN		sizeof(struct rte_udp_hdr)
+#define FRAG_LEN	sizeof(struct rte_ipv6_fragment_ext)
+#define VXLAN_OUTER_LEN	(ETH_LEN + IPV6_LEN + UDP_LEN + \
+			 sizeof(struct rte_vxlan_hdr))
+
+#define TCP_SEQ		1000
+
+static struct rte_mempool *pkt_pool;
+
+/* Description of a test packet */
+struct pkt_desc {
+	/* VxLAN encapsulated in an outer IPv6 header */
+	uint8_t vxlan;
+	/* inner or only IP version is 6 */
+	uint8_t ipv6;
+	/* UDP instead of TCP */
+	uint8_t udp;
+};
+
+/*
+ * Build a packet with PAYLOAD_LEN bytes of L4 payload, whose bytes
+ * are the low bytes of their offset, and set its GSO ol_flags.
+ */
+static struct rte_mbuf *
+build_pkt(const struct pkt_desc *d)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_vxlan_hdr *vxlan_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_mbuf *m;
+	uint16_t l3_len, l4_len, outer_len, i;
+	uint8_t *p;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	l3_len = d->ipv6 ? IPV6_LEN : IPV4_LEN;
+	l4_len = d->udp ? UDP_LEN : TCP_LEN;
+	outer_len = d->vxlan ? VXLAN_OUTER_LEN : 0;
+	p = (uint8_t *)rte_pktmbuf_append(m, outer_len + ETH_LEN + l3_len +
+			l4_len + PAYLOAD_LEN);
+	if (p == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(p, 0, m->data_len);
+
+	if (d->vxlan) {
+		eth_hdr = (struct rte_ether_hdr *)p;
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(m->data_len -
+				ETH_LEN - IPV6_LEN);
+		ipv6_hdr->proto = IPPROTO_UDP;
+		ipv6_hdr->src_addr[0] = 0x20;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0x20;
+		ipv6_hdr->dst_addr[15] = 2;
+		udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+		udp_hdr->src_port = rte_cpu_to_be_16(49152);
+		udp_hdr->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+		udp_hdr->dgram_len = ipv6_hdr->payload_len;
+		vxlan_hdr = (struct rte_vxlan_hdr *)(udp_hdr + 1);
+		vxlan_hdr->vx_flags = rte_cpu_to_be_32(0x08000000);
+		vxlan_hdr->vx_vni = rte_cpu_to_be_32(42 << 8);
+		p += outer_len;
+
+		m->outer_l2_len = ETH_LEN;
+		m->outer_l3_len = IPV6_LEN;
+		m->l2_len = UDP_LEN + sizeof(*vxlan_hdr) + ETH_LEN;
+		m->ol_flags = RTE_MBUF_F_TX_TUNNEL_VXLAN |
+			RTE_MBUF_F_TX_OUTER_IPV6;
+	} else {
+		m->l2_len = ETH_LEN;
+	}
+	m->l3_len = l3_len;
+	m->l4_len = l4_len;
+	m->ol_flags |= (d->udp ? RTE_MBUF_F_TX_UDP_SEG : RTE_MBUF_F_TX_TCP_SEG) |
+		(d->ipv6 ? RTE_MBUF_F_TX_IPV6 : RTE_MBUF_F_TX_IPV4);
+
+	eth_hdr = (struct rte_ether_hdr *)p;
+	if (d->ipv6) {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(l4_len + PAYLOAD_LEN);
+		ipv6_hdr->proto = d->udp ? IPPROTO_UDP : IPPROTO_TCP;
+		ipv6_hdr->hop_limits = 64;
+		ipv6_hdr->src_addr[0] = 0xfd;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0xfd;
+		ipv6_hdr->dst_addr[15] = 2;
+		p = (uint8_t *)(ipv6_hdr + 1);
+	} else {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(IPV4_LEN + l4_len +
+				PAYLOAD_LEN);
+		ipv4_hdr->packet_id = rte_cpu_to_be_16(7);
+		ipv4_hdr->time_to_live = 64;
+		ipv4_hdr->next_proto_id = d->udp ? IPPROTO_UDP : IPPROTO_TCP;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+		p = (uint8_t *)(ipv4_hdr + 1);
+	}
+
+	if (d->udp) {
+		udp_hdr = (struct rte_udp_hdr *)p;
+		udp_hdr->src_port = rte_cpu_to_be_16(1024);
+		udp_hdr->dst_port = rte_cpu_to_be_16(5000);
+		udp_hdr->dgram_len = rte_cpu_to_be_16(UDP_LEN + PAYLOAD_LEN);
+	} else {
+		tcp_hdr = (struct rte_tcp_hdr *)p;
+		tcp_hdr->src_port = rte_cpu_to_be_16(1024);
+		tcp_hdr->dst_port = rte_cpu_to_be_16(80);
+		tcp_hdr->sent_seq = rte_cpu_to_be_32(TCP_SEQ);
+		tcp_hdr->recv_ack = rte_cpu_to_be_32(1);
+		tcp_hdr->data_off = TCP_LEN << 2;
+		tcp_hdr->tcp_flags = RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG;
+	}
+
+	p += l4_len;
+	for (i = 0; i < PAYLOAD_LEN; i++)
+		p[i] = (uint8_t)i;
+
+	return m;
+}
+
+/* Check that len bytes of seg at seg_off are the ones of pkt at pkt_off. */
+static int
+check_payload(struct rte_mbuf *seg, uint32_t seg_off, struct rte_mbuf *pkt,
+		uint32_t pkt_off, uint32_t len)
+{
+	uint8_t seg_buf[MBUF_DATA_SIZE], pkt_buf[MBUF_DATA_SIZE];
+	const uint8_t *seg_data, *pkt_data;
+
+	seg_data = rte_pktmbuf_read(seg, seg_off, len, seg_buf);
+	pkt_data = rte_pktmbuf_read(pkt, pkt_off, len, pkt_buf);
+	TEST_ASSERT(seg_data != NULL && pkt_data != NULL,
+			"Cannot read the payload");
+	TEST_ASSERT_BUFFERS_ARE_EQUAL(seg_data, pkt_data, len,
+			"Wrong segment payload");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Segment a TCP packet and check the length fields, the sequence
+ * number, the PSH flag and the payload of each segment.
+ */
+static int
+test_gso_tcp(const struct pkt_desc *d, const struct rte_gso_ctx *ctx)
+{
+	struct rte_mbuf *pkt, *segs[MAX_SEGS];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint32_t outer_len, inner_off, hdr_len, pyld_len, sent = 0;
+	uint8_t *iph;
+	int nb, i, ret = TEST_FAILED;
+
+	pkt = build_pkt(d);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build the packet");
+
+	outer_len = d->vxlan ? VXLAN_OUTER_LEN : 0;
+	inner_off = outer_len + ETH_LEN;
+	hdr_len = inner_off + pkt->l3_len + TCP_LEN;
+
+	nb = rte_gso_segment(pkt, ctx, segs, RTE_DIM(segs));
+	if (nb != (int)((PAYLOAD_LEN + GSO_SIZE - hdr_len - 1) /
+			(GSO_SIZE - hdr_len))) {
+		printf("%d segments, expected %u\n", nb,
+			(PAYLOAD_LEN + GSO_SIZE - hdr_len - 1) /
+			(GSO_SIZE - hdr_len));
+		goto out;
+	}
+
+	for (i = 0; i < nb; i++) {
+		pyld_len = segs[i]->pkt_len - hdr_len;
+		if (segs[i]->pkt_len > GSO_SIZE ||
+				(segs[i]->ol_flags & RTE_MBUF_F_TX_TCP_SEG)) {
+			printf("Wrong segment %d\n", i);
+			goto free_segs;
+		}
+
+		if (d->vxlan) {
+			ipv6_hdr = rte_pktmbuf_mtod_offset(segs[i],
+					struct rte_ipv6_hdr *, ETH_LEN);
+			udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+			if (rte_be_to_cpu_16(ipv6_hdr->payload_len) !=
+					segs[i]->pkt_len - ETH_LEN - IPV6_LEN ||
+					rte_be_to_cpu_16(udp_hdr->dgram_len) !=
+					segs[i]->pkt_len - ETH_LEN - IPV6_LEN) {
+				printf("Wrong outer length in segment %d\n", i);
+				goto free_segs;
+			}
+		}
+
+		iph = rte_pktmbuf_mtod_offset(segs[i], uint8_t *, inner_off);
+		if (d->ipv6) {
+			ipv6_hdr = (struct rte_ipv6_hdr *)iph;
+			if (rte_be_to_cpu_16(ipv6_hdr->payload_len) !=
+					TCP_LEN + pyld_len) {
+				printf("Wrong IPv6 length in segment %d\n", i);
+				goto free_segs;
+			}
+		} else {
+			ipv4_hdr = (struct rte_ipv4_hdr *)iph;
+			if (rte_be_to_cpu_16(ipv4_hdr->total_length) !=
+					IPV4_LEN + TCP_LEN + pyld_len ||
+					rte_be_to_cpu_16(ipv4_hdr->packet_id) !=
+					7 + i) {
+				printf("Wrong IPv4 header in segment %d\n", i);
+				goto free_segs;
+			}
+		}
+
+		tcp_hdr = (struct rte_tcp_hdr *)(iph + pkt->l3_len);
+		if (rte_be_to_cpu_32(tcp_hdr->sent_seq) != TCP_SEQ + sent ||
+				!!(tcp_hdr->tcp_flags & RTE_TCP_PSH_FLAG) !=
+				(i == nb - 1)) {
+			printf("Wrong TCP header in segment %d\n", i);
+			goto free_segs;
+		}
+
+		if (check_payload(segs[i], hdr_len, pkt, hdr_len + sent,
+				pyld_len) != TEST_SUCCESS)
+			goto free_segs;
+		sent += pyld_len;
+	}
+
+	if (sent != PAYLOAD_LEN) {
+		printf("%u payload bytes in the segments, expected %u\n",
+			sent, PAYLOAD_LEN);
+		goto free_segs;
+	}
+	ret = TEST_SUCCESS;
+
+free_segs:
+	rte_pktmbuf_free_bulk(segs, nb);
+out:
+	rte_pktmbuf_free(pkt);
+	return ret;
+}
+
+static int
+test_gso_tcp6(void)
+{
+	struct pkt_desc d = {0, 1, 0};
+	struct rte_gso_ctx ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_TCP_TSO,
+		.gso_size = GSO_SIZE,
+	};
+
+	return test_gso_tcp(&d, &ctx);
+}
+
+static int
+test_gso_vxlan6_tcp4(void)
+{
+	struct pkt_desc d = {1, 0, 0};
+	struct rte_gso_ctx ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO,
+		.gso_size = GSO_SIZE,
+	};
+
+	return test_gso_tcp(&d, &ctx);
+}
+
+static int
+test_gso_vxlan6_tcp6(void)
+{
+	struct pkt_desc d = {1, 1, 0};
+	struct rte_gso_ctx ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO,
+		.gso_size = GSO_SIZE,
+	};
+
+	return test_gso_tcp(&d, &ctx);
+}
+
+/*
+ * Segment a UDP/IPv6 packet, and check that the segments are the
+ * IPv6 fragments of the datagram.
+ */
+static int
+test_gso_udp6(void)
+{
+	struct pkt_desc d = {0, 1, 1};
+	struct rte_gso_ctx ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_UDP_TSO,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *pkt, *segs[MAX_SEGS];
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint32_t hdr_len, frag_len, frag_id = 0, offset = 0;
+	uint16_t frag_data;
+	int nb, nb_frags, i, ret = TEST_FAILED;
+
+	pkt = build_pkt(&d);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build the packet");
+
+	/* Fragments keep the datagram boundary, on a 8 bytes unit. */
+	hdr_len = ETH_LEN + IPV6_LEN + FRAG_LEN;
+	frag_len = (GSO_SIZE - hdr_len) & ~(RTE_IPV6_EHDR_FO_ALIGN - 1);
+
+	nb_frags = (UDP_LEN + PAYLOAD_LEN + frag_len - 1) / frag_len;
+
+	nb = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	if (nb != nb_frags) {
+		printf("%d segments, expected %d\n", nb, nb_frags);
+		goto out;
+	}
+
+	for (i = 0; i < nb; i++) {
+		ipv6_hdr = rte_pktmbuf_mtod_offset(segs[i],
+				struct rte_ipv6_hdr *, ETH_LEN);
+		frag_hdr = (struct rte_ipv6_fragment_ext *)(ipv6_hdr + 1);
+		frag_data = rte_be_to_cpu_16(frag_hdr->frag_data);
+		if (i == 0)
+			frag_id = frag_hdr->id;
+
+		if (segs[i]->pkt_len > GSO_SIZE ||
+				segs[i]->l3_len != IPV6_LEN + FRAG_LEN ||
+				ipv6_hdr->proto != IPPROTO_FRAGMENT ||
+				rte_be_to_cpu_16(ipv6_hdr->payload_len) !=
+				segs[i]->pkt_len - ETH_LEN - IPV6_LEN ||
+				frag_hdr->next_header != IPPROTO_UDP ||
+				frag_hdr->id != frag_id ||
+				RTE_IPV6_GET_FO(frag_data) !=
+				offset / RTE_IPV6_EHDR_FO_ALIGN ||
+				RTE_IPV6_GET_MF(frag_data) != (i < nb - 1)) {
+			printf("Wrong IPv6 fragment %d\n", i);
+			goto free_segs;
+		}
+
+		if (check_payload(segs[i], hdr_len, pkt,
+				ETH_LEN + IPV6_LEN + offset,
+				segs[i]->pkt_len - hdr_len) != TEST_SUCCESS)
+			goto free_segs;
+		offset += segs[i]->pkt_len - hdr_len;
+	}
+
+	if (offset != UDP_LEN + PAYLOAD_LEN) {
+		printf("%u bytes in the fragments, expected %u\n",
+			offset, (uint32_t)(UDP_LEN + PAYLOAD_LEN));
+		goto free_segs;
+	}
+	ret = TEST_SUCCESS;
+
+free_segs:
+	rte_pktmbuf_free_bulk(segs, nb);
+out:
+	rte_pktmbuf_free(pkt);
+	return ret;
+}
+
+/* IPv6 fragments are not segmented. */
+static int
+test_gso_tcp6_frag(void)
+{
+	struct pkt_desc d = {0, 1, 0};
+	struct rte_gso_ctx ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_TCP_TSO,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *pkt, *segs[MAX_SEGS];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	int nb;
+
+	pkt = build_pkt(&d);
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build the packet");
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			ETH_LEN);
+	ipv6_hdr->proto = IPPROTO_FRAGMENT;
+
+	nb = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	rte_pktmbuf_free(pkt);
+	TEST_ASSERT_EQUAL(nb, 0, "IPv6 fragment was segmented");
+
+	return TEST_SUCCESS;
+}
+
+static int
+testsuite_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("GSO_MBUF_POOL", NUM_MBUFS, 0, 0,
+			MBUF_DATA_SIZE, SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return TEST_FAILED;
+	}
+	return TEST_SUCCESS;
+}
+
+static void
+testsuite_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite gso_testsuite = {
+	.suite_name = "GSO Unit Test Suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_gso_tcp6),
+		TEST_CASE(test_gso_udp6),
+		TEST_CASE(test_gso_vxlan6_tcp4),
+		TEST_CASE(test_gso_vxlan6_tcp6),
+		TEST_CASE(test_gso_tcp6_frag),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gso(void)
+{
+	return unit_test_suite_runner(&gso_testsuite);
+}
+
+REGISTER_TEST_COMMAND(gso_autotest, test_gso);
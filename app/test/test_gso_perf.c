@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_gso.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+
+#include "test.h"
+
+#define NUM_MBUFS	4096
+#define MBUF_DATA_SIZE	(RTE_PKTMBUF_HEADROOM + 2048)
+/* The payload of a packet is in this number of full mbufs. */
+#define PAYLOAD_MBUFS	31
+#define PAYLOAD_LEN	(PAYLOAD_MBUFS * 2048)
+/* The segments fit in a standard Ethernet frame. */
+#define GSO_SIZE	(RTE_ETHER_MAX_LEN - RTE_ETHER_CRC_LEN)
+#define MAX_SEGS	64
+#define ITERATIONS	10000
+
+#define VXLAN_OUTER_LEN	(sizeof(struct rte_ether_hdr) + \
+			 sizeof(struct rte_ipv6_hdr) + \
+			 sizeof(struct rte_udp_hdr) + \
+			 sizeof(struct rte_vxlan_hdr))
+
+static const struct {
+	const char *name;
+	/* VxLAN encapsulated in an outer IPv6 header */
+	uint8_t vxlan;
+	uint8_t ipv6;
+	uint8_t udp;
+	uint32_t gso_types;
+} perf_types[] = {
+	{"TCP/IPv4", 0, 0, 0, RTE_ETH_TX_OFFLOAD_TCP_TSO},
+	{"TCP/IPv6", 0, 1, 0, RTE_ETH_TX_OFFLOAD_TCP_TSO},
+	{"UDP/IPv6", 0, 1, 1, RTE_ETH_TX_OFFLOAD_UDP_TSO},
+	{"VxLAN/IPv6 TCP/IPv6", 1, 1, 0, RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO},
+};
+
+/* Fill the L3 and L4 headers, return the L3 header length. */
+static uint16_t
+fill_inner_hdrs(uint8_t *p, uint32_t type, uint16_t l4_len)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint16_t l3_len;
+
+	if (perf_types[type].ipv6) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)p;
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(l4_len + PAYLOAD_LEN);
+		ipv6_hdr->proto = perf_types[type].udp ? IPPROTO_UDP :
+			IPPROTO_TCP;
+		ipv6_hdr->hop_limits = 64;
+		ipv6_hdr->src_addr[0] = 0xfd;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0xfd;
+		ipv6_hdr->dst_addr[15] = 2;
+		l3_len = sizeof(*ipv6_hdr);
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)p;
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+			l4_len + PAYLOAD_LEN);
+		ipv4_hdr->time_to_live = 64;
+		ipv4_hdr->next_proto_id = IPPROTO_TCP;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+		l3_len = sizeof(*ipv4_hdr);
+	}
+
+	if (perf_types[type].udp) {
+		udp_hdr = (struct rte_udp_hdr *)(p + l3_len);
+		udp_hdr->src_port = rte_cpu_to_be_16(1024);
+		udp_hdr->dst_port = rte_cpu_to_be_16(5000);
+		udp_hdr->dgram_len = rte_cpu_to_be_16(l4_len + PAYLOAD_LEN);
+	} else {
+		tcp_hdr = (struct rte_tcp_hdr *)(p + l3_len);
+		tcp_hdr->src_port = rte_cpu_to_be_16(1024);
+		tcp_hdr->dst_port = rte_cpu_to_be_16(80);
+		tcp_hdr->data_off = sizeof(*tcp_hdr) << 2;
+		tcp_hdr->tcp_flags = RTE_TCP_ACK_FLAG;
+	}
+
+	return l3_len;
+}
+
+/*
+ * Build a large packet of the type, the headers are in the first mbuf
+ * and the payload in PAYLOAD_MBUFS chained mbufs, as received from a
+ * virtio device with TSO.
+ */
+static struct rte_mbuf *
+build_pkt(struct rte_mempool *mp, uint32_t type)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_mbuf *m, *seg;
+	uint16_t l4_len, outer_len, inner_len;
+	uint32_t i;
+	uint8_t *p;
+
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		return NULL;
+
+	l4_len = perf_types[type].udp ? sizeof(struct rte_udp_hdr) :
+		sizeof(struct rte_tcp_hdr);
+	outer_len = perf_types[type].vxlan ? VXLAN_OUTER_LEN : 0;
+	inner_len = sizeof(*eth_hdr) + (perf_types[type].ipv6 ?
+		sizeof(struct rte_ipv6_hdr) : sizeof(struct rte_ipv4_hdr)) +
+		l4_len;
+	p = (uint8_t *)rte_pktmbuf_append(m, outer_len + inner_len);
+	if (p == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(p, 0, m->data_len);
+
+	if (perf_types[type].vxlan) {
+		eth_hdr = (struct rte_ether_hdr *)p;
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(outer_len + inner_len +
+			PAYLOAD_LEN - sizeof(*eth_hdr) - sizeof(*ipv6_hdr));
+		ipv6_hdr->proto = IPPROTO_UDP;
+		udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+		udp_hdr->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+		udp_hdr->dgram_len = ipv6_hdr->payload_len;
+		m->outer_l2_len = sizeof(*eth_hdr);
+		m->outer_l3_len = sizeof(*ipv6_hdr);
+		m->ol_flags = RTE_MBUF_F_TX_TUNNEL_VXLAN |
+			RTE_MBUF_F_TX_OUTER_IPV6;
+		m->l2_len = sizeof(*udp_hdr) + sizeof(struct rte_vxlan_hdr);
+		p += outer_len;
+	}
+
+	eth_hdr = (struct rte_ether_hdr *)p;
+	eth_hdr->ether_type = rte_cpu_to_be_16(perf_types[type].ipv6 ?
+		RTE_ETHER_TYPE_IPV6 : RTE_ETHER_TYPE_IPV4);
+	m->l2_len += sizeof(*eth_hdr);
+	m->l3_len = fill_inner_hdrs((uint8_t *)(eth_hdr + 1), type, l4_len);
+	m->l4_len = l4_len;
+	m->ol_flags |= (perf_types[type].udp ? RTE_MBUF_F_TX_UDP_SEG :
+		RTE_MBUF_F_TX_TCP_SEG) | (perf_types[type].ipv6 ?
+		RTE_MBUF_F_TX_IPV6 : RTE_MBUF_F_TX_IPV4);
+
+	for (i = 0; i < PAYLOAD_MBUFS; i++) {
+		seg = rte_pktmbuf_alloc(mp);
+		if (seg == NULL || rte_pktmbuf_append(seg, 2048) == NULL ||
+				rte_pktmbuf_chain(m, seg) != 0) {
+			rte_pktmbuf_free(seg);
+			rte_pktmbuf_free(m);
+			return NULL;
+		}
+	}
+
+	return m;
+}
+
+static int
+run_gso_perf(struct rte_mempool *mp, uint32_t type)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = mp,
+		.indirect_pool = mp,
+		.gso_types = perf_types[type].gso_types,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *pkt, *segs[MAX_SEGS];
+	uint64_t ol_flags, tsc, nb_segs = 0;
+	uint32_t i;
+	int nb;
+
+	pkt = build_pkt(mp, type);
+	if (pkt == NULL) {
+		printf("Cannot build %s packet\n", perf_types[type].name);
+		return -1;
+	}
+	ol_flags = pkt->ol_flags;
+
+	tsc = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		/* The GSO flag is cleared once the packet is segmented. */
+		pkt->ol_flags = ol_flags;
+		nb = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+		if (nb <= 1) {
+			printf("%s packet not segmented: %d\n",
+				perf_types[type].name, nb);
+			rte_pktmbuf_free(pkt);
+			return -1;
+		}
+		rte_pktmbuf_free_bulk(segs, nb);
+		nb_segs += nb;
+	}
+	tsc = rte_rdtsc_precise() - tsc;
+	rte_pktmbuf_free(pkt);
+
+	printf("%-20s %4"PRIu64" segments/pkt: %.1f cycles/segment, "
+		"%.2f Msegments/s per core\n",
+		perf_types[type].name, nb_segs / ITERATIONS,
+		(double)tsc / nb_segs,
+		(double)nb_segs * rte_get_tsc_hz() / tsc / 1e6);
+
+	return 0;
+}
+
+static int
+test_gso_perf(void)
+{
+	struct rte_mempool *mp;
+	uint32_t i;
+	int ret = 0;
+
+	mp = rte_pktmbuf_pool_create("GSO_PERF_POOL", NUM_MBUFS, 0, 0,
+		MBUF_DATA_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Cannot create mbuf pool, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	printf("Segmenting %u bytes of payload into %u bytes segments\n",
+		PAYLOAD_LEN, GSO_SIZE);
+	for (i = 0; i < RTE_DIM(perf_types) && ret == 0; i++)
+		ret = run_gso_perf(mp, i);
+
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gso_perf_autotest, test_gso_perf);
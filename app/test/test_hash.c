@@ -781,6 +781,94 @@ static int test_five_keys(void)
 	return 0;
 }
 
+/*
+ * Sequence of bulk operations for 5 keys
+ *	- add keys in bulk
+ *	- lookup keys: hit
+ *	- add keys in bulk (update)
+ *	- delete keys in bulk: hit
+ *	- delete keys in bulk: miss
+ *	- lookup keys: miss
+ */
+static int test_five_keys_bulk(void)
+{
+	struct rte_hash *handle;
+	const void *key_array[5] = {0};
+	void *data_array[5];
+	int32_t pos[5];
+	int32_t expected_pos[5];
+	void *data;
+	unsigned int i;
+	int ret;
+
+	ut_params.name = "test_bulk";
+	handle = rte_hash_create(&ut_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < 5; i++) {
+		key_array[i] = &keys[i];
+		data_array[i] = (void *)(uintptr_t)(i + 1);
+	}
+
+	/* Add */
+	ret = rte_hash_add_key_bulk(handle, key_array, data_array, 5, pos);
+	RETURN_IF_ERROR(ret != 5, "failed to add keys in bulk (ret=%d)", ret);
+	for (i = 0; i < 5; i++) {
+		print_key_info("Add", &keys[i], pos[i]);
+		RETURN_IF_ERROR(pos[i] < 0,
+				"failed to add key (pos[%u]=%d)", i, pos[i]);
+		expected_pos[i] = pos[i];
+	}
+
+	/* Lookup */
+	for (i = 0; i < 5; i++) {
+		ret = rte_hash_lookup_data(handle, &keys[i], &data);
+		RETURN_IF_ERROR(ret != expected_pos[i] ||
+				data != data_array[i],
+				"failed to find key (pos[%u]=%d)", i, ret);
+	}
+
+	/* Add - update */
+	ret = rte_hash_add_key_bulk(handle, key_array, NULL, 5, pos);
+	RETURN_IF_ERROR(ret != 5, "failed to update keys in bulk (ret=%d)",
+			ret);
+	for (i = 0; i < 5; i++)
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to add key (pos[%u]=%d)", i, pos[i]);
+	RETURN_IF_ERROR(rte_hash_count(handle) != 5,
+			"bulk update changed the number of keys");
+
+	/* Delete */
+	ret = rte_hash_del_key_bulk(handle, key_array, 5, pos);
+	RETURN_IF_ERROR(ret != 5, "failed to delete keys in bulk (ret=%d)",
+			ret);
+	for (i = 0; i < 5; i++) {
+		print_key_info("Del", &keys[i], pos[i]);
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to delete key (pos[%u]=%d)", i, pos[i]);
+	}
+
+	/* Delete - miss */
+	ret = rte_hash_del_key_bulk(handle, key_array, 5, pos);
+	RETURN_IF_ERROR(ret != 0, "deleted non-existent keys (ret=%d)", ret);
+	for (i = 0; i < 5; i++)
+		RETURN_IF_ERROR(pos[i] != -ENOENT,
+				"deleted non-existent key (pos[%u]=%d)", i,
+				pos[i]);
+
+	/* Lookup */
+	ret = rte_hash_lookup_bulk(handle, key_array, 5, pos);
+	if (ret == 0)
+		for (i = 0; i < 5; i++)
+			RETURN_IF_ERROR(pos[i] != -ENOENT,
+					"found non-existent key (pos[%u]=%d)",
+					i, pos[i]);
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /*
  * Add keys to the same bucket until bucket full.
  *	- add 5 keys to the same bucket (hash created with 4 keys per bucket):
@@ -1001,6 +1089,104 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Resizable table test: the bucket array grows while keys are added,
+ * shrinks while they are deleted and keys are found at every step.
+ */
+#define RESIZE_TEST_KEYS 4096
+static int test_resizable_table(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize",
+		.entries = RESIZE_TEST_KEYS * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE
+	};
+	struct rte_hash *handle;
+	static uint32_t resize_keys[RESIZE_TEST_KEYS];
+	static int expected_pos[RESIZE_TEST_KEYS];
+	const void *next_key;
+	void *next_data;
+	uint32_t i, iter;
+	int pos;
+
+	/* Resizable and extendable bucket tables are exclusive */
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle != NULL,
+			"resizable table with ext buckets should have failed");
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Grow while adding */
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		resize_keys[i] = i;
+		pos = rte_hash_add_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (pos=%d)",
+				i, pos);
+		expected_pos[i] = pos;
+	}
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		pos = rte_hash_lookup(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(pos != expected_pos[i],
+			"failed to find key %u (pos=%d)", i, pos);
+	}
+
+	i = 0;
+	iter = 0;
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0)
+		i++;
+	RETURN_IF_ERROR(i != RESIZE_TEST_KEYS,
+			"iterated over %u keys instead of %u", i,
+			RESIZE_TEST_KEYS);
+
+	/* Explicit resize, keys stay visible during the migration */
+	RETURN_IF_ERROR(rte_hash_resize(handle, 16) != -ENOSPC,
+			"resize below the number of keys should fail");
+	RETURN_IF_ERROR(rte_hash_resize(handle, RESIZE_TEST_KEYS * 2) != 0,
+			"failed to start resize");
+	while (rte_hash_resize_migrate(handle, 1) > 0) {
+		pos = rte_hash_lookup(handle, &resize_keys[0]);
+		RETURN_IF_ERROR(pos != expected_pos[0],
+			"failed to find key during resize (pos=%d)", pos);
+	}
+
+	/* Shrink while deleting */
+	for (i = 0; i < RESIZE_TEST_KEYS - 16; i++) {
+		pos = rte_hash_del_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(pos != expected_pos[i],
+			"failed to delete key %u (pos=%d)", i, pos);
+	}
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		pos = rte_hash_lookup(handle, &resize_keys[i]);
+		if (i < RESIZE_TEST_KEYS - 16)
+			RETURN_IF_ERROR(pos != -ENOENT,
+				"found deleted key %u (pos=%d)", i, pos);
+		else
+			RETURN_IF_ERROR(pos != expected_pos[i],
+				"failed to find key %u (pos=%d)", i, pos);
+	}
+
+	rte_hash_free(handle);
+
+	/* Resize is only supported by resizable tables */
+	params.extra_flag = 0;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	RETURN_IF_ERROR(rte_hash_resize(handle, 16) != -ENOTSUP,
+			"resize of a fixed size table should fail");
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -2215,10 +2401,14 @@ test_hash(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_five_keys_bulk() < 0)
+		return -1;
 	if (test_full_bucket() < 0)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_resizable_table() < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
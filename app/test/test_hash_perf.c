@@ -7,12 +7,14 @@
 
 #include <rte_lcore.h>
 #include <rte_cycles.h>
+#include <rte_launch.h>
 #include <rte_malloc.h>
 #include <rte_hash.h>
 #include <rte_hash_crc.h>
 #include <rte_jhash.h>
 #include <rte_fbk_hash.h>
 #include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_string_fns.h>
 
 #include "test.h"
@@ -34,6 +36,8 @@ enum operations {
 	OP_LOOKUP,
 	OP_LOOKUP_MULTI,
 	OP_DELETE,
+	OP_ADD_BULK,
+	OP_DELETE_BULK,
 	NUM_OPERATIONS
 };
 
@@ -559,6 +563,82 @@ timed_deletes(unsigned int with_hash, unsigned int with_data,
 	return 0;
 }
 
+/* Bulk adds hash the keys themselves, so they are only timed without
+ * pre-computed hash values.
+ */
+static int
+timed_adds_bulk(unsigned int with_data, unsigned int table_index,
+				unsigned int ext)
+{
+	unsigned int i, j, num_keys;
+	const uint64_t start_tsc = rte_rdtsc();
+	const void *keys_burst[BURST_SIZE];
+	void *data_burst[BURST_SIZE];
+	int32_t ret;
+	unsigned int keys_to_add;
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	for (i = 0; i < keys_to_add; i += num_keys) {
+		num_keys = RTE_MIN(keys_to_add - i, (unsigned int)BURST_SIZE);
+		for (j = 0; j < num_keys; j++) {
+			keys_burst[j] = keys[i + j];
+			data_burst[j] = (void *) ((uintptr_t) signatures[i + j]);
+		}
+		ret = rte_hash_add_key_bulk(h[table_index], keys_burst,
+					with_data ? data_burst : NULL,
+					num_keys, &positions[i]);
+		if (ret != (int32_t)num_keys) {
+			printf("Failed to add burst of keys from %u\n", i);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][OP_ADD_BULK][0][with_data] = time_taken/keys_to_add;
+
+	return 0;
+}
+
+static int
+timed_deletes_bulk(unsigned int with_data, unsigned int table_index,
+				unsigned int ext)
+{
+	unsigned int i, j, num_keys;
+	const uint64_t start_tsc = rte_rdtsc();
+	const void *keys_burst[BURST_SIZE];
+	int32_t ret;
+	unsigned int keys_to_add;
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	for (i = 0; i < keys_to_add; i += num_keys) {
+		num_keys = RTE_MIN(keys_to_add - i, (unsigned int)BURST_SIZE);
+		for (j = 0; j < num_keys; j++)
+			keys_burst[j] = keys[i + j];
+		ret = rte_hash_del_key_bulk(h[table_index], keys_burst,
+					num_keys, &positions[i]);
+		if (ret != (int32_t)num_keys) {
+			printf("Failed to delete burst of keys from %u\n", i);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][OP_DELETE_BULK][0][with_data] =
+		time_taken/keys_to_add;
+
+	return 0;
+}
+
 static void
 free_table(unsigned table_index)
 {
@@ -604,6 +684,15 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 				if (timed_deletes(with_hash, with_data, i, ext) < 0)
 					return -1;
 
+				if (!with_hash) {
+					if (timed_adds_bulk(with_data, i, ext) < 0)
+						return -1;
+
+					if (timed_deletes_bulk(with_data, i,
+							ext) < 0)
+						return -1;
+				}
+
 				/* Print a dot to show progress on operations */
 				printf(".");
 				fflush(stdout);
@@ -627,11 +716,15 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 			else
 				printf("\nWithout pre-computed hash values\n");
 
-			printf("\n%-18s%-18s%-18s%-18s%-18s\n",
+			printf("\n%-18s%-18s%-18s%-18s%-18s",
 			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+			if (!with_hash)
+				printf("%-18s%-18s", "Add_bulk", "Delete_bulk");
+			printf("\n");
 			for (i = 0; i < NUM_KEYSIZES; i++) {
 				printf("%-18d", hashtest_key_lens[i]);
-				for (j = 0; j < NUM_OPERATIONS; j++)
+				for (j = 0; j < (with_hash ? OP_ADD_BULK :
+						NUM_OPERATIONS); j++)
 					printf("%-18"PRIu64, cycles[i][j][with_hash][with_data]);
 				printf("\n");
 			}
@@ -640,6 +733,178 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 	return 0;
 }
 
+/* Control operation of performance testing of online resize. */
+#define RESIZE_KEYS (1 << 19)	/* Keys in the table while resizing. */
+#define RESIZE_MAX_ENTRIES (RESIZE_KEYS * 4) /* Room for a 2x resize. */
+#define RESIZE_STEADY_MS 200	/* Lookup time before resizing. */
+#define RESIZE_MIGRATE_BKTS 64	/* Buckets migrated per call. */
+
+enum resize_phase {
+	RESIZE_PHASE_STEADY = 0,
+	RESIZE_PHASE_MIGRATING,
+	RESIZE_PHASE_DONE,
+};
+
+static struct rte_hash *resize_h;
+static struct rte_rcu_qsbr *resize_qsv;
+static uint32_t resize_keys[RESIZE_KEYS];
+static volatile enum resize_phase resize_phase;
+static uint64_t resize_lookups[RTE_MAX_LCORE][RESIZE_PHASE_DONE];
+static uint64_t resize_cycles[RTE_MAX_LCORE][RESIZE_PHASE_DONE];
+static uint64_t resize_misses[RTE_MAX_LCORE];
+
+static int
+resize_perf_reader(__rte_unused void *arg)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	const void *key_ptrs[BURST_SIZE];
+	int32_t pos[BURST_SIZE];
+	enum resize_phase phase;
+	uint64_t begin;
+	unsigned int i;
+
+	(void)rte_rcu_qsbr_thread_register(resize_qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(resize_qsv, lcore_id);
+
+	while ((phase = resize_phase) != RESIZE_PHASE_DONE) {
+		for (i = 0; i < BURST_SIZE; i++)
+			key_ptrs[i] = &resize_keys[rte_rand_max(RESIZE_KEYS)];
+
+		begin = rte_rdtsc();
+		rte_hash_lookup_bulk(resize_h, key_ptrs, BURST_SIZE, pos);
+		resize_cycles[lcore_id][phase] += rte_rdtsc() - begin;
+		resize_lookups[lcore_id][phase] += BURST_SIZE;
+
+		/* All keys stay in the table during the resize */
+		for (i = 0; i < BURST_SIZE; i++)
+			if (pos[i] < 0)
+				resize_misses[lcore_id]++;
+
+		rte_rcu_qsbr_quiescent(resize_qsv, lcore_id);
+	}
+
+	rte_rcu_qsbr_thread_offline(resize_qsv, lcore_id);
+	(void)rte_rcu_qsbr_thread_unregister(resize_qsv, lcore_id);
+
+	return 0;
+}
+
+/*
+ * Measure lock free lookup throughput on the worker lcores while
+ * the main lcore doubles the bucket array of a resizable table.
+ */
+static int
+hash_resize_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "hash_resize_perf",
+		.entries = RESIZE_MAX_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+				RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	uint64_t lookups[RESIZE_PHASE_DONE] = {0};
+	uint64_t lookup_cycles[RESIZE_PHASE_DONE] = {0};
+	uint64_t misses = 0, begin, migrate_cycles;
+	unsigned int i, lcore_id, num_readers = 0;
+	int ret = -1;
+
+	printf("\n\n *** Hash online resize performance test ***\n");
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough lcores, skipping\n");
+		return 0;
+	}
+
+	memset(resize_lookups, 0, sizeof(resize_lookups));
+	memset(resize_cycles, 0, sizeof(resize_cycles));
+	memset(resize_misses, 0, sizeof(resize_misses));
+
+	resize_h = rte_hash_create(&params);
+	resize_qsv = rte_zmalloc(NULL,
+			rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+	if (resize_h == NULL || resize_qsv == NULL) {
+		printf("Resize test allocation failed\n");
+		goto end;
+	}
+	rte_rcu_qsbr_init(resize_qsv, RTE_MAX_LCORE);
+	rcu_cfg.v = resize_qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	if (rte_hash_rcu_qsbr_add(resize_h, &rcu_cfg) != 0) {
+		printf("Attach RCU QSBR to hash table failed\n");
+		goto end;
+	}
+
+	/* The bucket array grows while the keys are added */
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		resize_keys[i] = i;
+		if (rte_hash_add_key(resize_h, &resize_keys[i]) < 0) {
+			printf("Failed to add key number %u\n", i);
+			goto end;
+		}
+	}
+	while (rte_hash_resize_migrate(resize_h, UINT32_MAX) > 0)
+		;
+
+	resize_phase = RESIZE_PHASE_STEADY;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		rte_eal_remote_launch(resize_perf_reader, NULL, lcore_id);
+		num_readers++;
+	}
+
+	rte_delay_ms(RESIZE_STEADY_MS);
+
+	/* Half of the maximum is enough for the keys, so this is a 2x grow */
+	resize_phase = RESIZE_PHASE_MIGRATING;
+	begin = rte_rdtsc();
+	if (rte_hash_resize(resize_h, RESIZE_MAX_ENTRIES) != 0) {
+		printf("Failed to start resize\n");
+		resize_phase = RESIZE_PHASE_DONE;
+		rte_eal_mp_wait_lcore();
+		goto end;
+	}
+	while (rte_hash_resize_migrate(resize_h, RESIZE_MIGRATE_BKTS) > 0)
+		;
+	migrate_cycles = rte_rdtsc() - begin;
+	resize_phase = RESIZE_PHASE_DONE;
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		for (i = 0; i < RESIZE_PHASE_DONE; i++) {
+			lookups[i] += resize_lookups[lcore_id][i];
+			lookup_cycles[i] += resize_cycles[lcore_id][i];
+		}
+		misses += resize_misses[lcore_id];
+	}
+
+	if (misses != 0) {
+		printf("%"PRIu64" keys not found during resize\n", misses);
+		goto end;
+	}
+
+	printf("Readers: %u, keys: %u\n", num_readers, RESIZE_KEYS);
+	printf("Resize time = %"PRIu64" cycles\n", migrate_cycles);
+	printf("Cycles per lookup before resize = %"PRIu64"\n",
+		lookups[RESIZE_PHASE_STEADY] == 0 ? 0 :
+		lookup_cycles[RESIZE_PHASE_STEADY] /
+		lookups[RESIZE_PHASE_STEADY]);
+	printf("Cycles per lookup during resize = %"PRIu64"\n",
+		lookups[RESIZE_PHASE_MIGRATING] == 0 ? 0 :
+		lookup_cycles[RESIZE_PHASE_MIGRATING] /
+		lookups[RESIZE_PHASE_MIGRATING]);
+	ret = 0;
+end:
+	rte_hash_free(resize_h);
+	rte_free(resize_qsv);
+	resize_h = NULL;
+	resize_qsv = NULL;
+	return ret;
+}
+
 /* Control operation of performance testing of fbk hash. */
 #define LOAD_FACTOR 0.667	/* How full to make the hash table. */
 #define TEST_SIZE 1000000	/* How many operations to time. */
@@ -751,6 +1016,9 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (hash_resize_perf_test() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
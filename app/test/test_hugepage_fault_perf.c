@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+
+#include "test.h"
+
+#ifndef RTE_EXEC_ENV_LINUX
+
+static int
+test_hugepage_fault_perf(void)
+{
+	printf("hugepage_fault_perf not supported on this platform, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include "process.h"
+
+/*
+ * Hugepage faulting performance test, measures the startup time of
+ * a process allocating its memory with one or more threads faulting
+ * the hugepages (--huge-fault-threads).
+ */
+
+#define MEM_SIZE "1024"
+
+static const char * const fault_threads[] = { "1", "2", "4", "8" };
+
+#define launch_proc(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
+
+static int
+test_hugepage_fault_perf(void)
+{
+	const uint64_t hz = rte_get_timer_hz();
+	char threads_arg[32];
+	const char *argv[] = { prgname, "--file-prefix=hugefault",
+		"--in-memory", "--no-pci", "-m", MEM_SIZE, threads_arg };
+	uint64_t begin, ms;
+	unsigned int i;
+
+	printf("\n### Startup time with %sMB of hugepages ###\n", MEM_SIZE);
+
+	for (i = 0; i < RTE_DIM(fault_threads); i++) {
+		snprintf(threads_arg, sizeof(threads_arg),
+			"--huge-fault-threads=%s", fault_threads[i]);
+
+		begin = rte_get_timer_cycles();
+		if (launch_proc(argv) != 0) {
+			if (i == 0) {
+				printf("Cannot start a process with %sMB of hugepages, skipping test\n",
+					MEM_SIZE);
+				return TEST_SKIPPED;
+			}
+			printf("Error - process failed with %s\n", threads_arg);
+			return -1;
+		}
+		ms = (rte_get_timer_cycles() - begin) * 1000 / hz;
+
+		printf("%s fault threads: %"PRIu64" ms\n", fault_threads[i], ms);
+	}
+
+	return 0;
+}
+
+#endif /* !RTE_EXEC_ENV_LINUX */
+
+REGISTER_TEST_COMMAND(hugepage_fault_perf_autotest, test_hugepage_fault_perf);
@@ -488,6 +488,110 @@ test_ip_frag(void)
 	return result;
 }
 
+/*
+ * Fragment a few packets, then reassemble their fragments interleaved
+ * in one burst with the bulk API.
+ */
+static int
+test_ip_frag_reassemble_bulk_ipv(int ipv)
+{
+#define REASS_PKTS	4
+#define REASS_FRAGS	2
+	static const size_t pkt_size = 2000, mtu_size = 1280;
+	struct rte_mbuf *frags[REASS_PKTS][REASS_FRAGS];
+	struct rte_mbuf *burst[REASS_PKTS * REASS_FRAGS];
+	struct rte_ip_frag_death_row dr = {0};
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ip_frag_tbl_stats stats;
+	struct rte_ip_frag_tbl *tbl;
+	struct rte_mbuf *b;
+	uint32_t i, j, n, hdr_len;
+	int32_t len;
+	uint16_t nb;
+
+	tbl = rte_ip_frag_table_create(REASS_PKTS, 4, REASS_PKTS,
+		rte_get_tsc_hz(), SOCKET_ID_ANY);
+	RTE_TEST_ASSERT_NOT_NULL(tbl, "Failed to create table.");
+
+	hdr_len = ipv == 4 ? sizeof(struct rte_ipv4_hdr) :
+		sizeof(struct rte_ipv6_hdr);
+	n = 0;
+	for (i = 0; i < REASS_PKTS; i++) {
+		b = rte_pktmbuf_alloc(pkt_pool);
+		RTE_TEST_ASSERT_NOT_NULL(b, "Failed to allocate pkt.");
+
+		if (ipv == 4) {
+			v4_allocate_packet_of(b, 0x41414141, pkt_size, 0, 0, 0,
+				64, IPPROTO_ICMP, i + 1, false, false, false);
+			len = rte_ipv4_fragment_packet(b, frags[i], REASS_FRAGS,
+				mtu_size, direct_pool, indirect_pool);
+		} else {
+			v6_allocate_packet_of(b, 0x41414141, pkt_size, 64,
+				IPPROTO_ICMP, i + 1);
+			len = rte_ipv6_fragment_packet(b, frags[i], REASS_FRAGS,
+				mtu_size, direct_pool, indirect_pool);
+		}
+		rte_pktmbuf_free(b);
+		RTE_TEST_ASSERT_EQUAL(len, REASS_FRAGS,
+			"Failed to fragment IPv%d packet %u: %d.", ipv, i, len);
+
+		for (j = 0; j < REASS_FRAGS; j++) {
+			frags[i][j]->l2_len = 0;
+			frags[i][j]->l3_len = hdr_len;
+			if (ipv == 4)
+				continue;
+			/* the IPv6 fragments of all packets have id 0 */
+			frag_hdr = rte_pktmbuf_mtod_offset(frags[i][j],
+				struct rte_ipv6_fragment_ext *, hdr_len);
+			frag_hdr->id = rte_cpu_to_be_32(i + 1);
+			frags[i][j]->l3_len += sizeof(*frag_hdr);
+		}
+	}
+
+	/* last fragments first, the packets are interleaved */
+	for (j = REASS_FRAGS; j-- != 0; )
+		for (i = 0; i < REASS_PKTS; i++)
+			burst[n++] = frags[i][j];
+
+	if (ipv == 4)
+		nb = rte_ipv4_frag_reassemble_bulk(tbl, &dr, burst, n,
+			rte_rdtsc(), burst);
+	else
+		nb = rte_ipv6_frag_reassemble_bulk(tbl, &dr, burst, n,
+			rte_rdtsc(), burst);
+
+	for (i = 0; i < nb; i++)
+		if (burst[i]->pkt_len != hdr_len + pkt_size)
+			break;
+	test_free_fragments(burst, nb);
+	rte_ip_frag_free_death_row(&dr, 0);
+	rte_ip_frag_table_stats_get(tbl, &stats);
+	rte_ip_frag_table_destroy(tbl);
+
+	RTE_TEST_ASSERT_EQUAL(nb, REASS_PKTS,
+		"IPv%d bulk reassembly returned %u packets.", ipv, nb);
+	RTE_TEST_ASSERT_EQUAL(i, nb,
+		"IPv%d bulk reassembly packet %u has a wrong length.", ipv, i);
+	RTE_TEST_ASSERT_EQUAL(stats.use_entries, 0,
+		"IPv%d bulk reassembly left %u entries.", ipv,
+		stats.use_entries);
+	RTE_TEST_ASSERT_EQUAL(stats.max_entries, REASS_PKTS,
+		"Wrong table max entries %u.", stats.max_entries);
+
+	return TEST_SUCCESS;
+#undef REASS_PKTS
+#undef REASS_FRAGS
+}
+
+static int
+test_ip_frag_reassemble_bulk(void)
+{
+	if (test_ip_frag_reassemble_bulk_ipv(4) != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	return test_ip_frag_reassemble_bulk_ipv(6);
+}
+
 static struct unit_test_suite ipfrag_testsuite  = {
 	.suite_name = "IP Frag Unit Test Suite",
 	.setup = testsuite_setup,
@@ -495,6 +599,8 @@ static struct unit_test_suite ipfrag_testsuite  = {
 	.unit_test_cases = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			     test_ip_frag),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			     test_ip_frag_reassemble_bulk),
 
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
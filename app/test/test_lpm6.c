@@ -52,6 +52,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -84,6 +85,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define MAX_DEPTH                                                    128
@@ -1771,6 +1773,75 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Check that every supported bulk lookup method gives the expected next hops
+ * for the large route table, with burst sizes that are not multiples
+ * of the vector width.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint32_t i, j, n;
+	int32_t status = 0;
+
+	static uint8_t ips[NUM_IPS_ENTRIES][RTE_LPM6_IPV6_ADDR_SIZE];
+	static int32_t next_hops[NUM_IPS_ENTRIES];
+	static const enum rte_lpm6_lookup_type types[] = {
+		RTE_LPM6_LOOKUP_SCALAR,
+		RTE_LPM6_LOOKUP_VECTOR_AVX2,
+		RTE_LPM6_LOOKUP_VECTOR_AVX512,
+	};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* leave the last rule out to get some lookup misses */
+	for (i = 0; i != NUM_ROUTE_ENTRIES - 1; i++) {
+		status = rte_lpm6_add(lpm, large_route_table[i].ip,
+			large_route_table[i].depth,
+			large_route_table[i].next_hop);
+		TEST_LPM_ASSERT(status == 0);
+	}
+
+	generate_large_ips_table(0);
+	for (i = 0; i != NUM_IPS_ENTRIES; i++)
+		memcpy(ips[i], large_ips_table[i].ip, RTE_LPM6_IPV6_ADDR_SIZE);
+
+	for (i = 0; i != RTE_DIM(types); i++) {
+		if (rte_lpm6_select_lookup(lpm, types[i]) != 0) {
+			printf("lookup type %d is not supported\n", types[i]);
+			continue;
+		}
+
+		memset(next_hops, 0, sizeof(next_hops));
+		for (j = 0; j < NUM_IPS_ENTRIES; j += n) {
+			n = RTE_MIN(NUM_IPS_ENTRIES - j, 1 + j % 67);
+			status = rte_lpm6_lookup_bulk_func(lpm, ips + j,
+				next_hops + j, n);
+			TEST_LPM_ASSERT(status == 0);
+		}
+
+		for (j = 0; j != NUM_IPS_ENTRIES; j++) {
+			uint32_t next_hop;
+
+			status = rte_lpm6_lookup(lpm, ips[j], &next_hop);
+			TEST_LPM_ASSERT((status == 0 &&
+					next_hops[j] == (int32_t)next_hop) ||
+				(status == -ENOENT && next_hops[j] == -1));
+		}
+	}
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -27,6 +27,15 @@
 #define BATCH_SIZE 100000
 #define NUMBER_TBL8S                                           (1 << 16)
 
+static const struct {
+	enum rte_lpm6_lookup_type type;
+	const char *name;
+} lookup_types[] = {
+	{ RTE_LPM6_LOOKUP_SCALAR, "scalar" },
+	{ RTE_LPM6_LOOKUP_VECTOR_AVX2, "avx2" },
+	{ RTE_LPM6_LOOKUP_VECTOR_AVX512, "avx512" },
+};
+
 static void
 print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
 {
@@ -57,7 +66,7 @@ test_lpm6_perf(void)
 	struct rte_lpm6 *lpm = NULL;
 	struct rte_lpm6_config config;
 	uint64_t begin, total_time;
-	unsigned i, j;
+	unsigned i, j, k;
 	uint32_t next_hop_add = 0xAA, next_hop_return = 0;
 	int status = 0;
 	int64_t count = 0;
@@ -115,30 +124,43 @@ test_lpm6_perf(void)
 			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
 			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 
-	/* Measure bulk Lookup */
-	total_time = 0;
-	count = 0;
-
+	/* Measure bulk Lookup with every supported method */
 	uint8_t ip_batch[NUM_IPS_ENTRIES][16];
 	int32_t next_hops[NUM_IPS_ENTRIES];
 
 	for (i = 0; i < NUM_IPS_ENTRIES; i++)
 		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
 
-	for (i = 0; i < ITERATIONS; i ++) {
+	for (k = 0; k < RTE_DIM(lookup_types); k++) {
 
-		/* Lookup per batch */
-		begin = rte_rdtsc();
-		rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops, NUM_IPS_ENTRIES);
-		total_time += rte_rdtsc() - begin;
+		if (rte_lpm6_select_lookup(lpm, lookup_types[k].type) != 0) {
+			printf("BULK LPM Lookup (%s): not supported\n",
+				lookup_types[k].name);
+			continue;
+		}
 
-		for (j = 0; j < NUM_IPS_ENTRIES; j++)
-			if (next_hops[j] < 0)
-				count++;
-	}
-	printf("BULK LPM Lookup: %.1f cycles (fails = %.1f%%)\n",
+		total_time = 0;
+		count = 0;
+
+		for (i = 0; i < ITERATIONS; i ++) {
+
+			/* Lookup per batch */
+			begin = rte_rdtsc();
+			rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops,
+				NUM_IPS_ENTRIES);
+			total_time += rte_rdtsc() - begin;
+
+			for (j = 0; j < NUM_IPS_ENTRIES; j++)
+				if (next_hops[j] < 0)
+					count++;
+		}
+		printf("BULK LPM Lookup (%s): %.1f cycles (fails = %.1f%%)\n",
+			lookup_types[k].name,
 			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
 			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
+	}
+
+	rte_lpm6_select_lookup(lpm, RTE_LPM6_LOOKUP_DEFAULT);
 
 	/* Delete */
 	status = 0;
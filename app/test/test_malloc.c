@@ -827,6 +827,45 @@ test_zero_aligned_alloc(void)
 	return -1;
 }
 
+/*
+ * Memory freed with data in it must be cleared when allocated again with
+ * rte_zmalloc(), including when it is served from the per-lcore cache.
+ */
+static int
+test_zmalloc_reuse(void)
+{
+	static const size_t sizes[] = { 64, 200, 1024, 4096 };
+	unsigned int i, j;
+	char *p;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(sizes); i++) {
+		p = rte_malloc(NULL, sizes[i], 0);
+		if (p == NULL)
+			return -1;
+		memset(p, 0xa5, sizes[i]);
+		rte_free(p);
+
+		p = rte_zmalloc(NULL, sizes[i], 0);
+		if (p == NULL)
+			return -1;
+		for (j = 0; j < sizes[i]; j++) {
+			if (p[j] != 0) {
+				printf("%zu bytes not cleared at offset %u\n",
+					sizes[i], j);
+				rte_free(p);
+				return -1;
+			}
+		}
+		rte_free(p);
+	}
+
+	ret = rte_malloc_lcore_cache_flush();
+	if (ret != 0 && ret != -ENOTSUP)
+		return -1;
+	return 0;
+}
+
 static int
 test_malloc_bad_params(void)
 {
@@ -1007,6 +1046,13 @@ test_malloc(void)
 	}
 	else printf("test_zero_aligned_alloc() passed\n");
 
+	if (test_zmalloc_reuse() < 0) {
+		printf("test_zmalloc_reuse() failed\n");
+		return -1;
+	}
+	else
+		printf("test_zmalloc_reuse() passed\n");
+
 	if (test_malloc_bad_params() < 0){
 		printf("test_malloc_bad_params() failed\n");
 		return -1;
@@ -6,6 +6,8 @@
 #include <string.h>
 #include <rte_cycles.h>
 #include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_memzone.h>
 
@@ -147,6 +149,93 @@ memzone_free(void *addr)
 	rte_memzone_free((struct rte_memzone *)addr);
 }
 
+#define SCALE_TIME_MS 100
+#define SCALE_BURST 16
+
+static uint32_t scale_start;
+static uint64_t scale_ops[RTE_MAX_LCORE];
+
+/* allocate and free bursts of small objects for SCALE_TIME_MS */
+static int
+alloc_scale_loop(void *arg __rte_unused)
+{
+	static const size_t SIZES[] = { 64, 256, 1024 };
+	const uint64_t hz = rte_get_timer_hz();
+	void *ptrs[SCALE_BURST];
+	uint64_t end, ops = 0;
+	unsigned int i;
+
+	rte_wait_until_equal_32(&scale_start, 1, __ATOMIC_ACQUIRE);
+
+	end = rte_get_timer_cycles() + hz * SCALE_TIME_MS / 1000;
+	while (rte_get_timer_cycles() < end) {
+		for (i = 0; i < SCALE_BURST; i++) {
+			ptrs[i] = rte_malloc(NULL, SIZES[i % RTE_DIM(SIZES)], 0);
+			if (ptrs[i] == NULL)
+				break;
+		}
+		ops += i;
+		while (i-- > 0)
+			rte_free(ptrs[i]);
+	}
+	scale_ops[rte_lcore_id()] = ops;
+
+	/* give the cached objects back before the next run */
+	rte_malloc_lcore_cache_flush();
+	return 0;
+}
+
+static int
+test_alloc_scaling(void)
+{
+	unsigned int counts[] = { 1, 2, rte_lcore_count() };
+	unsigned int i, n, lcore_id;
+	uint64_t total;
+	int ret = 0;
+
+	TEST_LOG(INFO, "Scaling: rte_malloc/rte_free of small objects (per-lcore cache %s)\n",
+			rte_malloc_lcore_cache_flush() == -ENOTSUP ?
+			"disabled" : "enabled");
+	TEST_LOG(INFO, "%8s%20s%20s\n", "Lcores", "Total (Mops/s)",
+			"Per lcore (Mops/s)");
+
+	for (i = 0; i < RTE_DIM(counts); i++) {
+		if (counts[i] > rte_lcore_count() ||
+				(i > 0 && counts[i] <= counts[i - 1]))
+			continue;
+
+		memset(scale_ops, 0, sizeof(scale_ops));
+		__atomic_store_n(&scale_start, 0, __ATOMIC_RELAXED);
+
+		n = 1;
+		RTE_LCORE_FOREACH_WORKER(lcore_id) {
+			if (n == counts[i])
+				break;
+			if (rte_eal_remote_launch(alloc_scale_loop, NULL,
+					lcore_id) < 0)
+				break;
+			n++;
+		}
+
+		__atomic_store_n(&scale_start, 1, __ATOMIC_RELEASE);
+		alloc_scale_loop(NULL);
+		rte_eal_mp_wait_lcore();
+
+		total = 0;
+		RTE_LCORE_FOREACH(lcore_id)
+			total += scale_ops[lcore_id];
+		if (total == 0)
+			ret = -1;
+
+		TEST_LOG(INFO, "%8u%20.2f%20.2f\n", n,
+				(double)total * 1000 / SCALE_TIME_MS / 1E6,
+				(double)total * 1000 / SCALE_TIME_MS / 1E6 / n);
+	}
+
+	TEST_LOG(INFO, "\n");
+	return ret;
+}
+
 static int
 test_malloc_perf(void)
 {
@@ -168,6 +257,9 @@ test_malloc_perf(void)
 			NULL, memset_us_gb, RTE_MAX_MEMZONE - 1) < 0)
 		return -1;
 
+	if (test_alloc_scaling() < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -951,6 +951,121 @@ test_member_sketch(void)
 	return 0;
 }
 
+/* expected count of the sliding window test keys */
+static int
+check_window_count(const void *key, uint64_t expected)
+{
+	uint64_t count;
+
+	rte_member_query_count(setsum_sketch, key, &count);
+	if (count != expected) {
+		printf("sliding window count %"PRIu64", expected %"PRIu64"\n",
+			count, expected);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_member_sketch_window(void)
+{
+	struct rte_member_parameters window_params = {
+		.name = "test_member_sketch_window",
+		.type = RTE_MEMBER_TYPE_SKETCH,
+		.key_len = sizeof(uint32_t),
+		.prim_hash_seed = 1,
+		.sec_hash_seed = 11,
+		.error_rate = SKETCH_ERROR_RATE,
+		.sample_rate = 1,
+		.top_k = TOP_K,
+		.extra_flag = RTE_MEMBER_SKETCH_COUNT_BYTE |
+			RTE_MEMBER_SKETCH_SLIDING_WINDOW,
+		.socket_id = 0,
+		.num_windows = 1,
+	};
+	uint64_t count[TOP_K];
+	uint32_t key_a = 1, key_b = 2;
+	unsigned int i;
+	int ret = -1;
+
+	printf("\n[Sketch with Sliding Window Mode]\n");
+
+	setsum_sketch = rte_member_create(&window_params);
+	if (setsum_sketch != NULL) {
+		printf("Sliding window sketch created with 1 window\n");
+		goto exit;
+	}
+	window_params.num_windows = RTE_MEMBER_SKETCH_WINDOWS_MAX + 1;
+	setsum_sketch = rte_member_create(&window_params);
+	if (setsum_sketch != NULL) {
+		printf("Sliding window sketch created with too many windows\n");
+		goto exit;
+	}
+
+	window_params.num_windows = 4;
+	setsum_sketch = rte_member_create(&window_params);
+	if (setsum_sketch == NULL) {
+		printf("Creation of sliding window sketch fail\n");
+		return -1;
+	}
+
+	/* key a is counted in window 0, key b in window 1 */
+	for (i = 0; i < 10; i++)
+		rte_member_add_byte_count(setsum_sketch, &key_a, HH_PKT_SIZE);
+	rte_member_advance_window(setsum_sketch);
+	for (i = 0; i < 5; i++)
+		rte_member_add_byte_count(setsum_sketch, &key_b, HH_PKT_SIZE);
+	rte_member_add_byte_count(setsum_sketch, &key_a, HH_PKT_SIZE);
+
+	if (check_window_count(&key_a, 11 * HH_PKT_SIZE) < 0 ||
+			check_window_count(&key_b, 5 * HH_PKT_SIZE) < 0)
+		goto exit;
+
+	/* window 0 slides out of the sketch */
+	for (i = 0; i < 3; i++)
+		rte_member_advance_window(setsum_sketch);
+	if (check_window_count(&key_a, HH_PKT_SIZE) < 0 ||
+			check_window_count(&key_b, 5 * HH_PKT_SIZE) < 0)
+		goto exit;
+
+	if (rte_member_report_heavyhitter(setsum_sketch, heavy_hitters,
+			count) != 2) {
+		printf("Sliding window sketch heavy hitter report error\n");
+		goto exit;
+	}
+
+	/* window 1 slides out, nothing is left */
+	rte_member_advance_window(setsum_sketch);
+	if (check_window_count(&key_a, 0) < 0 ||
+			check_window_count(&key_b, 0) < 0)
+		goto exit;
+
+	if (rte_member_report_heavyhitter(setsum_sketch, heavy_hitters,
+			count) != 0) {
+		printf("Expired keys reported as heavy hitters\n");
+		goto exit;
+	}
+
+	/* counting goes on in the new windows */
+	rte_member_add_byte_count(setsum_sketch, &key_a, HH_PKT_SIZE);
+	if (check_window_count(&key_a, HH_PKT_SIZE) < 0)
+		goto exit;
+
+	if (rte_member_advance_window(NULL) != -EINVAL ||
+			rte_member_advance_window(setsum_ht) != -EINVAL) {
+		printf("Window advanced on an invalid set-summary\n");
+		goto exit;
+	}
+
+	printf("Sliding window sketch test passed\n");
+	ret = 0;
+exit:
+	rte_member_free(setsum_sketch);
+	setsum_sketch = NULL;
+	return ret;
+}
+
 static int
 test_member(void)
 {
@@ -990,6 +1105,11 @@ test_member(void)
 		perform_free();
 		return -1;
 	}
+
+	if (test_member_sketch_window() < 0) {
+		perform_free();
+		return -1;
+	}
 	perform_free();
 	return 0;
 }
@@ -44,6 +44,15 @@ test_member_perf(void)
 #define SKETCH_ERROR_RATE 0.05
 #define SKETCH_SAMPLE_RATE 0.001
 #define NUM_ADDS (KEYS_TO_ADD * 20)
+/* sliding window sketch accuracy test */
+#define SKETCH_NUM_WINDOWS 4
+#define WINDOW_FLOWS 1024
+#define WINDOW_ROUNDS (SKETCH_NUM_WINDOWS * 3)
+#define WINDOW_LARGEST_FLOW 4096
+/* The flow ranks shift every window, so that elephants come and go. */
+#define WINDOW_RANK_SHIFT 61
+#define WINDOW_TOP_FLOWS 10
+#define WINDOW_ERROR_RATE 0.001
 
 static unsigned int test_socket_id;
 
@@ -54,6 +63,7 @@ enum sstype {
 	SKETCH,
 	SKETCH_BOUNDED,
 	SKETCH_BYTE,
+	SKETCH_WINDOW,
 	NUM_TYPE
 };
 
@@ -278,6 +288,20 @@ setup_keys_and_data(struct member_perf_params *params, unsigned int cycle,
 	if (params->setsum[SKETCH_BYTE] == NULL)
 		fprintf(stderr, "sketch create fail\n");
 
+	member_params.name = "test_member_sketch_window";
+	member_params.key_len = params->key_size;
+	member_params.type = RTE_MEMBER_TYPE_SKETCH;
+	member_params.error_rate = SKETCH_ERROR_RATE;
+	member_params.sample_rate = SKETCH_SAMPLE_RATE;
+	member_params.extra_flag = RTE_MEMBER_SKETCH_COUNT_BYTE |
+		RTE_MEMBER_SKETCH_SLIDING_WINDOW;
+	member_params.num_windows = SKETCH_NUM_WINDOWS;
+	member_params.top_k = TOP_K;
+	member_params.prim_hash_seed = rte_rdtsc();
+	params->setsum[SKETCH_WINDOW] = rte_member_create(&member_params);
+	if (params->setsum[SKETCH_WINDOW] == NULL)
+		fprintf(stderr, "sketch create fail\n");
+
 
 	for (i = 0; i < NUM_TYPE; i++) {
 		if (params->setsum[i] == NULL)
@@ -322,8 +346,11 @@ timed_adds_sketch(struct member_perf_params *params, int type)
 	int32_t ret;
 
 	for (i = 0; i < NUM_ADDS / KEYS_TO_ADD; i++) {
+		/* the window of the sketch advances every KEYS_TO_ADD adds */
+		if (type == SKETCH_WINDOW && i != 0)
+			rte_member_advance_window(params->setsum[type]);
 		for (j = 0; j < KEYS_TO_ADD; j++) {
-			if (type == SKETCH_BYTE)
+			if (type == SKETCH_BYTE || type == SKETCH_WINDOW)
 				ret = rte_member_add_byte_count(params->setsum[type],
 						&hh_keys[j], SKETCH_PKT_SIZE);
 			else
@@ -639,6 +666,124 @@ perform_frees(struct member_perf_params *params)
 	}
 }
 
+/* bytes of a flow in a window of the sliding window accuracy test */
+static uint32_t
+window_flow_bytes(uint32_t flow, uint32_t round)
+{
+	uint32_t rank = (flow + round * WINDOW_RANK_SHIFT) % WINDOW_FLOWS;
+
+	return (WINDOW_LARGEST_FLOW / (rank + 1) + 1) * SKETCH_PKT_SIZE;
+}
+
+/*
+ * Feed flows whose sizes change every window to a sliding window sketch and
+ * to a sketch counting forever, and compare their estimates of the largest
+ * flows of the last SKETCH_NUM_WINDOWS windows with the exact counts.
+ */
+static int
+sketch_window_accuracy(void)
+{
+	struct rte_member_setsum *setsum[2];
+	static const char * const names[] = {"sketch_byte", "sketch_window"};
+	uint64_t exact[WINDOW_FLOWS] = {0};
+	uint32_t top[WINDOW_TOP_FLOWS] = {0};
+	uint64_t hh_counts[TOP_K];
+	void *hh[TOP_K];
+	uint64_t advance_tsc = 0, tsc;
+	double error[2] = {0};
+	uint32_t hits[2] = {0};
+	uint32_t flow, round, pkt, i, j, k;
+	uint64_t count;
+	int nb_hh;
+
+	member_params.name = "test_member_window_forever";
+	member_params.key_len = sizeof(flow);
+	member_params.type = RTE_MEMBER_TYPE_SKETCH;
+	member_params.error_rate = WINDOW_ERROR_RATE;
+	member_params.sample_rate = SKETCH_SAMPLE_RATE;
+	member_params.extra_flag = RTE_MEMBER_SKETCH_COUNT_BYTE;
+	member_params.top_k = TOP_K;
+	member_params.prim_hash_seed = rte_rdtsc();
+	setsum[0] = rte_member_create(&member_params);
+
+	member_params.name = "test_member_window_sliding";
+	member_params.extra_flag |= RTE_MEMBER_SKETCH_SLIDING_WINDOW;
+	member_params.num_windows = SKETCH_NUM_WINDOWS;
+	setsum[1] = rte_member_create(&member_params);
+	if (setsum[0] == NULL || setsum[1] == NULL) {
+		printf("sliding window sketch create fail\n");
+		rte_member_free(setsum[0]);
+		rte_member_free(setsum[1]);
+		return -1;
+	}
+
+	/* interleave the packets of the flows within each window */
+	for (round = 0; round < WINDOW_ROUNDS; round++) {
+		if (round != 0) {
+			tsc = rte_rdtsc_precise();
+			rte_member_advance_window(setsum[1]);
+			advance_tsc += rte_rdtsc_precise() - tsc;
+		}
+		for (pkt = 0; pkt < WINDOW_LARGEST_FLOW + 1; pkt++) {
+			for (flow = 0; flow < WINDOW_FLOWS; flow++) {
+				if (pkt * SKETCH_PKT_SIZE >=
+						window_flow_bytes(flow, round))
+					continue;
+				rte_member_add_byte_count(setsum[0], &flow,
+					SKETCH_PKT_SIZE);
+				rte_member_add_byte_count(setsum[1], &flow,
+					SKETCH_PKT_SIZE);
+			}
+		}
+	}
+
+	/* exact counts of the last windows, and their largest flows */
+	for (flow = 0; flow < WINDOW_FLOWS; flow++) {
+		for (round = WINDOW_ROUNDS - SKETCH_NUM_WINDOWS;
+				round < WINDOW_ROUNDS; round++)
+			exact[flow] += window_flow_bytes(flow, round);
+
+		/* insertion into the sorted top flows */
+		for (i = RTE_MIN(flow, (uint32_t)WINDOW_TOP_FLOWS); i > 0; i--) {
+			if (exact[top[i - 1]] >= exact[flow])
+				break;
+			if (i < WINDOW_TOP_FLOWS)
+				top[i] = top[i - 1];
+		}
+		if (i < WINDOW_TOP_FLOWS)
+			top[i] = flow;
+	}
+
+	for (k = 0; k < RTE_DIM(setsum); k++) {
+		for (i = 0; i < WINDOW_TOP_FLOWS; i++) {
+			rte_member_query_count(setsum[k], &top[i], &count);
+			error[k] += fabs((double)count - exact[top[i]]) /
+				exact[top[i]];
+		}
+
+		/* how many of the reported heavy hitters are the largest flows */
+		nb_hh = rte_member_report_heavyhitter(setsum[k], hh, hh_counts);
+		for (i = 0; i < RTE_MIN(nb_hh, WINDOW_TOP_FLOWS); i++)
+			for (j = 0; j < WINDOW_TOP_FLOWS; j++)
+				if (*(uint32_t *)hh[i] == top[j])
+					hits[k]++;
+	}
+
+	printf("\nSliding window accuracy over the last %u of %u windows\n",
+		SKETCH_NUM_WINDOWS, WINDOW_ROUNDS);
+	printf("-----------------------------------\n");
+	for (k = 0; k < RTE_DIM(setsum); k++)
+		printf("%-18s top %u flows: mean relative error %f, "
+			"%u reported as top heavy hitters\n", names[k],
+			WINDOW_TOP_FLOWS, error[k] / WINDOW_TOP_FLOWS, hits[k]);
+	printf("Window advance: %"PRIu64" cycles\n",
+		advance_tsc / (WINDOW_ROUNDS - 1));
+
+	rte_member_free(setsum[0]);
+	rte_member_free(setsum[1]);
+	return 0;
+}
+
 static int
 exit_with_fail(const char *testname, struct member_perf_params *params,
 		unsigned int i, unsigned int j)
@@ -727,6 +872,9 @@ run_all_tbl_perf_tests(void)
 		perform_frees(&params);
 	}
 
+	if (sketch_window_accuracy() < 0)
+		return -1;
+
 	printf("\nResults (in CPU cycles/operation)\n");
 	printf("-----------------------------------\n");
 	printf("\n%-18s%-18s%-18s%-18s%-18s%-18s%-18s%-18s%-18s\n",
@@ -225,6 +225,92 @@ static int test_mempool_creation_with_invalid_flags(void)
 	return 0;
 }
 
+/* get and put back the objects of a pool by bulk of n */
+static int
+test_mempool_adaptive_cycle(struct rte_mempool *mp, void **objs,
+	unsigned int count, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i += n) {
+		if (rte_mempool_get_bulk(mp, &objs[i], n) < 0)
+			RET_ERR();
+	}
+	for (i = 0; i < count; i += n)
+		rte_mempool_put_bulk(mp, &objs[i], n);
+
+	return 0;
+}
+
+static int
+test_mempool_adaptive_cache(void)
+{
+	const unsigned int pool_size = 4 * RTE_MEMPOOL_CACHE_MAX_SIZE;
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	unsigned int i, size;
+	void **objs;
+	int ret = 0;
+
+	objs = rte_calloc("test_adaptive", pool_size, sizeof(void *), 0);
+	if (objs == NULL)
+		RET_ERR();
+
+	mp = rte_mempool_create("test_adaptive", pool_size, MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0, NULL, NULL, my_obj_init, NULL,
+		SOCKET_ID_ANY,
+		RTE_MEMPOOL_F_ADAPTIVE_CACHE | RTE_MEMPOOL_F_SOCKET_CACHE);
+	if (mp == NULL)
+		GOTO_ERR(ret, out);
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL || cache->size != RTE_MEMPOOL_CACHE_MAX_SIZE)
+		GOTO_ERR(ret, out);
+
+	/* single object requests shrink the cache to its minimum */
+	for (i = 0; i < 32; i++) {
+		if (test_mempool_adaptive_cycle(mp, objs, pool_size / 2, 1) < 0)
+			GOTO_ERR(ret, out);
+	}
+	size = cache->size;
+	printf("adaptive cache size with bulk of 1: %u\n", size);
+	if (size != RTE_MIN(RTE_MEMPOOL_CACHE_ADAPT_MIN,
+			RTE_MEMPOOL_CACHE_MAX_SIZE))
+		GOTO_ERR(ret, out);
+	if (cache->flushthresh != size + size / 2)
+		GOTO_ERR(ret, out);
+
+	/* larger requests grow it back */
+	for (i = 0; i < 32; i++) {
+		if (test_mempool_adaptive_cycle(mp, objs, pool_size / 2, 32) < 0)
+			GOTO_ERR(ret, out);
+	}
+	printf("adaptive cache size with bulk of 32: %u\n", cache->size);
+	if (cache->size <= size || cache->size > RTE_MEMPOOL_CACHE_MAX_SIZE)
+		GOTO_ERR(ret, out);
+
+	/* objects in the cache and the socket cache are available */
+	if (rte_mempool_avail_count(mp) != pool_size)
+		GOTO_ERR(ret, out);
+	rte_mempool_cache_flush(NULL, mp);
+	if (cache->len != 0 || rte_mempool_avail_count(mp) != pool_size)
+		GOTO_ERR(ret, out);
+
+	/* all the objects can be taken through the socket cache */
+	if (test_mempool_adaptive_cycle(mp, objs, pool_size, 1) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != pool_size)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_audit(mp);
+	rte_mempool_dump(stdout, mp);
+
+out:
+	rte_mempool_free(mp);
+	rte_free(objs);
+	return ret;
+}
+
 static struct rte_mempool *mp_spsc;
 static rte_spinlock_t scsp_spinlock;
 static void *scsp_obj_table[MAX_KEEP];
@@ -848,6 +934,7 @@ test_mempool(void)
 	struct rte_mempool *mp_stack_anon = NULL;
 	struct rte_mempool *mp_stack_mempool_iter = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_shard = NULL;
 	struct rte_mempool *default_pool = NULL;
 	struct mp_data cb_arg = {
 		.ret = -1
@@ -944,6 +1031,27 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+	/* create a mempool with the sharded handler */
+	mp_shard = rte_mempool_create_empty("test_shard",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_shard == NULL) {
+		printf("cannot allocate mp_shard mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_set_ops_byname(mp_shard, "shard", NULL) < 0) {
+		printf("cannot set shard handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp_shard) < 0) {
+		printf("cannot populate mp_shard mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp_shard, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n", default_pool_ops);
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -1007,10 +1115,18 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
+	/* test adaptive and socket caches */
+	if (test_mempool_adaptive_cache() < 0)
+		GOTO_ERR(ret, err);
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the shard handler */
+	if (test_mempool_basic(mp_shard, 1) < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
@@ -1038,6 +1154,7 @@ test_mempool(void)
 	rte_mempool_free(mp_stack_anon);
 	rte_mempool_free(mp_stack_mempool_iter);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_shard);
 	rte_mempool_free(default_pool);
 
 	return ret;
@@ -23,6 +23,7 @@
 #include <rte_lcore.h>
 #include <rte_branch_prediction.h>
 #include <rte_mempool.h>
+#include <rte_ring.h>
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
@@ -63,6 +64,16 @@
  *      - 32
  *      - 128
  *      - 512
+ *
+ *    The ring, stack and shard pool handlers are then compared without
+ *    cache, with bulk of 1 and 32 and 128 kept objects.
+ *
+ *    An asymmetric test is then done with a cache, where some cores get
+ *    objects and pass them through a ring to other cores putting them back,
+ *    like a packet received on one socket and transmitted on another.
+ *    The cores of the main lcore socket get, the cores of the other sockets
+ *    put, or half of the cores each with a single socket.
+ *    It is done with the default, adaptive and per-socket caches.
  */
 
 #define N 65536
@@ -107,6 +118,16 @@ struct mempool_test_stats {
 
 static struct mempool_test_stats stats[RTE_MAX_LCORE];
 
+/* asymmetric test: burst size, ring between the cores and pool size */
+#define ASYM_BULK 32
+#define ASYM_RING_SIZE 1024
+#define ASYM_POOL_SIZE ((rte_lcore_count() * 4 * RTE_MEMPOOL_CACHE_MAX_SIZE) - 1)
+
+static struct rte_ring *asym_ring;
+
+/* true for the cores putting the objects back in the asymmetric test */
+static bool asym_put_lcore[RTE_MAX_LCORE];
+
 /*
  * save the object number in the first 4 bytes of object data. All
  * other bytes are set to 0.
@@ -285,6 +306,217 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+static int
+per_lcore_asym_test(void *arg)
+{
+	struct rte_mempool *mp = arg;
+	unsigned int lcore_id = rte_lcore_id();
+	void *obj_table[ASYM_BULK];
+	uint64_t start_cycles, time_diff = 0, hz = rte_get_timer_hz();
+	unsigned int i, n;
+
+	stats[lcore_id].enq_count = 0;
+
+	/* wait synchro for workers */
+	if (lcore_id != rte_get_main_lcore())
+		rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+
+	start_cycles = rte_get_timer_cycles();
+
+	while (time_diff/hz < TIME_S) {
+		for (i = 0; i < N / ASYM_BULK; i++) {
+			if (asym_put_lcore[lcore_id]) {
+				n = rte_ring_dequeue_burst(asym_ring, obj_table,
+					ASYM_BULK, NULL);
+				if (n == 0)
+					continue;
+				rte_mempool_put_bulk(mp, obj_table, n);
+				stats[lcore_id].enq_count += n;
+			} else {
+				if (rte_mempool_get_bulk(mp, obj_table,
+						ASYM_BULK) < 0)
+					continue;
+				n = rte_ring_enqueue_burst(asym_ring, obj_table,
+					ASYM_BULK, NULL);
+				if (n < ASYM_BULK)
+					rte_mempool_put_bulk(mp, &obj_table[n],
+						ASYM_BULK - n);
+			}
+		}
+
+		time_diff = rte_get_timer_cycles() - start_cycles;
+	}
+
+	return 0;
+}
+
+/* launch the asymmetric test on all the cores, and display the result */
+static int
+launch_asym_cores(struct rte_mempool *mp, const char *name)
+{
+	unsigned int lcore_id, nb_get = 0, nb_put = 0;
+	void *obj_table[ASYM_BULK];
+	uint64_t rate;
+	unsigned int n;
+	int ret = 0;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (asym_put_lcore[lcore_id])
+			nb_put++;
+		else
+			nb_get++;
+	}
+
+	__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+	memset(stats, 0, sizeof(stats));
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(per_lcore_asym_test, mp, lcore_id);
+
+	__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+	per_lcore_asym_test(mp);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+
+	/* give back the objects left in the ring */
+	while ((n = rte_ring_dequeue_burst(asym_ring, obj_table, ASYM_BULK,
+			NULL)) != 0)
+		rte_mempool_put_bulk(mp, obj_table, n);
+
+	rate = 0;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		rate += stats[lcore_id].enq_count / TIME_S;
+
+	printf("mempool_asym_autotest cache=%s get_cores=%u put_cores=%u "
+	       "bulk=%u rate_persec=%" PRIu64 "\n",
+	       name, nb_get, nb_put, ASYM_BULK, rate);
+
+	if (rte_mempool_avail_count(mp) != ASYM_POOL_SIZE) {
+		printf("mempool is not full\n");
+		ret = -1;
+	}
+	return ret;
+}
+
+/* compare pool handlers without cache, every request reaching the handler */
+static int
+test_mempool_handlers_perf(void)
+{
+	static const char * const handlers[] = {
+		"ring_mp_mc", "stack", "shard",
+	};
+	const unsigned int cores_tab[] = { 1, 2, rte_lcore_count() };
+	const unsigned int bulk_tab[] = { 1, 32 };
+	struct rte_mempool *mp;
+	unsigned int i, j, k;
+	int ret = 0;
+
+	for (i = 0; i < RTE_DIM(handlers); i++) {
+		mp = rte_mempool_create_empty("perf_test_handler", MEMPOOL_SIZE,
+			MEMPOOL_ELT_SIZE, 0, 0, SOCKET_ID_ANY, 0);
+		if (mp == NULL)
+			RET_ERR();
+
+		if (rte_mempool_set_ops_byname(mp, handlers[i], NULL) < 0) {
+			printf("%s handler not available, skipping\n",
+			       handlers[i]);
+			rte_mempool_free(mp);
+			continue;
+		}
+		if (rte_mempool_populate_default(mp) < 0) {
+			printf("cannot populate %s mempool\n", handlers[i]);
+			rte_mempool_free(mp);
+			RET_ERR();
+		}
+		rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+		printf("start performance test for %s handler (without cache)\n",
+		       handlers[i]);
+
+		use_constant_values = 0;
+		n_keep = 128;
+		for (j = 0; j < RTE_DIM(cores_tab) && ret == 0; j++) {
+			for (k = 0; k < RTE_DIM(bulk_tab) && ret == 0; k++) {
+				n_get_bulk = bulk_tab[k];
+				n_put_bulk = bulk_tab[k];
+				ret = launch_cores(mp, cores_tab[j]);
+			}
+		}
+
+		rte_mempool_free(mp);
+		if (ret < 0)
+			RET_ERR();
+	}
+
+	return 0;
+}
+
+/* asymmetric test with the default, adaptive and per-socket caches */
+static int
+test_mempool_asym_perf(void)
+{
+	static const struct {
+		const char *name;
+		unsigned int flags;
+	} caches[] = {
+		{ "default", 0 },
+		{ "adaptive", RTE_MEMPOOL_F_ADAPTIVE_CACHE },
+		{ "socket", RTE_MEMPOOL_F_SOCKET_CACHE },
+		{ "adaptive+socket",
+		  RTE_MEMPOOL_F_ADAPTIVE_CACHE | RTE_MEMPOOL_F_SOCKET_CACHE },
+	};
+	unsigned int main_socket = rte_lcore_to_socket_id(rte_get_main_lcore());
+	unsigned int lcore_id, i = 0;
+	struct rte_mempool *mp;
+	bool multi_socket = false;
+	int ret = 0;
+
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for asymmetric test\n");
+		return 0;
+	}
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_lcore_to_socket_id(lcore_id) != main_socket)
+			multi_socket = true;
+	}
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (multi_socket)
+			asym_put_lcore[lcore_id] =
+				rte_lcore_to_socket_id(lcore_id) != main_socket;
+		else
+			asym_put_lcore[lcore_id] = i++ >= rte_lcore_count() / 2;
+	}
+
+	asym_ring = rte_ring_create("perf_test_asym", ASYM_RING_SIZE,
+		SOCKET_ID_ANY, 0);
+	if (asym_ring == NULL)
+		RET_ERR();
+
+	printf("start asymmetric performance test (with cache)\n");
+
+	for (i = 0; i < RTE_DIM(caches); i++) {
+		mp = rte_mempool_create("perf_test_asym", ASYM_POOL_SIZE,
+			MEMPOOL_ELT_SIZE, RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+			NULL, NULL, my_obj_init, NULL,
+			SOCKET_ID_ANY, caches[i].flags);
+		if (mp == NULL)
+			GOTO_ERR(ret, out);
+
+		ret = launch_asym_cores(mp, caches[i].name);
+		rte_mempool_free(mp);
+		if (ret < 0)
+			GOTO_ERR(ret, out);
+	}
+
+out:
+	rte_ring_free(asym_ring);
+	return ret;
+}
+
 /* for a given number of core, launch all test cases */
 static int
 do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
@@ -413,6 +645,10 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_cache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* performance test of the pool handlers with 1, 2 and max cores */
+	if (test_mempool_handlers_perf() < 0)
+		goto err;
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (with user-owned cache)\n");
 	use_external_cache = 1;
@@ -428,6 +664,10 @@ test_mempool_perf(void)
 
 	rte_mempool_list_dump(stdout);
 
+	/* asymmetric performance test with all the cores */
+	if (test_mempool_asym_perf() < 0)
+		goto err;
+
 	ret = 0;
 
 err:
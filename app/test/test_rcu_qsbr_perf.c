@@ -11,6 +11,7 @@
 #include <rte_hash_crc.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
+#include <rte_service.h>
 #include <unistd.h>
 
 #include "test.h"
@@ -609,6 +610,195 @@ test_rcu_qsbr_sw_sv_1qs_non_blocking(void)
 	return -1;
 }
 
+/*
+ * Defer queue perf test: writers enqueue resources to a defer queue
+ * while a reader reports its quiescent state, with a shared queue,
+ * per-lcore queues, and per-lcore queues reclaimed by a service.
+ */
+#define DQ_ENTRIES (1024 * 256)
+#define DQ_SIZE (1024 * 16)
+
+static struct rte_rcu_qsbr_dq *dq;
+static uint64_t dq_freed;
+static uint64_t dq_enq_max[RTE_MAX_LCORE];
+
+static void
+test_rcu_qsbr_dq_free(void *p __rte_unused, void *e __rte_unused,
+		      unsigned int n)
+{
+	__atomic_fetch_add(&dq_freed, n, __ATOMIC_RELAXED);
+}
+
+static int
+test_rcu_qsbr_dq_reader(void *arg __rte_unused)
+{
+	rte_rcu_qsbr_thread_register(t[0], 0);
+	rte_rcu_qsbr_thread_online(t[0], 0);
+
+	while (!writer_done)
+		rte_rcu_qsbr_quiescent(t[0], 0);
+
+	rte_rcu_qsbr_thread_offline(t[0], 0);
+	rte_rcu_qsbr_thread_unregister(t[0], 0);
+
+	return 0;
+}
+
+static int
+test_rcu_qsbr_dq_writer(void *arg __rte_unused)
+{
+	uint64_t begin, cycles, total = 0, max = 0;
+	uint64_t e;
+
+	for (e = 0; e < DQ_ENTRIES; e++) {
+		begin = rte_rdtsc();
+		while (rte_rcu_qsbr_dq_enqueue(dq, &e) != 0)
+			rte_pause();
+		cycles = rte_rdtsc() - begin;
+		total += cycles;
+		if (cycles > max)
+			max = cycles;
+	}
+
+	__atomic_fetch_add(&update_cycles, total, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&updates, DQ_ENTRIES, __ATOMIC_RELAXED);
+	dq_enq_max[rte_lcore_id()] = max;
+
+	return 0;
+}
+
+static int
+test_rcu_qsbr_dq_mode(const char *mode, uint32_t flags)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq_stats stats;
+	unsigned int i, first_writer = 1;
+	uint16_t service_lcore = 0;
+	uint32_t service_id = 0;
+	uint64_t max = 0;
+	size_t sz;
+
+	writer_done = 0;
+	__atomic_store_n(&updates, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&update_cycles, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq_freed, 0, __ATOMIC_RELAXED);
+	memset(dq_enq_max, 0, sizeof(dq_enq_max));
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	t[0] = rte_zmalloc("rcu0", sz, RTE_CACHE_LINE_SIZE);
+	if (t[0] == NULL) {
+		printf("QSBR variable allocation failed\n");
+		return -1;
+	}
+	rte_rcu_qsbr_init(t[0], 1);
+
+	memset(&params, 0, sizeof(params));
+	params.name = "dq_perf";
+	params.size = DQ_SIZE;
+	params.esize = sizeof(uint64_t);
+	params.trigger_reclaim_limit = DQ_SIZE / 4;
+	params.max_reclaim_size = DQ_SIZE / 4;
+	params.free_fn = test_rcu_qsbr_dq_free;
+	params.v = t[0];
+	params.flags = flags;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	if (dq == NULL) {
+		printf("Defer queue create failed\n");
+		rte_free(t[0]);
+		return -1;
+	}
+
+	/* The second worker runs the reclamation service */
+	if (flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) {
+		service_lcore = enabled_core_ids[1];
+		first_writer = 2;
+		if (rte_rcu_qsbr_dq_service_id_get(dq, &service_id) != 0 ||
+		    rte_service_lcore_add(service_lcore) != 0 ||
+		    rte_service_map_lcore_set(service_id, service_lcore,
+					      1) != 0 ||
+		    rte_service_runstate_set(service_id, 1) != 0 ||
+		    rte_service_lcore_start(service_lcore) != 0) {
+			printf("Reclamation service start failed\n");
+			goto error;
+		}
+	}
+
+	printf("\nPerf test: defer queue, %s, %u writers, 1 reader\n",
+		mode, num_cores - first_writer);
+
+	rte_eal_remote_launch(test_rcu_qsbr_dq_reader, NULL,
+			      enabled_core_ids[0]);
+	for (i = first_writer; i < num_cores; i++)
+		rte_eal_remote_launch(test_rcu_qsbr_dq_writer, NULL,
+				      enabled_core_ids[i]);
+	for (i = first_writer; i < num_cores; i++)
+		rte_eal_wait_lcore(enabled_core_ids[i]);
+	writer_done = 1;
+	rte_eal_wait_lcore(enabled_core_ids[0]);
+
+	if (flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) {
+		rte_service_map_lcore_set(service_id, service_lcore, 0);
+		rte_service_lcore_stop(service_lcore);
+		rte_service_lcore_del(service_lcore);
+	}
+
+	rte_rcu_qsbr_dq_stats_get(dq, &stats);
+	if (rte_rcu_qsbr_dq_delete(dq) != 0) {
+		printf("Defer queue delete failed\n");
+		goto error;
+	}
+	rte_free(t[0]);
+
+	if (__atomic_load_n(&dq_freed, __ATOMIC_RELAXED) !=
+	    __atomic_load_n(&updates, __ATOMIC_RELAXED)) {
+		printf("Freed %"PRIu64" resources out of %"PRIu64"\n",
+			dq_freed, updates);
+		return -1;
+	}
+
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		max = RTE_MAX(max, dq_enq_max[i]);
+
+	printf("Cycles per enqueue: %"PRIu64" (max %"PRIu64")\n",
+		__atomic_load_n(&update_cycles, __ATOMIC_RELAXED) /
+		__atomic_load_n(&updates, __ATOMIC_RELAXED), max);
+	printf("Grace periods started: %"PRIu64", queue full: %"PRIu64"\n",
+		stats.tokens, stats.full);
+
+	return 0;
+
+error:
+	if (flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) {
+		rte_service_map_lcore_set(service_id, service_lcore, 0);
+		rte_service_lcore_stop(service_lcore);
+		rte_service_lcore_del(service_lcore);
+	}
+	rte_rcu_qsbr_dq_delete(dq);
+	rte_free(t[0]);
+
+	return -1;
+}
+
+static int
+test_rcu_qsbr_dq_perf(void)
+{
+	if (test_rcu_qsbr_dq_mode("shared queue", 0) < 0)
+		return -1;
+
+	if (test_rcu_qsbr_dq_mode("per-lcore queues",
+				  RTE_RCU_QSBR_DQ_PER_LCORE) < 0)
+		return -1;
+
+	if (num_cores < 3) {
+		printf("Not enough cores for the reclamation service, skipping\n");
+		return 0;
+	}
+
+	return test_rcu_qsbr_dq_mode("per-lcore queues, reclamation service",
+				     RTE_RCU_QSBR_DQ_PER_LCORE |
+				     RTE_RCU_QSBR_DQ_RECLAIM_SERVICE);
+}
+
 static int
 test_rcu_qsbr_main(void)
 {
@@ -682,6 +872,9 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_sw_sv_1qs_non_blocking() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_perf() < 0)
+		goto test_fail;
+
 	printf("\n");
 
 	return 0;
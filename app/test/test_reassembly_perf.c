@@ -0,0 +1,236 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_udp.h>
+
+#include "test.h"
+
+#define BURST_SIZE	32
+#define FRAGS_PER_FLOW	4
+/* The payload of a fragment, a multiple of 8 bytes. */
+#define FRAG_LEN	64
+#define MAX_FLOWS	16384
+#define MBUF_DATA_SIZE	(RTE_PKTMBUF_HEADROOM + 256)
+
+static const uint32_t flow_nums[] = {256, 4096, MAX_FLOWS};
+
+/* Build fragment idx of the datagram of flow. */
+static void
+fill_frag(struct rte_mbuf *m, int ipv6, uint32_t flow, uint32_t idx)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t mf, l3_len;
+
+	mf = idx != FRAGS_PER_FLOW - 1;
+	l3_len = ipv6 ? sizeof(*ipv6_hdr) + sizeof(*frag_hdr) :
+		sizeof(*ipv4_hdr);
+
+	rte_pktmbuf_reset(m);
+	eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+		sizeof(*eth_hdr) + l3_len + FRAG_LEN);
+	memset(eth_hdr, 0, m->data_len);
+	m->l2_len = sizeof(*eth_hdr);
+	m->l3_len = l3_len;
+
+	if (ipv6) {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(sizeof(*frag_hdr) +
+			FRAG_LEN);
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+		ipv6_hdr->hop_limits = 64;
+		ipv6_hdr->src_addr[0] = 0xfd;
+		ipv6_hdr->src_addr[15] = 1;
+		ipv6_hdr->dst_addr[0] = 0xfd;
+		ipv6_hdr->dst_addr[14] = flow >> 8;
+		ipv6_hdr->dst_addr[15] = flow;
+
+		frag_hdr = (struct rte_ipv6_fragment_ext *)(ipv6_hdr + 1);
+		frag_hdr->next_header = IPPROTO_UDP;
+		frag_hdr->frag_data = rte_cpu_to_be_16(
+			RTE_IPV6_SET_FRAG_DATA(idx * FRAG_LEN, mf));
+		frag_hdr->id = rte_cpu_to_be_32(flow);
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6_EXT |
+			RTE_PTYPE_L4_FRAG;
+		return;
+	}
+
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+	ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+	ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+		FRAG_LEN);
+	ipv4_hdr->packet_id = rte_cpu_to_be_16(flow);
+	ipv4_hdr->fragment_offset = rte_cpu_to_be_16(
+		idx * FRAG_LEN / RTE_IPV4_HDR_OFFSET_UNITS |
+		(mf ? RTE_IPV4_HDR_MF_FLAG : 0));
+	ipv4_hdr->time_to_live = 64;
+	ipv4_hdr->next_proto_id = IPPROTO_UDP;
+	ipv4_hdr->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ipv4_hdr->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 1, 0, 0) + flow);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_FRAG;
+}
+
+/* Reassemble a burst one fragment at a time. */
+static uint16_t
+reassemble_single(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, int ipv6, struct rte_mbuf **mb,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_mbuf *m;
+	uint16_t i, k;
+
+	for (i = 0, k = 0; i != nb_pkts; i++) {
+		if (ipv6) {
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mb[i],
+				struct rte_ipv6_hdr *, mb[i]->l2_len);
+			frag_hdr = (struct rte_ipv6_fragment_ext *)(ipv6_hdr + 1);
+			m = rte_ipv6_frag_reassemble_packet(tbl, dr, mb[i], tms,
+				ipv6_hdr, frag_hdr);
+		} else {
+			ipv4_hdr = rte_pktmbuf_mtod_offset(mb[i],
+				struct rte_ipv4_hdr *, mb[i]->l2_len);
+			m = rte_ipv4_frag_reassemble_packet(tbl, dr, mb[i], tms,
+				ipv4_hdr);
+		}
+		if (m != NULL)
+			out[k++] = m;
+	}
+
+	return k;
+}
+
+/*
+ * Reassemble the datagrams of nb_flows flows, their fragments are
+ * interleaved as seen by a high fan-in server, return the cycles spent.
+ */
+static int
+run_reassembly(struct rte_mempool *mp, struct rte_mbuf **pkts, int ipv6,
+	int bulk, uint32_t nb_flows, uint64_t *cycles)
+{
+	struct rte_ip_frag_death_row dr = {0};
+	struct rte_ip_frag_tbl_stats stats;
+	struct rte_mbuf *out[BURST_SIZE];
+	struct rte_ip_frag_tbl *tbl;
+	uint32_t i, j, nb_pkts, nb_out = 0;
+	uint64_t tsc, tms;
+	uint16_t nb, k;
+
+	nb_pkts = nb_flows * FRAGS_PER_FLOW;
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, nb_pkts) != 0) {
+		printf("Cannot allocate %u mbufs\n", nb_pkts);
+		return -1;
+	}
+	for (i = 0; i < FRAGS_PER_FLOW; i++)
+		for (j = 0; j < nb_flows; j++)
+			fill_frag(pkts[i * nb_flows + j], ipv6, j, i);
+
+	tbl = rte_ip_frag_table_create(nb_flows, FRAGS_PER_FLOW, nb_flows,
+		rte_get_tsc_hz(), rte_socket_id());
+	if (tbl == NULL) {
+		printf("Cannot create fragmentation table\n");
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		return -1;
+	}
+
+	tms = rte_rdtsc();
+	tsc = rte_rdtsc_precise();
+	for (i = 0; i < nb_pkts; i += nb) {
+		nb = RTE_MIN(nb_pkts - i, (uint32_t)BURST_SIZE);
+		if (bulk)
+			k = ipv6 ? rte_ipv6_frag_reassemble_bulk(tbl, &dr,
+					&pkts[i], nb, tms, out) :
+				rte_ipv4_frag_reassemble_bulk(tbl, &dr,
+					&pkts[i], nb, tms, out);
+		else
+			k = reassemble_single(tbl, &dr, ipv6, &pkts[i], nb,
+				tms, out);
+		rte_pktmbuf_free_bulk(out, k);
+		rte_ip_frag_free_death_row(&dr, 0);
+		nb_out += k;
+	}
+	*cycles = rte_rdtsc_precise() - tsc;
+
+	rte_ip_frag_table_stats_get(tbl, &stats);
+	rte_ip_frag_table_destroy(tbl);
+
+	if (nb_out != nb_flows || stats.use_entries != 0) {
+		printf("%u packets reassembled, expected %u, %u left in table\n",
+			nb_out, nb_flows, stats.use_entries);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_reassembly_perf(void)
+{
+	uint64_t single_tsc, bulk_tsc;
+	struct rte_mempool *mp;
+	struct rte_mbuf **pkts;
+	uint32_t i, nb_frags;
+	int ipv6, ret = 0;
+
+	mp = rte_pktmbuf_pool_create("REASS_PERF_POOL",
+		MAX_FLOWS * FRAGS_PER_FLOW, 0, 0, MBUF_DATA_SIZE,
+		SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Cannot create mbuf pool, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	pkts = rte_malloc(NULL, sizeof(*pkts) * MAX_FLOWS * FRAGS_PER_FLOW, 0);
+	if (pkts == NULL) {
+		printf("Cannot allocate packet array\n");
+		rte_mempool_free(mp);
+		return -1;
+	}
+
+	printf("Reassembling datagrams of %u fragments of %u bytes\n",
+		FRAGS_PER_FLOW, FRAG_LEN);
+	for (i = 0; i < RTE_DIM(flow_nums) && ret == 0; i++) {
+		for (ipv6 = 0; ipv6 <= 1 && ret == 0; ipv6++) {
+			ret = run_reassembly(mp, pkts, ipv6, 0, flow_nums[i],
+				&single_tsc);
+			if (ret == 0)
+				ret = run_reassembly(mp, pkts, ipv6, 1,
+					flow_nums[i], &bulk_tsc);
+			if (ret != 0)
+				break;
+
+			nb_frags = flow_nums[i] * FRAGS_PER_FLOW;
+			printf("IPv%d %5u flows: single %.1f, bulk %.1f "
+				"cycles/fragment\n",
+				ipv6 ? 6 : 4, flow_nums[i],
+				(double)single_tsc / nb_frags,
+				(double)bulk_tsc / nb_frags);
+		}
+	}
+
+	rte_free(pkts);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(reassembly_perf_autotest, test_reassembly_perf);
@@ -485,6 +485,224 @@ test_reorder_set_seqn(void)
 	return ret;
 }
 
+static int
+test_reorder_mp_insert_drain(void)
+{
+	struct rte_mempool *p = test_params->p;
+	struct rte_reorder_buffer *b = NULL;
+	const unsigned int num_bufs = 8;
+	const unsigned int size = 4;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	static const uint32_t exp_seqn[] = {0, 1, 3, 4, 5, 6};
+	unsigned int i, cnt, nb_out = 0;
+	int ret = -1;
+
+	memset(bufs, 0, sizeof(bufs));
+	memset(robufs, 0, sizeof(robufs));
+
+	b = rte_reorder_create_mp("test_mp", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		if (bufs[i] == NULL) {
+			printf("Packet allocation failed\n");
+			goto exit;
+		}
+		*rte_reorder_seqn(bufs[i]) = i;
+	}
+
+	/* OB[] = {NULL, 1, NULL, 3}, waiting for 0 */
+	if (rte_reorder_insert(b, bufs[1]) != 0 ||
+			rte_reorder_insert(b, bufs[3]) != 0) {
+		printf("%s:%d: Error inserting packets\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[1] = bufs[3] = NULL;
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d: %u packets drained before seqn 0\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+
+	/* OB[] = {0, 1, NULL, 3}, drain 0 and 1 */
+	if (rte_reorder_insert(b, bufs[0]) != 0) {
+		printf("%s:%d: Error inserting packet\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[0] = NULL;
+	nb_out += rte_reorder_drain(b, &robufs[nb_out], num_bufs - nb_out);
+
+	/* early packet, the drain skips seqn 2 to make room for it */
+	*rte_reorder_seqn(bufs[7]) = 6;
+	ret = rte_reorder_insert(b, bufs[7]);
+	if (!(ret == -1 && rte_errno == ENOSPC)) {
+		printf("%s:%d: No error inserting early packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	ret = -1;
+	nb_out += rte_reorder_drain(b, &robufs[nb_out], num_bufs - nb_out);
+	if (rte_reorder_insert(b, bufs[7]) != 0) {
+		printf("%s:%d: Error inserting early packet after drain\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	bufs[7] = NULL;
+
+	/* seqn 2 is now late */
+	if (!(rte_reorder_insert(b, bufs[2]) == -1 && rte_errno == ERANGE)) {
+		printf("%s:%d: No error inserting late packet\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+
+	if (rte_reorder_insert(b, bufs[5]) != 0 ||
+			rte_reorder_insert(b, bufs[4]) != 0) {
+		printf("%s:%d: Error inserting packets\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[4] = bufs[5] = NULL;
+	nb_out += rte_reorder_drain(b, &robufs[nb_out], num_bufs - nb_out);
+
+	if (nb_out != RTE_DIM(exp_seqn)) {
+		printf("%s:%d: %u packets drained, expected %zu\n",
+				__func__, __LINE__, nb_out, RTE_DIM(exp_seqn));
+		goto exit;
+	}
+	for (i = 0; i < nb_out; i++) {
+		if (*rte_reorder_seqn(robufs[i]) != exp_seqn[i]) {
+			printf("%s:%d: drained seqn %u, expected %u\n",
+					__func__, __LINE__,
+					*rte_reorder_seqn(robufs[i]),
+					exp_seqn[i]);
+			goto exit;
+		}
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		rte_pktmbuf_free(bufs[i]);
+		rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
+#define MP_TOTAL_PKTS (1 << 20)
+#define MP_MAX_WORKERS 16
+
+struct reorder_mp_args {
+	struct rte_reorder_buffer *b;
+	struct rte_mempool *p;
+	unsigned int size;
+	uint32_t nb_workers;
+	uint32_t drained;
+};
+
+static struct reorder_mp_args mp_args;
+
+/*
+ * Insert every nb_workers sequence number, staying inside the window
+ * so that no mbuf is skipped by the drain.
+ */
+static int
+reorder_mp_worker(void *arg)
+{
+	struct reorder_mp_args *args = &mp_args;
+	uint32_t seqn = (uintptr_t)arg;
+	struct rte_mbuf *m;
+
+	for (; seqn < MP_TOTAL_PKTS; seqn += args->nb_workers) {
+		while (seqn - __atomic_load_n(&args->drained,
+				__ATOMIC_RELAXED) >= args->size)
+			rte_pause();
+
+		do {
+			m = rte_pktmbuf_alloc(args->p);
+		} while (m == NULL);
+		*rte_reorder_seqn(m) = seqn;
+
+		if (rte_reorder_insert(args->b, m) != 0) {
+			printf("%s: Error inserting seqn %u: %d\n", __func__,
+					seqn, rte_errno);
+			rte_pktmbuf_free(m);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_reorder_mp_concurrent(void)
+{
+	struct reorder_mp_args *args = &mp_args;
+	struct rte_mbuf *robufs[BURST];
+	unsigned int lcore_id, i, cnt;
+	uint32_t seqn = 0;
+	uint64_t tsc;
+	int ret = 0;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for multi-producer test, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	memset(args, 0, sizeof(*args));
+	args->p = test_params->p;
+	args->size = 1024;
+	args->b = rte_reorder_create_mp("test_mp_mt", rte_socket_id(),
+			args->size);
+	TEST_ASSERT_NOT_NULL(args->b, "Failed to create reorder buffer");
+	args->nb_workers = RTE_MIN(rte_lcore_count() - 1, MP_MAX_WORKERS);
+
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (i == args->nb_workers)
+			break;
+		rte_eal_remote_launch(reorder_mp_worker,
+				(void *)(uintptr_t)i++, lcore_id);
+	}
+
+	tsc = rte_rdtsc();
+	while (seqn < MP_TOTAL_PKTS && ret == 0) {
+		cnt = rte_reorder_drain(args->b, robufs, BURST);
+		for (i = 0; i < cnt; i++) {
+			if (*rte_reorder_seqn(robufs[i]) != seqn + i) {
+				printf("%s: drained seqn %u, expected %u\n",
+						__func__,
+						*rte_reorder_seqn(robufs[i]),
+						seqn + i);
+				ret = -1;
+			}
+		}
+		rte_pktmbuf_free_bulk(robufs, cnt);
+		seqn += cnt;
+		__atomic_store_n(&args->drained, seqn, __ATOMIC_RELAXED);
+		if (ret != 0)
+			/* let the workers finish */
+			__atomic_store_n(&args->drained, MP_TOTAL_PKTS,
+					__ATOMIC_RELAXED);
+	}
+	tsc = rte_rdtsc() - tsc;
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+
+	if (ret == 0)
+		printf("%u producers: %.1f cycles/packet\n", args->nb_workers,
+				(double)tsc / MP_TOTAL_PKTS);
+
+	rte_reorder_free(args->b);
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -537,6 +755,8 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_drain),
 		TEST_CASE(test_reorder_drain_up_to_seqn),
 		TEST_CASE(test_reorder_set_seqn),
+		TEST_CASE(test_reorder_mp_insert_drain),
+		TEST_CASE(test_reorder_mp_concurrent),
 		TEST_CASES_END()
 	}
 };
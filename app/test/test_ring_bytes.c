@@ -0,0 +1,362 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+#include <rte_ring_bytes.h>
+
+#include "test.h"
+
+#define RING_NAME	"RING_BYTES"
+#define RING_SIZE	1024
+#define REC_MAX		200
+#define MAX_BURST	8
+#define ITERATIONS	20000
+#define MT_RECORDS	20000
+
+static const struct {
+	const char *name;
+	unsigned int flags;
+} sync_modes[] = {
+	{ "SP/SC", RING_F_SP_ENQ | RING_F_SC_DEQ },
+	{ "MP/SC", RING_F_SC_DEQ },
+	{ "MP_RTS/SC", RING_F_MP_RTS_ENQ | RING_F_SC_DEQ },
+	{ "MP_HTS/SC", RING_F_MP_HTS_ENQ | RING_F_SC_DEQ },
+	{ "SP/MC_HTS", RING_F_SP_ENQ | RING_F_MC_HTS_DEQ },
+	{ "MP_HTS/MC_HTS", RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+};
+
+/* fills a record with a pattern derived from its sequence number */
+static void
+fill_record(void *data, uint32_t len, uint32_t seq)
+{
+	uint8_t *p = data;
+	uint32_t i;
+
+	for (i = 0; i != len; i++)
+		p[i] = (uint8_t)(seq + i);
+}
+
+static int
+check_record(const void *data, uint32_t len, uint32_t seq)
+{
+	const uint8_t *p = data;
+	uint32_t i;
+
+	for (i = 0; i != len; i++)
+		if (p[i] != (uint8_t)(seq + i))
+			return -1;
+	return 0;
+}
+
+static int
+test_ring_bytes_create_invalid(void)
+{
+	struct rte_ring *r;
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE + 8, REC_MAX,
+		SOCKET_ID_ANY, RING_F_SC_DEQ);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring with an invalid size");
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+		SOCKET_ID_ANY, RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring of exact size");
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+		SOCKET_ID_ANY, 0);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring with an MC consumer");
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+		SOCKET_ID_ANY, RING_F_MC_RTS_DEQ);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring with an MC_RTS consumer");
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, RING_SIZE - 8,
+		SOCKET_ID_ANY, RING_F_SC_DEQ);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring with a too large record length");
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, 0,
+		SOCKET_ID_ANY, RING_F_SC_DEQ);
+	TEST_ASSERT(r == NULL && rte_errno == EINVAL,
+		"Created a byte ring with no record length");
+
+	return TEST_SUCCESS;
+}
+
+/* enqueues and dequeues bursts of random lengths on a single lcore */
+static int
+test_ring_bytes_mode(unsigned int flags)
+{
+	struct rte_ring_bytes_zc zc;
+	struct rte_ring *r;
+	void *data[MAX_BURST];
+	uint32_t lens[MAX_BURST], out_lens[MAX_BURST];
+	uint32_t i, it, n, num, used, enq_seq = 0, deq_seq = 0;
+	unsigned int free, space, avail;
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+		SOCKET_ID_ANY, flags);
+	TEST_ASSERT_NOT_NULL(r, "Cannot create byte ring");
+
+	n = rte_ring_bytes_dequeue_peek(r, data, out_lens, MAX_BURST, &zc,
+		&avail);
+	TEST_ASSERT(n == 0 && avail == 0, "Dequeued from an empty ring");
+	rte_ring_bytes_dequeue_release(r, &zc);
+
+	lens[0] = REC_MAX + 1;
+	n = rte_ring_bytes_enqueue_reserve(r, lens, 1, data, &zc, &space);
+	TEST_ASSERT(n == 0 && space == RING_SIZE - RTE_RING_BYTES_ALIGN,
+		"Reserved a record larger than the max record length");
+	rte_ring_bytes_enqueue_commit(r, &zc);
+
+	for (it = 0; it != ITERATIONS; it++) {
+		/* fill the ring up to a random level, wrapping around */
+		num = rte_rand_max(MAX_BURST) + 1;
+		used = 0;
+		for (i = 0; i != num; i++) {
+			lens[i] = rte_rand_max(REC_MAX + 1);
+			used += RTE_RING_BYTES_SLOTS(lens[i]);
+		}
+
+		free = rte_ring_free_count(r);
+		n = rte_ring_bytes_enqueue_reserve(r, lens, num, data, &zc,
+			&space);
+		if (n == 0) {
+			TEST_ASSERT(used > free,
+				"Failed to reserve %u slots in a ring with %u free",
+				used, free);
+		} else {
+			TEST_ASSERT_EQUAL(n, num, "Reserved %u records of %u",
+				n, num);
+			TEST_ASSERT_EQUAL(space, (free - used) *
+				RTE_RING_BYTES_ALIGN, "Wrong free space %u",
+				space);
+			for (i = 0; i != n; i++) {
+				TEST_ASSERT(((uintptr_t)data[i] &
+					(RTE_RING_BYTES_ALIGN - 1)) == 0,
+					"Unaligned record");
+				fill_record(data[i], lens[i], enq_seq++);
+			}
+			rte_ring_bytes_enqueue_commit(r, &zc);
+		}
+
+		/* drain a random number of records */
+		num = rte_rand_max(MAX_BURST + 1);
+		n = rte_ring_bytes_dequeue_peek(r, data, out_lens, num, &zc,
+			&avail);
+		TEST_ASSERT_EQUAL(avail, rte_ring_count(r) *
+			RTE_RING_BYTES_ALIGN - zc.num * RTE_RING_BYTES_ALIGN,
+			"Wrong available data %u", avail);
+		for (i = 0; i != n; i++, deq_seq++)
+			TEST_ASSERT(check_record(data[i], out_lens[i],
+				deq_seq) == 0, "Corrupted record %u", deq_seq);
+		rte_ring_bytes_dequeue_release(r, &zc);
+	}
+
+	/* drain the ring */
+	do {
+		n = rte_ring_bytes_dequeue_peek(r, data, out_lens, MAX_BURST,
+			&zc, NULL);
+		for (i = 0; i != n; i++, deq_seq++)
+			TEST_ASSERT(check_record(data[i], out_lens[i],
+				deq_seq) == 0, "Corrupted record %u", deq_seq);
+		rte_ring_bytes_dequeue_release(r, &zc);
+	} while (n != 0);
+
+	TEST_ASSERT_EQUAL(enq_seq, deq_seq, "Enqueued %u records, dequeued %u",
+		enq_seq, deq_seq);
+	TEST_ASSERT(rte_ring_empty(r), "Ring not empty");
+
+	rte_ring_free(r);
+	return TEST_SUCCESS;
+}
+
+/* fills the ring completely with records crossing its end */
+static int
+test_ring_bytes_full(void)
+{
+	struct rte_ring_bytes_zc zc;
+	struct rte_ring *r;
+	void *data[2];
+	uint32_t lens[2];
+	unsigned int n, space;
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, RING_SIZE - 16,
+		SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(r, "Cannot create byte ring");
+
+	/* move the head in the middle of the ring */
+	lens[0] = RING_SIZE / 2 - 8;
+	n = rte_ring_bytes_enqueue_reserve(r, lens, 1, data, &zc, NULL);
+	TEST_ASSERT_EQUAL(n, 1, "Cannot reserve a record");
+	fill_record(data[0], lens[0], 0);
+	rte_ring_bytes_enqueue_commit(r, &zc);
+	n = rte_ring_bytes_dequeue_peek(r, data, lens, 1, &zc, NULL);
+	TEST_ASSERT(n == 1 && check_record(data[0], lens[0], 0) == 0,
+		"Cannot dequeue a record");
+	rte_ring_bytes_dequeue_release(r, &zc);
+
+	/* a record of the full usable size of the ring wraps around */
+	lens[0] = RING_SIZE - 16;
+	lens[1] = 0;
+	n = rte_ring_bytes_enqueue_reserve(r, lens, 2, data, &zc, NULL);
+	TEST_ASSERT_EQUAL(n, 0, "Reserved more than the ring size");
+	n = rte_ring_bytes_enqueue_reserve(r, lens, 1, data, &zc, &space);
+	TEST_ASSERT(n == 1 && space == 0, "Cannot fill the ring");
+	fill_record(data[0], lens[0], 1);
+	rte_ring_bytes_enqueue_commit(r, &zc);
+	TEST_ASSERT(rte_ring_full(r), "Ring not full");
+
+	n = rte_ring_bytes_dequeue_peek(r, data, lens, 2, &zc, NULL);
+	TEST_ASSERT(n == 1 && lens[0] == RING_SIZE - 16 &&
+		check_record(data[0], lens[0], 1) == 0,
+		"Corrupted wrapped record");
+	rte_ring_bytes_dequeue_release(r, &zc);
+	TEST_ASSERT(rte_ring_empty(r), "Ring not empty");
+
+	rte_ring_free(r);
+	return TEST_SUCCESS;
+}
+
+/*
+ * Multi-thread test: every worker enqueues records tagged with its lcore id
+ * and a sequence number, the main lcore checks they come in order.
+ */
+struct mt_record {
+	uint32_t lcore;
+	uint32_t seq;
+};
+
+static struct rte_ring *mt_ring;
+static uint32_t mt_start;
+
+static int
+mt_producer(__rte_unused void *arg)
+{
+	struct rte_ring_bytes_zc zc;
+	struct mt_record *rec;
+	void *data[MAX_BURST];
+	uint32_t lens[MAX_BURST];
+	uint32_t i, n, seq = 0;
+
+	rte_wait_until_equal_32(&mt_start, 1, __ATOMIC_ACQUIRE);
+
+	while (seq != MT_RECORDS) {
+		n = RTE_MIN(rte_rand_max(MAX_BURST) + 1, MT_RECORDS - seq);
+		for (i = 0; i != n; i++)
+			lens[i] = sizeof(*rec) + rte_rand_max(REC_MAX -
+				sizeof(*rec) + 1);
+
+		if (rte_ring_bytes_enqueue_reserve(mt_ring, lens, n, data,
+				&zc, NULL) == 0) {
+			rte_pause();
+			continue;
+		}
+		for (i = 0; i != n; i++, seq++) {
+			rec = data[i];
+			rec->lcore = rte_lcore_id();
+			rec->seq = seq;
+			fill_record(rec + 1, lens[i] - sizeof(*rec), seq);
+		}
+		rte_ring_bytes_enqueue_commit(mt_ring, &zc);
+	}
+
+	return 0;
+}
+
+static int
+test_ring_bytes_mt(unsigned int flags)
+{
+	static uint32_t next_seq[RTE_MAX_LCORE];
+	struct rte_ring_bytes_zc zc;
+	const struct mt_record *rec;
+	void *data[MAX_BURST];
+	uint32_t lens[MAX_BURST];
+	uint64_t total, expected;
+	unsigned int i, n, lcore;
+	int ret = TEST_SUCCESS;
+
+	mt_ring = rte_ring_bytes_create(RING_NAME, RING_SIZE * 4, REC_MAX,
+		SOCKET_ID_ANY, flags);
+	TEST_ASSERT_NOT_NULL(mt_ring, "Cannot create byte ring");
+
+	memset(next_seq, 0, sizeof(next_seq));
+	__atomic_store_n(&mt_start, 0, __ATOMIC_RELAXED);
+	rte_eal_mp_remote_launch(mt_producer, NULL, SKIP_MAIN);
+	__atomic_store_n(&mt_start, 1, __ATOMIC_RELEASE);
+
+	/* keep on dequeuing after a failure to let the producers finish */
+	expected = (uint64_t)MT_RECORDS * (rte_lcore_count() - 1);
+	for (total = 0; total != expected; total += n) {
+		n = rte_ring_bytes_dequeue_peek(mt_ring, data, lens,
+			MAX_BURST, &zc, NULL);
+		for (i = 0; i != n && ret == TEST_SUCCESS; i++) {
+			rec = data[i];
+			lcore = rec->lcore;
+			if (lcore >= RTE_MAX_LCORE ||
+					rec->seq != next_seq[lcore] ||
+					check_record(rec + 1, lens[i] -
+						sizeof(*rec), rec->seq) != 0) {
+				printf("Unexpected record %u from lcore %u\n",
+					rec->seq, lcore);
+				ret = TEST_FAILED;
+			} else
+				next_seq[lcore]++;
+		}
+		rte_ring_bytes_dequeue_release(mt_ring, &zc);
+	}
+
+	rte_eal_mp_wait_lcore();
+	rte_ring_free(mt_ring);
+	return ret;
+}
+
+static int
+test_ring_bytes(void)
+{
+	unsigned int i;
+
+	if (test_ring_bytes_create_invalid() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	for (i = 0; i != RTE_DIM(sync_modes); i++) {
+		printf("Testing %s byte ring\n", sync_modes[i].name);
+		if (test_ring_bytes_mode(sync_modes[i].flags) != TEST_SUCCESS)
+			return TEST_FAILED;
+	}
+
+	if (test_ring_bytes_full() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough lcores for multi-thread tests\n");
+		return TEST_SUCCESS;
+	}
+
+	for (i = 0; i != RTE_DIM(sync_modes); i++) {
+		/* a single producer needs a single worker */
+		if ((sync_modes[i].flags & RING_F_SP_ENQ) != 0 &&
+				rte_lcore_count() > 2)
+			continue;
+		printf("Testing %s byte ring on %u lcores\n",
+			sync_modes[i].name, rte_lcore_count());
+		if (test_ring_bytes_mt(sync_modes[i].flags) != TEST_SUCCESS)
+			return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(ring_bytes_autotest, test_ring_bytes);
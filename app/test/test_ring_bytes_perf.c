@@ -0,0 +1,392 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_mempool.h>
+#include <rte_pause.h>
+#include <rte_ring_bytes.h>
+
+#include "test.h"
+
+/*
+ * Byte ring performance test cases, measures the cycles per record of
+ * variable-sized records enqueued and dequeued in place, compared to
+ * records copied into mempool objects passed through a pointer ring.
+ */
+
+#define RING_NAME	"RING_BYTES_PERF"
+#define RING_SIZE	(256 * 1024)
+#define REC_MAX		2048
+#define MAX_BURST	32
+#define POOL_SIZE	(RING_SIZE / 32)
+#define TIME_MS		100
+
+/*
+ * the record sizes and bursts to enqueue and dequeue in testing
+ * (marked volatile so they won't be seen as compile-time constants)
+ */
+static const volatile unsigned int rec_sizes[] = { 32, 256, 2048 };
+static const volatile unsigned int bulk_sizes[] = { 1, 8, 32 };
+
+static uint8_t src_rec[REC_MAX] __rte_cache_aligned;
+
+struct lcore_pair {
+	unsigned int c1, c2;
+};
+
+static int
+get_two_cores(struct lcore_pair *lcp)
+{
+	unsigned int id1, id2;
+
+	RTE_LCORE_FOREACH(id1) {
+		RTE_LCORE_FOREACH(id2) {
+			if (id1 == id2)
+				continue;
+			if (rte_lcore_to_cpu_id(id1) != rte_lcore_to_cpu_id(id2) &&
+					rte_lcore_to_socket_id(id1) ==
+					rte_lcore_to_socket_id(id2)) {
+				lcp->c1 = id1;
+				lcp->c2 = id2;
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/* enqueues a burst of records copied from src_rec, returns 0 if no room */
+static __rte_always_inline unsigned int
+enqueue_records(struct rte_ring *r, unsigned int len, unsigned int n)
+{
+	struct rte_ring_bytes_zc zc;
+	uint32_t lens[MAX_BURST];
+	void *data[MAX_BURST];
+	unsigned int i;
+
+	for (i = 0; i != n; i++)
+		lens[i] = len;
+
+	n = rte_ring_bytes_enqueue_reserve(r, lens, n, data, &zc, NULL);
+	for (i = 0; i != n; i++)
+		memcpy(data[i], src_rec, len);
+	rte_ring_bytes_enqueue_commit(r, &zc);
+	return n;
+}
+
+/* dequeues up to a burst of records, reading their first bytes */
+static __rte_always_inline unsigned int
+dequeue_records(struct rte_ring *r, unsigned int n, uint64_t *sum)
+{
+	struct rte_ring_bytes_zc zc;
+	uint32_t lens[MAX_BURST];
+	void *data[MAX_BURST];
+	unsigned int i;
+
+	n = rte_ring_bytes_dequeue_peek(r, data, lens, n, &zc, NULL);
+	for (i = 0; i != n; i++)
+		*sum += *(volatile uint8_t *)data[i] + lens[i];
+	rte_ring_bytes_dequeue_release(r, &zc);
+	return n;
+}
+
+/* same as above with records copied into mempool objects */
+static __rte_always_inline unsigned int
+enqueue_objects(struct rte_ring *r, struct rte_mempool *mp, unsigned int len,
+	unsigned int n)
+{
+	void *objs[MAX_BURST];
+	unsigned int i;
+
+	if (rte_mempool_get_bulk(mp, objs, n) != 0)
+		return 0;
+	for (i = 0; i != n; i++)
+		memcpy(objs[i], src_rec, len);
+	if (rte_ring_enqueue_bulk(r, objs, n, NULL) == 0) {
+		rte_mempool_put_bulk(mp, objs, n);
+		return 0;
+	}
+	return n;
+}
+
+static __rte_always_inline unsigned int
+dequeue_objects(struct rte_ring *r, struct rte_mempool *mp, unsigned int n,
+	uint64_t *sum)
+{
+	void *objs[MAX_BURST];
+	unsigned int i;
+
+	n = rte_ring_dequeue_burst(r, objs, n, NULL);
+	for (i = 0; i != n; i++)
+		*sum += *(volatile uint8_t *)objs[i];
+	rte_mempool_put_bulk(mp, objs, n);
+	return n;
+}
+
+/*
+ * Test that does both enqueue and dequeue on a core, with the byte ring
+ * and with mempool objects, for every record size and burst.
+ */
+static int
+test_single_lcore(struct rte_ring *r, struct rte_ring *pr,
+	struct rte_mempool *mp)
+{
+	const unsigned int iterations = 1 << 20;
+	unsigned int sz, bsz, i, n;
+	uint64_t start, zc_cycles, obj_cycles, sum = 0;
+
+	for (sz = 0; sz < RTE_DIM(rec_sizes); sz++) {
+		for (bsz = 0; bsz < RTE_DIM(bulk_sizes); bsz++) {
+			n = bulk_sizes[bsz];
+
+			start = rte_rdtsc();
+			for (i = 0; i < iterations / n; i++) {
+				enqueue_records(r, rec_sizes[sz], n);
+				dequeue_records(r, n, &sum);
+			}
+			zc_cycles = rte_rdtsc() - start;
+
+			start = rte_rdtsc();
+			for (i = 0; i < iterations / n; i++) {
+				enqueue_objects(pr, mp, rec_sizes[sz], n);
+				dequeue_objects(pr, mp, n, &sum);
+			}
+			obj_cycles = rte_rdtsc() - start;
+
+			printf("record size %4uB bulk %2u: byte ring: %.2F, mempool objects: %.2F\n",
+				rec_sizes[sz], n,
+				(double)zc_cycles / (iterations / n * n),
+				(double)obj_cycles / (iterations / n * n));
+		}
+	}
+
+	RTE_SET_USED(sum);
+	return 0;
+}
+
+/*
+ * for the separate enqueue and dequeue threads they take in one param
+ * and return the cycles per record
+ */
+struct thread_params {
+	struct rte_ring *r;
+	unsigned int len;      /* input value, the record size */
+	unsigned int size;     /* input value, the burst size */
+	double cycles;         /* output value, the cycles per record */
+};
+
+static uint32_t lcore_count;
+static uint32_t synchro;
+static uint64_t queue_count[RTE_MAX_LCORE];
+
+static int
+enqueue_bulk(void *p)
+{
+	const unsigned int iterations = 1 << 20;
+	struct thread_params *params = p;
+	unsigned int i;
+	uint64_t start;
+
+	__atomic_fetch_add(&lcore_count, 1, __ATOMIC_RELAXED);
+	rte_wait_until_equal_32(&lcore_count, 2, __ATOMIC_RELAXED);
+
+	start = rte_rdtsc();
+	for (i = 0; i < iterations; i += params->size)
+		while (enqueue_records(params->r, params->len,
+				params->size) == 0)
+			rte_pause();
+	params->cycles = (double)(rte_rdtsc() - start) / i;
+	return 0;
+}
+
+static int
+dequeue_bulk(void *p)
+{
+	const unsigned int iterations = 1 << 20;
+	struct thread_params *params = p;
+	unsigned int i, n;
+	uint64_t start, sum = 0;
+
+	__atomic_fetch_add(&lcore_count, 1, __ATOMIC_RELAXED);
+	rte_wait_until_equal_32(&lcore_count, 2, __ATOMIC_RELAXED);
+
+	start = rte_rdtsc();
+	for (i = 0; i < iterations; i += n) {
+		n = dequeue_records(params->r, params->size, &sum);
+		if (n == 0)
+			rte_pause();
+	}
+	params->cycles = (double)(rte_rdtsc() - start) / i;
+
+	RTE_SET_USED(sum);
+	return 0;
+}
+
+/*
+ * Function that calls the enqueue and dequeue bulk functions on a pair
+ * of cores, to measure the byte ring between a producer and a consumer.
+ */
+static int
+run_on_core_pair(struct lcore_pair *cores, struct rte_ring *r)
+{
+	struct thread_params param1 = {0}, param2 = {0};
+	unsigned int sz, bsz;
+
+	for (sz = 0; sz < RTE_DIM(rec_sizes); sz++) {
+		for (bsz = 0; bsz < RTE_DIM(bulk_sizes); bsz++) {
+			__atomic_store_n(&lcore_count, 0, __ATOMIC_RELAXED);
+			param1.r = param2.r = r;
+			param1.len = param2.len = rec_sizes[sz];
+			param1.size = param2.size = bulk_sizes[bsz];
+			if (cores->c1 == rte_get_main_lcore()) {
+				rte_eal_remote_launch(dequeue_bulk, &param2,
+					cores->c2);
+				enqueue_bulk(&param1);
+				rte_eal_wait_lcore(cores->c2);
+			} else {
+				rte_eal_remote_launch(enqueue_bulk, &param1,
+					cores->c1);
+				rte_eal_remote_launch(dequeue_bulk, &param2,
+					cores->c2);
+				if (rte_eal_wait_lcore(cores->c1) < 0)
+					return -1;
+				if (rte_eal_wait_lcore(cores->c2) < 0)
+					return -1;
+			}
+			printf("record size %4uB bulk %2u: SP/SC: %.2F\n",
+				rec_sizes[sz], bulk_sizes[bsz],
+				param1.cycles + param2.cycles);
+		}
+	}
+
+	return 0;
+}
+
+/* producer of the MPSC test, enqueues records until the consumer stops */
+static int
+load_loop_fn(void *p)
+{
+	struct thread_params *params = p;
+	const unsigned int lcore = rte_lcore_id();
+	uint64_t lcount = 0;
+
+	rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+
+	while (__atomic_load_n(&synchro, __ATOMIC_RELAXED) == 1)
+		lcount += enqueue_records(params->r, params->len,
+			params->size);
+	queue_count[lcore] = lcount;
+
+	return 0;
+}
+
+/*
+ * Every worker enqueues records for TIME_MS while the main lcore
+ * dequeues them, for each multi-producer sync mode.
+ */
+static int
+run_mpsc_on_all_cores(void)
+{
+	static const struct {
+		const char *name;
+		unsigned int flags;
+	} modes[] = {
+		{ "MP/SC", RING_F_SC_DEQ },
+		{ "MP_RTS/SC", RING_F_MP_RTS_ENQ | RING_F_SC_DEQ },
+		{ "MP_HTS/SC", RING_F_MP_HTS_ENQ | RING_F_SC_DEQ },
+	};
+	const uint64_t hz = rte_get_timer_hz();
+	struct thread_params param = {0};
+	uint64_t begin, total, sum = 0;
+	unsigned int i, c;
+
+	for (i = 0; i < RTE_DIM(modes); i++) {
+		param.r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+			rte_socket_id(), modes[i].flags);
+		if (param.r == NULL)
+			return -1;
+		param.len = 256;
+		param.size = 8;
+
+		/* clear synchro and start workers */
+		__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+		if (rte_eal_mp_remote_launch(load_loop_fn, &param,
+				SKIP_MAIN) < 0) {
+			rte_ring_free(param.r);
+			return -1;
+		}
+
+		/* start synchro and consume on main */
+		__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+		begin = rte_get_timer_cycles();
+		while (rte_get_timer_cycles() - begin < hz * TIME_MS / 1000)
+			dequeue_records(param.r, MAX_BURST, &sum);
+		__atomic_store_n(&synchro, 2, __ATOMIC_RELAXED);
+
+		rte_eal_mp_wait_lcore();
+
+		total = 0;
+		RTE_LCORE_FOREACH_WORKER(c)
+			total += queue_count[c];
+		printf("%s, %u producers, record size %uB bulk %u: %.2F Mrecords/s\n",
+			modes[i].name, rte_lcore_count() - 1, param.len,
+			param.size, (double)total * 1000 / TIME_MS / 1E6);
+
+		rte_ring_free(param.r);
+	}
+
+	RTE_SET_USED(sum);
+	return 0;
+}
+
+static int
+test_ring_bytes_perf(void)
+{
+	struct rte_ring *r = NULL, *pr = NULL;
+	struct rte_mempool *mp = NULL;
+	struct lcore_pair cores;
+	int ret = -1;
+
+	r = rte_ring_bytes_create(RING_NAME, RING_SIZE, REC_MAX,
+		rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+	pr = rte_ring_create("RING_BYTES_PERF_OBJ", POOL_SIZE,
+		rte_socket_id(), RING_F_SP_ENQ | RING_F_SC_DEQ);
+	mp = rte_mempool_create("RING_BYTES_PERF_POOL", POOL_SIZE, REC_MAX,
+		0, 0, NULL, NULL, NULL, NULL, rte_socket_id(), 0);
+	if (r == NULL || pr == NULL || mp == NULL) {
+		printf("Cannot create rings or mempool\n");
+		goto exit;
+	}
+
+	printf("\n### Testing enq/deq on a single lcore (cycles per record) ###\n");
+	if (test_single_lcore(r, pr, mp) < 0)
+		goto exit;
+
+	if (get_two_cores(&cores) == 0) {
+		printf("\n### Testing using two physical cores (cycles per record) ###\n");
+		if (run_on_core_pair(&cores, r) < 0)
+			goto exit;
+	}
+
+	if (rte_lcore_count() > 1) {
+		printf("\n### Testing MPSC using all worker lcores ###\n");
+		if (run_mpsc_on_all_cores() < 0)
+			goto exit;
+	}
+
+	ret = 0;
+exit:
+	rte_ring_free(r);
+	rte_ring_free(pr);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(ring_bytes_perf_autotest, test_ring_bytes_perf);
@@ -1013,6 +1013,148 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+/* services with a skewed load, in percent of a core */
+#define BALANCE_NB_SERVICES 4
+#define BALANCE_PERIOD_US 20000
+#define BALANCE_WORK_US 100
+
+struct balance_service {
+	uint32_t load;
+	uint64_t next; /* TSC of the next work item */
+	uint32_t active; /* set while the service runs */
+	uint32_t concurrent; /* set if the service ran concurrently */
+};
+
+static struct balance_service balance_services[BALANCE_NB_SERVICES] = {
+	{ .load = 40 }, { .load = 30 }, { .load = 20 }, { .load = 10 },
+};
+
+static int32_t
+balance_service_cb(void *args)
+{
+	struct balance_service *bs = args;
+	const uint64_t work = rte_get_tsc_hz() * BALANCE_WORK_US / US_PER_S;
+	uint64_t now = rte_rdtsc();
+
+	if (now < bs->next)
+		return -EAGAIN;
+
+	/* the services are not MT safe, moving them must not break it */
+	if (__atomic_exchange_n(&bs->active, 1, __ATOMIC_ACQUIRE) != 0)
+		__atomic_store_n(&bs->concurrent, 1, __ATOMIC_RELAXED);
+
+	while (rte_rdtsc() < now + work)
+		rte_pause();
+
+	/* schedule the next work item to get the expected load,
+	 * without catching up the work items missed
+	 */
+	bs->next += work * 100 / bs->load;
+	if (bs->next < now)
+		bs->next = now;
+
+	__atomic_store_n(&bs->active, 0, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/* check services are balanced across two service lcores */
+static int
+service_lcore_balance(void)
+{
+	uint64_t before[2], after[2], load[2];
+	uint32_t ids[BALANCE_NB_SERVICES];
+	struct rte_service_spec service;
+	uint32_t lcores[2];
+	uint32_t i, j;
+
+	if (rte_lcore_count() < 3)
+		return TEST_SKIPPED;
+
+	lcores[0] = rte_get_next_lcore(/* start core */ -1,
+				       /* skip main */ 1,
+				       /* wrap */ 0);
+	lcores[1] = rte_get_next_lcore(/* start core */ lcores[0],
+				       /* skip main */ 1,
+				       /* wrap */ 0);
+
+	/* all the services start on the first service lcore */
+	memset(&service, 0, sizeof(service));
+	service.callback = balance_service_cb;
+	for (i = 0; i < BALANCE_NB_SERVICES; i++) {
+		balance_services[i].next = 0;
+		balance_services[i].concurrent = 0;
+		snprintf(service.name, sizeof(service.name),
+			 "balance_service_%u", i);
+		service.callback_userdata = &balance_services[i];
+		TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+				&ids[i]), "Failed to register service");
+		rte_service_component_runstate_set(ids[i], 1);
+		rte_service_set_stats_enable(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 1),
+				"Starting valid service failed");
+	}
+
+	for (j = 0; j < 2; j++)
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_add(lcores[j]),
+				"Add service core failed");
+	for (i = 0; i < BALANCE_NB_SERVICES; i++)
+		TEST_ASSERT_EQUAL(0,
+			rte_service_map_lcore_set(ids[i], lcores[0], 1),
+			"Enabling valid service on valid core failed");
+	for (j = 0; j < 2; j++)
+		TEST_ASSERT_EQUAL(0, rte_service_lcore_start(lcores[j]),
+				"Service core start failed");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_balance_set(BALANCE_PERIOD_US),
+			"Enabling service balancing failed");
+
+	/* let the balancing settle, then measure the load of the lcores */
+	rte_delay_ms(500);
+	for (j = 0; j < 2; j++)
+		rte_service_lcore_attr_get(lcores[j],
+			RTE_SERVICE_LCORE_ATTR_CYCLES, &before[j]);
+	rte_delay_ms(200);
+	for (j = 0; j < 2; j++)
+		rte_service_lcore_attr_get(lcores[j],
+			RTE_SERVICE_LCORE_ATTR_CYCLES, &after[j]);
+
+	rte_service_lcore_balance_set(0);
+	for (j = 0; j < 2; j++) {
+		load[j] = (after[j] - before[j]) * 100 /
+			(rte_get_tsc_hz() / 5);
+		printf("Service lcore %u: %d services, %"PRIu64"%% load\n",
+			lcores[j], rte_service_lcore_count_services(lcores[j]),
+			load[j]);
+	}
+
+	for (i = 0; i < BALANCE_NB_SERVICES; i++) {
+		rte_service_runstate_set(ids[i], 0);
+		TEST_ASSERT_EQUAL(0, service_ensure_stopped_with_timeout(ids[i]),
+				"Service not stopped after timeout period");
+	}
+	for (j = 0; j < 2; j++) {
+		rte_service_lcore_stop(lcores[j]);
+		wait_slcore_inactive(lcores[j]);
+	}
+
+	for (i = 0; i < BALANCE_NB_SERVICES; i++)
+		TEST_ASSERT_EQUAL(0, balance_services[i].concurrent,
+				"Service not MT safe run concurrently");
+	TEST_ASSERT(load[0] + load[1] > 0, "Services did not run");
+	for (j = 0; j < 2; j++)
+		TEST_ASSERT(load[j] * 100 >= (load[0] + load[1]) * 30 &&
+			    load[j] * 100 <= (load[0] + load[1]) * 70,
+			    "Service lcore loads not balanced");
+
+	for (i = 0; i < BALANCE_NB_SERVICES; i++)
+		rte_service_component_unregister(ids[i]);
+	rte_service_lcore_reset_all();
+	rte_eal_mp_wait_lcore();
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1030,6 +1172,7 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_poll),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE(service_lcore_balance),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -7,6 +7,9 @@
 #include <rte_ip.h>
 #include <rte_random.h>
 #include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_tcp.h>
 
 #include "test.h"
 
@@ -804,6 +807,128 @@ test_adjust_tuple(void)
 	return TEST_SUCCESS;
 }
 
+#define MBUF_TEST_POOL_SZ	63
+
+/* Build TCP packets matching the verification suite entries */
+static int
+thash_mbuf_fill(struct rte_mempool *mp, struct rte_mbuf **pkts)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	unsigned int i, n = 0;
+
+	for (i = 0; i < RTE_DIM(v4_tbl); i++, n++) {
+		pkts[n] = rte_pktmbuf_alloc(mp);
+		if (pkts[n] == NULL)
+			return -1;
+		eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(pkts[n],
+			sizeof(*eth_hdr) + sizeof(*ipv4_hdr) + sizeof(*tcp_hdr));
+		memset(eth_hdr, 0, pkts[n]->data_len);
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->next_proto_id = IPPROTO_TCP;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(v4_tbl[i].src_ip);
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(v4_tbl[i].dst_ip);
+		tcp_hdr = (struct rte_tcp_hdr *)(ipv4_hdr + 1);
+		tcp_hdr->src_port = rte_cpu_to_be_16(v4_tbl[i].src_port);
+		tcp_hdr->dst_port = rte_cpu_to_be_16(v4_tbl[i].dst_port);
+		tcp_hdr->data_off = sizeof(*tcp_hdr) << 2;
+	}
+
+	for (i = 0; i < RTE_DIM(v6_tbl); i++, n++) {
+		pkts[n] = rte_pktmbuf_alloc(mp);
+		if (pkts[n] == NULL)
+			return -1;
+		eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(pkts[n],
+			sizeof(*eth_hdr) + sizeof(*ipv6_hdr) + sizeof(*tcp_hdr));
+		memset(eth_hdr, 0, pkts[n]->data_len);
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+		ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ipv6_hdr->proto = IPPROTO_TCP;
+		memcpy(ipv6_hdr->src_addr, v6_tbl[i].src_ip,
+			sizeof(ipv6_hdr->src_addr));
+		memcpy(ipv6_hdr->dst_addr, v6_tbl[i].dst_ip,
+			sizeof(ipv6_hdr->dst_addr));
+		tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
+		tcp_hdr->src_port = rte_cpu_to_be_16(v6_tbl[i].src_port);
+		tcp_hdr->dst_port = rte_cpu_to_be_16(v6_tbl[i].dst_port);
+		tcp_hdr->data_off = sizeof(*tcp_hdr) << 2;
+	}
+
+	/* Non IP packet */
+	pkts[n] = rte_pktmbuf_alloc(mp);
+	if (pkts[n] == NULL)
+		return -1;
+	eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(pkts[n], 64);
+	memset(eth_hdr, 0, 64);
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_ARP);
+
+	return n + 1;
+}
+
+static int
+test_thash_mbuf_bulk(void)
+{
+	struct rte_mbuf *pkts[RTE_DIM(v4_tbl) + RTE_DIM(v6_tbl) + 1] = {0};
+	struct rte_thash_ctx *ctx;
+	struct rte_mempool *mp;
+	unsigned int i, nb_v4 = RTE_DIM(v4_tbl);
+	int nb_pkts, ret = -TEST_FAILED;
+
+	ctx = rte_thash_init_ctx("test", RTE_DIM(default_rss_key), 7,
+		default_rss_key, 0);
+	RTE_TEST_ASSERT(ctx != NULL, "Can not create CTX\n");
+
+	mp = rte_pktmbuf_pool_create("thash_mbuf_pool", MBUF_TEST_POOL_SZ, 0,
+		0, RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Can not create mbuf pool\n");
+		goto free_ctx;
+	}
+
+	nb_pkts = thash_mbuf_fill(mp, pkts);
+	if (nb_pkts < 0) {
+		printf("Can not allocate mbufs\n");
+		goto free_pkts;
+	}
+
+	if (rte_thash_mbuf_bulk(ctx, pkts, nb_pkts, 0) != nb_pkts - 1)
+		goto free_pkts;
+	for (i = 0; i < (unsigned int)nb_pkts - 1; i++) {
+		if (pkts[i]->hash.rss != ((i < nb_v4) ? v4_tbl[i].hash_l3 :
+				v6_tbl[i - nb_v4].hash_l3) ||
+				!(pkts[i]->ol_flags & RTE_MBUF_F_RX_RSS_HASH))
+			goto free_pkts;
+	}
+
+	if (rte_thash_mbuf_bulk(ctx, pkts, nb_pkts, RTE_THASH_MBUF_L4) !=
+			nb_pkts - 1)
+		goto free_pkts;
+	for (i = 0; i < (unsigned int)nb_pkts - 1; i++) {
+		if (pkts[i]->hash.rss != ((i < nb_v4) ? v4_tbl[i].hash_l3l4 :
+				v6_tbl[i - nb_v4].hash_l3l4))
+			goto free_pkts;
+	}
+
+	if (pkts[nb_pkts - 1]->ol_flags & RTE_MBUF_F_RX_RSS_HASH)
+		goto free_pkts;
+
+	ret = TEST_SUCCESS;
+
+free_pkts:
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		rte_pktmbuf_free(pkts[i]);
+	rte_mempool_free(mp);
+free_ctx:
+	rte_thash_free_ctx(ctx);
+
+	return ret;
+}
+
 static struct unit_test_suite thash_tests = {
 	.suite_name = "thash autotest",
 	.setup = NULL,
@@ -824,6 +949,7 @@ static struct unit_test_suite thash_tests = {
 	TEST_CASE(test_predictable_rss_min_seq),
 	TEST_CASE(test_predictable_rss_multirange),
 	TEST_CASE(test_adjust_tuple),
+	TEST_CASE(test_thash_mbuf_bulk),
 	TEST_CASES_END()
 	}
 };
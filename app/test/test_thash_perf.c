@@ -8,8 +8,11 @@
 #include <math.h>
 
 #include <rte_cycles.h>
+#include <rte_ether.h>
 #include <rte_malloc.h>
+#include <rte_mbuf.h>
 #include <rte_random.h>
+#include <rte_tcp.h>
 #include <rte_thash.h>
 
 #include "test.h"
@@ -84,6 +87,102 @@ run_rss_calc_bulk(uint32_t *tuples[BATCH_SZ], int len, const void *key)
 	return end_tsc - start_tsc;
 }
 
+/* Fill TCP packets with random addresses and ports */
+static void
+fill_mbufs(struct rte_mbuf *pkts[BATCH_SZ], int ipv6)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint32_t l3_len, i, j;
+
+	l3_len = ipv6 ? sizeof(*ipv6_hdr) : sizeof(*ipv4_hdr);
+	for (i = 0; i < BATCH_SZ; i++) {
+		rte_pktmbuf_reset(pkts[i]);
+		eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(pkts[i],
+			sizeof(*eth_hdr) + l3_len + sizeof(*tcp_hdr));
+		memset(eth_hdr, 0, pkts[i]->data_len);
+		if (ipv6) {
+			eth_hdr->ether_type =
+				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+			ipv6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+			ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+			ipv6_hdr->proto = IPPROTO_TCP;
+			for (j = 0; j < sizeof(ipv6_hdr->src_addr); j++) {
+				ipv6_hdr->src_addr[j] = rte_rand();
+				ipv6_hdr->dst_addr[j] = rte_rand();
+			}
+		} else {
+			eth_hdr->ether_type =
+				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+			ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+			ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+			ipv4_hdr->next_proto_id = IPPROTO_TCP;
+			ipv4_hdr->src_addr = rte_rand();
+			ipv4_hdr->dst_addr = rte_rand();
+		}
+		tcp_hdr = rte_pktmbuf_mtod_offset(pkts[i], struct rte_tcp_hdr *,
+			sizeof(*eth_hdr) + l3_len);
+		tcp_hdr->src_port = rte_rand();
+		tcp_hdr->dst_port = rte_rand();
+		tcp_hdr->data_off = sizeof(*tcp_hdr) << 2;
+	}
+}
+
+static inline uint64_t
+run_rss_calc_mbuf(struct rte_thash_ctx *ctx, struct rte_mbuf *pkts[BATCH_SZ],
+	uint32_t flags)
+{
+	int i;
+	uint64_t start_tsc, end_tsc;
+
+	start_tsc = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++)
+		rte_thash_mbuf_bulk(ctx, pkts, BATCH_SZ, flags);
+	end_tsc = rte_rdtsc_precise();
+
+	return end_tsc - start_tsc;
+}
+
+/* Hash whole packets, including the extraction of the tuple */
+static void
+run_thash_mbuf_test(unsigned int tuple_len)
+{
+	struct rte_mbuf *pkts[BATCH_SZ];
+	struct rte_thash_ctx *ctx;
+	struct rte_mempool *mp;
+	uint64_t tsc_diff;
+	int ipv6 = (tuple_len >= IPV6_2_TUPLE_LEN);
+	uint32_t flags = (tuple_len == IPV4_4_TUPLE_LEN ||
+		tuple_len == IPV6_4_TUPLE_LEN) ? RTE_THASH_MBUF_L4 : 0;
+
+	ctx = rte_thash_init_ctx("thash_perf", RTE_DIM(default_rss_key), 7,
+		(uint8_t *)(uintptr_t)default_rss_key, 0);
+	if (ctx == NULL)
+		return;
+
+	mp = rte_pktmbuf_pool_create("thash_perf_pool", BATCH_SZ, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL)
+		goto free_ctx;
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, BATCH_SZ) != 0)
+		goto free_mp;
+
+	fill_mbufs(pkts, ipv6);
+
+	tsc_diff = run_rss_calc_mbuf(ctx, pkts, flags);
+	printf("Average rte_thash_mbuf_bulk takes \t%.1f cycles for key len %d\n",
+		(double)(tsc_diff) / (double)(ITERATIONS * BATCH_SZ), tuple_len);
+
+	rte_pktmbuf_free_bulk(pkts, BATCH_SZ);
+free_mp:
+	rte_mempool_free(mp);
+free_ctx:
+	rte_thash_free_ctx(ctx);
+}
+
 static void
 run_thash_test(unsigned int tuple_len)
 {
@@ -107,6 +206,8 @@ run_thash_test(unsigned int tuple_len)
 	printf("Average rte_softrss_be() takes \t\t%.1f cycles for key len %d\n",
 		(double)(tsc_diff) / (double)(ITERATIONS * BATCH_SZ), len);
 
+	run_thash_mbuf_test(tuple_len);
+
 	if (!rte_thash_gfni_supported())
 		return;
 
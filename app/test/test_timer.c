@@ -83,6 +83,19 @@
  *      - At initialization, timer3 is loaded by the main core, on
  *        another core in "periodical" mode (time = 1 second).
  *      - It is stopped at t=25s by timer2.
+ *
+ * #. Timing wheel test.
+ *
+ *    This test checks the timing wheel backend of a timer data instance on
+ *    the main lcore.
+ *
+ *    - One-shot timers are loaded with delays spread over one second, and
+ *      every other timer is stopped.
+ *    - rte_timer_alt_manage() is called until all delays have elapsed, and
+ *      we check that each remaining timer ran exactly once, not before its
+ *      expiry time, and that the stopped timers did not run.
+ *    - A periodical timer is then loaded and stopped with
+ *      rte_timer_stop_all() after running several times.
  */
 
 #include <stdio.h>
@@ -109,6 +122,7 @@
 
 #define TEST_DURATION_S 1 /* in seconds */
 #define NB_TIMER 4
+#define NB_WHEEL_TIMER 256
 
 #define RTE_LOGTYPE_TESTTIMER RTE_LOGTYPE_USER3
 
@@ -527,6 +541,96 @@ timer_sanity_check(void)
 	return 0;
 }
 
+static struct rte_timer wheel_tim[NB_WHEEL_TIMER];
+static unsigned int wheel_count[NB_WHEEL_TIMER];
+
+/* timer callback for timing wheel test */
+static void
+timer_wheel_cb(struct rte_timer *tim)
+{
+	unsigned int i = tim - wheel_tim;
+
+	if (rte_get_timer_cycles() < tim->expire) {
+		printf("%s: timer %u expired too early\n", __func__, i);
+		test_failed = 1;
+	}
+	wheel_count[i]++;
+}
+
+static void
+timer_wheel_manage(uint32_t timer_data_id, uint64_t duration)
+{
+	uint64_t end = rte_get_timer_cycles() + duration;
+
+	while (rte_get_timer_cycles() < end)
+		rte_timer_alt_manage(timer_data_id, NULL, 0, timer_wheel_cb);
+}
+
+static int
+timer_wheel_test(void)
+{
+	struct rte_timer_data_conf conf;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint32_t timer_data_id;
+	unsigned int i;
+	int ret;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.backend = RTE_TIMER_BACKEND_WHEEL + 1;
+	ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+	if (ret != -EINVAL) {
+		printf("%s: invalid backend accepted\n", __func__);
+		return -1;
+	}
+
+	conf.backend = RTE_TIMER_BACKEND_WHEEL;
+	conf.wheel_resolution = hz / MS_PER_S;
+	ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+	if (ret != 0) {
+		printf("%s: cannot allocate timer data (%d)\n", __func__, ret);
+		return -1;
+	}
+
+	test_failed = 0;
+	memset(wheel_count, 0, sizeof(wheel_count));
+	for (i = 0; i < NB_WHEEL_TIMER; i++) {
+		rte_timer_init(&wheel_tim[i]);
+		rte_timer_alt_reset(timer_data_id, &wheel_tim[i],
+			hz * i / NB_WHEEL_TIMER, SINGLE, lcore_id, NULL, NULL);
+	}
+	for (i = 1; i < NB_WHEEL_TIMER; i += 2)
+		rte_timer_alt_stop(timer_data_id, &wheel_tim[i]);
+
+	timer_wheel_manage(timer_data_id, hz + hz / 10);
+
+	for (i = 0; i < NB_WHEEL_TIMER; i++) {
+		if (wheel_count[i] != !(i & 1) ||
+				rte_timer_pending(&wheel_tim[i])) {
+			printf("%s: timer %u ran %u times\n", __func__, i,
+				wheel_count[i]);
+			test_failed = 1;
+		}
+	}
+
+	/* periodical timer every 10 ms for 200 ms */
+	wheel_count[0] = 0;
+	rte_timer_alt_reset(timer_data_id, &wheel_tim[0], hz / 100,
+		PERIODICAL, lcore_id, NULL, NULL);
+	timer_wheel_manage(timer_data_id, hz / 5);
+	rte_timer_stop_all(timer_data_id, &lcore_id, 1, NULL, NULL);
+	if (wheel_count[0] < 10 || wheel_count[0] > 20 ||
+			rte_timer_pending(&wheel_tim[0])) {
+		printf("%s: periodical timer ran %u times\n", __func__,
+			wheel_count[0]);
+		test_failed = 1;
+	}
+
+	rte_timer_data_dealloc(timer_data_id);
+
+	return test_failed ? -1 : 0;
+}
+
 static int
 test_timer(void)
 {
@@ -591,6 +695,10 @@ test_timer(void)
 
 	rte_timer_dump_stats(stdout);
 
+	printf("\nStart timer wheel tests\n");
+	if (timer_wheel_test() < 0)
+		return TEST_FAILED;
+
 	return TEST_SUCCESS;
 }
 
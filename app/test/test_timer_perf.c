@@ -16,6 +16,7 @@
 #include <rte_pause.h>
 
 #define MAX_ITERATIONS 1000000
+#define MAX_COMPARE_TIMERS 10000000
 
 int outstanding_count = 0;
 
@@ -33,6 +34,114 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+static uint64_t expired_count;
+
+static void
+timer_alt_cb(struct rte_timer *t __rte_unused)
+{
+	expired_count++;
+}
+
+/*
+ * Measure the reset, stop and expiry costs of n timers with random delays
+ * of up to one second, on a given timer data instance.
+ */
+static int
+timer_perf_alt(uint32_t timer_data_id, const char *name,
+	       struct rte_timer *tms, unsigned int n)
+{
+	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t start_tsc, end_tsc, delay_start;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		rte_timer_init(&tms[i]);
+	expired_count = 0;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(timer_data_id, &tms[i], rte_rand() % ticks,
+				    SINGLE, lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	printf("%s: cycles per reset: %"PRIu64", ", name,
+			(end_tsc - start_tsc) / n);
+
+	/* move the pending timers to new random delays */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(timer_data_id, &tms[i], rte_rand() % ticks,
+				    SINGLE, lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	printf("per re-reset: %"PRIu64", ", (end_tsc - start_tsc) / n);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i += 2)
+		rte_timer_alt_stop(timer_data_id, &tms[i]);
+	end_tsc = rte_rdtsc();
+	printf("per stop: %"PRIu64", ", (end_tsc - start_tsc) / (n / 2));
+
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	rte_timer_alt_manage(timer_data_id, NULL, 0, timer_alt_cb);
+	end_tsc = rte_rdtsc();
+	printf("per expiry: %"PRIu64"\n", (end_tsc - start_tsc) / (n / 2));
+
+	if (expired_count != n / 2) {
+		printf("Error: %"PRIu64" expired timers, expected %u\n",
+				expired_count, n / 2);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* compare the skiplist and the timing wheel with many pending timers */
+static int
+test_timer_perf_backends(void)
+{
+	struct rte_timer_data_conf conf = {
+		.backend = RTE_TIMER_BACKEND_WHEEL,
+	};
+	struct rte_timer *tms;
+	uint32_t timer_data_id;
+	unsigned int n;
+	int ret = 0;
+
+	for (n = MAX_ITERATIONS; n <= MAX_COMPARE_TIMERS; n *= 10) {
+		tms = rte_malloc(NULL, sizeof(*tms) * n, 0);
+		if (tms == NULL) {
+			printf("Not enough memory for %u timers, skipped\n", n);
+			break;
+		}
+		printf("\nComparing timer backends with %u timers\n", n);
+
+		if (rte_timer_data_alloc(&timer_data_id) != 0) {
+			rte_free(tms);
+			return -1;
+		}
+		ret = timer_perf_alt(timer_data_id, "skiplist", tms, n);
+		rte_timer_data_dealloc(timer_data_id);
+		if (ret != 0)
+			break;
+
+		if (rte_timer_data_alloc_conf(&timer_data_id, &conf) != 0) {
+			rte_free(tms);
+			return -1;
+		}
+		ret = timer_perf_alt(timer_data_id, "wheel", tms, n);
+		rte_timer_data_dealloc(timer_data_id);
+		rte_free(tms);
+		if (ret != 0)
+			break;
+	}
+
+	return ret;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -128,7 +237,8 @@ test_timer_perf(void)
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	rte_free(tms);
-	return 0;
+
+	return test_timer_perf_backends();
 }
 
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
@@ -2,12 +2,15 @@
  * Copyright(C) 2020 Marvell International Ltd.
  */
 
+#include <inttypes.h>
+
 #include <rte_cycles.h>
 #include <rte_debug.h>
 #include <rte_eal.h>
 #include <rte_eal_trace.h>
 #include <rte_malloc.h>
 #include <rte_lcore.h>
+#include <rte_trace.h>
 
 #include "test.h"
 #include "test_trace.h"
@@ -127,6 +130,10 @@ static void
 run_test(const char *str, lcore_function_t f, struct test_data *data, size_t sz)
 {
 	unsigned int id, worker = 0;
+	uint64_t lost = 0;
+
+	if (rte_trace_stream_is_enabled())
+		lost = rte_trace_stream_lost_get();
 
 	memset(data, 0, sz);
 	data->nb_workers = rte_lcore_count() - 1;
@@ -141,6 +148,11 @@ run_test(const char *str, lcore_function_t f, struct test_data *data, size_t sz)
 		rte_eal_wait_lcore(id);
 
 	measure_perf(str, data);
+
+	/* Events dropped as the stream could not keep up */
+	if (rte_trace_stream_is_enabled())
+		printf("%16s  stream lost=%"PRIu64"\n", "",
+			rte_trace_stream_lost_get() - lost);
 }
 
 static int
@@ -158,6 +170,8 @@ test_trace_perf(void)
 	}
 
 	printf("Timer running at %5.2fMHz\n", rte_get_timer_hz()/1E6);
+	if (rte_trace_stream_is_enabled())
+		printf("Trace buffers are streamed\n");
 	sz = sizeof(struct test_data);
 	sz += nb_workers * sizeof(struct lcore_data);
 
@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdio.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+/*
+ * The objects of the pool are spread over stripes, one per lcore,
+ * each stripe being a lock-free MP/MC ring allocated on the socket
+ * of its lcore.
+ * An lcore puts objects in its own stripe and gets objects from it,
+ * stealing from the next stripes when it is empty, and spilling to
+ * them when it is full.
+ * As long as each lcore allocates about as much as it frees,
+ * the lcores do not access the same ring.
+ */
+struct shard_pool {
+	unsigned int nb_stripes;	/**< Number of stripes */
+	struct rte_ring *stripes[];	/**< Stripe of each lcore index */
+};
+
+/* stripe of the running lcore, stripe 0 for unregistered threads */
+static inline unsigned int
+shard_stripe(const struct shard_pool *sp)
+{
+	int idx = rte_lcore_index(-1);
+
+	if (unlikely(idx < 0))
+		return 0;
+	return (unsigned int)idx % sp->nb_stripes;
+}
+
+static unsigned int
+shard_put(struct shard_pool *sp, unsigned int first,
+	void * const *obj_table, unsigned int n)
+{
+	unsigned int i, s, done = 0;
+
+	/* spill to the next stripes when the stripe is full */
+	for (i = 0, s = first; i < sp->nb_stripes && done < n; i++) {
+		done += rte_ring_mp_enqueue_burst(sp->stripes[s],
+			&obj_table[done], n - done, NULL);
+		if (++s == sp->nb_stripes)
+			s = 0;
+	}
+	return done;
+}
+
+static int
+shard_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	unsigned int n)
+{
+	struct shard_pool *sp = mp->pool_data;
+
+	/*
+	 * The stripes can hold twice the pool size altogether,
+	 * so there is always room for the objects of the pool.
+	 */
+	return shard_put(sp, shard_stripe(sp), obj_table, n) < n ?
+		-ENOBUFS : 0;
+}
+
+static int
+shard_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct shard_pool *sp = mp->pool_data;
+	unsigned int first = shard_stripe(sp);
+	unsigned int i, s, done = 0;
+
+	/* steal from the next stripes when the stripe is empty */
+	for (i = 0, s = first; i < sp->nb_stripes && done < n; i++) {
+		done += rte_ring_mc_dequeue_burst(sp->stripes[s],
+			&obj_table[done], n - done, NULL);
+		if (++s == sp->nb_stripes)
+			s = 0;
+	}
+
+	if (unlikely(done < n)) {
+		/* not enough objects, give back the ones taken */
+		if (done != 0)
+			shard_put(sp, first, obj_table, done);
+		return -ENOBUFS;
+	}
+	return 0;
+}
+
+static unsigned int
+shard_get_count(const struct rte_mempool *mp)
+{
+	const struct shard_pool *sp = mp->pool_data;
+	unsigned int i, count = 0;
+
+	for (i = 0; i < sp->nb_stripes; i++)
+		count += rte_ring_count(sp->stripes[i]);
+	return count;
+}
+
+static void
+shard_free(struct rte_mempool *mp)
+{
+	struct shard_pool *sp = mp->pool_data;
+	unsigned int i;
+
+	if (sp == NULL)
+		return;
+
+	for (i = 0; i < sp->nb_stripes; i++)
+		rte_free(sp->stripes[i]);
+	rte_free(sp);
+	mp->pool_data = NULL;
+}
+
+/* socket of the lcore of a stripe */
+static int
+shard_stripe_socket(const struct rte_mempool *mp, unsigned int stripe)
+{
+	unsigned int lcore_id;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_lcore_index(lcore_id) == (int)stripe)
+			return rte_lcore_to_socket_id(lcore_id);
+	}
+	return mp->socket_id;
+}
+
+static int
+shard_alloc(struct rte_mempool *mp)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct shard_pool *sp;
+	unsigned int i, nb_stripes, count;
+	ssize_t ring_size;
+	int socket_id, ret;
+
+	nb_stripes = rte_lcore_count();
+
+	sp = rte_zmalloc_socket("MEMPOOL_SHARD", sizeof(*sp) +
+		nb_stripes * sizeof(sp->stripes[0]), RTE_CACHE_LINE_SIZE,
+		mp->socket_id);
+	if (sp == NULL) {
+		rte_errno = ENOMEM;
+		return -rte_errno;
+	}
+	sp->nb_stripes = nb_stripes;
+	mp->pool_data = sp;
+
+	/* each stripe holds twice its share of the pool */
+	count = rte_align32pow2(2 * mp->size / nb_stripes + 1);
+	count = RTE_MAX(count, 2U);
+	ring_size = rte_ring_get_memsize(count);
+	if (ring_size < 0) {
+		rte_errno = -ring_size;
+		goto fail;
+	}
+
+	for (i = 0; i < nb_stripes; i++) {
+		/* stripe names are only informative, they may be truncated */
+		snprintf(name, sizeof(name), "%s_%u", mp->name, i);
+
+		socket_id = shard_stripe_socket(mp, i);
+		sp->stripes[i] = rte_zmalloc_socket(name, ring_size,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		if (sp->stripes[i] == NULL)
+			sp->stripes[i] = rte_zmalloc_socket(name, ring_size,
+				RTE_CACHE_LINE_SIZE, mp->socket_id);
+		if (sp->stripes[i] == NULL) {
+			rte_errno = ENOMEM;
+			goto fail;
+		}
+
+		ret = rte_ring_init(sp->stripes[i], name, count, 0);
+		if (ret < 0) {
+			rte_errno = -ret;
+			goto fail;
+		}
+	}
+
+	return 0;
+
+fail:
+	shard_free(mp);
+	return -rte_errno;
+}
+
+static const struct rte_mempool_ops ops_shard = {
+	.name = "shard",
+	.alloc = shard_alloc,
+	.free = shard_free,
+	.enqueue = shard_enqueue,
+	.dequeue = shard_dequeue,
+	.get_count = shard_get_count,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_shard);
@@ -8,12 +8,14 @@
 
 #include <rte_eal.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
 #include <rte_mempool.h>
+#include <rte_pause.h>
 #include <rte_ring.h>
 #include <rte_reorder.h>
 
@@ -35,11 +37,14 @@ enum {
 	OPT_DISABLE_REORDER_NUM = 256,
 #define OPT_INSIGHT_WORKER  "insight-worker"
 	OPT_INSIGHT_WORKER_NUM,
+#define OPT_MP_REORDER      "mp-reorder"
+	OPT_MP_REORDER_NUM,
 };
 
 unsigned int portmask;
 unsigned int disable_reorder;
 unsigned int insight_worker;
+unsigned int mp_reorder;
 volatile uint8_t quit_signal;
 
 static struct rte_mempool *mbuf_pool;
@@ -49,6 +54,8 @@ static struct rte_eth_conf port_conf_default;
 struct worker_thread_args {
 	struct rte_ring *ring_in;
 	struct rte_ring *ring_out;
+	/* multi-producer reorder buffer the workers insert into */
+	struct rte_reorder_buffer *buffer;
 };
 
 struct send_thread_args {
@@ -78,6 +85,9 @@ volatile struct app_stats {
 		uint64_t ro_tx_pkts;
 		uint64_t ro_tx_failed_pkts;
 	} tx __rte_cache_aligned;
+
+	uint64_t start_tsc;
+	uint64_t end_tsc;
 } app_stats;
 
 /* per worker lcore stats */
@@ -85,6 +95,7 @@ struct wkr_stats_per {
 		uint64_t deq_pkts;
 		uint64_t enq_pkts;
 		uint64_t enq_failed_pkts;
+		uint64_t ro_retry_pkts;
 } __rte_cache_aligned;
 
 static struct wkr_stats_per wkr_stats[RTE_MAX_LCORE] = { {0} };
@@ -138,7 +149,11 @@ static void
 print_usage(const char *prgname)
 {
 	printf("%s [EAL options] -- -p PORTMASK\n"
-			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n",
+			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n"
+			"  --disable-reorder: do not reorder packets\n"
+			"  --insight-worker: print statistics of each worker\n"
+			"  --mp-reorder: workers insert packets into the reorder\n"
+			"      buffer concurrently\n",
 			prgname);
 }
 
@@ -167,6 +182,7 @@ parse_args(int argc, char **argv)
 	static struct option lgopts[] = {
 		{OPT_DISABLE_REORDER, 0, NULL, OPT_DISABLE_REORDER_NUM},
 		{OPT_INSIGHT_WORKER,  0, NULL, OPT_INSIGHT_WORKER_NUM },
+		{OPT_MP_REORDER,      0, NULL, OPT_MP_REORDER_NUM     },
 		{NULL,                0, 0,    0                      }
 	};
 
@@ -196,6 +212,11 @@ parse_args(int argc, char **argv)
 			insight_worker = 1;
 			break;
 
+		case OPT_MP_REORDER_NUM:
+			printf("multi-producer reorder\n");
+			mp_reorder = 1;
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -374,6 +395,9 @@ print_stats(void)
 					wkr_stats[lcore_id].enq_pkts);
 			printf(" - Pkts enq to tx failed:		%"PRIu64"\n",
 					wkr_stats[lcore_id].enq_failed_pkts);
+			if (mp_reorder)
+				printf(" - Reorder insert retries:		%"PRIu64"\n",
+					wkr_stats[lcore_id].ro_retry_pkts);
 		}
 
 		app_stats.wkr.dequeue_pkts += wkr_stats[lcore_id].deq_pkts;
@@ -401,6 +425,10 @@ print_stats(void)
 						app_stats.tx.early_pkts_txtd_woro);
 	printf(" - Pkts tx failed w/o reorder:		%"PRIu64"\n",
 						app_stats.tx.early_pkts_tx_failed_woro);
+	if (app_stats.end_tsc > app_stats.start_tsc)
+		printf(" - Ro Pkts rate (Mpps):			%.2f\n",
+			(double)app_stats.tx.ro_tx_pkts * rte_get_tsc_hz() /
+			(app_stats.end_tsc - app_stats.start_tsc) / 1e6);
 
 	RTE_ETH_FOREACH_DEV(i) {
 		rte_eth_stats_get(i, &eth_stats);
@@ -473,10 +501,37 @@ rx_thread(struct rte_ring *ring_out)
 	return 0;
 }
 
+/**
+ * Insert the mbufs into the multi-producer reorder buffer, retrying the
+ * early ones until the send thread drains enough packets.
+ * The late mbufs are moved to the front of the array, to be transmitted
+ * without reordering, and their number is returned.
+ */
+static uint16_t
+worker_reorder_insert(struct rte_reorder_buffer *buffer,
+		struct rte_mbuf **mbufs, uint16_t nb_mbufs)
+{
+	unsigned int core_id = rte_lcore_id();
+	uint16_t i, nb_late = 0;
+
+	for (i = 0; i < nb_mbufs; i++) {
+		while (rte_reorder_insert(buffer, mbufs[i]) != 0) {
+			if (rte_errno == ERANGE || quit_signal) {
+				mbufs[nb_late++] = mbufs[i];
+				break;
+			}
+			wkr_stats[core_id].ro_retry_pkts++;
+			rte_pause();
+		}
+	}
+
+	return nb_late;
+}
+
 /**
  * This thread takes bursts of packets from the rx_to_workers ring and
  * Changes the input port value to output port value. And feds it to
- * workers_to_tx
+ * workers_to_tx, or inserts them into the reorder buffer with --mp-reorder
  */
 static int
 worker_thread(void *args_ptr)
@@ -511,6 +566,10 @@ worker_thread(void *args_ptr)
 		for (i = 0; i < burst_size;)
 			burst_buffer[i++]->port ^= xor_val;
 
+		if (args->buffer != NULL)
+			burst_size = worker_reorder_insert(args->buffer,
+					burst_buffer, burst_size);
+
 		/* enqueue the modified mbufs to workers_to_tx ring */
 		ret = rte_ring_enqueue_burst(ring_out, (void *)burst_buffer,
 				burst_size, NULL);
@@ -550,14 +609,23 @@ send_thread(struct send_thread_args *args)
 		nb_dq_mbufs = rte_ring_dequeue_burst(args->ring_in,
 				(void *)mbufs, MAX_PKTS_BURST, NULL);
 
-		if (unlikely(nb_dq_mbufs == 0))
+		/* the workers fill the buffer directly with --mp-reorder */
+		if (unlikely(nb_dq_mbufs == 0) && !mp_reorder)
 			continue;
 
 		app_stats.tx.dequeue_pkts += nb_dq_mbufs;
 
 		for (i = 0; i < nb_dq_mbufs; i++) {
-			/* send dequeued mbufs for reordering */
-			ret = rte_reorder_insert(args->buffer, mbufs[i]);
+			/*
+			 * send dequeued mbufs for reordering, the workers
+			 * already tried with --mp-reorder
+			 */
+			if (mp_reorder) {
+				ret = -1;
+				rte_errno = ERANGE;
+			} else {
+				ret = rte_reorder_insert(args->buffer, mbufs[i]);
+			}
 
 			if (ret == -1 && rte_errno == ERANGE) {
 				/* Too early pkts should be transmitted out directly */
@@ -666,7 +734,7 @@ main(int argc, char **argv)
 	unsigned int lcore_id, last_lcore_id, main_lcore_id;
 	uint16_t port_id;
 	uint16_t nb_ports_available;
-	struct worker_thread_args worker_args = {NULL, NULL};
+	struct worker_thread_args worker_args = {NULL, NULL, NULL};
 	struct send_thread_args send_args = {NULL, NULL};
 	struct rte_ring *rx_to_workers;
 	struct rte_ring *workers_to_tx;
@@ -742,7 +810,15 @@ main(int argc, char **argv)
 	if (workers_to_tx == NULL)
 		rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 
-	if (!disable_reorder) {
+	if (disable_reorder) {
+		mp_reorder = 0;
+	} else if (mp_reorder) {
+		send_args.buffer = rte_reorder_create_mp("PKT_RO",
+				rte_socket_id(), REORDER_BUFFER_SIZE);
+		if (send_args.buffer == NULL)
+			rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
+		worker_args.buffer = send_args.buffer;
+	} else {
 		send_args.buffer = rte_reorder_create("PKT_RO", rte_socket_id(),
 				REORDER_BUFFER_SIZE);
 		if (send_args.buffer == NULL)
@@ -773,12 +849,14 @@ main(int argc, char **argv)
 	}
 
 	/* Start rx_thread() on the main core */
+	app_stats.start_tsc = rte_rdtsc();
 	rx_thread(rx_to_workers);
 
 	RTE_LCORE_FOREACH_WORKER(lcore_id) {
 		if (rte_eal_wait_lcore(lcore_id) < 0)
 			return -1;
 	}
+	app_stats.end_tsc = rte_rdtsc();
 
 	print_stats();
 
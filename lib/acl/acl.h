@@ -163,6 +163,8 @@ struct rte_acl_bld_trie {
 	struct rte_acl_node *trie;
 };
 
+struct acl_incr;
+
 struct rte_acl_ctx {
 	char                name[RTE_ACL_NAMESIZE];
 	/** Name of the ACL context. */
@@ -174,6 +176,7 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	struct acl_incr    *incr;  /* incremental update state, if enabled. */
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
@@ -194,6 +197,19 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+int acl_check_rule(const struct rte_acl_rule_data *rd);
+
+/*
+ * Incremental updates support.
+ */
+int acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
+
+void acl_incr_free(struct rte_acl_ctx *ctx);
+
+int acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t fn);
+
 /*
  * Different implementations of ACL classify.
  */
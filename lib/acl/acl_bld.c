@@ -2,7 +2,11 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <pthread.h>
+
 #include <rte_acl.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include "tb_mem.h"
 #include "acl.h"
 
@@ -88,6 +92,30 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* worker threads to offload build of the tries to */
+	struct acl_bld_mt         *mt;
+};
+
+/* Build of the final version of one trie, run by a worker thread. */
+struct acl_bld_job {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+	uint32_t                  n;
+	int32_t                   rc;
+};
+
+/* State shared by the build caller and its worker threads. */
+struct acl_bld_mt {
+	const struct rte_acl_build_param *prm;
+	uint32_t                  num_threads;
+	pthread_t                 tid[RTE_ACL_MAX_TRIES];
+	pthread_mutex_t           lock;
+	pthread_cond_t            cond;
+	struct acl_bld_job        *job[RTE_ACL_MAX_TRIES];
+	uint32_t                  num_job;  /* number of posted jobs */
+	uint32_t                  next_job; /* first job not taken yet */
+	uint32_t                  stop;     /* no more jobs to come */
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1341,6 +1369,200 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static void
+acl_bld_job_run(struct acl_bld_job *job)
+{
+	int32_t rc;
+	struct rte_acl_build_rule *last;
+
+	/* worker build runs out of memory. */
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+	if (rc == 0) {
+		last = build_one_trie(&job->bcx, job->rule_sets, job->n,
+			INT32_MAX);
+		if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL)
+			rc = -ENOMEM;
+	}
+
+	if (rc != 0)
+		RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", job->n);
+	job->rc = rc;
+}
+
+/*
+ * Hand the final build of n-th trie over to the worker threads.
+ */
+static int
+acl_bld_job_post(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES], uint32_t n)
+{
+	struct acl_bld_job *job;
+	struct acl_bld_mt *mt;
+
+	mt = context->mt;
+	if (mt == NULL || mt->num_threads == 0)
+		return -ENOTSUP;
+
+	job = calloc(1, sizeof(*job));
+	if (job == NULL)
+		return -ENOMEM;
+
+	job->bcx.acx = context->acx;
+	job->bcx.cfg = context->cfg;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = context->node_max;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->rule_sets[n] = rule_sets[n];
+	job->n = n;
+
+	pthread_mutex_lock(&mt->lock);
+	mt->job[mt->num_job++] = job;
+	pthread_cond_signal(&mt->cond);
+	pthread_mutex_unlock(&mt->lock);
+	return 0;
+}
+
+/*
+ * Run posted jobs till there are no more to come.
+ */
+static void
+acl_bld_mt_run(struct acl_bld_mt *mt)
+{
+	struct acl_bld_job *job;
+
+	pthread_mutex_lock(&mt->lock);
+
+	for (;;) {
+		if (mt->next_job != mt->num_job) {
+			job = mt->job[mt->next_job++];
+			pthread_mutex_unlock(&mt->lock);
+			acl_bld_job_run(job);
+			pthread_mutex_lock(&mt->lock);
+		} else if (mt->stop != 0) {
+			break;
+		} else {
+			pthread_cond_wait(&mt->cond, &mt->lock);
+		}
+	}
+
+	pthread_mutex_unlock(&mt->lock);
+}
+
+static int
+acl_bld_lcore(void *arg)
+{
+	acl_bld_mt_run(arg);
+	return 0;
+}
+
+static void *
+acl_bld_thread(void *arg)
+{
+	acl_bld_mt_run(arg);
+	return NULL;
+}
+
+/*
+ * Start the worker threads, build carries on with the ones
+ * that could be started.
+ */
+static void
+acl_bld_mt_start(struct acl_bld_mt *mt, const struct rte_acl_build_param *prm)
+{
+	int32_t rc;
+	uint32_t i, n;
+	char name[RTE_MAX_THREAD_NAME_LEN];
+
+	memset(mt, 0, sizeof(*mt));
+	mt->prm = prm;
+	pthread_mutex_init(&mt->lock, NULL);
+	pthread_cond_init(&mt->cond, NULL);
+
+	/* no more than one job per trie. */
+	n = RTE_MIN(prm->num_threads, (uint32_t)RTE_DIM(mt->tid));
+
+	for (i = 0; i != n; i++) {
+		if (prm->lcores != NULL) {
+			rc = rte_eal_remote_launch(acl_bld_lcore, mt,
+				prm->lcores[i]);
+		} else {
+			snprintf(name, sizeof(name), "acl-bld-%u", i);
+			rc = rte_ctrl_thread_create(mt->tid + i, name, NULL,
+				acl_bld_thread, mt);
+		}
+		if (rc != 0) {
+			RTE_LOG(WARNING, ACL,
+				"failed to start build thread %u, error: %d\n",
+				i, rc);
+			break;
+		}
+	}
+
+	mt->num_threads = i;
+}
+
+/*
+ * Finish all posted jobs, stop the worker threads and
+ * take over the tries they built.
+ */
+static int
+acl_bld_mt_stop(struct acl_bld_mt *mt, struct acl_build_context *bcx)
+{
+	int32_t rc;
+	uint32_t i, n;
+	struct acl_bld_job *job;
+
+	pthread_mutex_lock(&mt->lock);
+	mt->stop = 1;
+	pthread_cond_broadcast(&mt->cond);
+	pthread_mutex_unlock(&mt->lock);
+
+	/* help with what is left. */
+	acl_bld_mt_run(mt);
+
+	for (i = 0; i != mt->num_threads; i++) {
+		if (mt->prm->lcores != NULL)
+			rte_eal_wait_lcore(mt->prm->lcores[i]);
+		else
+			pthread_join(mt->tid[i], NULL);
+	}
+
+	pthread_cond_destroy(&mt->cond);
+	pthread_mutex_destroy(&mt->lock);
+
+	rc = 0;
+	for (i = 0; i != mt->num_job; i++) {
+		job = mt->job[i];
+		n = job->n;
+		if (job->rc != 0) {
+			rc = job->rc;
+			continue;
+		}
+
+		bcx->tries[n] = job->bcx.tries[n];
+		memcpy(bcx->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(bcx->data_indexes[n]));
+		bcx->tries[n].data_index = bcx->data_indexes[n];
+		bcx->bld_tries[n] = job->bcx.bld_tries[n];
+		bcx->num_nodes += job->bcx.num_nodes;
+	}
+
+	return rc;
+}
+
+static void
+acl_bld_mt_free(struct acl_bld_mt *mt)
+{
+	uint32_t i;
+
+	for (i = 0; i != mt->num_job; i++) {
+		tb_free_pool(&mt->job[i]->bcx.pool);
+		free(mt->job[i]);
+	}
+	mt->num_job = 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
@@ -1403,7 +1625,12 @@ acl_build_tries(struct acl_build_context *context,
 		/*
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
+		 * Leave it to the worker threads, if any,
+		 * while we carry on with the remaining rules.
 		 */
+		if (acl_bld_job_post(context, rule_sets, n) == 0)
+			continue;
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
@@ -1505,13 +1732,15 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	struct acl_bld_mt *mt)
 {
 	int32_t rc;
 
 	/* setup build context. */
 	memset(bcx, 0, sizeof(*bcx));
 	bcx->acx = ctx;
+	bcx->mt = mt;
 	bcx->pool.alignment = ACL_POOL_ALIGN;
 	bcx->pool.min_alloc = ACL_POOL_ALLOC_MIN;
 	bcx->cfg = *cfg;
@@ -1618,18 +1847,24 @@ get_first_load_size(const struct rte_acl_config *cfg)
 	return (ofs < max_ofs) ? sizeof(uint32_t) : sizeof(uint8_t);
 }
 
-int
-rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+static int
+acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *prm)
 {
 	int32_t rc;
 	uint32_t n;
 	size_t max_size;
 	struct acl_build_context bcx;
+	struct acl_bld_mt mt, *pmt;
 
 	rc = acl_check_bld_param(ctx, cfg);
 	if (rc != 0)
 		return rc;
 
+	/* incremental context keeps its tries in the update state. */
+	if (ctx->incr != NULL)
+		return acl_incr_build(ctx, cfg);
+
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1640,10 +1875,22 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		max_size = cfg->max_size;
 	}
 
+	pmt = (prm != NULL && prm->num_threads != 0) ? &mt : NULL;
+
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
+		if (pmt != NULL)
+			acl_bld_mt_start(pmt, prm);
+
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, pmt);
+
+		/* collect tries built by the worker threads. */
+		if (pmt != NULL) {
+			int32_t mrc = acl_bld_mt_stop(pmt, &bcx);
+			if (rc == 0)
+				rc = mrc;
+		}
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1667,7 +1914,22 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 
 		/* cleanup after build. */
 		tb_free_pool(&bcx.pool);
+		if (pmt != NULL)
+			acl_bld_mt_free(pmt);
 	}
 
 	return rc;
 }
+
+int
+rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return acl_build(ctx, cfg, NULL);
+}
+
+int
+rte_acl_build_mt(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *param)
+{
+	return acl_build(ctx, cfg, param);
+}
@@ -0,0 +1,1013 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_acl.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_spinlock.h>
+#include "acl.h"
+
+/*
+ * Incremental updates of the ACL context.
+ * Rules that are known at the last full build (or compaction) are kept
+ * in the main tries. Rules added after that, together with the main rules
+ * that a delete could uncover, are kept in a small delta trie, that is
+ * rebuilt on each update. Deleted rules are masked out of the results by
+ * a bitmap. rte_acl_classify() runs both tries and keeps the match with
+ * the highest priority for each category.
+ * Internal tries are built with rule id (index in the rule store + 1)
+ * as userdata, so the priority and the user's userdata of a match are
+ * looked up by id.
+ */
+
+/* max number of inputs classified by the delta trie at once. */
+#define	ACL_INCR_BATCH		64
+
+#define	ACL_INCR_WORD_BIT	(sizeof(uint64_t) * CHAR_BIT)
+#define	ACL_INCR_DEAD_NUM(n)	((n) / ACL_INCR_WORD_BIT + 1)
+
+enum {
+	ACL_INCR_OP_ADD,
+	ACL_INCR_OP_DEL,
+};
+
+/*
+ * Rule set between two full builds, the first num_main rules are
+ * in the main tries. Fields after num_rules are used by writers only.
+ */
+struct acl_incr_gen {
+	struct rte_acl_ctx *main;
+	uint8_t            *rules;    /* rules with original userdata. */
+	uint32_t           *userdata; /* indexed by rule id. */
+	int32_t            *priority; /* indexed by rule id. */
+	uint32_t            num_rules;
+	uint32_t            num_main;
+	uint32_t            max_rules;
+	uint32_t            num_delta;
+	uint32_t           *delta;    /* ids of the delta trie rules. */
+	uint8_t            *in_delta; /* indexed by rule id. */
+};
+
+/* State seen by rte_acl_classify(), replaced as a whole on update. */
+struct acl_incr_ver {
+	struct acl_incr_gen *gen;
+	struct rte_acl_ctx  *delta;
+	uint32_t             num_dead;
+	uint64_t             dead[];  /* bitmap of deleted rule ids. */
+};
+
+struct acl_incr {
+	struct acl_incr_ver *ver;
+	struct rte_rcu_qsbr *v;
+	uint32_t             max_delta;
+	uint32_t             build_cnt;
+	rte_spinlock_t       lock;      /* serialises the updates. */
+	uint32_t             compacting;
+	/* updates done while compacting, to replay on the new tries. */
+	uint32_t             num_log;
+	uint32_t             max_log;
+	uint8_t             *log;
+};
+
+static inline const struct rte_acl_rule *
+acl_incr_rule(const struct rte_acl_ctx *ctx, const struct acl_incr_gen *gen,
+	uint32_t id)
+{
+	return (const struct rte_acl_rule *)
+		(gen->rules + (id - 1) * ctx->rule_sz);
+}
+
+static inline int
+acl_incr_is_dead(const uint64_t *dead, uint32_t id)
+{
+	return (dead[id / ACL_INCR_WORD_BIT] >> (id % ACL_INCR_WORD_BIT)) & 1;
+}
+
+static void
+acl_incr_ctx_free(struct rte_acl_ctx *ctx)
+{
+	if (ctx != NULL) {
+		rte_free(ctx->mem);
+		rte_free(ctx);
+	}
+}
+
+/*
+ * Build internal context from the given rule ids (1..num if ids is NULL)
+ * that are not dead. Context is NULL when there is nothing to build.
+ */
+static int
+acl_incr_ctx_build(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, const struct acl_incr_gen *gen,
+	const uint32_t *ids, uint32_t num, const uint64_t *dead,
+	struct rte_acl_ctx **res)
+{
+	int32_t rc;
+	uint32_t catmask, i, id, n;
+	size_t sz;
+	uint8_t *p;
+	struct rte_acl_ctx *c;
+
+	*res = NULL;
+	catmask = RTE_LEN2MASK(cfg->num_categories, typeof(catmask));
+
+	n = 0;
+	for (i = 0; i != num; i++) {
+		id = (ids == NULL) ? i + 1 : ids[i];
+		if ((dead == NULL || acl_incr_is_dead(dead, id) == 0) &&
+				(acl_incr_rule(ctx, gen, id)->data.category_mask &
+				catmask) != 0)
+			n++;
+	}
+
+	/* nothing would be ever matched. */
+	if (n == 0)
+		return 0;
+
+	sz = sizeof(*c) + n * ctx->rule_sz;
+	c = rte_zmalloc_socket(ctx->name, sz, RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (c == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, ctx->socket_id, ctx->name);
+		return -ENOMEM;
+	}
+
+	strlcpy(c->name, ctx->name, sizeof(c->name));
+	c->socket_id = ctx->socket_id;
+	c->alg = ctx->alg;
+	c->rules = c + 1;
+	c->max_rules = n;
+	c->rule_sz = ctx->rule_sz;
+
+	p = c->rules;
+	for (i = 0; i != num; i++) {
+		id = (ids == NULL) ? i + 1 : ids[i];
+		if ((dead != NULL && acl_incr_is_dead(dead, id) != 0) ||
+				(acl_incr_rule(ctx, gen, id)->data.category_mask &
+				catmask) == 0)
+			continue;
+		memcpy(p, acl_incr_rule(ctx, gen, id), ctx->rule_sz);
+		((struct rte_acl_rule *)p)->data.userdata = id;
+		p += ctx->rule_sz;
+	}
+	c->num_rules = n;
+
+	rc = rte_acl_build(c, cfg);
+	if (rc != 0) {
+		acl_incr_ctx_free(c);
+		return rc;
+	}
+
+	*res = c;
+	return 0;
+}
+
+static void
+acl_incr_gen_free(struct acl_incr_gen *gen)
+{
+	if (gen != NULL) {
+		acl_incr_ctx_free(gen->main);
+		rte_free(gen);
+	}
+}
+
+/*
+ * Create new rule set with the given rules in the main tries.
+ */
+static int
+acl_incr_gen_create(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, const uint8_t *rules, uint32_t num,
+	struct acl_incr_gen **res)
+{
+	int32_t rc;
+	uint32_t i, n;
+	size_t sz;
+	const struct rte_acl_rule *rule;
+	struct acl_incr_gen *gen;
+
+	n = ctx->max_rules + ctx->incr->max_delta;
+	if (num > n)
+		return -ENOMEM;
+
+	sz = sizeof(*gen) + n * ctx->rule_sz +
+		(n + 1) * (sizeof(gen->userdata[0]) + sizeof(gen->priority[0]) +
+		sizeof(gen->in_delta[0])) + n * sizeof(gen->delta[0]);
+
+	gen = rte_zmalloc_socket(ctx->name, sz, RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (gen == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, ctx->socket_id, ctx->name);
+		return -ENOMEM;
+	}
+
+	gen->rules = (uint8_t *)(gen + 1);
+	gen->userdata = (uint32_t *)(gen->rules + n * ctx->rule_sz);
+	gen->priority = (int32_t *)(gen->userdata + n + 1);
+	gen->delta = (uint32_t *)(gen->priority + n + 1);
+	gen->in_delta = (uint8_t *)(gen->delta + n);
+	gen->max_rules = n;
+
+	memcpy(gen->rules, rules, num * ctx->rule_sz);
+	for (i = 1; i <= num; i++) {
+		rule = acl_incr_rule(ctx, gen, i);
+		gen->userdata[i] = rule->data.userdata;
+		gen->priority[i] = rule->data.priority;
+	}
+	gen->num_rules = num;
+	gen->num_main = num;
+
+	rc = acl_incr_ctx_build(ctx, cfg, gen, NULL, num, NULL, &gen->main);
+	if (rc != 0) {
+		rte_free(gen);
+		return rc;
+	}
+
+	*res = gen;
+	return 0;
+}
+
+static struct acl_incr_ver *
+acl_incr_ver_alloc(const struct rte_acl_ctx *ctx, struct acl_incr_gen *gen,
+	const struct acl_incr_ver *cur)
+{
+	size_t sz;
+	struct acl_incr_ver *ver;
+
+	sz = sizeof(*ver) +
+		ACL_INCR_DEAD_NUM(gen->max_rules) * sizeof(ver->dead[0]);
+	ver = rte_zmalloc_socket(ctx->name, sz, RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (ver == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, ctx->socket_id, ctx->name);
+		return NULL;
+	}
+
+	ver->gen = gen;
+	if (cur != NULL) {
+		ver->num_dead = cur->num_dead;
+		memcpy(ver->dead, cur->dead, sz - sizeof(*ver));
+	}
+	return ver;
+}
+
+static void
+acl_incr_ver_free(struct acl_incr_ver *ver)
+{
+	if (ver != NULL) {
+		acl_incr_ctx_free(ver->delta);
+		rte_free(ver);
+	}
+}
+
+/*
+ * Free replaced state once no classify can reference it anymore.
+ */
+static void
+acl_incr_reclaim(const struct acl_incr *incr, struct acl_incr_ver *ver,
+	struct acl_incr_gen *gen)
+{
+	if (incr->v != NULL)
+		rte_rcu_qsbr_synchronize(incr->v, RTE_QSBR_THRID_INVALID);
+	acl_incr_ver_free(ver);
+	acl_incr_gen_free(gen);
+}
+
+static inline uint64_t
+acl_incr_field_value(const union rte_acl_field_types *v, uint8_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+/*
+ * Check can some input match both fields.
+ */
+static int
+acl_incr_field_overlap(const struct rte_acl_field_def *def,
+	const struct rte_acl_field *f1, const struct rte_acl_field *f2)
+{
+	uint32_t bits, len;
+	uint64_t m1, m2, v1, v2;
+
+	v1 = acl_incr_field_value(&f1->value, def->size);
+	v2 = acl_incr_field_value(&f2->value, def->size);
+	m1 = acl_incr_field_value(&f1->mask_range, def->size);
+	m2 = acl_incr_field_value(&f2->mask_range, def->size);
+
+	switch (def->type) {
+	case RTE_ACL_FIELD_TYPE_RANGE:
+		return v1 <= m2 && v2 <= m1;
+	case RTE_ACL_FIELD_TYPE_BITMASK:
+		return ((v1 ^ v2) & m1 & m2) == 0;
+	default:
+		/* prefixes have to agree on the shorter length. */
+		bits = def->size * CHAR_BIT;
+		len = RTE_MIN(RTE_MIN(m1, m2), (uint64_t)bits);
+		if (len == 0)
+			return 1;
+		return (((v1 ^ v2) >> (bits - len)) &
+			RTE_LEN2MASK(len, uint64_t)) == 0;
+	}
+}
+
+static int
+acl_incr_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t catmask, i, n;
+
+	catmask = RTE_LEN2MASK(cfg->num_categories, typeof(catmask));
+	if ((r1->data.category_mask & r2->data.category_mask & catmask) == 0)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		n = cfg->defs[i].field_index;
+		if (acl_incr_field_overlap(cfg->defs + i, r1->field + n,
+				r2->field + n) == 0)
+			return 0;
+	}
+	return 1;
+}
+
+static void
+acl_incr_delta_add(struct acl_incr_gen *gen, uint32_t id)
+{
+	if (gen->in_delta[id] == 0) {
+		gen->in_delta[id] = 1;
+		gen->delta[gen->num_delta++] = id;
+	}
+}
+
+/*
+ * Undo not published changes of the rule set.
+ */
+static void
+acl_incr_rollback(struct acl_incr_gen *gen, uint32_t num_rules,
+	uint32_t num_delta)
+{
+	uint32_t i;
+
+	for (i = num_delta; i != gen->num_delta; i++)
+		gen->in_delta[gen->delta[i]] = 0;
+	gen->num_delta = num_delta;
+	gen->num_rules = num_rules;
+}
+
+/*
+ * Drop deleted rules from the delta list of a published version.
+ */
+static void
+acl_incr_delta_prune(struct acl_incr_ver *ver)
+{
+	uint32_t i, id, n;
+	struct acl_incr_gen *gen;
+
+	gen = ver->gen;
+	n = 0;
+	for (i = 0; i != gen->num_delta; i++) {
+		id = gen->delta[i];
+		if (acl_incr_is_dead(ver->dead, id) != 0)
+			gen->in_delta[id] = 0;
+		else
+			gen->delta[n++] = id;
+	}
+	gen->num_delta = n;
+}
+
+/*
+ * Rules are equal when they have the same data and the same fields,
+ * bytes beyond the field size are ignored.
+ */
+static int
+acl_incr_rule_equal(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t i, n;
+	const struct rte_acl_field *f1, *f2;
+
+	if (r1->data.category_mask != r2->data.category_mask ||
+			r1->data.priority != r2->data.priority ||
+			r1->data.userdata != r2->data.userdata)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		n = cfg->defs[i].field_index;
+		f1 = r1->field + n;
+		f2 = r2->field + n;
+		if (acl_incr_field_value(&f1->value, cfg->defs[i].size) !=
+				acl_incr_field_value(&f2->value,
+				cfg->defs[i].size) ||
+				acl_incr_field_value(&f1->mask_range,
+				cfg->defs[i].size) !=
+				acl_incr_field_value(&f2->mask_range,
+				cfg->defs[i].size))
+			return 0;
+	}
+	return 1;
+}
+
+static uint32_t
+acl_incr_find(const struct rte_acl_ctx *ctx, const struct acl_incr_gen *gen,
+	const uint64_t *dead, const struct rte_acl_rule *rule)
+{
+	uint32_t id;
+
+	for (id = 1; id <= gen->num_rules; id++) {
+		if (acl_incr_is_dead(dead, id) == 0 &&
+				acl_incr_rule_equal(&ctx->config, rule,
+				acl_incr_rule(ctx, gen, id)) != 0)
+			return id;
+	}
+	return 0;
+}
+
+/*
+ * Apply single rule update to the rule set and the new version.
+ */
+static int
+acl_incr_change(const struct rte_acl_ctx *ctx, struct acl_incr_gen *gen,
+	struct acl_incr_ver *ver, const struct rte_acl_rule *rule, uint32_t op)
+{
+	uint32_t id, i;
+	const struct rte_acl_rule *r;
+
+	if (op == ACL_INCR_OP_ADD) {
+		if (gen->num_rules == gen->max_rules)
+			return -ENOSPC;
+		id = ++gen->num_rules;
+		memcpy((void *)(uintptr_t)acl_incr_rule(ctx, gen, id), rule,
+			ctx->rule_sz);
+		gen->userdata[id] = rule->data.userdata;
+		gen->priority[id] = rule->data.priority;
+		acl_incr_delta_add(gen, id);
+		return 0;
+	}
+
+	id = acl_incr_find(ctx, gen, ver->dead, rule);
+	if (id == 0)
+		return -ENOENT;
+
+	ver->dead[id / ACL_INCR_WORD_BIT] |= 1ULL << (id % ACL_INCR_WORD_BIT);
+	ver->num_dead++;
+
+	/*
+	 * Main tries could report the deleted rule instead of the lower
+	 * priority ones, that match the same inputs,
+	 * so move these into the delta trie.
+	 */
+	if (id <= gen->num_main) {
+		r = acl_incr_rule(ctx, gen, id);
+		for (i = 1; i <= gen->num_main; i++) {
+			if (gen->in_delta[i] == 0 &&
+					gen->priority[i] <= gen->priority[id] &&
+					acl_incr_is_dead(ver->dead, i) == 0 &&
+					acl_incr_rule_overlap(&ctx->config, r,
+					acl_incr_rule(ctx, gen, i)) != 0)
+				acl_incr_delta_add(gen, i);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Copy live rules, leaving space for extra ones.
+ */
+static int
+acl_incr_live_rules(const struct rte_acl_ctx *ctx,
+	const struct acl_incr_ver *ver, uint32_t extra, uint8_t **rules,
+	uint32_t *num)
+{
+	uint32_t id, n;
+	uint8_t *p;
+	const struct acl_incr_gen *gen;
+
+	gen = ver->gen;
+	n = gen->num_rules - ver->num_dead + extra;
+	p = rte_malloc_socket(NULL, (n + 1) * ctx->rule_sz, 0, ctx->socket_id);
+	if (p == NULL)
+		return -ENOMEM;
+
+	n = 0;
+	for (id = 1; id <= gen->num_rules; id++) {
+		if (acl_incr_is_dead(ver->dead, id) == 0)
+			memcpy(p + n++ * ctx->rule_sz,
+				acl_incr_rule(ctx, gen, id), ctx->rule_sz);
+	}
+
+	*rules = p;
+	*num = n;
+	return 0;
+}
+
+/*
+ * Apply the updates by rebuilding main tries from all the live rules.
+ */
+static int
+acl_incr_rebuild(const struct rte_acl_ctx *ctx, const struct acl_incr_ver *cur,
+	const uint8_t *rules, uint32_t num, uint32_t op,
+	struct acl_incr_ver **res)
+{
+	int32_t rc;
+	uint32_t i, k, n, sz;
+	uint8_t *p;
+	const uint8_t *r;
+	struct acl_incr_gen *gen;
+	struct acl_incr_ver *ver;
+
+	sz = ctx->rule_sz;
+	rc = acl_incr_live_rules(ctx, cur, (op == ACL_INCR_OP_ADD) ? num : 0,
+		&p, &n);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i != num && rc == 0; i++) {
+		r = rules + i * sz;
+		if (op == ACL_INCR_OP_ADD) {
+			memcpy(p + n++ * sz, r, sz);
+			continue;
+		}
+		for (k = 0; k != n && acl_incr_rule_equal(&ctx->config,
+				(const struct rte_acl_rule *)(p + k * sz),
+				(const struct rte_acl_rule *)r) == 0; k++)
+			;
+		if (k == n) {
+			rc = -ENOENT;
+		} else {
+			n--;
+			memmove(p + k * sz, p + (k + 1) * sz, (n - k) * sz);
+		}
+	}
+
+	if (rc == 0)
+		rc = acl_incr_gen_create(ctx, &ctx->config, p, n, &gen);
+	rte_free(p);
+	if (rc != 0)
+		return rc;
+
+	ver = acl_incr_ver_alloc(ctx, gen, NULL);
+	if (ver == NULL) {
+		acl_incr_gen_free(gen);
+		return -ENOMEM;
+	}
+
+	*res = ver;
+	return 0;
+}
+
+/*
+ * Prepare new version with the updates applied, current one stays intact.
+ */
+static int
+acl_incr_apply(const struct rte_acl_ctx *ctx, const struct acl_incr_ver *cur,
+	const uint8_t *rules, uint32_t num, uint32_t op,
+	struct acl_incr_ver **res)
+{
+	int32_t rc;
+	uint32_t i, n, nd, nr;
+	struct acl_incr_gen *gen;
+	struct acl_incr_ver *ver;
+
+	gen = cur->gen;
+	if (op == ACL_INCR_OP_ADD) {
+		if (gen->num_rules - cur->num_dead + num > ctx->max_rules)
+			return -ENOMEM;
+		if (gen->num_rules + num > gen->max_rules)
+			return acl_incr_rebuild(ctx, cur, rules, num, op, res);
+	}
+
+	ver = acl_incr_ver_alloc(ctx, gen, cur);
+	if (ver == NULL)
+		return -ENOMEM;
+
+	nr = gen->num_rules;
+	nd = gen->num_delta;
+
+	rc = 0;
+	for (i = 0; i != num && rc == 0; i++)
+		rc = acl_incr_change(ctx, gen, ver, (const struct rte_acl_rule *)
+			(rules + i * ctx->rule_sz), op);
+
+	/* delta trie grew too big, time to fold it into the main tries. */
+	if (rc == 0) {
+		for (i = 0, n = 0; i != gen->num_delta; i++)
+			n += acl_incr_is_dead(ver->dead, gen->delta[i]) == 0;
+		if (n > ctx->incr->max_delta)
+			rc = -ENOSPC;
+	}
+
+	if (rc == 0)
+		rc = acl_incr_ctx_build(ctx, &ctx->config, gen, gen->delta,
+			gen->num_delta, ver->dead, &ver->delta);
+
+	if (rc != 0) {
+		acl_incr_rollback(gen, nr, nd);
+		rte_free(ver);
+		if (rc == -ENOSPC)
+			rc = acl_incr_rebuild(ctx, cur, rules, num, op, res);
+		return rc;
+	}
+
+	*res = ver;
+	return 0;
+}
+
+/*
+ * Make sure log has space for the num updates.
+ */
+static int
+acl_incr_log_reserve(const struct rte_acl_ctx *ctx, uint32_t num)
+{
+	uint32_t n;
+	uint8_t *p;
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr->compacting == 0 || incr->num_log + num <= incr->max_log)
+		return 0;
+
+	n = RTE_MAX(incr->num_log + num, incr->max_log * 2);
+	p = rte_realloc_socket(incr->log,
+		(size_t)n * (sizeof(uint64_t) + ctx->rule_sz), 0,
+		ctx->socket_id);
+	if (p == NULL)
+		return -ENOMEM;
+
+	incr->log = p;
+	incr->max_log = n;
+	return 0;
+}
+
+static void
+acl_incr_log_append(const struct rte_acl_ctx *ctx, const uint8_t *rules,
+	uint32_t num, uint32_t op)
+{
+	uint32_t i;
+	uint8_t *p;
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	p = incr->log + incr->num_log * (sizeof(uint64_t) + ctx->rule_sz);
+	for (i = 0; i != num; i++) {
+		*(uint64_t *)p = op;
+		memcpy(p + sizeof(uint64_t), rules + i * ctx->rule_sz,
+			ctx->rule_sz);
+		p += sizeof(uint64_t) + ctx->rule_sz;
+	}
+	incr->num_log += num;
+}
+
+static int
+acl_incr_update(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num, uint32_t op)
+{
+	int32_t rc;
+	struct acl_incr *incr;
+	struct acl_incr_gen *gen;
+	struct acl_incr_ver *cur, *ver;
+
+	incr = ctx->incr;
+	gen = NULL;
+
+	rte_spinlock_lock(&incr->lock);
+
+	cur = incr->ver;
+	if (cur == NULL)
+		rc = -EINVAL;
+	else
+		rc = acl_incr_log_reserve(ctx, num);
+
+	if (rc == 0)
+		rc = acl_incr_apply(ctx, cur, (const uint8_t *)rules, num, op,
+			&ver);
+
+	if (rc == 0) {
+		if (incr->compacting != 0)
+			acl_incr_log_append(ctx, (const uint8_t *)rules, num,
+				op);
+		if (ver->gen != cur->gen)
+			gen = cur->gen;
+		__atomic_store_n(&incr->ver, ver, __ATOMIC_RELEASE);
+		acl_incr_delta_prune(ver);
+	}
+
+	rte_spinlock_unlock(&incr->lock);
+
+	if (rc == 0)
+		acl_incr_reclaim(incr, cur, gen);
+	return rc;
+}
+
+int
+acl_incr_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	int32_t rc;
+	struct acl_incr *incr;
+	struct acl_incr_gen *gen;
+	struct acl_incr_ver *cur, *ver;
+
+	incr = ctx->incr;
+
+	rte_spinlock_lock(&incr->lock);
+
+	rc = acl_incr_gen_create(ctx, cfg, ctx->rules, ctx->num_rules, &gen);
+	if (rc == 0) {
+		ver = acl_incr_ver_alloc(ctx, gen, NULL);
+		if (ver == NULL) {
+			acl_incr_gen_free(gen);
+			rc = -ENOMEM;
+		}
+	}
+
+	if (rc != 0) {
+		rte_spinlock_unlock(&incr->lock);
+		return rc;
+	}
+
+	ctx->config = *cfg;
+	cur = incr->ver;
+	__atomic_store_n(&incr->ver, ver, __ATOMIC_RELEASE);
+
+	/* invalidate compaction in progress, if any. */
+	incr->build_cnt++;
+	incr->num_log = 0;
+
+	rte_spinlock_unlock(&incr->lock);
+
+	if (cur != NULL)
+		acl_incr_reclaim(incr, cur, cur->gen);
+	return 0;
+}
+
+void
+acl_incr_free(struct rte_acl_ctx *ctx)
+{
+	struct acl_incr *incr;
+
+	incr = ctx->incr;
+	if (incr == NULL)
+		return;
+
+	if (incr->ver != NULL) {
+		acl_incr_gen_free(incr->ver->gen);
+		acl_incr_ver_free(incr->ver);
+	}
+	rte_free(incr->log);
+	rte_free(incr);
+	ctx->incr = NULL;
+}
+
+int
+acl_incr_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t fn)
+{
+	int32_t rc;
+	uint32_t i, j, k, n;
+	uint32_t *res;
+	const struct acl_incr_gen *gen;
+	const struct acl_incr_ver *ver;
+	uint32_t dres[ACL_INCR_BATCH * RTE_ACL_MAX_CATEGORIES];
+
+	n = num * categories;
+
+	ver = __atomic_load_n(&ctx->incr->ver, __ATOMIC_ACQUIRE);
+	if (ver == NULL || ver->gen->main == NULL) {
+		memset(results, 0, n * sizeof(results[0]));
+		if (ver == NULL)
+			return 0;
+	}
+
+	gen = ver->gen;
+	if (gen->main != NULL) {
+		rc = fn(gen->main, data, results, num, categories);
+		if (rc != 0)
+			return rc;
+
+		/* drop matches of the deleted rules. */
+		if (ver->num_dead != 0) {
+			for (i = 0; i != n; i++) {
+				if (acl_incr_is_dead(ver->dead,
+						results[i]) != 0)
+					results[i] = 0;
+			}
+		}
+	}
+
+	/* merge matches of the delta trie, highest priority wins. */
+	if (ver->delta != NULL) {
+		for (i = 0; i != num; i += k) {
+			k = RTE_MIN(num - i, (uint32_t)ACL_INCR_BATCH);
+			rc = fn(ver->delta, data + i, dres, k, categories);
+			if (rc != 0)
+				return rc;
+
+			res = results + i * categories;
+			for (j = 0; j != k * categories; j++) {
+				if (dres[j] != 0 && (res[j] == 0 ||
+						gen->priority[dres[j]] >
+						gen->priority[res[j]]))
+					res[j] = dres[j];
+			}
+		}
+	}
+
+	for (i = 0; i != n; i++)
+		results[i] = gen->userdata[results[i]];
+
+	return 0;
+}
+
+int
+rte_acl_incr_enable(struct rte_acl_ctx *ctx,
+	const struct rte_acl_incr_param *param)
+{
+	int32_t rc;
+	struct acl_incr *incr;
+
+	if (ctx == NULL || ctx->rule_sz == 0)
+		return -EINVAL;
+
+	if (ctx->incr != NULL)
+		return -EEXIST;
+
+	incr = rte_zmalloc_socket(ctx->name, sizeof(*incr),
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (incr == NULL)
+		return -ENOMEM;
+
+	incr->max_delta = RTE_ACL_INCR_DELTA_DEF;
+	if (param != NULL) {
+		incr->v = param->v;
+		if (param->max_delta_rules != 0)
+			incr->max_delta = param->max_delta_rules;
+	}
+	rte_spinlock_init(&incr->lock);
+	ctx->incr = incr;
+
+	/* context was already built, take over its rules. */
+	if (ctx->mem != NULL) {
+		rc = acl_incr_build(ctx, &ctx->config);
+		if (rc != 0) {
+			acl_incr_free(ctx);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+static int
+acl_incr_check_rules(const struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num, const char *func)
+{
+	uint32_t i;
+	int32_t rc;
+	const struct rte_acl_rule *rv;
+
+	if (ctx == NULL || ctx->incr == NULL || rules == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * ctx->rule_sz);
+		rc = acl_check_rule(&rv->data);
+		if (rc != 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is invalid\n",
+				func, ctx->name, i + 1);
+			return rc;
+		}
+	}
+	return 0;
+}
+
+int
+rte_acl_incr_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc;
+
+	rc = acl_incr_check_rules(ctx, rules, num, __func__);
+	if (rc != 0)
+		return rc;
+
+	return acl_incr_update(ctx, rules, num, ACL_INCR_OP_ADD);
+}
+
+int
+rte_acl_incr_del_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	if (ctx == NULL || ctx->incr == NULL || rules == NULL)
+		return -EINVAL;
+
+	return acl_incr_update(ctx, rules, num, ACL_INCR_OP_DEL);
+}
+
+int
+rte_acl_incr_compact(struct rte_acl_ctx *ctx)
+{
+	int32_t rc;
+	uint32_t cnt, i, n, sz;
+	const uint8_t *p;
+	uint8_t *rules;
+	struct rte_acl_config cfg;
+	struct acl_incr *incr;
+	struct acl_incr_gen *gen;
+	struct acl_incr_ver *cur, *ver;
+
+	if (ctx == NULL || ctx->incr == NULL)
+		return -EINVAL;
+
+	incr = ctx->incr;
+
+	/* take snapshot of the live rules. */
+	rte_spinlock_lock(&incr->lock);
+
+	cur = incr->ver;
+	if (cur == NULL)
+		rc = -EINVAL;
+	else if (incr->compacting != 0)
+		rc = -EBUSY;
+	else if (cur->gen->num_rules == cur->gen->num_main &&
+			cur->num_dead == 0)
+		/* nothing to fold. */
+		rc = 1;
+	else
+		rc = acl_incr_live_rules(ctx, cur, 0, &rules, &n);
+
+	if (rc != 0) {
+		rte_spinlock_unlock(&incr->lock);
+		return RTE_MIN(rc, 0);
+	}
+
+	cfg = ctx->config;
+	cnt = incr->build_cnt;
+	incr->compacting = 1;
+	incr->num_log = 0;
+
+	rte_spinlock_unlock(&incr->lock);
+
+	/* the expensive part, updates and classify go on meanwhile. */
+	rc = acl_incr_gen_create(ctx, &cfg, rules, n, &gen);
+	rte_free(rules);
+
+	rte_spinlock_lock(&incr->lock);
+
+	incr->compacting = 0;
+	if (rc == 0 && cnt != incr->build_cnt) {
+		acl_incr_gen_free(gen);
+		rc = -EAGAIN;
+	}
+	if (rc != 0) {
+		rte_spinlock_unlock(&incr->lock);
+		return rc;
+	}
+
+	ver = acl_incr_ver_alloc(ctx, gen, NULL);
+	if (ver == NULL)
+		rc = -ENOMEM;
+
+	/* replay updates made since the snapshot. */
+	sz = sizeof(uint64_t) + ctx->rule_sz;
+	p = incr->log;
+	for (i = 0; i != incr->num_log && rc == 0; i++, p += sz)
+		rc = acl_incr_change(ctx, gen, ver,
+			(const struct rte_acl_rule *)(p + sizeof(uint64_t)),
+			*(const uint64_t *)p);
+	incr->num_log = 0;
+
+	if (rc == 0)
+		rc = acl_incr_ctx_build(ctx, &cfg, gen, gen->delta,
+			gen->num_delta, ver->dead, &ver->delta);
+
+	if (rc != 0) {
+		rte_spinlock_unlock(&incr->lock);
+		rte_free(ver);
+		acl_incr_gen_free(gen);
+		return (rc == -ENOSPC || rc == -ENOENT) ? -EAGAIN : rc;
+	}
+
+	cur = incr->ver;
+	__atomic_store_n(&incr->ver, ver, __ATOMIC_RELEASE);
+	acl_incr_delta_prune(ver);
+
+	rte_spinlock_unlock(&incr->lock);
+
+	acl_incr_reclaim(incr, cur, cur->gen);
+	return 0;
+}
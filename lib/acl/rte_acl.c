@@ -295,6 +295,10 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	if (ctx->incr != NULL)
+		return acl_incr_classify(ctx, data, results, num, categories,
+			classify_fns[alg]);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -357,6 +361,7 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_incr_free(ctx);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -447,7 +452,7 @@ acl_add_rules(struct rte_acl_ctx *ctx, const void *rules, uint32_t num)
 	return 0;
 }
 
-static int
+int
 acl_check_rule(const struct rte_acl_rule_data *rd)
 {
 	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
@@ -11,6 +11,7 @@
  * RTE Classifier.
  */
 
+#include <rte_compat.h>
 #include <rte_acl_osdep.h>
 
 #ifdef __cplusplus
@@ -221,6 +222,50 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/**
+ * Parameters for the multi-threaded build of the ACL context.
+ */
+struct rte_acl_build_param {
+	/**
+	 * Number of threads to build with, in addition to the caller one.
+	 */
+	uint32_t num_threads;
+	/**
+	 * Array of num_threads worker lcores to build on, they have to be
+	 * waiting for work. If NULL, the build creates its own control threads.
+	 */
+	const uint32_t *lcores;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Analyze set of rules and build required internal run-time structures,
+ * spreading the work over several threads.
+ * When the rule set gets split into several tries, each trie is finalized
+ * by a worker thread, while the caller carries on splitting the remaining
+ * rules. The run-time structures are identical to the ones
+ * rte_acl_build() produces.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param param
+ *   Threads to build with, NULL or zero threads means rte_acl_build().
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_build_mt(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const struct rte_acl_build_param *param);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -340,6 +385,136 @@ extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
+struct rte_rcu_qsbr;
+
+/** Default max number of rules in the delta trie of an incremental context. */
+#define RTE_ACL_INCR_DELTA_DEF	128
+
+/**
+ * Parameters for incremental updates of an ACL context.
+ */
+struct rte_acl_incr_param {
+	/**
+	 * RCU QSBR variable used to reclaim replaced run-time structures.
+	 * Every thread calling rte_acl_classify() on the context has to be
+	 * registered with it and to report its quiescent states.
+	 * If NULL, updates must not run concurrently with classification.
+	 */
+	struct rte_rcu_qsbr *v;
+	/**
+	 * Max number of rules kept in the delta trie before the context
+	 * is compacted into a new main trie.
+	 * Zero means RTE_ACL_INCR_DELTA_DEF.
+	 */
+	uint32_t max_delta_rules;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable incremental rule updates for the ACL context.
+ * Rules added or deleted with rte_acl_incr_add_rules() and
+ * rte_acl_incr_del_rules() go into a small delta trie, consulted by
+ * rte_acl_classify() alongside the main tries, so the update does not
+ * need a full rebuild. The delta is folded back into the main tries by
+ * rte_acl_incr_compact() or, once it grows over the limit, by the update
+ * itself.
+ * If the context is already built, its rules are taken over right away.
+ * Any later rte_acl_build() rebuilds the incremental state from the rules
+ * added with rte_acl_add_rules(), discarding previous incremental updates.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to enable incremental updates for.
+ * @param param
+ *   Incremental update parameters, NULL means defaults.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if incremental updates are already enabled.
+ *   - -ENOMEM if memory allocation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_enable(struct rte_acl_ctx *ctx,
+	const struct rte_acl_incr_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add rules to a built incremental ACL context.
+ * The rules become visible to rte_acl_classify() when the function returns.
+ * Can be called concurrently with rte_acl_classify() and with other updates.
+ *
+ * @param ctx
+ *   ACL context to add rules to.
+ * @param rules
+ *   Array of rules to add.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOMEM if the context would hold more than max_rule_num rules
+ *     or memory allocation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Delete rules from a built incremental ACL context.
+ * Each rule is identified by its data and the values of all its fields.
+ * The rules stop matching when the function returns.
+ * Can be called concurrently with rte_acl_classify() and with other updates.
+ *
+ * @param ctx
+ *   ACL context to delete rules from.
+ * @param rules
+ *   Array of rules to delete.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if one of the rules is not in the context,
+ *     none of the rules is deleted then.
+ *   - -ENOMEM if memory allocation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_del_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Fold the delta trie of an incremental ACL context into new main tries.
+ * The main tries are built without blocking classification or updates,
+ * so the function is meant to be called periodically from a background
+ * thread. Updates made while the build is running are replayed on top
+ * of the new tries before they are published.
+ *
+ * @param ctx
+ *   ACL context to compact.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EBUSY if a compaction is already running.
+ *   - -EAGAIN if the context was rebuilt while compacting.
+ *   - -ENOMEM if memory allocation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_compact(struct rte_acl_ctx *ctx);
+
 /**
  * Dump an ACL context structure to the console.
  *
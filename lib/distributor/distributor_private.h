@@ -57,16 +57,20 @@ union rte_distributor_buffer_single {
 } __rte_cache_aligned;
 
 /*
- * Transfer up to 8 mbufs at a time to/from workers, and
+ * Transfer up to 8 mbufs at a time to/from workers by default, and
  * flow matching algorithm optimized for 8 flow IDs at a time
  */
 #define RTE_DIST_BURST_SIZE 8
 
+/* Default and maximum size of the rings of a worker in ring mode */
+#define RTE_DIST_RING_SIZE 512
+#define RTE_DIST_RING_SIZE_MAX (1 << 16)
+
 struct rte_distributor_backlog {
 	unsigned int start;
 	unsigned int count;
-	int64_t pkts[RTE_DIST_BURST_SIZE] __rte_cache_aligned;
-	uint16_t *tags; /* will point to second cacheline of inflights */
+	int64_t pkts[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
+	uint16_t *tags; /* will point to second half of inflights */
 } __rte_cache_aligned;
 
 
@@ -101,6 +105,8 @@ struct rte_distributor_single {
 enum rte_distributor_match_function {
 	RTE_DIST_MATCH_SCALAR = 0,
 	RTE_DIST_MATCH_VECTOR,
+	RTE_DIST_MATCH_AVX2,
+	RTE_DIST_MATCH_AVX512,
 	RTE_DIST_NUM_MATCH_FNS
 };
 
@@ -109,16 +115,17 @@ enum rte_distributor_match_function {
  * line aligned, but to improve performance and prevent adjacent cache-line
  * prefetches of buffers for other workers, e.g. when worker 1's buffer is on
  * the next cache line to worker 0, we pad this out to two cache lines.
- * We can pass up to 8 mbufs at a time in one cacheline.
- * There is a separate cacheline for returns in the burst API.
+ * We can pass up to 8 mbufs at a time in one cacheline, bigger bursts
+ * use burst_size / 8 cachelines with the handshake bits in the first one.
+ * There are separate cachelines for returns in the burst API.
  */
 struct rte_distributor_buffer {
-	volatile int64_t bufptr64[RTE_DIST_BURST_SIZE]
+	volatile int64_t bufptr64[RTE_DIST_BURST_SIZE_MAX]
 		__rte_cache_aligned; /* <= outgoing to worker */
 
 	int64_t pad1 __rte_cache_aligned;    /* <= one cache line  */
 
-	volatile int64_t retptr64[RTE_DIST_BURST_SIZE]
+	volatile int64_t retptr64[RTE_DIST_BURST_SIZE_MAX]
 		__rte_cache_aligned; /* <= incoming from worker */
 
 	int64_t pad2 __rte_cache_aligned;    /* <= one cache line  */
@@ -126,20 +133,64 @@ struct rte_distributor_buffer {
 	int count __rte_cache_aligned;       /* <= number of current mbufs */
 };
 
+/* States of a worker in ring mode, set by the worker */
+#define RTE_DIST_RING_WKR_IDLE 0     /**< not requesting packets */
+#define RTE_DIST_RING_WKR_ACTIVE 1   /**< requesting packets */
+#define RTE_DIST_RING_WKR_SHUTDOWN 2 /**< returned, distributor must ack */
+
+/*
+ * Flow table of the ring mode, indexed by the tag divided by two
+ * (tags are odd). An entry holds the number of packets of the flow
+ * sent to a worker and not completed yet, and the last worker (+1) of
+ * the flow, on which it is pinned while this number is not zero.
+ */
+#define RTE_DIST_RING_FLOWS (1 << 15)
+#define RTE_DIST_FLOW_WKR_MASK 0xff
+#define RTE_DIST_FLOW_CNT_SHIFT 8
+
+/**
+ * Per worker state of a distributor passing the packets through rings
+ * (RTE_DIST_F_WORKER_RINGS). The first cache lines are only written by the
+ * distributor, the last one only by the worker, apart from the counters
+ * reset by the distributor when a worker shuts down.
+ */
+struct rte_distributor_ring_worker {
+	struct rte_ring *to_wkr;   /**< packets given to the worker */
+	struct rte_ring *from_wkr; /**< packets returned by the worker */
+	uint16_t *tags;            /**< tags of the packets sent, by sequence */
+	uint32_t tags_mask;
+	uint32_t sent;             /**< packets enqueued to the worker */
+	uint32_t retired;          /**< completed packets with flow released */
+	unsigned int count;        /**< packets in the backlog */
+	unsigned int closing;      /**< return of the worker being handled */
+	uint16_t bl_tags[RTE_DIST_BURST_SIZE_MAX];
+	struct rte_mbuf *bl_pkts[RTE_DIST_BURST_SIZE_MAX] __rte_cache_aligned;
+
+	uint32_t wake __rte_cache_aligned; /**< incremented on flush */
+
+	uint32_t state __rte_cache_aligned; /**< RTE_DIST_RING_WKR_* */
+	uint32_t done;             /**< packets completed by the worker */
+	uint32_t received;         /**< packets dequeued by the worker */
+	uint32_t wake_seen;        /**< last wake value seen by the worker */
+} __rte_cache_aligned;
+
 struct rte_distributor {
 	TAILQ_ENTRY(rte_distributor) next;    /**< Next in list. */
 
 	char name[RTE_DISTRIBUTOR_NAMESIZE];  /**< Name of the ring. */
 	unsigned int num_workers;             /**< Number of workers polling */
 	unsigned int alg_type;                /**< Number of alg types */
+	unsigned int burst_size;              /**< Packets per worker burst */
+	uint32_t flags;                       /**< RTE_DIST_F_* flags */
 
 	/**>
-	 * First cache line in the this array are the tags inflight
-	 * on the worker core. Second cache line are the backlog
+	 * First burst_size tags of a worker in this array are the tags
+	 * inflight on the worker core. Next burst_size tags are the backlog
 	 * that are going to go to the worker core.
+	 * The tags of worker i start at i * 2 * burst_size.
 	 */
-	uint16_t in_flight_tags[RTE_DISTRIB_MAX_WORKERS][RTE_DIST_BURST_SIZE*2]
-			__rte_cache_aligned;
+	uint16_t in_flight_tags[RTE_DISTRIB_MAX_WORKERS *
+			RTE_DIST_BURST_SIZE_MAX * 2] __rte_cache_aligned;
 
 	struct rte_distributor_backlog backlog[RTE_DISTRIB_MAX_WORKERS]
 			__rte_cache_aligned;
@@ -154,8 +205,21 @@ struct rte_distributor {
 
 	uint8_t active[RTE_DISTRIB_MAX_WORKERS];
 	uint8_t activesum;
+
+	/* ring mode only */
+	unsigned int ring_size;               /**< Size of the worker rings */
+	unsigned int next_wkr;                /**< Worker of the new flows */
+	struct rte_distributor_ring_worker *ring_wkrs;
+	uint32_t *flows;                      /**< RTE_DIST_RING_FLOWS entries */
 };
 
+/* tags inflight on a worker, followed by the tags of its backlog */
+static inline uint16_t *
+dist_in_flight_tags(struct rte_distributor *d, unsigned int wkr)
+{
+	return &d->in_flight_tags[wkr * d->burst_size * 2];
+}
+
 void
 find_match_scalar(struct rte_distributor *d,
 			uint16_t *data_ptr,
@@ -166,4 +230,48 @@ find_match_vec(struct rte_distributor *d,
 			uint16_t *data_ptr,
 			uint16_t *output_ptr);
 
+void
+find_match_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
+/* Ring mode (RTE_DIST_F_WORKER_RINGS) functions, see rte_distributor.h */
+
+int
+rte_distributor_ring_init(struct rte_distributor *d, unsigned int socket_id,
+		unsigned int ring_size);
+
+void
+rte_distributor_request_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **oldpkt,
+		unsigned int count);
+
+int
+rte_distributor_poll_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **pkts);
+
+int
+rte_distributor_get_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **pkts,
+		struct rte_mbuf **oldpkt, unsigned int return_count);
+
+int
+rte_distributor_return_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **oldpkt, int num);
+
+int
+rte_distributor_process_ring(struct rte_distributor *d,
+		struct rte_mbuf **mbufs, unsigned int num_mbufs);
+
+int
+rte_distributor_flush_ring(struct rte_distributor *d);
+
+void
+rte_distributor_clear_returns_ring(struct rte_distributor *d);
+
 #endif /* _DIST_PRIV_H_ */
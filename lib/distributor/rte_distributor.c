@@ -7,6 +7,7 @@
 #include <sys/queue.h>
 #include <string.h>
 #include <rte_mbuf.h>
+#include <rte_cpuflags.h>
 #include <rte_cycles.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
@@ -14,6 +15,7 @@
 #include <rte_eal_memconfig.h>
 #include <rte_pause.h>
 #include <rte_tailq.h>
+#include <rte_vect.h>
 
 #include "rte_distributor.h"
 #include "rte_distributor_single.h"
@@ -46,6 +48,11 @@ rte_distributor_request_pkt(struct rte_distributor *d,
 		return;
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS) {
+		rte_distributor_request_pkt_ring(d, worker_id, oldpkt, count);
+		return;
+	}
+
 	retptr64 = &(buf->retptr64[0]);
 	/* Spin while handshake bits are set (scheduler clears it).
 	 * Sync with worker on GET_BUF flag.
@@ -64,7 +71,7 @@ rte_distributor_request_pkt(struct rte_distributor *d,
 	 * handshake bits. Populate the retptrs with returning packets.
 	 */
 
-	for (i = count; i < RTE_DIST_BURST_SIZE; i++)
+	for (i = count; i < d->burst_size; i++)
 		buf->retptr64[i] = 0;
 
 	/* Set VALID_BUF bit for each packet returned */
@@ -97,6 +104,9 @@ rte_distributor_poll_pkt(struct rte_distributor *d,
 		return (pkts[0]) ? 1 : 0;
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS)
+		return rte_distributor_poll_pkt_ring(d, worker_id, pkts);
+
 	/* If any of below bits is set, return.
 	 * GET_BUF is set when distributor hasn't sent any packets yet
 	 * RETURN_BUF is set when distributor must retrieve in-flight packets
@@ -107,7 +117,7 @@ rte_distributor_poll_pkt(struct rte_distributor *d,
 		return -1;
 
 	/* since bufptr64 is signed, this should be an arithmetic shift */
-	for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
+	for (i = 0; i < d->burst_size; i++) {
 		if (likely(buf->bufptr64[i] & RTE_DISTRIB_VALID_BUF)) {
 			ret = buf->bufptr64[i] >> RTE_DISTRIB_FLAG_BITS;
 			pkts[count++] = (struct rte_mbuf *)((uintptr_t)(ret));
@@ -142,6 +152,10 @@ rte_distributor_get_pkt(struct rte_distributor *d,
 			return -EINVAL;
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS)
+		return rte_distributor_get_pkt_ring(d, worker_id, pkts, oldpkt,
+			return_count);
+
 	rte_distributor_request_pkt(d, worker_id, oldpkt, return_count);
 
 	count = rte_distributor_poll_pkt(d, worker_id, pkts);
@@ -174,6 +188,10 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 			return -EINVAL;
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS)
+		return rte_distributor_return_pkt_ring(d, worker_id, oldpkt,
+			num);
+
 	/* Spin while handshake bits are set (scheduler clears it).
 	 * Sync with worker on GET_BUF flag.
 	 */
@@ -188,7 +206,7 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 
 	/* Sync with distributor to acquire retptrs */
 	__atomic_thread_fence(__ATOMIC_ACQUIRE);
-	for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
+	for (i = 0; i < d->burst_size; i++)
 		/* Switch off the return bit first */
 		buf->retptr64[i] = 0;
 
@@ -241,6 +259,7 @@ find_match_scalar(struct rte_distributor *d,
 			uint16_t *output_ptr)
 {
 	struct rte_distributor_backlog *bl;
+	uint16_t *in_flight_tags;
 	uint16_t i, j, w;
 
 	/*
@@ -256,15 +275,16 @@ find_match_scalar(struct rte_distributor *d,
 
 	for (i = 0; i < d->num_workers; i++) {
 		bl = &d->backlog[i];
+		in_flight_tags = dist_in_flight_tags(d, i);
 
 		for (j = 0; j < RTE_DIST_BURST_SIZE ; j++)
-			for (w = 0; w < RTE_DIST_BURST_SIZE; w++)
-				if (d->in_flight_tags[i][w] == data_ptr[j]) {
+			for (w = 0; w < d->burst_size; w++)
+				if (in_flight_tags[w] == data_ptr[j]) {
 					output_ptr[j] = i+1;
 					break;
 				}
 		for (j = 0; j < RTE_DIST_BURST_SIZE; j++)
-			for (w = 0; w < RTE_DIST_BURST_SIZE; w++)
+			for (w = 0; w < d->burst_size; w++)
 				if (bl->tags[w] == data_ptr[j]) {
 					output_ptr[j] = i+1;
 					break;
@@ -289,7 +309,8 @@ handle_worker_shutdown(struct rte_distributor *d, unsigned int wkr)
 {
 	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
 	/* double BURST size for storing both inflights and backlog */
-	struct rte_mbuf *pkts[RTE_DIST_BURST_SIZE * 2];
+	struct rte_mbuf *pkts[RTE_DIST_BURST_SIZE_MAX * 2];
+	uint16_t *in_flight_tags = dist_in_flight_tags(d, wkr);
 	unsigned int pkts_count = 0;
 	unsigned int i;
 
@@ -299,7 +320,7 @@ handle_worker_shutdown(struct rte_distributor *d, unsigned int wkr)
 	 */
 	if (!(__atomic_load_n(&(buf->bufptr64[0]), __ATOMIC_ACQUIRE)
 		& RTE_DISTRIB_GET_BUF))
-		for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
+		for (i = 0; i < d->burst_size; i++)
 			if (buf->bufptr64[i] & RTE_DISTRIB_VALID_BUF)
 				pkts[pkts_count++] = (void *)((uintptr_t)
 					(buf->bufptr64[i]
@@ -321,8 +342,8 @@ handle_worker_shutdown(struct rte_distributor *d, unsigned int wkr)
 	d->backlog[wkr].count = 0;
 
 	/* Clear both inflight and backlog tags */
-	for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
-		d->in_flight_tags[wkr][i] = 0;
+	for (i = 0; i < d->burst_size; i++) {
+		in_flight_tags[i] = 0;
 		d->backlog[wkr].tags[i] = 0;
 	}
 
@@ -350,7 +371,7 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 	/* Sync on GET_BUF flag. Acquire retptrs. */
 	if (__atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE)
 		& (RTE_DISTRIB_GET_BUF | RTE_DISTRIB_RETURN_BUF)) {
-		for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
+		for (i = 0; i < d->burst_size; i++) {
 			if (buf->retptr64[i] & RTE_DISTRIB_VALID_BUF) {
 				oldbuf = ((uintptr_t)(buf->retptr64[i] >>
 					RTE_DISTRIB_FLAG_BITS));
@@ -397,6 +418,7 @@ static unsigned int
 release(struct rte_distributor *d, unsigned int wkr)
 {
 	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
+	uint16_t *in_flight_tags;
 	unsigned int i;
 
 	handle_returns(d, wkr);
@@ -413,16 +435,17 @@ release(struct rte_distributor *d, unsigned int wkr)
 	}
 
 	buf->count = 0;
+	in_flight_tags = dist_in_flight_tags(d, wkr);
 
 	for (i = 0; i < d->backlog[wkr].count; i++) {
 		d->bufs[wkr].bufptr64[i] = d->backlog[wkr].pkts[i] |
 				RTE_DISTRIB_GET_BUF | RTE_DISTRIB_VALID_BUF;
-		d->in_flight_tags[wkr][i] = d->backlog[wkr].tags[i];
+		in_flight_tags[i] = d->backlog[wkr].tags[i];
 	}
 	buf->count = i;
-	for ( ; i < RTE_DIST_BURST_SIZE ; i++) {
+	for ( ; i < d->burst_size ; i++) {
 		buf->bufptr64[i] = RTE_DISTRIB_GET_BUF;
-		d->in_flight_tags[wkr][i] = 0;
+		in_flight_tags[i] = 0;
 	}
 
 	d->backlog[wkr].count = 0;
@@ -456,6 +479,9 @@ rte_distributor_process(struct rte_distributor *d,
 			mbufs, num_mbufs);
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS)
+		return rte_distributor_process_ring(d, mbufs, num_mbufs);
+
 	for (wid = 0 ; wid < d->num_workers; wid++)
 		handle_returns(d, wid);
 
@@ -507,6 +533,18 @@ rte_distributor_process(struct rte_distributor *d,
 					find_match_vec(d, &flows[0],
 						&matches[0]);
 					break;
+#ifdef CC_AVX2_SUPPORT
+				case RTE_DIST_MATCH_AVX2:
+					find_match_avx2(d, &flows[0],
+						&matches[0]);
+					break;
+#endif
+#ifdef CC_AVX512_SUPPORT
+				case RTE_DIST_MATCH_AVX512:
+					find_match_avx512(d, &flows[0],
+						&matches[0]);
+					break;
+#endif
 				default:
 					find_match_scalar(d, &flows[0],
 						&matches[0]);
@@ -542,7 +580,7 @@ rte_distributor_process(struct rte_distributor *d,
 				struct rte_distributor_backlog *bl =
 						&d->backlog[matches[j]-1];
 				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
+						d->burst_size)) {
 					release(d, matches[j]-1);
 					if (!d->active[matches[j]-1]) {
 						j--;
@@ -566,7 +604,7 @@ rte_distributor_process(struct rte_distributor *d,
 				bl = &d->backlog[wkr];
 
 				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
+						d->burst_size)) {
 					release(d, wkr);
 					if (!d->active[wkr]) {
 						j--;
@@ -665,6 +703,9 @@ rte_distributor_flush(struct rte_distributor *d)
 		return rte_distributor_flush_single(d->d_single);
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS)
+		return rte_distributor_flush_ring(d);
+
 	flushed = total_outstanding(d);
 
 	while (total_outstanding(d) > 0)
@@ -697,6 +738,11 @@ rte_distributor_clear_returns(struct rte_distributor *d)
 		return;
 	}
 
+	if (d->flags & RTE_DIST_F_WORKER_RINGS) {
+		rte_distributor_clear_returns_ring(d);
+		return;
+	}
+
 	/* throw away returns, so workers can exit */
 	for (wkr = 0; wkr < d->num_workers; wkr++)
 		/* Sync with worker. Release retptrs. */
@@ -706,6 +752,95 @@ rte_distributor_clear_returns(struct rte_distributor *d)
 	d->returns.start = d->returns.count = 0;
 }
 
+/* selects the flow matching function of a burst distributor */
+static enum rte_distributor_match_function
+select_match_fn(void)
+{
+	uint16_t simd_bitwidth = rte_vect_get_max_simd_bitwidth();
+
+#if defined(RTE_ARCH_X86)
+#ifdef CC_AVX512_SUPPORT
+	if (simd_bitwidth >= RTE_VECT_SIMD_512 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VL) > 0)
+		return RTE_DIST_MATCH_AVX512;
+#endif
+#ifdef CC_AVX2_SUPPORT
+	if (simd_bitwidth >= RTE_VECT_SIMD_256 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) > 0)
+		return RTE_DIST_MATCH_AVX2;
+#endif
+	if (simd_bitwidth >= RTE_VECT_SIMD_128)
+		return RTE_DIST_MATCH_VECTOR;
+#elif defined(RTE_ARCH_ARM64)
+	if (simd_bitwidth >= RTE_VECT_SIMD_128 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON) > 0)
+		return RTE_DIST_MATCH_VECTOR;
+#else
+	RTE_SET_USED(simd_bitwidth);
+#endif
+	return RTE_DIST_MATCH_SCALAR;
+}
+
+/* creates a burst distributor instance */
+static struct rte_distributor *
+create_burst(const char *name, unsigned int socket_id,
+		const struct rte_distributor_conf *conf)
+{
+	struct rte_distributor *d;
+	struct rte_dist_burst_list *dist_burst_list;
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	unsigned int i;
+
+	snprintf(mz_name, sizeof(mz_name), RTE_DISTRIB_PREFIX"%s", name);
+	mz = rte_memzone_reserve(mz_name, sizeof(*d), socket_id, NO_FLAGS);
+	if (mz == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	d = mz->addr;
+	strlcpy(d->name, name, sizeof(d->name));
+	d->num_workers = conf->num_workers;
+	d->alg_type = RTE_DIST_ALG_BURST;
+	d->burst_size = conf->burst_size;
+	d->flags = conf->flags;
+
+	d->dist_match_fn = select_match_fn();
+
+	/*
+	 * Set up the backlog tags so they're pointing at the second half
+	 * of the tags of the worker for performance during flow matching
+	 */
+	for (i = 0 ; i < conf->num_workers ; i++)
+		d->backlog[i].tags =
+			&dist_in_flight_tags(d, i)[conf->burst_size];
+
+	memset(d->active, 0, sizeof(d->active));
+	d->activesum = 0;
+
+	if (d->flags & RTE_DIST_F_WORKER_RINGS) {
+		if (rte_distributor_ring_init(d, socket_id,
+				conf->ring_size) != 0) {
+			rte_memzone_free(mz);
+			/* rte_errno will have been set */
+			return NULL;
+		}
+	}
+
+	dist_burst_list = RTE_TAILQ_CAST(rte_dist_burst_tailq.head,
+					  rte_dist_burst_list);
+
+
+	rte_mcfg_tailq_write_lock();
+	TAILQ_INSERT_TAIL(dist_burst_list, d, next);
+	rte_mcfg_tailq_write_unlock();
+
+	return d;
+}
+
 /* creates a distributor instance */
 struct rte_distributor *
 rte_distributor_create(const char *name,
@@ -713,11 +848,11 @@ rte_distributor_create(const char *name,
 		unsigned int num_workers,
 		unsigned int alg_type)
 {
+	struct rte_distributor_conf conf = {
+		.num_workers = num_workers,
+		.burst_size = RTE_DIST_BURST_SIZE,
+	};
 	struct rte_distributor *d;
-	struct rte_dist_burst_list *dist_burst_list;
-	char mz_name[RTE_MEMZONE_NAMESIZE];
-	const struct rte_memzone *mz;
-	unsigned int i;
 
 	/* TODO Reorganise function properly around RTE_DIST_ALG_SINGLE/BURST */
 
@@ -748,41 +883,40 @@ rte_distributor_create(const char *name,
 		return d;
 	}
 
-	snprintf(mz_name, sizeof(mz_name), RTE_DISTRIB_PREFIX"%s", name);
-	mz = rte_memzone_reserve(mz_name, sizeof(*d), socket_id, NO_FLAGS);
-	if (mz == NULL) {
-		rte_errno = ENOMEM;
-		return NULL;
-	}
-
-	d = mz->addr;
-	strlcpy(d->name, name, sizeof(d->name));
-	d->num_workers = num_workers;
-	d->alg_type = alg_type;
-
-	d->dist_match_fn = RTE_DIST_MATCH_SCALAR;
-#if defined(RTE_ARCH_X86)
-	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
-		d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
-#endif
-
-	/*
-	 * Set up the backlog tags so they're pointing at the second cache
-	 * line for performance during flow matching
-	 */
-	for (i = 0 ; i < num_workers ; i++)
-		d->backlog[i].tags = &d->in_flight_tags[i][RTE_DIST_BURST_SIZE];
+	return create_burst(name, socket_id, &conf);
+}
 
-	memset(d->active, 0, sizeof(d->active));
-	d->activesum = 0;
+/* creates a burst distributor instance with a configuration */
+struct rte_distributor *
+rte_distributor_create_conf(const char *name, unsigned int socket_id,
+		const struct rte_distributor_conf *conf)
+{
+	struct rte_distributor_conf c;
 
-	dist_burst_list = RTE_TAILQ_CAST(rte_dist_burst_tailq.head,
-					  rte_dist_burst_list);
+	if (name == NULL || conf == NULL || conf->num_workers >=
+		(unsigned int)RTE_MIN(RTE_DISTRIB_MAX_WORKERS, RTE_MAX_LCORE) ||
+			(conf->flags & ~RTE_DIST_F_WORKER_RINGS) != 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
 
+	c = *conf;
+	if (c.burst_size == 0)
+		c.burst_size = RTE_DIST_BURST_SIZE;
+	if (c.ring_size == 0)
+		c.ring_size = RTE_DIST_RING_SIZE;
 
-	rte_mcfg_tailq_write_lock();
-	TAILQ_INSERT_TAIL(dist_burst_list, d, next);
-	rte_mcfg_tailq_write_unlock();
+	/* the flow matching compares tags 8 at a time */
+	if (c.burst_size % RTE_DIST_BURST_SIZE != 0 ||
+			c.burst_size > RTE_DIST_BURST_SIZE_MAX) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if ((c.flags & RTE_DIST_F_WORKER_RINGS) && (c.ring_size <
+			c.burst_size || c.ring_size > RTE_DIST_RING_SIZE_MAX)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
 
-	return d;
+	return create_burst(name, socket_id, &c);
 }
@@ -13,6 +13,11 @@
  * one-at-a-time to workers, with dynamic load balancing.
  */
 
+#include <stdint.h>
+
+#include <rte_bitops.h>
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,9 +29,37 @@ enum rte_distributor_alg_type {
 	RTE_DIST_NUM_ALG_TYPES
 };
 
+/** Maximum number of packets given to a worker at once. */
+#define RTE_DIST_BURST_SIZE_MAX 32
+
+/** Pass the packets to the workers through per-worker rings. */
+#define RTE_DIST_F_WORKER_RINGS RTE_BIT32(0)
+
 struct rte_distributor;
 struct rte_mbuf;
 
+/**
+ * Distributor configuration, see rte_distributor_create_conf().
+ */
+struct rte_distributor_conf {
+	/** Maximum number of workers that will request packets. */
+	unsigned int num_workers;
+	/**
+	 * Maximum number of packets given to a worker at once,
+	 * a multiple of 8 up to RTE_DIST_BURST_SIZE_MAX, 0 for 8.
+	 * The array of mbufs of a worker given to rte_distributor_get_pkt()
+	 * and rte_distributor_poll_pkt() must hold this number of packets.
+	 */
+	unsigned int burst_size;
+	/**
+	 * Size of the rings of each worker with RTE_DIST_F_WORKER_RINGS,
+	 * at least burst_size and up to 65536, 0 for 512.
+	 */
+	unsigned int ring_size;
+	/** RTE_DIST_F_* flags. */
+	uint32_t flags;
+};
+
 /**
  * Function to create a new distributor instance
  *
@@ -52,6 +85,36 @@ rte_distributor_create(const char *name, unsigned int socket_id,
 		unsigned int num_workers,
 		unsigned int alg_type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Function to create a new burst distributor instance with a configuration
+ *
+ * Unlike rte_distributor_create(), the number of packets given to a worker
+ * at once can be above 8. With RTE_DIST_F_WORKER_RINGS, the packets are
+ * passed to each worker through a pair of rings rather than a cache line
+ * handshake, so a worker has packets queued while it is busy, and the flows
+ * are pinned to the workers through a flow table rather than by comparing
+ * them with the tags in-flight on every worker, which scales better with
+ * the number of workers.
+ *
+ * @param name
+ *   The name to be given to the distributor instance.
+ * @param socket_id
+ *   The NUMA node on which the memory is to be allocated
+ * @param conf
+ *   The configuration of the distributor.
+ * @return
+ *   The newly created distributor instance, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameter
+ *    - ENOMEM - no appropriate memory area found
+ */
+__rte_experimental
+struct rte_distributor *
+rte_distributor_create_conf(const char *name, unsigned int socket_id,
+		const struct rte_distributor_conf *conf);
+
 /*  *** APIS to be called on the distributor lcore ***  */
 /*
  * The following APIs are the public APIs which are designed for use on a
@@ -153,7 +216,8 @@ rte_distributor_clear_returns(struct rte_distributor *d);
  *   The worker instance number to use - must be less that num_workers passed
  *   at distributor creation time.
  * @param pkts
- *   The mbufs pointer array to be filled in (up to 8 packets)
+ *   The mbufs pointer array to be filled in (up to 8 packets, or up to
+ *   the burst size of a distributor created by rte_distributor_create_conf())
  * @param oldpkt
  *   The previous packets, if any, being processed by the worker
  * @param retcount
@@ -224,7 +288,8 @@ rte_distributor_request_pkt(struct rte_distributor *d,
  *   The worker instance number to use - must be less that num_workers passed
  *   at distributor creation time.
  * @param mbufs
- *   The array of mbufs being given to the worker
+ *   The array of mbufs being given to the worker, of the burst size
+ *   of the distributor
  *
  * @return
  *   The number of packets being given to the worker thread,
@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/*
+ * Compare the 8 incoming flow IDs, repeated in both 128-bit lanes, with
+ * 8 tags in each lane. Rotating the tags within their lane compares each
+ * incoming flow ID with every tag of the lane.
+ */
+static __rte_always_inline __m256i
+match_tags_avx2(__m256i incoming_fids, __m256i tags)
+{
+	__m256i mask;
+
+	mask = _mm256_cmpeq_epi16(incoming_fids, tags);
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 2)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 4)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 6)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 8)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 10)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 12)));
+	mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(incoming_fids,
+		_mm256_alignr_epi8(tags, tags, 14)));
+
+	return mask;
+}
+
+void
+find_match_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m256i incoming_fids;
+	__m256i tags;
+	__m256i mask;
+	__m128i match;
+	__m128i output;
+	uint16_t *in_flight_tags;
+	uint16_t i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Loop through all worker ID's
+	 *  1a. Load the inflights and the backlog of the worker, 16 tags
+	 *      at a time into a ymm reg
+	 *  1b. Compare them with the incoming tags in both lanes
+	 *  1c. Add any matches to the output
+	 * 2. Write the output xmm (matching worker ids).
+	 */
+
+	output = _mm_setzero_si128();
+	incoming_fids = _mm256_broadcastsi128_si256(
+		_mm_load_si128((__m128i *)data_ptr));
+
+	for (i = 0; i < d->num_workers; i++) {
+		in_flight_tags = dist_in_flight_tags(d, i);
+		mask = _mm256_setzero_si256();
+
+		for (j = 0; j < d->burst_size * 2; j += 16) {
+			tags = _mm256_loadu_si256(
+				(const __m256i *)&in_flight_tags[j]);
+			mask = _mm256_or_si256(mask,
+				match_tags_avx2(incoming_fids, tags));
+		}
+
+		match = _mm_or_si128(_mm256_castsi256_si128(mask),
+			_mm256_extracti128_si256(mask, 1));
+		output = _mm_or_si128(output,
+			_mm_and_si128(match, _mm_set1_epi16(i + 1)));
+	}
+
+	_mm_store_si128((__m128i *)output_ptr, output);
+}
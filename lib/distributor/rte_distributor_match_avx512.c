@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_bitops.h>
+#include <rte_vect.h>
+
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/*
+ * Compare the 8 incoming flow IDs, repeated in the four 128-bit lanes,
+ * with 8 tags in each lane. Rotating the tags within their lane compares
+ * each incoming flow ID with every tag of the lane.
+ */
+static __rte_always_inline __mmask32
+match_tags_avx512(__m512i incoming_fids, __m512i tags)
+{
+	__mmask32 mask;
+
+	mask = _mm512_cmpeq_epi16_mask(incoming_fids, tags);
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 2));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 4));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 6));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 8));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 10));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 12));
+	mask |= _mm512_cmpeq_epi16_mask(incoming_fids,
+		_mm512_alignr_epi8(tags, tags, 14));
+
+	return mask;
+}
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	/* the tags of the workers are contiguous, in groups of 8 */
+	const uint32_t worker_groups = d->burst_size * 2 / RTE_DIST_BURST_SIZE;
+	const uint32_t groups = d->num_workers * worker_groups;
+	__m512i incoming_fids;
+	__m512i tags;
+	__m128i output;
+	uint32_t g, q, mask;
+
+	/*
+	 * Function overview:
+	 * 1. Loop through the tags of all the workers, 4 groups of 8 tags
+	 *    at a time, a group being the inflights or the backlog of a
+	 *    worker, or a part of them for bursts bigger than 8 packets
+	 *  1a. Compare them with the incoming tags in each lane
+	 *  1b. Set the worker of the matching groups in the output
+	 * 2. Write the output xmm (matching worker ids).
+	 */
+
+	output = _mm_setzero_si128();
+	incoming_fids = _mm512_broadcast_i32x4(
+		_mm_load_si128((__m128i *)data_ptr));
+
+	for (g = 0; g < groups; g += 4) {
+		tags = _mm512_loadu_si512(
+			&d->in_flight_tags[g * RTE_DIST_BURST_SIZE]);
+		mask = match_tags_avx512(incoming_fids, tags);
+
+		/* ignore the groups beyond the last worker */
+		if (unlikely(g + 4 > groups))
+			mask &= (UINT32_C(1) <<
+				((groups - g) * RTE_DIST_BURST_SIZE)) - 1;
+
+		while (mask != 0) {
+			q = rte_bsf32(mask) / RTE_DIST_BURST_SIZE;
+			output = _mm_mask_set1_epi16(output,
+				mask >> (q * RTE_DIST_BURST_SIZE),
+				(g + q) / worker_groups + 1);
+			mask &= ~(UINT32_C(0xff) << (q * RTE_DIST_BURST_SIZE));
+		}
+	}
+
+	_mm_store_si128((__m128i *)output_ptr, output);
+}
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/*
+ * Compare the 8 incoming flow IDs with 8 tags. Rotating the tags
+ * compares each incoming flow ID with every tag.
+ */
+static __rte_always_inline uint16x8_t
+match_tags_neon(uint16x8_t incoming_fids, uint16x8_t tags)
+{
+	uint16x8_t mask;
+
+	mask = vceqq_u16(incoming_fids, tags);
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 1)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 2)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 3)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 4)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 5)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 6)));
+	mask = vorrq_u16(mask, vceqq_u16(incoming_fids,
+		vextq_u16(tags, tags, 7)));
+
+	return mask;
+}
+
+void
+find_match_vec(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	uint16x8_t incoming_fids;
+	uint16x8_t mask;
+	uint16x8_t output;
+	uint16_t *in_flight_tags;
+	uint16_t i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Loop through all worker ID's
+	 *  1a. Load the inflights and the backlog of the worker, 8 tags
+	 *      at a time
+	 *  1b. Compare them with the incoming tags
+	 *  1c. Add any matches to the output
+	 * 2. Write the output (matching worker ids).
+	 */
+
+	output = vdupq_n_u16(0);
+	incoming_fids = vld1q_u16(data_ptr);
+
+	for (i = 0; i < d->num_workers; i++) {
+		in_flight_tags = dist_in_flight_tags(d, i);
+		mask = vdupq_n_u16(0);
+
+		for (j = 0; j < d->burst_size * 2; j += RTE_DIST_BURST_SIZE)
+			mask = vorrq_u16(mask, match_tags_neon(incoming_fids,
+				vld1q_u16(&in_flight_tags[j])));
+
+		output = vorrq_u16(output,
+			vandq_u16(mask, vdupq_n_u16(i + 1)));
+	}
+
+	vst1q_u16(output_ptr, output);
+}
@@ -0,0 +1,525 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <sys/queue.h>
+#include <string.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/*
+ * In ring mode, the distributor enqueues the packets of a worker to its
+ * to_wkr ring and the worker returns packets through its from_wkr ring.
+ * A worker publishes the number of packets it completed, i.e. all the
+ * packets it received before requesting more. The distributor records the
+ * tag of every packet sent to a worker, so it can count the packets of
+ * each flow not completed yet and keep the flow on its worker meanwhile.
+ */
+
+/**** Ring mode APIs called by workers ****/
+
+void
+rte_distributor_request_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **oldpkt,
+		unsigned int count)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[worker_id];
+	unsigned int n;
+
+	/* Wait for the distributor to take back the packets after a return. */
+	while (unlikely(__atomic_load_n(&rw->state, __ATOMIC_ACQUIRE) ==
+			RTE_DIST_RING_WKR_SHUTDOWN))
+		rte_pause();
+
+	while (count > 0) {
+		n = rte_ring_enqueue_burst(rw->from_wkr, (void **)oldpkt,
+			count, NULL);
+		oldpkt += n;
+		count -= n;
+		if (count > 0)
+			rte_pause();
+	}
+
+	/*
+	 * All the packets received so far are completed.
+	 * Sync with distributor to release the flows of these packets.
+	 */
+	__atomic_store_n(&rw->done, rw->received, __ATOMIC_RELEASE);
+	if (unlikely(rw->state != RTE_DIST_RING_WKR_ACTIVE))
+		__atomic_store_n(&rw->state, RTE_DIST_RING_WKR_ACTIVE,
+			__ATOMIC_RELEASE);
+}
+
+int
+rte_distributor_poll_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **pkts)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[worker_id];
+	unsigned int n;
+
+	n = rte_ring_dequeue_burst(rw->to_wkr, (void **)pkts, d->burst_size,
+		NULL);
+	if (n == 0)
+		return -1;
+
+	rw->received += n;
+	return n;
+}
+
+int
+rte_distributor_get_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **pkts,
+		struct rte_mbuf **oldpkt, unsigned int return_count)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[worker_id];
+	uint32_t wake;
+	int count;
+
+	rte_distributor_request_pkt_ring(d, worker_id, oldpkt, return_count);
+
+	count = rte_distributor_poll_pkt_ring(d, worker_id, pkts);
+	while (count == -1) {
+		/* A flush gives an empty burst to the waiting workers. */
+		wake = __atomic_load_n(&rw->wake, __ATOMIC_ACQUIRE);
+		if (wake != rw->wake_seen) {
+			rw->wake_seen = wake;
+			return 0;
+		}
+
+		uint64_t t = rte_rdtsc() + 100;
+
+		while (rte_rdtsc() < t)
+			rte_pause();
+
+		count = rte_distributor_poll_pkt_ring(d, worker_id, pkts);
+	}
+	return count;
+}
+
+int
+rte_distributor_return_pkt_ring(struct rte_distributor *d,
+		unsigned int worker_id, struct rte_mbuf **oldpkt, int num)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[worker_id];
+	unsigned int n, count = num;
+
+	while (unlikely(__atomic_load_n(&rw->state, __ATOMIC_ACQUIRE) ==
+			RTE_DIST_RING_WKR_SHUTDOWN))
+		rte_pause();
+
+	while (count > 0) {
+		n = rte_ring_enqueue_burst(rw->from_wkr, (void **)oldpkt,
+			count, NULL);
+		oldpkt += n;
+		count -= n;
+		if (count > 0)
+			rte_pause();
+	}
+
+	/*
+	 * Notify distributor that we don't request more packets any more,
+	 * it takes back the packets left in the ring and clears the state.
+	 */
+	__atomic_store_n(&rw->done, rw->received, __ATOMIC_RELEASE);
+	__atomic_store_n(&rw->state, RTE_DIST_RING_WKR_SHUTDOWN,
+		__ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/**** Ring mode APIs called on distributor core ***/
+
+/* stores packets returned from a worker inside the returns array */
+static inline void
+store_returns(struct rte_distributor *d, struct rte_mbuf **mbufs,
+		unsigned int num)
+{
+	unsigned int ret_start = d->returns.start,
+			ret_count = d->returns.count;
+	unsigned int i;
+
+	/* store returns in a circular buffer */
+	for (i = 0; i < num; i++) {
+		d->returns.mbufs[(ret_start + ret_count) &
+				RTE_DISTRIB_RETURNS_MASK] = mbufs[i];
+		ret_start += (ret_count == RTE_DISTRIB_RETURNS_MASK);
+		ret_count += (ret_count != RTE_DISTRIB_RETURNS_MASK);
+	}
+	d->returns.start = ret_start;
+	d->returns.count = ret_count;
+}
+
+/* number of packets of a worker queued or being processed */
+static inline uint32_t
+ring_outstanding(const struct rte_distributor *d, unsigned int wkr)
+{
+	const struct rte_distributor_ring_worker *rw = &d->ring_wkrs[wkr];
+
+	return rw->sent - rw->retired + rw->count;
+}
+
+/* releases the flows of the packets sent to a worker up to sequence done */
+static inline void
+ring_retire(struct rte_distributor *d, struct rte_distributor_ring_worker *rw,
+		uint32_t done)
+{
+	uint16_t tag;
+
+	while ((int32_t)(done - rw->retired) > 0) {
+		tag = rw->tags[rw->retired++ & rw->tags_mask];
+		d->flows[tag >> 1] -= 1 << RTE_DIST_FLOW_CNT_SHIFT;
+	}
+}
+
+/*
+ * Distributes again packets taken back from a worker, hands them back
+ * to the application as returned packets if no worker is left.
+ */
+static void
+ring_redistribute(struct rte_distributor *d, struct rte_mbuf **pkts,
+		unsigned int num)
+{
+	unsigned int done;
+
+	done = rte_distributor_process_ring(d, pkts, num);
+	if (unlikely(done < num))
+		store_returns(d, &pkts[done], num - done);
+}
+
+/*
+ * When worker called rte_distributor_return_pkt(), distributor must
+ * retrieve both the packets left in its ring and its backlog and
+ * reprocess them to another worker.
+ */
+static void
+ring_worker_shutdown(struct rte_distributor *d, unsigned int wkr)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[wkr];
+	struct rte_mbuf *pkts[RTE_DIST_BURST_SIZE_MAX];
+	struct rte_mbuf *bl_pkts[RTE_DIST_BURST_SIZE_MAX];
+	unsigned int i, n, bl_count;
+
+	d->activesum -= d->active[wkr];
+	d->active[wkr] = 0;
+	rw->closing = 1;
+
+	/* None of the packets of the worker is in-flight any more. */
+	ring_retire(d, rw, rw->sent);
+	bl_count = rw->count;
+	for (i = 0; i < bl_count; i++) {
+		d->flows[rw->bl_tags[i] >> 1] -= 1 << RTE_DIST_FLOW_CNT_SHIFT;
+		bl_pkts[i] = rw->bl_pkts[i];
+	}
+	rw->count = 0;
+
+	/* The ring packets were sent before the backlog ones. */
+	do {
+		n = rte_ring_dequeue_burst(rw->to_wkr, (void **)pkts,
+			RTE_DIST_BURST_SIZE_MAX, NULL);
+		if (n > 0)
+			ring_redistribute(d, pkts, n);
+	} while (n > 0);
+	if (bl_count > 0)
+		ring_redistribute(d, bl_pkts, bl_count);
+
+	/*
+	 * The worker waits for the state to be cleared before touching its
+	 * counters again, restart them from the packets sent.
+	 * Sync with worker on state. Release counters.
+	 */
+	rw->received = rw->sent;
+	rw->done = rw->sent;
+	rw->closing = 0;
+	__atomic_store_n(&rw->state, RTE_DIST_RING_WKR_IDLE, __ATOMIC_RELEASE);
+}
+
+/*
+ * Collects the packets returned by a worker, releases the flows of the
+ * packets it completed and handles the change of state of the worker.
+ */
+static void
+ring_handle_returns(struct rte_distributor *d, unsigned int wkr)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[wkr];
+	struct rte_mbuf *mbufs[RTE_DIST_BURST_SIZE_MAX];
+	uint32_t state;
+	unsigned int n;
+
+	/* Sync with worker on state. Acquire counters. */
+	state = __atomic_load_n(&rw->state, __ATOMIC_ACQUIRE);
+	if (state == RTE_DIST_RING_WKR_IDLE || unlikely(rw->closing))
+		return;
+
+	do {
+		n = rte_ring_dequeue_burst(rw->from_wkr, (void **)mbufs,
+			RTE_DIST_BURST_SIZE_MAX, NULL);
+		store_returns(d, mbufs, n);
+	} while (n == RTE_DIST_BURST_SIZE_MAX);
+
+	ring_retire(d, rw, __atomic_load_n(&rw->done, __ATOMIC_ACQUIRE));
+
+	if (unlikely(state == RTE_DIST_RING_WKR_SHUTDOWN))
+		ring_worker_shutdown(d, wkr);
+	else if (unlikely(!d->active[wkr])) {
+		d->active[wkr] = 1;
+		d->activesum++;
+	}
+}
+
+/*
+ * Enqueues the backlog of a worker to its ring, waiting for room in
+ * the ring while the worker is active.
+ */
+static void
+ring_release(struct rte_distributor *d, unsigned int wkr)
+{
+	struct rte_distributor_ring_worker *rw = &d->ring_wkrs[wkr];
+	unsigned int i, n, room;
+
+	while (rw->count > 0) {
+		/* A tag is kept until the packet is completed. */
+		room = rw->tags_mask + 1 - (rw->sent - rw->retired);
+		n = rte_ring_enqueue_burst(rw->to_wkr, (void **)rw->bl_pkts,
+			RTE_MIN(rw->count, room), NULL);
+		for (i = 0; i < n; i++)
+			rw->tags[rw->sent++ & rw->tags_mask] = rw->bl_tags[i];
+
+		rw->count -= n;
+		if (rw->count == 0)
+			break;
+		if (n > 0) {
+			memmove(rw->bl_pkts, &rw->bl_pkts[n],
+				rw->count * sizeof(rw->bl_pkts[0]));
+			memmove(rw->bl_tags, &rw->bl_tags[n],
+				rw->count * sizeof(rw->bl_tags[0]));
+		}
+
+		/* Backlog packets are redistributed if the worker returns. */
+		ring_handle_returns(d, wkr);
+		if (unlikely(!d->active[wkr]))
+			break;
+		rte_pause();
+	}
+}
+
+/* selects the worker of a packet from the state of its flow */
+static inline unsigned int
+ring_select_worker(struct rte_distributor *d, uint32_t flow)
+{
+	unsigned int wkr, n;
+
+	/* Flow with packets in-flight, stay on the same worker. */
+	if (flow >> RTE_DIST_FLOW_CNT_SHIFT)
+		return (flow & RTE_DIST_FLOW_WKR_MASK) - 1;
+
+	/* Keep an idle flow on its last worker while it is not busy. */
+	wkr = flow & RTE_DIST_FLOW_WKR_MASK;
+	if (wkr != 0 && d->active[wkr - 1] &&
+			ring_outstanding(d, wkr - 1) < d->burst_size)
+		return wkr - 1;
+
+	/* New flows go to the current worker, or the next one with room. */
+	for (n = 0; n < d->num_workers; n++) {
+		wkr = d->next_wkr;
+		if (d->active[wkr] && ring_outstanding(d, wkr) < d->ring_size)
+			return wkr;
+		d->next_wkr = (wkr + 1) % d->num_workers;
+	}
+
+	/* All the rings are full, wait for the next active worker. */
+	while (!d->active[d->next_wkr])
+		d->next_wkr = (d->next_wkr + 1) % d->num_workers;
+	return d->next_wkr;
+}
+
+/* process a set of packets to distribute them to workers */
+int
+rte_distributor_process_ring(struct rte_distributor *d,
+		struct rte_mbuf **mbufs, unsigned int num_mbufs)
+{
+	struct rte_distributor_ring_worker *rw;
+	unsigned int i, wkr;
+	uint32_t *flow;
+	uint16_t tag;
+
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		ring_handle_returns(d, wkr);
+
+	for (i = 0; i < num_mbufs; i++) {
+		if (unlikely(!d->activesum))
+			return i;
+
+		/* flows MUST be non-zero */
+		tag = (uint16_t)(mbufs[i]->hash.usr) | 1;
+		flow = &d->flows[tag >> 1];
+		wkr = ring_select_worker(d, *flow);
+		rw = &d->ring_wkrs[wkr];
+
+		if (unlikely(rw->count == d->burst_size)) {
+			ring_release(d, wkr);
+			/* The flow may have moved if the worker returned. */
+			if (unlikely(!d->active[wkr])) {
+				i--;
+				continue;
+			}
+		}
+
+		rw->bl_tags[rw->count] = tag;
+		rw->bl_pkts[rw->count++] = mbufs[i];
+		*flow = ((*flow >> RTE_DIST_FLOW_CNT_SHIFT) + 1) <<
+			RTE_DIST_FLOW_CNT_SHIFT | (wkr + 1);
+
+		/* New flows go to the next worker every 8 packets. */
+		if ((i + 1) % RTE_DIST_BURST_SIZE == 0 || i + 1 == num_mbufs)
+			d->next_wkr = (d->next_wkr + 1) % d->num_workers;
+	}
+
+	/* Flush out all non-empty backlogs to workers. */
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		if (d->ring_wkrs[wkr].count > 0)
+			ring_release(d, wkr);
+
+	return num_mbufs;
+}
+
+/*
+ * Return the number of packets in-flight in a distributor, i.e. packets
+ * being worked on or queued up in a ring or a backlog.
+ */
+static inline unsigned int
+ring_total_outstanding(const struct rte_distributor *d)
+{
+	unsigned int wkr, total_outstanding = 0;
+
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		total_outstanding += ring_outstanding(d, wkr);
+
+	return total_outstanding;
+}
+
+int
+rte_distributor_flush_ring(struct rte_distributor *d)
+{
+	struct rte_distributor_ring_worker *rw;
+	unsigned int flushed;
+	unsigned int wkr;
+
+	flushed = ring_total_outstanding(d);
+
+	while (ring_total_outstanding(d) > 0)
+		rte_distributor_process_ring(d, NULL, 0);
+
+	/*
+	 * Send empty burst to all workers to allow them to exit
+	 * gracefully, should they need to.
+	 */
+	for (wkr = 0; wkr < d->num_workers; wkr++) {
+		rw = &d->ring_wkrs[wkr];
+		__atomic_store_n(&rw->wake, rw->wake + 1, __ATOMIC_RELEASE);
+	}
+
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		ring_handle_returns(d, wkr);
+
+	return flushed;
+}
+
+void
+rte_distributor_clear_returns_ring(struct rte_distributor *d)
+{
+	struct rte_mbuf *mbufs[RTE_DIST_BURST_SIZE_MAX];
+	unsigned int wkr, n;
+
+	/* throw away returns, so workers can exit */
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		do {
+			n = rte_ring_dequeue_burst(d->ring_wkrs[wkr].from_wkr,
+				(void **)mbufs, RTE_DIST_BURST_SIZE_MAX, NULL);
+		} while (n > 0);
+
+	d->returns.start = d->returns.count = 0;
+}
+
+/* allocates the rings and the flow table of a distributor in ring mode */
+int
+rte_distributor_ring_init(struct rte_distributor *d, unsigned int socket_id,
+		unsigned int ring_size)
+{
+	struct rte_distributor_ring_worker *rw;
+	char ring_name[RTE_RING_NAMESIZE];
+	unsigned int i, ring_count, tags_count;
+	ssize_t ring_mem;
+
+	d->ring_size = ring_size;
+	d->next_wkr = 0;
+
+	/* the rings hold exactly ring_size packets */
+	ring_count = rte_align32pow2(ring_size + 1);
+	tags_count = rte_align32pow2(ring_size + d->burst_size);
+	ring_mem = rte_ring_get_memsize(ring_count);
+	if (ring_mem < 0) {
+		rte_errno = EINVAL;
+		return -rte_errno;
+	}
+
+	d->flows = rte_zmalloc_socket(NULL,
+		RTE_DIST_RING_FLOWS * sizeof(d->flows[0]), RTE_CACHE_LINE_SIZE,
+		socket_id);
+	d->ring_wkrs = rte_zmalloc_socket(NULL,
+		RTE_MAX(d->num_workers, 1U) * sizeof(d->ring_wkrs[0]),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (d->flows == NULL || d->ring_wkrs == NULL)
+		goto nomem;
+
+	for (i = 0; i < d->num_workers; i++) {
+		rw = &d->ring_wkrs[i];
+		rw->to_wkr = rte_zmalloc_socket(NULL, ring_mem,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		rw->from_wkr = rte_zmalloc_socket(NULL, ring_mem,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		rw->tags = rte_zmalloc_socket(NULL,
+			tags_count * sizeof(rw->tags[0]), RTE_CACHE_LINE_SIZE,
+			socket_id);
+		if (rw->to_wkr == NULL || rw->from_wkr == NULL ||
+				rw->tags == NULL)
+			goto nomem;
+		rw->tags_mask = tags_count - 1;
+
+		snprintf(ring_name, sizeof(ring_name), "%.20s_t%u", d->name, i);
+		if (rte_ring_init(rw->to_wkr, ring_name, ring_size,
+				RING_F_SP_ENQ | RING_F_SC_DEQ |
+				RING_F_EXACT_SZ) != 0)
+			goto free;
+		snprintf(ring_name, sizeof(ring_name), "%.20s_r%u", d->name, i);
+		if (rte_ring_init(rw->from_wkr, ring_name, ring_size,
+				RING_F_SP_ENQ | RING_F_SC_DEQ |
+				RING_F_EXACT_SZ) != 0)
+			goto free;
+	}
+
+	return 0;
+
+nomem:
+	rte_errno = ENOMEM;
+free:
+	if (d->ring_wkrs != NULL) {
+		for (i = 0; i < d->num_workers; i++) {
+			rte_free(d->ring_wkrs[i].to_wkr);
+			rte_free(d->ring_wkrs[i].from_wkr);
+			rte_free(d->ring_wkrs[i].tags);
+		}
+	}
+	rte_free(d->ring_wkrs);
+	rte_free(d->flows);
+	d->ring_wkrs = NULL;
+	d->flows = NULL;
+	return -rte_errno;
+}
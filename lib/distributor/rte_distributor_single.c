@@ -12,6 +12,7 @@
 #include <rte_pause.h>
 #include <rte_tailq.h>
 
+#include "rte_distributor.h"
 #include "rte_distributor_single.h"
 #include "distributor_private.h"
 
@@ -80,6 +80,7 @@ eal_long_options[] = {
 	{OPT_TRACE_DIR,         1, NULL, OPT_TRACE_DIR_NUM        },
 	{OPT_TRACE_BUF_SIZE,    1, NULL, OPT_TRACE_BUF_SIZE_NUM   },
 	{OPT_TRACE_MODE,        1, NULL, OPT_TRACE_MODE_NUM       },
+	{OPT_TRACE_STREAM,      0, NULL, OPT_TRACE_STREAM_NUM     },
 	{OPT_MAIN_LCORE,        1, NULL, OPT_MAIN_LCORE_NUM       },
 	{OPT_MBUF_POOL_OPS_NAME, 1, NULL, OPT_MBUF_POOL_OPS_NAME_NUM},
 	{OPT_NO_HPET,           0, NULL, OPT_NO_HPET_NUM          },
@@ -104,6 +105,8 @@ eal_long_options[] = {
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
 	{OPT_HUGE_WORKER_STACK, 2, NULL, OPT_HUGE_WORKER_STACK_NUM     },
+	{OPT_HUGE_FAULT_THREADS, 1, NULL, OPT_HUGE_FAULT_THREADS_NUM   },
+	{OPT_MALLOC_LCORE_CACHE, 0, NULL, OPT_MALLOC_LCORE_CACHE_NUM   },
 
 	{0,                     0, NULL, 0                        }
 };
@@ -350,6 +353,8 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->init_complete = 0;
 	internal_cfg->max_simd_bitwidth.bitwidth = RTE_VECT_DEFAULT_SIMD_BITWIDTH;
 	internal_cfg->max_simd_bitwidth.forced = 0;
+	internal_cfg->huge_fault_threads = 0;
+	internal_cfg->malloc_lcore_cache = 0;
 }
 
 static int
@@ -1870,6 +1875,10 @@ eal_parse_common_option(int opt, const char *optarg,
 		}
 		break;
 	}
+
+	case OPT_TRACE_STREAM_NUM:
+		eal_trace_stream_args_save();
+		break;
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 	case OPT_LCORES_NUM:
@@ -1914,6 +1923,9 @@ eal_parse_common_option(int opt, const char *optarg,
 	case OPT_NO_TELEMETRY_NUM:
 		conf->no_telemetry = 1;
 		break;
+	case OPT_MALLOC_LCORE_CACHE_NUM:
+		conf->malloc_lcore_cache = 1;
+		break;
 	case OPT_FORCE_MAX_SIMD_BITWIDTH_NUM:
 		if (eal_parse_simd_bitwidth(optarg) < 0) {
 			RTE_LOG(ERR, EAL, "invalid parameter for --"
@@ -2084,6 +2096,12 @@ eal_check_common_options(struct internal_config *internal_cfg)
 			"be specified together with --"OPT_NO_HUGE"\n");
 		return -1;
 	}
+	if (internal_cfg->no_hugetlbfs &&
+			internal_cfg->huge_fault_threads != 0) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_HUGE_FAULT_THREADS" cannot "
+			"be specified together with --"OPT_NO_HUGE"\n");
+		return -1;
+	}
 	if (internal_conf->force_socket_limits && internal_conf->legacy_mem) {
 		RTE_LOG(ERR, EAL, "Option --"OPT_SOCKET_LIMIT
 			" is only supported in non-legacy memory mode\n");
@@ -2223,6 +2241,10 @@ eal_common_usage(void)
 	       "                      reaches its maximum limit.\n"
 	       "                      Default mode is 'overwrite' and parameter\n"
 	       "                      must be specified once only.\n"
+	       "  --"OPT_TRACE_STREAM"\n"
+	       "                      Continuously write the trace output files\n"
+	       "                      from a control thread. Events are dropped\n"
+	       "                      when the trace memory of a thread is full.\n"
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 	       "  -v                  Display version information on startup\n"
 	       "  -h, --help          This help\n"
@@ -2232,6 +2254,7 @@ eal_common_usage(void)
 	       "  --"OPT_TELEMETRY"   Enable telemetry support (on by default)\n"
 	       "  --"OPT_NO_TELEMETRY"   Disable telemetry support\n"
 	       "  --"OPT_FORCE_MAX_SIMD_BITWIDTH" Force the max SIMD bitwidth\n"
+	       "  --"OPT_MALLOC_LCORE_CACHE" Cache small allocations per lcore\n"
 	       "\nEAL options for DEBUG use only:\n"
 	       "  --"OPT_HUGE_UNLINK"[=existing|always|never]\n"
 	       "                      When to unlink files in hugetlbfs\n"
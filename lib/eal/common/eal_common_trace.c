@@ -2,6 +2,7 @@
  * Copyright(C) 2020 Marvell International Ltd.
  */
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <fnmatch.h>
 #include <sys/queue.h>
@@ -76,6 +77,10 @@ eal_trace_init(void)
 
 	rte_trace_mode_set(trace.mode);
 
+	/* Start writing the trace buffers to the trace directory */
+	if (trace.stream && trace_stream_start() < 0)
+		goto free_meta;
+
 	return 0;
 
 free_meta:
@@ -88,6 +93,7 @@ eal_trace_init(void)
 void
 eal_trace_fini(void)
 {
+	trace_stream_stop();
 	trace_mem_free();
 	trace_metadata_destroy();
 	eal_trace_args_free();
@@ -271,6 +277,10 @@ trace_lcore_mem_dump(FILE *f)
 		trace_area_to_string(trace->lcore_meta[count].area),
 		header->stream_header.lcore_id,
 		header->stream_header.thread_name);
+		if (trace->stream)
+			fprintf(f, "\t\tstream=%u, lost=%"PRIu64"\n",
+				trace->lcore_meta[count].stream_id,
+				header->lost);
 	}
 out:
 	rte_spinlock_unlock(&trace->lock);
@@ -289,6 +299,7 @@ rte_trace_dump(FILE *f)
 	fprintf(f, "mode = %s\n",
 		trace_mode_to_string(rte_trace_mode_get()));
 	fprintf(f, "dir = %s\n", trace->dir);
+	fprintf(f, "stream = %s\n", trace->stream ? "enabled" : "disabled");
 	fprintf(f, "buffer len = %d\n", trace->buff_len);
 	fprintf(f, "number of trace points = %d\n", trace->nb_trace_points);
 
@@ -362,6 +373,11 @@ __rte_trace_mem_per_thread_alloc(void)
 found:
 	header->offset = 0;
 	header->len = trace->buff_len;
+	header->stream = trace->stream;
+	header->head = 0;
+	header->wrap = 0;
+	header->commit = 0;
+	header->lost = 0;
 	header->stream_header.magic = TRACE_CTF_MAGIC;
 	rte_uuid_copy(header->stream_header.uuid, trace->uuid);
 	header->stream_header.lcore_id = rte_lcore_id();
@@ -373,6 +389,8 @@ __rte_trace_mem_per_thread_alloc(void)
 		__RTE_TRACE_EMIT_STRING_LEN_MAX);
 
 	trace->lcore_meta[count].mem = header;
+	trace->lcore_meta[count].stream_id = trace->nb_stream_ids++;
+	trace->lcore_meta[count].stream_fd = -1;
 	trace->nb_trace_mem_list++;
 fail:
 	RTE_PER_LCORE(trace_mem) = header;
@@ -382,6 +400,12 @@ __rte_trace_mem_per_thread_alloc(void)
 static void
 trace_mem_per_thread_free_unlocked(struct thread_mem_meta *meta)
 {
+	struct trace *trace = trace_obj_get();
+
+	/* Write the last events to the trace file */
+	if (trace->stream)
+		trace_stream_close(trace, meta);
+
 	if (meta->area == TRACE_AREA_HUGEPAGE)
 		eal_free_no_trace(meta->mem);
 	else if (meta->area == TRACE_AREA_HEAP)
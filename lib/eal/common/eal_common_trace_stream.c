@@ -0,0 +1,269 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+
+#include "eal_trace.h"
+
+/*
+ * A streamed trace buffer is a single producer, single consumer ring
+ * of variable-sized events. The thread owning the buffer writes the events,
+ * the stream thread appends them to the trace file of the buffer.
+ *
+ * The writer never overtakes the data not yet written to the file:
+ * when it reaches the end of the buffer, it records the end of the data
+ * in the wrap field and goes on from the start of the buffer, up to the head
+ * of the stream thread. The stream thread writes the data up to the wrap
+ * and clears it, which gives the whole buffer back to the writer.
+ * When no space is left, the events are dropped and counted as lost.
+ */
+
+void *
+__rte_trace_mem_stream_reserve(struct __rte_trace_header *trace, uint16_t sz)
+{
+	const uint32_t size = trace_obj_get()->buff_len;
+	uint32_t offset, head;
+
+	offset = RTE_ALIGN_CEIL(trace->offset, __RTE_TRACE_EVENT_HEADER_SZ);
+
+	/* Stay behind the head until the data before the wrap is written */
+	if (trace->len != size) {
+		if (__atomic_load_n(&trace->wrap, __ATOMIC_ACQUIRE) != 0)
+			goto drop;
+		trace->len = size;
+		if (offset + sz < size)
+			goto out;
+	}
+
+	/* Wrap around if the start of the buffer was written */
+	head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+	if (sz >= head)
+		goto drop;
+
+	__atomic_store_n(&trace->wrap, offset, __ATOMIC_RELEASE);
+	trace->len = head;
+	offset = 0;
+out:
+	trace->offset = offset + sz;
+	return RTE_PTR_ADD(&trace->mem[0], offset);
+drop:
+	trace->lost++;
+	return NULL;
+}
+
+static int
+trace_stream_write(int fd, const void *buf, size_t len)
+{
+	ssize_t rc;
+
+	while (len != 0) {
+		rc = write(fd, buf, len);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		buf = RTE_PTR_ADD(buf, rc);
+		len -= rc;
+	}
+
+	return 0;
+}
+
+static int
+trace_stream_open(struct trace *trace, struct thread_mem_meta *meta)
+{
+	struct __rte_trace_header *header = meta->mem;
+	char file_name[PATH_MAX];
+	int fd, rc;
+
+	rc = snprintf(file_name, PATH_MAX, "%s/channel0_%u", trace->dir,
+		meta->stream_id);
+	if (rc < 0)
+		return rc;
+
+	fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return -errno;
+
+	/* The file starts with the packet header of the CTF stream */
+	rc = trace_stream_write(fd, &header->stream_header,
+		sizeof(header->stream_header));
+	if (rc < 0) {
+		close(fd);
+		return rc;
+	}
+
+	meta->stream_fd = fd;
+	return 0;
+}
+
+/* Called with the trace lock held */
+int
+trace_stream_flush(struct trace *trace, struct thread_mem_meta *meta)
+{
+	struct __rte_trace_header *header = meta->mem;
+	uint32_t head, wrap, commit;
+	int rc;
+
+	if (meta->stream_fd < 0) {
+		rc = trace_stream_open(trace, meta);
+		if (rc < 0)
+			return rc;
+	}
+
+	/*
+	 * Read the commit before the wrap: an event committed after a wrap
+	 * ends below the head, which tells it apart from an older one.
+	 */
+	commit = __atomic_load_n(&header->commit, __ATOMIC_ACQUIRE);
+	wrap = __atomic_load_n(&header->wrap, __ATOMIC_ACQUIRE);
+	head = header->head;
+
+	if (wrap != 0) {
+		rc = trace_stream_write(meta->stream_fd, &header->mem[head],
+			wrap - head);
+		if (rc < 0)
+			return rc;
+		if (commit >= head)
+			commit = 0;
+		head = 0;
+	}
+
+	if (commit > head) {
+		rc = trace_stream_write(meta->stream_fd, &header->mem[head],
+			commit - head);
+		if (rc < 0)
+			return rc;
+		head = commit;
+	}
+
+	__atomic_store_n(&header->head, head, __ATOMIC_RELEASE);
+	if (wrap != 0)
+		__atomic_store_n(&header->wrap, 0, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/* Called with the trace lock held */
+void
+trace_stream_close(struct trace *trace, struct thread_mem_meta *meta)
+{
+	struct __rte_trace_header *header = meta->mem;
+	int rc;
+
+	rc = trace_stream_flush(trace, meta);
+	if (rc < 0)
+		trace_err("failed to write trace stream %u [%s]",
+			meta->stream_id, strerror(-rc));
+
+	trace->stream_lost += header->lost;
+	if (meta->stream_fd >= 0) {
+		close(meta->stream_fd);
+		meta->stream_fd = -1;
+	}
+}
+
+static void *
+trace_stream_thread(void *arg)
+{
+	struct trace *trace = arg;
+	bool meta_saved = false;
+	bool failed = false;
+	uint32_t count;
+	int rc;
+
+	while (__atomic_load_n(&trace->stream_running, __ATOMIC_ACQUIRE)) {
+		/* The metadata is complete once the timer is initialized */
+		if (!meta_saved && rte_get_timer_hz() != 0)
+			meta_saved = trace_meta_save(trace) == 0;
+
+		rte_spinlock_lock(&trace->lock);
+		for (count = 0; count < trace->nb_trace_mem_list; count++) {
+			rc = trace_stream_flush(trace,
+				&trace->lcore_meta[count]);
+			if (rc < 0 && !failed) {
+				trace_err("failed to write trace stream %u [%s]",
+					trace->lcore_meta[count].stream_id,
+					strerror(-rc));
+				failed = true;
+			}
+		}
+		rte_spinlock_unlock(&trace->lock);
+
+		rte_delay_us_sleep(TRACE_STREAM_PERIOD_US);
+	}
+
+	return NULL;
+}
+
+int
+trace_stream_start(void)
+{
+	struct trace *trace = trace_obj_get();
+	int rc;
+
+	rc = trace_mkdir();
+	if (rc < 0)
+		return rc;
+
+	__atomic_store_n(&trace->stream_running, 1, __ATOMIC_RELEASE);
+	rc = rte_ctrl_thread_create(&trace->stream_thread, "rte_trace_strm",
+		NULL, trace_stream_thread, trace);
+	if (rc < 0) {
+		__atomic_store_n(&trace->stream_running, 0, __ATOMIC_RELEASE);
+		trace_err("failed to create stream thread [%s]", strerror(-rc));
+		rte_errno = -rc;
+		return rc;
+	}
+
+	return 0;
+}
+
+void
+trace_stream_stop(void)
+{
+	struct trace *trace = trace_obj_get();
+
+	if (!__atomic_load_n(&trace->stream_running, __ATOMIC_ACQUIRE))
+		return;
+
+	__atomic_store_n(&trace->stream_running, 0, __ATOMIC_RELEASE);
+	pthread_join(trace->stream_thread, NULL);
+}
+
+bool
+rte_trace_stream_is_enabled(void)
+{
+	return trace_obj_get()->stream;
+}
+
+uint64_t
+rte_trace_stream_lost_get(void)
+{
+	struct trace *trace = trace_obj_get();
+	struct __rte_trace_header *header;
+	uint64_t lost;
+	uint32_t count;
+
+	rte_spinlock_lock(&trace->lock);
+	lost = trace->stream_lost;
+	for (count = 0; count < trace->nb_trace_mem_list; count++) {
+		header = trace->lcore_meta[count].mem;
+		lost += header->lost;
+	}
+	rte_spinlock_unlock(&trace->lock);
+
+	return lost;
+}
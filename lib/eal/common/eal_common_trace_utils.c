@@ -200,6 +200,11 @@ trace_bufsz_args_apply(void)
 
 	if (trace->buff_len == 0)
 		trace->buff_len = 1024 * 1024; /* 1MB */
+
+	/* A streamed buffer wraps around at an event boundary */
+	if (trace->stream)
+		trace->buff_len = RTE_ALIGN_CEIL(trace->buff_len,
+			__RTE_TRACE_EVENT_HEADER_SZ);
 }
 
 int
@@ -237,6 +242,14 @@ eal_trace_mode_args_save(const char *val)
 	return 0;
 }
 
+void
+eal_trace_stream_args_save(void)
+{
+	struct trace *trace = trace_obj_get();
+
+	trace->stream = true;
+}
+
 int
 eal_trace_dir_args_save(char const *val)
 {
@@ -299,7 +312,7 @@ trace_dir_default_path_get(char **dir_path)
 	return 0;
 }
 
-static int
+int
 trace_mkdir(void)
 {
 	struct trace *trace = trace_obj_get();
@@ -353,7 +366,7 @@ trace_mkdir(void)
 	return 0;
 }
 
-static int
+int
 trace_meta_save(struct trace *trace)
 {
 	char file_name[PATH_MAX];
@@ -429,6 +442,14 @@ rte_trace_save(void)
 
 	rte_spinlock_lock(&trace->lock);
 	for (count = 0; count < trace->nb_trace_mem_list; count++) {
+		/* Streamed buffers are only written since the last flush */
+		if (trace->stream) {
+			rc = trace_stream_flush(trace,
+				&trace->lcore_meta[count]);
+			if (rc)
+				break;
+			continue;
+		}
 		header = trace->lcore_meta[count].mem;
 		rc =  trace_mem_save(trace, header, count);
 		if (rc)
@@ -103,6 +103,10 @@ struct internal_config {
 	struct simd_bitwidth max_simd_bitwidth;
 	/**< max simd bitwidth path to use */
 	size_t huge_worker_stack_size; /**< worker thread stack size */
+	unsigned int huge_fault_threads;
+	/**< number of threads per socket faulting hugepages, 0 for one */
+	volatile unsigned malloc_lcore_cache;
+	/**< true to cache small allocations per lcore */
 };
 
 void eal_reset_internal_config(struct internal_config *internal_cfg);
@@ -43,6 +43,8 @@ enum {
 	OPT_TRACE_BUF_SIZE_NUM,
 #define OPT_TRACE_MODE        "trace-mode"
 	OPT_TRACE_MODE_NUM,
+#define OPT_TRACE_STREAM      "trace-stream"
+	OPT_TRACE_STREAM_NUM,
 #define OPT_MAIN_LCORE        "main-lcore"
 	OPT_MAIN_LCORE_NUM,
 #define OPT_MBUF_POOL_OPS_NAME "mbuf-pool-ops-name"
@@ -89,6 +91,10 @@ enum {
 	OPT_FORCE_MAX_SIMD_BITWIDTH_NUM,
 #define OPT_HUGE_WORKER_STACK  "huge-worker-stack"
 	OPT_HUGE_WORKER_STACK_NUM,
+#define OPT_HUGE_FAULT_THREADS "huge-fault-threads"
+	OPT_HUGE_FAULT_THREADS_NUM,
+#define OPT_MALLOC_LCORE_CACHE "malloc-lcore-cache"
+	OPT_MALLOC_LCORE_CACHE_NUM,
 
 	OPT_LONG_MAX_NUM
 };
@@ -5,6 +5,8 @@
 #ifndef __EAL_TRACE_H
 #define __EAL_TRACE_H
 
+#include <pthread.h>
+
 #include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
@@ -24,6 +26,7 @@
 
 #define TRACE_CTF_MAGIC 0xC1FC1FC1
 #define TRACE_MAX_ARGS	32
+#define TRACE_STREAM_PERIOD_US 10000
 
 struct trace_point {
 	STAILQ_ENTRY(trace_point) next;
@@ -40,6 +43,8 @@ enum trace_area_e {
 struct thread_mem_meta {
 	void *mem;
 	enum trace_area_e area;
+	uint32_t stream_id;
+	int stream_fd;
 };
 
 struct trace_arg {
@@ -66,6 +71,11 @@ struct trace {
 	uint32_t ctf_meta_offset_freq_off_s;
 	uint32_t ctf_meta_offset_freq_off;
 	uint16_t ctf_fixup_done;
+	bool stream;
+	uint32_t stream_running;
+	uint32_t nb_stream_ids;
+	uint64_t stream_lost;
+	pthread_t stream_thread;
 	rte_spinlock_t lock;
 };
 
@@ -103,6 +113,14 @@ char *trace_metadata_fixup_field(const char *field);
 int trace_epoch_time_save(void);
 void trace_mem_free(void);
 void trace_mem_per_thread_free(void);
+int trace_mkdir(void);
+int trace_meta_save(struct trace *trace);
+
+/* Stream functions */
+int trace_stream_start(void);
+void trace_stream_stop(void);
+int trace_stream_flush(struct trace *trace, struct thread_mem_meta *meta);
+void trace_stream_close(struct trace *trace, struct thread_mem_meta *meta);
 
 /* EAL interface */
 int eal_trace_init(void);
@@ -112,5 +130,6 @@ void eal_trace_args_free(void);
 int eal_trace_dir_args_save(const char *val);
 int eal_trace_mode_args_save(const char *val);
 int eal_trace_bufsz_args_save(const char *val);
+void eal_trace_stream_args_save(void);
 
 #endif /* __EAL_TRACE_H */
@@ -132,6 +132,7 @@ malloc_elem_init(struct malloc_elem *elem, struct malloc_heap *heap,
 	memset(&elem->free_list, 0, sizeof(elem->free_list));
 	elem->state = ELEM_FREE;
 	elem->dirty = dirty;
+	elem->cache_class = 0;
 	elem->size = size;
 	elem->pad = 0;
 	elem->orig_elem = orig_elem;
@@ -34,8 +34,10 @@ struct malloc_elem {
 	enum elem_state state : 3;
 	/** If state == ELEM_FREE: the memory is not filled with zeroes. */
 	uint32_t dirty : 1;
+	/** If state == ELEM_BUSY: per-lcore cache size class plus one, or 0. */
+	uint32_t cache_class : 4;
 	/** Reserved for future use. */
-	uint32_t reserved : 28;
+	uint32_t reserved : 24;
 	uint32_t pad;
 	size_t size;
 	struct malloc_elem *orig_elem;
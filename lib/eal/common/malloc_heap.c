@@ -882,6 +882,7 @@ malloc_heap_free(struct malloc_elem *elem)
 
 	/* mark element as free */
 	elem->state = ELEM_FREE;
+	elem->cache_class = 0;
 
 	elem = malloc_elem_free(elem);
 
@@ -1084,12 +1085,193 @@ malloc_heap_resize(struct malloc_elem *elem, size_t size)
 	rte_spinlock_lock(&(elem->heap->lock));
 
 	ret = malloc_elem_resize(elem, size);
+	/* the element does not match its size class anymore */
+	if (ret == 0)
+		elem->cache_class = 0;
 
 	rte_spinlock_unlock(&(elem->heap->lock));
 
 	return ret;
 }
 
+/*
+ * Per-lcore caches of small elements, in front of the heap free lists.
+ *
+ * The cached elements are allocated from the heap with the size of their
+ * class, a power of 2 number of cache lines, and stay busy for the heap
+ * while they are in a cache. The caches are local to a process, there is
+ * one per lcore and per socket heap, external heaps are not cached.
+ */
+#define MALLOC_CACHE_NUM_CLASSES 7
+#define MALLOC_CACHE_CLASS_SIZE(c) ((size_t)RTE_CACHE_LINE_SIZE << (c))
+#define MALLOC_CACHE_MAX_SIZE \
+	MALLOC_CACHE_CLASS_SIZE(MALLOC_CACHE_NUM_CLASSES - 1)
+/* maximum number of elements and of bytes kept in a size class */
+#define MALLOC_CACHE_MAX_OBJS 64
+#define MALLOC_CACHE_MAX_BYTES (64 * 1024)
+
+struct malloc_cache_class {
+	unsigned int len;
+	unsigned int size; /**< maximum number of elements */
+	struct malloc_elem *objs[MALLOC_CACHE_MAX_OBJS];
+};
+
+struct malloc_lcore_cache {
+	struct malloc_cache_class classes[MALLOC_CACHE_NUM_CLASSES];
+};
+
+static bool malloc_cache_enabled;
+static struct malloc_lcore_cache *
+malloc_caches[RTE_MAX_LCORE][RTE_MAX_NUMA_NODES];
+
+static struct malloc_lcore_cache *
+malloc_cache_get(unsigned int lcore_id, unsigned int heap_id)
+{
+	struct malloc_lcore_cache *cache = malloc_caches[lcore_id][heap_id];
+	unsigned int c;
+
+	if (likely(cache != NULL))
+		return cache;
+
+	cache = calloc(1, sizeof(*cache));
+	if (cache == NULL)
+		return NULL;
+	for (c = 0; c < MALLOC_CACHE_NUM_CLASSES; c++)
+		cache->classes[c].size = RTE_MIN(MALLOC_CACHE_MAX_OBJS,
+				MALLOC_CACHE_MAX_BYTES / MALLOC_CACHE_CLASS_SIZE(c));
+	malloc_caches[lcore_id][heap_id] = cache;
+	return cache;
+}
+
+/* give the elements above len back to the heap */
+static void
+malloc_cache_class_flush(struct malloc_cache_class *cc, unsigned int len)
+{
+	struct malloc_elem *elem;
+
+	while (cc->len > len) {
+		elem = cc->objs[--cc->len];
+		if (malloc_heap_free(elem) < 0)
+			RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
+	}
+}
+
+static void
+malloc_cache_flush(struct malloc_lcore_cache *cache)
+{
+	unsigned int c;
+
+	for (c = 0; c < MALLOC_CACHE_NUM_CLASSES; c++)
+		malloc_cache_class_flush(&cache->classes[c], 0);
+}
+
+void *
+malloc_heap_cache_alloc(size_t size, int socket_arg, size_t align)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	struct malloc_cache_class *cc;
+	struct malloc_heap *heap;
+	struct malloc_elem *elem;
+	int socket, heap_id;
+	unsigned int c;
+	void *data;
+
+	if (!malloc_cache_enabled || lcore_id >= RTE_MAX_LCORE ||
+			size == 0 || size > MALLOC_CACHE_MAX_SIZE ||
+			align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	if (!rte_eal_has_hugepages() && socket_arg < RTE_MAX_NUMA_NODES)
+		socket_arg = SOCKET_ID_ANY;
+
+	if (socket_arg == SOCKET_ID_ANY)
+		socket = malloc_get_numa_socket();
+	else
+		socket = socket_arg;
+
+	heap_id = malloc_socket_to_heap_id(socket);
+	if (heap_id < 0 || heap_id >= (int)rte_socket_count())
+		return NULL;
+
+	cache = malloc_cache_get(lcore_id, heap_id);
+	if (cache == NULL)
+		return NULL;
+
+	for (c = 0; MALLOC_CACHE_CLASS_SIZE(c) < size; c++)
+		;
+	cc = &cache->classes[c];
+
+	/* refill half of the cache with a single lock of the heap */
+	if (cc->len == 0) {
+		heap = &mcfg->malloc_heaps[heap_id];
+
+		rte_spinlock_lock(&(heap->lock));
+		while (cc->len < cc->size / 2) {
+			data = heap_alloc(heap, NULL, MALLOC_CACHE_CLASS_SIZE(c),
+					0, 1, 0, false);
+			if (data == NULL)
+				break;
+			elem = malloc_elem_from_data(data);
+			elem->cache_class = c + 1;
+			cc->objs[cc->len++] = elem;
+		}
+		rte_spinlock_unlock(&(heap->lock));
+
+		/* the heap must be expanded, leave it to the regular path */
+		if (cc->len == 0)
+			return NULL;
+	}
+
+	elem = cc->objs[--cc->len];
+	return RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN + elem->pad);
+}
+
+int
+malloc_heap_cache_free(struct malloc_elem *elem)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	struct malloc_cache_class *cc;
+
+	if (!malloc_cache_enabled || lcore_id >= RTE_MAX_LCORE ||
+			elem == NULL || elem->cache_class == 0 ||
+			elem->state != ELEM_BUSY)
+		return -1;
+
+	cache = malloc_cache_get(lcore_id, elem->heap - mcfg->malloc_heaps);
+	if (cache == NULL)
+		return -1;
+
+	cc = &cache->classes[elem->cache_class - 1];
+	if (cc->len == cc->size)
+		malloc_cache_class_flush(cc, cc->size / 2);
+
+	/* the previous user left its data in the element */
+	elem->dirty = 1;
+	cc->objs[cc->len++] = elem;
+	return 0;
+}
+
+int
+malloc_heap_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i;
+
+	if (!malloc_cache_enabled)
+		return -ENOTSUP;
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		if (malloc_caches[lcore_id][i] != NULL)
+			malloc_cache_flush(malloc_caches[lcore_id][i]);
+	return 0;
+}
+
 /*
  * Function to retrieve data for a given heap
  */
@@ -1404,6 +1586,14 @@ rte_eal_malloc_heap_init(void)
 	if (internal_conf->match_allocations)
 		RTE_LOG(DEBUG, EAL, "Hugepages will be freed exactly as allocated.\n");
 
+	if (internal_conf->malloc_lcore_cache) {
+#if defined(RTE_MALLOC_DEBUG) || defined(RTE_MALLOC_ASAN)
+		RTE_LOG(WARNING, EAL, "Per-lcore malloc caches are not supported with malloc debug\n");
+#else
+		malloc_cache_enabled = true;
+#endif
+	}
+
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		/* assign min socket ID to external heaps */
 		mcfg->next_socket_id = EXTERNAL_HEAP_MIN_SOCKET_ID;
@@ -1447,5 +1637,19 @@ int rte_eal_malloc_heap_populate(void)
 void
 rte_eal_malloc_heap_cleanup(void)
 {
+	unsigned int i, j;
+
+	/* the lcores are stopped, give their cached elements back */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		for (j = 0; j < RTE_MAX_NUMA_NODES; j++) {
+			if (malloc_caches[i][j] == NULL)
+				continue;
+			malloc_cache_flush(malloc_caches[i][j]);
+			free(malloc_caches[i][j]);
+			malloc_caches[i][j] = NULL;
+		}
+	}
+	malloc_cache_enabled = false;
+
 	unregister_mp_requests();
 }
@@ -69,6 +69,15 @@ malloc_heap_remove_external_memory(struct malloc_heap *heap, void *va_addr,
 int
 malloc_heap_free(struct malloc_elem *elem);
 
+void *
+malloc_heap_cache_alloc(size_t size, int socket, size_t align);
+
+int
+malloc_heap_cache_free(struct malloc_elem *elem);
+
+int
+malloc_heap_cache_flush(void);
+
 int
 malloc_heap_resize(struct malloc_elem *elem, size_t size);
 
@@ -34,7 +34,12 @@ mem_free(void *addr, const bool trace_ena)
 		rte_eal_trace_mem_free(addr);
 
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+
+	struct malloc_elem *elem = malloc_elem_from_data(addr);
+
+	if (malloc_heap_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
@@ -69,8 +74,10 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
-	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
-			align == 0 ? 1 : align, 0, false);
+	ptr = malloc_heap_cache_alloc(size, socket_arg, align);
+	if (ptr == NULL)
+		ptr = malloc_heap_alloc(type, size, socket_arg, 0,
+				align == 0 ? 1 : align, 0, false);
 
 	if (trace_ena)
 		rte_eal_trace_mem_malloc(type, size, align, socket_arg, ptr);
@@ -377,6 +384,12 @@ rte_malloc_virt2iova(const void *addr)
 	return ms->iova + RTE_PTR_DIFF(addr, ms->addr);
 }
 
+int
+rte_malloc_lcore_cache_flush(void)
+{
+	return malloc_heap_cache_flush();
+}
+
 static struct malloc_heap *
 find_named_heap(const char *name)
 {
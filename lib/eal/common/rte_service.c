@@ -76,6 +76,24 @@ static struct rte_service_spec_impl *rte_services;
 static struct core_state *lcore_states;
 static uint32_t rte_service_library_initialized;
 
+/* minimum load difference between two service lcores to move a service,
+ * in percent of the balancing period
+ */
+#define SERVICE_BALANCE_THRESHOLD 10
+
+/* the state of the load balancing of services across service lcores */
+static struct {
+	/* serializes balancing and updates of the service mappings */
+	rte_spinlock_t lock;
+	uint64_t period; /* in TSC cycles, 0 when disabled */
+	uint64_t next; /* TSC of the next balancing, for the service lcores */
+	uint64_t last; /* TSC of the last balancing, 0 if none */
+	uint64_t service_cycles[RTE_SERVICE_NUM_MAX];
+	uint64_t lcore_cycles[RTE_MAX_LCORE];
+} balance = {
+	.lock = RTE_SPINLOCK_INITIALIZER,
+};
+
 int32_t
 rte_service_init(void)
 {
@@ -130,6 +148,7 @@ rte_service_finalize(void)
 	if (!rte_service_library_initialized)
 		return;
 
+	__atomic_store_n(&balance.period, 0, __ATOMIC_RELAXED);
 	rte_service_lcore_reset_all();
 	rte_eal_mp_wait_lcore();
 
@@ -473,6 +492,8 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 	return ret;
 }
 
+static void service_balance_poll(void);
+
 static int32_t
 service_runner_func(void *arg)
 {
@@ -494,6 +515,8 @@ service_runner_func(void *arg)
 		uint8_t start_id;
 		uint8_t end_id;
 
+		service_balance_poll();
+
 		if (service_mask == 0)
 			continue;
 
@@ -623,6 +646,25 @@ rte_service_start_with_defaults(void)
 	return 0;
 }
 
+/* Called with the balance lock held */
+static void
+service_map_update(uint32_t sid, uint32_t lcore, uint32_t set)
+{
+	uint64_t sid_mask = UINT64_C(1) << sid;
+	uint64_t lcore_mapped = lcore_states[lcore].service_mask & sid_mask;
+
+	if (set && !lcore_mapped) {
+		lcore_states[lcore].service_mask |= sid_mask;
+		__atomic_fetch_add(&rte_services[sid].num_mapped_cores,
+			1, __ATOMIC_RELAXED);
+	}
+	if (!set && lcore_mapped) {
+		lcore_states[lcore].service_mask &= ~(sid_mask);
+		__atomic_fetch_sub(&rte_services[sid].num_mapped_cores,
+			1, __ATOMIC_RELAXED);
+	}
+}
+
 static int32_t
 service_update(uint32_t sid, uint32_t lcore, uint32_t *set, uint32_t *enabled)
 {
@@ -633,19 +675,9 @@ service_update(uint32_t sid, uint32_t lcore, uint32_t *set, uint32_t *enabled)
 
 	uint64_t sid_mask = UINT64_C(1) << sid;
 	if (set) {
-		uint64_t lcore_mapped = lcore_states[lcore].service_mask &
-			sid_mask;
-
-		if (*set && !lcore_mapped) {
-			lcore_states[lcore].service_mask |= sid_mask;
-			__atomic_fetch_add(&rte_services[sid].num_mapped_cores,
-				1, __ATOMIC_RELAXED);
-		}
-		if (!*set && lcore_mapped) {
-			lcore_states[lcore].service_mask &= ~(sid_mask);
-			__atomic_fetch_sub(&rte_services[sid].num_mapped_cores,
-				1, __ATOMIC_RELAXED);
-		}
+		rte_spinlock_lock(&balance.lock);
+		service_map_update(sid, lcore, *set);
+		rte_spinlock_unlock(&balance.lock);
 	}
 
 	if (enabled)
@@ -970,6 +1002,169 @@ rte_service_lcore_attr_reset_all(uint32_t lcore)
 	return 0;
 }
 
+/* Difference of a counter with its last value, which is updated. */
+static uint64_t
+balance_delta(uint64_t cur, uint64_t *last)
+{
+	uint64_t delta;
+
+	/* the counter has been reset since the last balancing */
+	if (cur < *last)
+		delta = cur;
+	else
+		delta = cur - *last;
+	*last = cur;
+
+	return delta;
+}
+
+/* Move one service from the busiest service lcore to the least busy one,
+ * based on the cycles spent in the services since the last balancing.
+ * Returns 1 if a service was moved. Called with the balance lock held.
+ */
+static int32_t
+service_balance(uint64_t now)
+{
+	uint64_t lcore_load[RTE_MAX_LCORE];
+	uint64_t load, diff, gap, best_gap = UINT64_MAX;
+	uint32_t max_lcore = RTE_MAX_LCORE, min_lcore = RTE_MAX_LCORE;
+	uint32_t best = RTE_SERVICE_NUM_MAX;
+	uint64_t elapsed = now - balance.last;
+	int first = (balance.last == 0);
+	struct rte_service_spec_impl *s;
+	struct core_state *cs;
+	uint32_t i;
+
+	balance.last = now;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		cs = &lcore_states[i];
+		if (!cs->is_service_core)
+			continue;
+
+		lcore_load[i] = balance_delta(lcore_attr_get_cycles(i),
+			&balance.lcore_cycles[i]);
+
+		/* only move services between running service lcores */
+		if (__atomic_load_n(&cs->runstate, __ATOMIC_ACQUIRE) !=
+				RUNSTATE_RUNNING)
+			continue;
+		if (max_lcore == RTE_MAX_LCORE ||
+				lcore_load[i] > lcore_load[max_lcore])
+			max_lcore = i;
+		if (min_lcore == RTE_MAX_LCORE ||
+				lcore_load[i] < lcore_load[min_lcore])
+			min_lcore = i;
+	}
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (!service_registered(i)) {
+			balance.service_cycles[i] = 0;
+			continue;
+		}
+
+		load = balance_delta(attr_get_service_cycles(i),
+			&balance.service_cycles[i]);
+
+		/* Only services with statistics, and run by a single lcore,
+		 * are moved. While a service is moved, it is mapped to both
+		 * lcores, which the execute lock serializes if the service
+		 * is not MT safe.
+		 */
+		s = service_get(i);
+		if (first || max_lcore == min_lcore ||
+				!service_stats_enabled(s) ||
+				__atomic_load_n(&s->num_mapped_cores,
+					__ATOMIC_RELAXED) != 1 ||
+				!(lcore_states[max_lcore].service_mask &
+					(UINT64_C(1) << i)))
+			continue;
+
+		/* moving the service must reduce the imbalance, pick the
+		 * one leaving the two lcores with the closest loads
+		 */
+		diff = lcore_load[max_lcore] - lcore_load[min_lcore];
+		if (load == 0 || load >= diff ||
+				diff * 100 < elapsed * SERVICE_BALANCE_THRESHOLD)
+			continue;
+		gap = diff > 2 * load ? diff - 2 * load : 2 * load - diff;
+		if (gap < best_gap) {
+			best_gap = gap;
+			best = i;
+		}
+	}
+
+	if (best == RTE_SERVICE_NUM_MAX)
+		return 0;
+
+	service_map_update(best, min_lcore, 1);
+	service_map_update(best, max_lcore, 0);
+
+	RTE_LOG(DEBUG, EAL, "service %s moved from lcore %u to lcore %u\n",
+		service_get(best)->spec.name, max_lcore, min_lcore);
+
+	return 1;
+}
+
+/* Balance the services from a service lcore, once every period */
+static void
+service_balance_poll(void)
+{
+	uint64_t period = __atomic_load_n(&balance.period, __ATOMIC_RELAXED);
+	uint64_t now;
+
+	if (likely(period == 0))
+		return;
+
+	now = rte_rdtsc();
+	if (now < __atomic_load_n(&balance.next, __ATOMIC_RELAXED) ||
+			!rte_spinlock_trylock(&balance.lock))
+		return;
+
+	/* another lcore might have balanced before the lock was taken */
+	if (balance.period != 0 && now >= balance.next) {
+		__atomic_store_n(&balance.next, now + balance.period,
+			__ATOMIC_RELAXED);
+		service_balance(now);
+	}
+
+	rte_spinlock_unlock(&balance.lock);
+}
+
+int32_t
+rte_service_lcore_balance_set(uint32_t period_us)
+{
+	uint64_t now;
+
+	rte_spinlock_lock(&balance.lock);
+
+	/* start a new measurement of the service loads */
+	now = rte_rdtsc();
+	balance.last = 0;
+	service_balance(now);
+
+	__atomic_store_n(&balance.next, now, __ATOMIC_RELAXED);
+	__atomic_store_n(&balance.period,
+		(uint64_t)period_us * rte_get_tsc_hz() / US_PER_S,
+		__ATOMIC_RELAXED);
+
+	rte_spinlock_unlock(&balance.lock);
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_balance(void)
+{
+	int32_t ret;
+
+	rte_spinlock_lock(&balance.lock);
+	ret = service_balance(rte_rdtsc());
+	rte_spinlock_unlock(&balance.lock);
+
+	return ret;
+}
+
 static void
 service_dump_one(FILE *f, uint32_t id)
 {
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <stddef.h>
+#include <rte_compat.h>
 #include <rte_memory.h>
 
 #ifdef __cplusplus
@@ -533,6 +534,28 @@ rte_malloc_dump_heaps(FILE *f);
 rte_iova_t
 rte_malloc_virt2iova(const void *addr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Give the memory cached by the calling lcore back to the malloc heaps.
+ *
+ * With the ``--malloc-lcore-cache`` EAL option, the small allocations of
+ * each lcore are served from a per-lcore cache of elements, refilled from
+ * and flushed to the socket heaps in bursts. The cached elements are
+ * accounted as allocated in the heap statistics, and are only freed back
+ * to their heap when the cache overflows, when this function is called
+ * or at rte_eal_cleanup().
+ *
+ * @return
+ *   0 on success,
+ *   -ENOTSUP if the per-lcore caches are not enabled,
+ *   -EINVAL if the calling thread is not an EAL or registered thread.
+ */
+__rte_experimental
+int
+rte_malloc_lcore_cache_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
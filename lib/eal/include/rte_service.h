@@ -439,6 +439,50 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 int32_t
 rte_service_lcore_attr_reset_all(uint32_t lcore);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable or disable the load balancing of services across service cores.
+ *
+ * When enabled, one of the running service cores balances the services
+ * every *period_us* microseconds, see rte_service_lcore_balance().
+ * The mappings of the services moved are updated, the application can
+ * still change them with rte_service_map_lcore_set().
+ *
+ * @param period_us The balancing period in microseconds,
+ *                  0 disables the load balancing.
+ * @retval 0 Success
+ */
+__rte_experimental
+int32_t rte_service_lcore_balance_set(uint32_t period_us);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Balance the load of the services across the running service cores.
+ *
+ * The cycles each running service core spent in services since the last
+ * balancing (see RTE_SERVICE_LCORE_ATTR_CYCLES) are compared, and if they
+ * differ by more than 10% of the elapsed time, one service is moved from
+ * the busiest service core to the least busy one, choosing the service
+ * which leaves them with the closest loads.
+ *
+ * Only the services with statistics enabled (see
+ * rte_service_set_stats_enable()) and mapped to a single service core
+ * are moved. A service which is not MT safe is never run by two service
+ * cores at the same time while it is moved.
+ *
+ * If neither this function nor rte_service_lcore_balance_set() was called
+ * before, the call only starts measuring the loads.
+ *
+ * @retval 1 A service was moved.
+ * @retval 0 No service was moved.
+ */
+__rte_experimental
+int32_t rte_service_lcore_balance(void);
+
 #ifdef __cplusplus
 }
 #endif
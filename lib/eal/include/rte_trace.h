@@ -134,6 +134,35 @@ int rte_trace_metadata_dump(FILE *f);
 __rte_experimental
 void rte_trace_dump(FILE *f);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Test if the trace buffers are streamed to the trace directory.
+ *
+ * In this mode, enabled by the --trace-stream EAL parameter, a control thread
+ * continuously writes the content of the trace buffers to the trace files,
+ * and an event is dropped when no space is left in the trace buffer.
+ *
+ * @return
+ *   true if the trace buffers are streamed, false otherwise.
+ */
+__rte_experimental
+bool rte_trace_stream_is_enabled(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of events dropped because the trace buffer of their thread
+ * was full when streaming.
+ *
+ * @return
+ *   The number of events lost since the start of the application.
+ */
+__rte_experimental
+uint64_t rte_trace_stream_lost_get(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -49,6 +49,7 @@ _tp _args \
 { \
 	__rte_trace_point_emit_header_##_mode(&__##_tp); \
 	__VA_ARGS__ \
+	__rte_trace_point_emit_commit(); \
 }
 
 /**
@@ -302,12 +303,35 @@ struct __rte_trace_stream_header {
 struct __rte_trace_header {
 	uint32_t offset;
 	uint32_t len;
+	/* Below fields are only used when the buffer is streamed */
+	uint32_t stream;
+	uint32_t head; /* Start of the data not yet written to the file */
+	uint32_t wrap; /* End of the data before a wrap around, 0 if none */
+	uint32_t commit; /* End of the last complete event */
+	uint64_t lost; /* Number of events dropped as the buffer was full */
 	struct __rte_trace_stream_header stream_header;
 	uint8_t mem[];
 };
 
 RTE_DECLARE_PER_LCORE(void *, trace_mem);
 
+/**
+ * @internal
+ *
+ * Reserve room for an event in a streamed trace buffer
+ * which has no more room until its end.
+ *
+ * @param trace
+ *   The trace buffer of the calling thread.
+ * @param sz
+ *   The size of the event.
+ * @return
+ *   The memory to write the event to, NULL if the event is dropped.
+ */
+__rte_experimental
+void *__rte_trace_mem_stream_reserve(struct __rte_trace_header *trace,
+	uint16_t sz);
+
 static __rte_always_inline void *
 __rte_trace_mem_get(uint64_t in)
 {
@@ -322,17 +346,21 @@ __rte_trace_mem_get(uint64_t in)
 		if (unlikely(trace == NULL))
 			return NULL;
 	}
+	/* Align to event header size */
+	uint32_t offset = RTE_ALIGN_CEIL(trace->offset,
+		__RTE_TRACE_EVENT_HEADER_SZ);
 	/* Check the wrap around case */
-	uint32_t offset = trace->offset;
 	if (unlikely((offset + sz) >= trace->len)) {
+		/* Wrap around behind the stream flusher */
+		if (trace->stream)
+			return __rte_trace_mem_stream_reserve(trace, sz);
+
 		/* Disable the trace event if it in DISCARD mode */
 		if (unlikely(in & __RTE_TRACE_FIELD_ENABLE_DISCARD))
 			return NULL;
 
 		offset = 0;
 	}
-	/* Align to event header size */
-	offset = RTE_ALIGN_CEIL(offset, __RTE_TRACE_EVENT_HEADER_SZ);
 	void *mem = RTE_PTR_ADD(&trace->mem[0], offset);
 	offset += sz;
 	trace->offset = offset;
@@ -340,6 +368,16 @@ __rte_trace_mem_get(uint64_t in)
 	return mem;
 }
 
+static __rte_always_inline void
+__rte_trace_mem_commit(void)
+{
+	struct __rte_trace_header *trace =
+		(struct __rte_trace_header *)(RTE_PER_LCORE(trace_mem));
+
+	/* Publish the event to the stream flusher */
+	__atomic_store_n(&trace->commit, trace->offset, __ATOMIC_RELEASE);
+}
+
 static __rte_always_inline void *
 __rte_trace_point_emit_ev_header(void *mem, uint64_t in)
 {
@@ -373,6 +411,8 @@ do { \
 		return; \
 	__rte_trace_point_emit_header_generic(t)
 
+#define __rte_trace_point_emit_commit() __rte_trace_mem_commit()
+
 #define __rte_trace_point_emit(in, type) \
 do { \
 	memcpy(mem, &(in), sizeof(in)); \
@@ -403,6 +443,7 @@ do { \
 
 #define __rte_trace_point_emit_header_generic(t) RTE_SET_USED(t)
 #define __rte_trace_point_emit_header_fp(t) RTE_SET_USED(t)
+#define __rte_trace_point_emit_commit() do { } while (0)
 #define __rte_trace_point_emit(in, type) RTE_SET_USED(in)
 #define rte_trace_point_emit_string(in) RTE_SET_USED(in)
 #define rte_trace_point_emit_blob(in, len) \
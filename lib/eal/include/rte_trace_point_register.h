@@ -33,6 +33,8 @@ RTE_INIT(trace##_init) \
 #define __rte_trace_point_emit_header_fp(t) \
 	__rte_trace_point_emit_header_generic(t)
 
+#define __rte_trace_point_emit_commit() do { } while (0)
+
 #define __rte_trace_point_emit(in, type) \
 do { \
 	RTE_BUILD_BUG_ON(sizeof(type) != sizeof(typeof(in))); \
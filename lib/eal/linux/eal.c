@@ -457,6 +457,9 @@ eal_usage(const char *prgname)
 	       "                      Allocate worker thread stacks from hugepage memory.\n"
 	       "                      Size is in units of kbytes and defaults to system\n"
 	       "                      thread stack size if not specified.\n"
+	       "  --"OPT_HUGE_FAULT_THREADS"=<n>\n"
+	       "                      Fault and zero hugepages with n threads,\n"
+	       "                      pinned to the cores of the socket being allocated.\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if (hook) {
@@ -622,6 +625,23 @@ eal_parse_huge_worker_stack(const char *arg)
 	return 0;
 }
 
+static int
+eal_parse_huge_fault_threads(const char *arg)
+{
+	struct internal_config *cfg = eal_get_internal_configuration();
+	unsigned long threads;
+	char *end;
+
+	errno = 0;
+	threads = strtoul(arg, &end, 10);
+	if (errno || end == NULL || *end != '\0' || threads == 0 ||
+			threads > RTE_MAX_LCORE)
+		return -1;
+
+	cfg->huge_fault_threads = threads;
+	return 0;
+}
+
 /* Parse the argument given in the command line of the application */
 static int
 eal_parse_args(int argc, char **argv)
@@ -769,6 +789,16 @@ eal_parse_args(int argc, char **argv)
 			}
 			break;
 
+		case OPT_HUGE_FAULT_THREADS_NUM:
+			if (eal_parse_huge_fault_threads(optarg) < 0) {
+				RTE_LOG(ERR, EAL, "invalid parameter for --"
+					OPT_HUGE_FAULT_THREADS"\n");
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				RTE_LOG(ERR, EAL, "Option %c is not supported "
@@ -31,12 +31,15 @@
 #include <rte_log.h>
 #include <rte_eal.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
+#include <rte_thread.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -97,11 +100,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* per thread, as hugepages may be faulted by several threads at once */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -110,11 +114,13 @@ static void huge_sigbus_handler(int signo __rte_unused)
  */
 static int huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
 static int huge_need_recover;
+/* set while the handler is registered for a parallel allocation */
+static int huge_sigbus_held;
 
 static void
 huge_register_sigbus(void)
@@ -122,6 +128,9 @@ huge_register_sigbus(void)
 	sigset_t mask;
 	struct sigaction action;
 
+	if (huge_sigbus_held)
+		return;
+
 	sigemptyset(&mask);
 	sigaddset(&mask, SIGBUS);
 	action.sa_flags = 0;
@@ -134,6 +143,9 @@ huge_register_sigbus(void)
 static void
 huge_recover_sigbus(void)
 {
+	if (huge_sigbus_held)
+		return;
+
 	if (huge_need_recover) {
 		sigaction(SIGBUS, &huge_action_old, NULL);
 		huge_need_recover = 0;
@@ -810,6 +822,138 @@ struct alloc_walk_param {
 	int socket;
 	bool exact;
 };
+
+/*
+ * parallel faulting of the segments of a memseg list: each thread takes
+ * the next segment index and maps it, until all are done or one fails.
+ */
+struct alloc_fault_param {
+	struct alloc_walk_param *wa;
+	struct rte_memseg_list *msl;
+	unsigned int msl_idx;
+	int start_idx;
+	unsigned int need;
+	unsigned int next; /**< next segment to fault */
+	int failed; /**< set when a segment could not be allocated */
+	int *ret; /**< result of each segment */
+};
+
+static void
+alloc_fault_segs(struct alloc_fault_param *p)
+{
+	struct rte_memseg *cur;
+	void *map_addr;
+	unsigned int i;
+	int idx;
+
+	while (!__atomic_load_n(&p->failed, __ATOMIC_RELAXED)) {
+		i = __atomic_fetch_add(&p->next, 1, __ATOMIC_RELAXED);
+		if (i >= p->need)
+			break;
+
+		idx = p->start_idx + i;
+		cur = rte_fbarray_get(&p->msl->memseg_arr, idx);
+		map_addr = RTE_PTR_ADD(p->msl->base_va, idx * p->msl->page_sz);
+
+		p->ret[i] = alloc_seg(cur, map_addr, p->wa->socket, p->wa->hi,
+				p->msl_idx, idx);
+		if (p->ret[i] != 0)
+			__atomic_store_n(&p->failed, 1, __ATOMIC_RELAXED);
+	}
+}
+
+static uint32_t
+alloc_fault_thread(void *arg)
+{
+	struct alloc_fault_param *p = arg;
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	if (check_numa())
+		numa_set_preferred(p->wa->socket);
+#endif
+	alloc_fault_segs(p);
+	return 0;
+}
+
+/*
+ * Allocate the *need* segments of a memseg list from *start_idx*, with
+ * several threads pinned to the cores of the socket, so that the kernel
+ * faults and zeroes the hugepages in parallel.
+ * Returns the number of leading segments allocated, which are marked used.
+ */
+static unsigned int
+alloc_seg_parallel(struct alloc_walk_param *wa, struct rte_memseg_list *msl,
+		unsigned int msl_idx, int start_idx, unsigned int need,
+		unsigned int nb_threads)
+{
+	rte_thread_t threads[RTE_MAX_LCORE];
+	struct alloc_fault_param p;
+	struct rte_memseg *cur;
+	rte_thread_attr_t attr;
+	rte_cpuset_t cpuset;
+	unsigned int i, n, done;
+
+	p.ret = malloc(sizeof(*p.ret) * need);
+	if (p.ret == NULL)
+		return 0;
+	for (i = 0; i < need; i++)
+		p.ret[i] = -1;
+	p.wa = wa;
+	p.msl = msl;
+	p.msl_idx = msl_idx;
+	p.start_idx = start_idx;
+	p.need = need;
+	p.next = 0;
+	p.failed = 0;
+
+	CPU_ZERO(&cpuset);
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		if (eal_cpu_detected(i) &&
+				(int)eal_cpu_socket_id(i) == wa->socket)
+			CPU_SET(i, &cpuset);
+
+	rte_thread_attr_init(&attr);
+	if (CPU_COUNT(&cpuset) != 0)
+		rte_thread_attr_set_affinity(&attr, &cpuset);
+
+	/* the handler must not be changed while threads are faulting */
+	huge_register_sigbus();
+	huge_sigbus_held = 1;
+
+	/* the calling thread faults hugepages too */
+	for (n = 0; n < nb_threads - 1; n++)
+		if (rte_thread_create(&threads[n], &attr,
+				alloc_fault_thread, &p) != 0)
+			break;
+	alloc_fault_segs(&p);
+	for (i = 0; i < n; i++)
+		rte_thread_join(threads[i], NULL);
+
+	huge_sigbus_held = 0;
+	huge_recover_sigbus();
+
+	RTE_LOG(DEBUG, EAL, "%s(): faulted %u segments with %u threads\n",
+		__func__, need, n + 1);
+
+	/* keep the segments before the first failure */
+	for (done = 0; done < need && p.ret[done] == 0; done++) {
+		cur = rte_fbarray_get(&msl->memseg_arr, start_idx + done);
+		if (wa->ms)
+			wa->ms[done] = cur;
+		rte_fbarray_set_used(&msl->memseg_arr, start_idx + done);
+	}
+	for (i = done + 1; i < need; i++) {
+		if (p.ret[i] != 0)
+			continue;
+		cur = rte_fbarray_get(&msl->memseg_arr, start_idx + i);
+		if (free_seg(cur, wa->hi, msl_idx, start_idx + i))
+			RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+	}
+
+	free(p.ret);
+	return done;
+}
+
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -818,7 +962,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct rte_memseg_list *cur_msl;
 	size_t page_sz;
 	int cur_idx, start_idx, j, dir_fd = -1;
-	unsigned int msl_idx, need, i;
+	unsigned int msl_idx, need, i, nb_threads;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
@@ -886,7 +1030,19 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
-	for (i = 0; i < need; i++, cur_idx++) {
+	/*
+	 * fault the hugepages with several threads when requested, the
+	 * remaining segments, if any, are then retried one by one below.
+	 */
+	i = 0;
+	nb_threads = RTE_MIN(internal_conf->huge_fault_threads, need);
+	if (nb_threads > 1 && !internal_conf->single_file_segments) {
+		i = alloc_seg_parallel(wa, cur_msl, msl_idx, start_idx, need,
+				nb_threads);
+		cur_idx += i;
+	}
+
+	for (; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
 
@@ -232,6 +232,14 @@ __rte_trace_mem_per_thread_alloc(void)
 {
 }
 
+void *
+__rte_trace_mem_stream_reserve(struct __rte_trace_header *trace, uint16_t sz)
+{
+	RTE_SET_USED(trace);
+	RTE_SET_USED(sz);
+	return NULL;
+}
+
 void
 trace_mem_per_thread_free(void)
 {
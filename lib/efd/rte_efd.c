@@ -18,6 +18,7 @@
 #include <rte_branch_prediction.h>
 #include <rte_memcpy.h>
 #include <rte_ring.h>
+#include <rte_spinlock.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
 #include <rte_tailq.h>
@@ -194,6 +195,11 @@ struct efd_offline_chunk_rules {
 	 * used to detect unbalanced groups
 	 */
 
+	rte_spinlock_t lock;
+	/**< Serializes the writers of a RTE_EFD_F_MULTI_WRITER table
+	 * updating keys of this chunk, in both the offline and online tables.
+	 */
+
 	struct efd_offline_group_rules group_rules[EFD_CHUNK_NUM_GROUPS];
 	/**< Array of all groups in the chunk. */
 };
@@ -247,6 +253,9 @@ struct rte_efd_table {
 	enum efd_lookup_internal_function lookup_fn;
 	/**< Indicates which lookup function to use. */
 
+	uint32_t flags;
+	/**< RTE_EFD_F_* flags the table was created with. */
+
 	struct efd_online_chunk *chunks[RTE_MAX_NUMA_NODES];
 	/**< Dynamic array of size num_chunks of chunk records. */
 
@@ -363,6 +372,23 @@ efd_compute_ids(const struct rte_efd_table * const table,
 	*bin_id = efd_get_bin_id(table, h);
 }
 
+/**
+ * Take the lock of a chunk before modifying it, if the table has several writers
+ */
+static inline void
+efd_chunk_lock(struct rte_efd_table * const table, const uint32_t chunk_id)
+{
+	if (table->flags & RTE_EFD_F_MULTI_WRITER)
+		rte_spinlock_lock(&table->offline_chunks[chunk_id].lock);
+}
+
+static inline void
+efd_chunk_unlock(struct rte_efd_table * const table, const uint32_t chunk_id)
+{
+	if (table->flags & RTE_EFD_F_MULTI_WRITER)
+		rte_spinlock_unlock(&table->offline_chunks[chunk_id].lock);
+}
+
 /**
  * Search for a hash function for a group that satisfies all group results
  */
@@ -494,6 +520,15 @@ efd_search_hash(struct rte_efd_table * const table,
 struct rte_efd_table *
 rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 		uint64_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket)
+{
+	return rte_efd_create_flags(name, max_num_rules, key_len,
+			online_cpu_socket_bitmask, offline_cpu_socket, 0);
+}
+
+struct rte_efd_table *
+rte_efd_create_flags(const char *name, uint32_t max_num_rules, uint32_t key_len,
+		uint64_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket,
+		uint32_t flags)
 {
 	struct rte_efd_table *table = NULL;
 	uint8_t *key_array = NULL;
@@ -504,6 +539,7 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 	uint64_t offline_table_size;
 	char ring_name[RTE_RING_NAMESIZE];
 	struct rte_ring *r = NULL;
+	unsigned int ring_flags;
 	unsigned int i;
 
 	efd_list = RTE_TAILQ_CAST(rte_efd_tailq.head, rte_efd_list);
@@ -519,6 +555,12 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 		return NULL;
 	}
 
+	if ((flags & ~RTE_EFD_F_MULTI_WRITER) != 0) {
+		RTE_LOG(ERR, EFD, "Invalid flags 0x%x\n", flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
 	/*
 	 * Compute the minimum number of chunks (smallest power of 2)
 	 * that can hold all of the rules
@@ -579,6 +621,7 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 	table->num_chunks = num_chunks;
 	table->num_chunks_shift = num_chunks_shift;
 	table->key_len = key_len;
+	table->flags = flags;
 
 	/* key_array */
 	key_array = rte_zmalloc_socket(NULL,
@@ -686,14 +729,24 @@ rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 			(float) offline_table_size / (1024.0F * 1024.0F),
 			offline_cpu_socket);
 
+	for (i = 0; i < num_chunks; i++)
+		rte_spinlock_init(&table->offline_chunks[i].lock);
+
 	te->data = (void *) table;
 	TAILQ_INSERT_TAIL(efd_list, te, next);
 	rte_mcfg_tailq_write_unlock();
 
 	snprintf(ring_name, sizeof(ring_name), "HT_%s", table->name);
-	/* Create ring (Dummy slot index is not enqueued) */
+	/*
+	 * Create ring (Dummy slot index is not enqueued).
+	 * Key slots are only taken and released by the writers.
+	 */
+	if (flags & RTE_EFD_F_MULTI_WRITER)
+		ring_flags = 0;
+	else
+		ring_flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
 	r = rte_ring_create(ring_name, rte_align32pow2(table->max_num_rules),
-			offline_cpu_socket, 0);
+			offline_cpu_socket, ring_flags);
 	if (r == NULL) {
 		RTE_LOG(ERR, EFD, "memory allocation failed\n");
 		rte_efd_free(table);
@@ -926,11 +979,11 @@ revert_groups(struct efd_offline_group_rules *previous_group,
  * @param value
  *   Value to associate with key
  * @param chunk_id
- *   Chunk ID of the chunk that was modified
+ *   Chunk ID of the key, as computed by efd_compute_ids
+ * @param bin_id
+ *   Bin ID of the key, as computed by efd_compute_ids
  * @param group_id
  *   Group ID of the group that was modified
- * @param bin_id
- *   Bin ID that was modified
  * @param new_bin_choice
  *   Newly chosen permutation which this bin will use
  * @param entry
@@ -957,8 +1010,8 @@ revert_groups(struct efd_offline_group_rules *previous_group,
 static inline int
 efd_compute_update(struct rte_efd_table * const table,
 		const unsigned int socket_id, const void *key,
-		const efd_value_t value, uint32_t * const chunk_id,
-		uint32_t * const group_id, uint32_t * const bin_id,
+		const efd_value_t value, const uint32_t chunk_id,
+		const uint32_t bin_id, uint32_t * const group_id,
 		uint8_t * const new_bin_choice,
 		struct efd_online_group_entry * const entry)
 {
@@ -969,15 +1022,15 @@ efd_compute_update(struct rte_efd_table * const table,
 	int status = EXIT_SUCCESS;
 	unsigned int found = 0;
 
-	efd_compute_ids(table, key, chunk_id, bin_id);
-
 	struct efd_offline_chunk_rules * const chunk =
-			&table->offline_chunks[*chunk_id];
+			&table->offline_chunks[chunk_id];
+	const struct efd_online_chunk * const online_chunk =
+			&table->chunks[socket_id][chunk_id];
 	struct efd_offline_group_rules *new_group;
 
 	uint8_t current_choice = efd_get_choice(table, socket_id,
-			*chunk_id, *bin_id);
-	uint32_t current_group_id = efd_bin_to_group[current_choice][*bin_id];
+			chunk_id, bin_id);
+	uint32_t current_group_id = efd_bin_to_group[current_choice][bin_id];
 	struct efd_offline_group_rules * const current_group =
 			&chunk->group_rules[current_group_id];
 	uint8_t bin_size = 0;
@@ -987,7 +1040,7 @@ efd_compute_update(struct rte_efd_table * const table,
 
 	/* Scan the current group and see if the key is already present */
 	for (i = 0; i < current_group->num_rules; i++) {
-		if (current_group->bin_id[i] == *bin_id)
+		if (current_group->bin_id[i] == bin_id)
 			bin_size++;
 		else
 			continue;
@@ -1018,8 +1071,8 @@ efd_compute_update(struct rte_efd_table * const table,
 			RTE_LOG(ERR, EFD,
 					"Fatal: No room remaining for insert into "
 					"chunk %u group %u bin %u\n",
-					*chunk_id,
-					current_group_id, *bin_id);
+					chunk_id,
+					current_group_id, bin_id);
 			return RTE_EFD_UPDATE_FAILED;
 		}
 
@@ -1027,12 +1080,12 @@ efd_compute_update(struct rte_efd_table * const table,
 				(EFD_MAX_GROUP_NUM_RULES - 1))) {
 			RTE_LOG(INFO, EFD, "Warn: Insert into last "
 					"available slot in chunk %u "
-					"group %u bin %u\n", *chunk_id,
-					current_group_id, *bin_id);
+					"group %u bin %u\n", chunk_id,
+					current_group_id, bin_id);
 			status = RTE_EFD_UPDATE_WARN_GROUP_FULL;
 		}
 
-		if (rte_ring_sc_dequeue(table->free_slots, &slot_id) != 0)
+		if (rte_ring_dequeue(table->free_slots, &slot_id) != 0)
 			return RTE_EFD_UPDATE_FAILED;
 
 		new_k = RTE_PTR_ADD(table->keys, (uintptr_t) slot_id *
@@ -1043,9 +1096,9 @@ efd_compute_update(struct rte_efd_table * const table,
 		rte_memcpy(EFD_KEY(new_idx, table), key, table->key_len);
 		current_group->key_idx[current_group->num_rules] = new_idx;
 		current_group->value[current_group->num_rules] = value;
-		current_group->bin_id[current_group->num_rules] = *bin_id;
+		current_group->bin_id[current_group->num_rules] = bin_id;
 		current_group->num_rules++;
-		table->num_rules++;
+		__atomic_fetch_add(&table->num_rules, 1, __ATOMIC_RELAXED);
 		bin_size++;
 	} else {
 		uint32_t last = current_group->num_rules - 1;
@@ -1063,7 +1116,7 @@ efd_compute_update(struct rte_efd_table * const table,
 		 */
 		current_group->key_idx[last] = key_idx_previous;
 		current_group->value[last] = value;
-		current_group->bin_id[last] = *bin_id;
+		current_group->bin_id[last] = bin_id;
 	}
 
 	*new_bin_choice = current_choice;
@@ -1092,7 +1145,7 @@ efd_compute_update(struct rte_efd_table * const table,
 		for (choice = 0; choice < EFD_CHUNK_NUM_BIN_TO_GROUP_SETS;
 				choice++) {
 			uint32_t test_group_id =
-					efd_bin_to_group[choice][*bin_id];
+					efd_bin_to_group[choice][bin_id];
 			uint32_t num_rules =
 					chunk->group_rules[test_group_id].num_rules;
 			if (num_rules < smallest_size) {
@@ -1122,11 +1175,14 @@ efd_compute_update(struct rte_efd_table * const table,
 					choice - 1);
 			goto next_choice;
 		}
-		move_groups(*bin_id, bin_size, new_group, current_group);
+		move_groups(bin_id, bin_size, new_group, current_group);
 		/*
 		 * Recompute the hash function for the modified group,
-		 * and return it to the caller
+		 * and return it to the caller.
+		 * The search starts from the functions currently in use,
+		 * which most of the time still fit the group after one change.
 		 */
+		*entry = online_chunk->groups[*group_id];
 		ret = efd_search_hash(table, new_group, entry);
 
 		if (!ret)
@@ -1143,30 +1199,35 @@ efd_compute_update(struct rte_efd_table * const table,
 		if (choice == EFD_CHUNK_NUM_BIN_TO_GROUP_SETS)
 			break;
 		*new_bin_choice = choice;
-		*group_id = efd_bin_to_group[choice][*bin_id];
+		*group_id = efd_bin_to_group[choice][bin_id];
 		new_group = &chunk->group_rules[*group_id];
 		choice++;
 	}
 
 	if (!found) {
 		current_group->num_rules--;
-		table->num_rules--;
+		__atomic_fetch_sub(&table->num_rules, 1, __ATOMIC_RELAXED);
 	} else
 		current_group->value[current_group->num_rules - 1] =
 			key_changed_previous_value;
 	return RTE_EFD_UPDATE_FAILED;
 }
 
-int
-rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
-		const void *key, const efd_value_t value)
+/*
+ * Insert or update a key whose chunk and bin are already computed,
+ * the caller holds the chunk lock on a multi-writer table
+ */
+static inline int
+efd_update_key(struct rte_efd_table * const table, const unsigned int socket_id,
+		const void *key, const efd_value_t value,
+		const uint32_t chunk_id, const uint32_t bin_id)
 {
-	uint32_t chunk_id = 0, group_id = 0, bin_id = 0;
+	uint32_t group_id = 0;
 	uint8_t new_bin_choice = 0;
-	struct efd_online_group_entry entry = {{0}};
+	struct efd_online_group_entry entry;
 
 	int status = efd_compute_update(table, socket_id, key, value,
-			&chunk_id, &group_id, &bin_id,
+			chunk_id, bin_id, &group_id,
 			&new_bin_choice, &entry);
 
 	if (status == RTE_EFD_UPDATE_NO_CHANGE)
@@ -1180,6 +1241,82 @@ rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
 	return status;
 }
 
+int
+rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
+		const void *key, const efd_value_t value)
+{
+	uint32_t chunk_id, bin_id;
+	int status;
+
+	efd_compute_ids(table, key, &chunk_id, &bin_id);
+
+	efd_chunk_lock(table, chunk_id);
+	status = efd_update_key(table, socket_id, key, value,
+			chunk_id, bin_id);
+	efd_chunk_unlock(table, chunk_id);
+
+	return status;
+}
+
+int
+rte_efd_update_bulk(struct rte_efd_table * const table,
+		const unsigned int socket_id, const int num_keys,
+		const void **key_list, const efd_value_t * const value_list,
+		int * const status_list)
+{
+	uint32_t chunk_id_list[RTE_EFD_BURST_MAX];
+	uint32_t bin_id_list[RTE_EFD_BURST_MAX];
+	int order[RTE_EFD_BURST_MAX];
+	uint32_t chunk_id, locked_chunk_id = 0;
+	int i, j, idx, status, num_updated = 0;
+
+	if (table == NULL || key_list == NULL || value_list == NULL ||
+			num_keys < 0 || num_keys > RTE_EFD_BURST_MAX)
+		return -EINVAL;
+
+	for (i = 0; i < num_keys; i++) {
+		efd_compute_ids(table, key_list[i], &chunk_id_list[i],
+				&bin_id_list[i]);
+		rte_prefetch0(&table->chunks[socket_id][chunk_id_list[i]]
+				.bin_choice_list[bin_id_list[i] /
+					EFD_CHUNK_NUM_BIN_TO_GROUP_SETS]);
+	}
+
+	/*
+	 * Process the keys chunk by chunk, so that a multi-writer table
+	 * takes each chunk lock once.
+	 * The sort is stable, the updates of a same key keep their order.
+	 */
+	for (i = 0; i < num_keys; i++) {
+		for (j = i; j > 0 &&
+				chunk_id_list[order[j - 1]] > chunk_id_list[i]; j--)
+			order[j] = order[j - 1];
+		order[j] = i;
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		idx = order[i];
+		chunk_id = chunk_id_list[idx];
+		if (i == 0 || chunk_id != locked_chunk_id) {
+			if (i != 0)
+				efd_chunk_unlock(table, locked_chunk_id);
+			efd_chunk_lock(table, chunk_id);
+			locked_chunk_id = chunk_id;
+		}
+
+		status = efd_update_key(table, socket_id, key_list[idx],
+				value_list[idx], chunk_id, bin_id_list[idx]);
+		if (status != RTE_EFD_UPDATE_FAILED)
+			num_updated++;
+		if (status_list != NULL)
+			status_list[idx] = status;
+	}
+	if (num_keys != 0)
+		efd_chunk_unlock(table, locked_chunk_id);
+
+	return num_updated;
+}
+
 int
 rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 		const void *key, efd_value_t * const prev_value)
@@ -1193,6 +1330,8 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 	struct efd_offline_chunk_rules * const chunk =
 			&table->offline_chunks[chunk_id];
 
+	efd_chunk_lock(table, chunk_id);
+
 	uint8_t current_choice = efd_get_choice(table, socket_id,
 			chunk_id, bin_id);
 	uint32_t current_group_id = efd_bin_to_group[current_choice][bin_id];
@@ -1213,7 +1352,7 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 					*prev_value = current_group->value[i];
 
 				not_found = 0;
-				rte_ring_sp_enqueue(table->free_slots,
+				rte_ring_enqueue(table->free_slots,
 					(void *)((uintptr_t)current_group->key_idx[i]));
 			}
 		} else {
@@ -1230,10 +1369,12 @@ rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 	}
 
 	if (not_found == 0) {
-		table->num_rules--;
+		__atomic_fetch_sub(&table->num_rules, 1, __ATOMIC_RELAXED);
 		current_group->num_rules--;
 	}
 
+	efd_chunk_unlock(table, chunk_id);
+
 	return not_found;
 }
 
@@ -13,6 +13,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -141,6 +143,45 @@ struct rte_efd_table *
 rte_efd_create(const char *name, uint32_t max_num_rules, uint32_t key_len,
 	uint64_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket);
 
+/**
+ * Flag allowing rte_efd_update(), rte_efd_update_bulk() and rte_efd_delete()
+ * to be called concurrently from several threads.
+ * Writers serialize on a lock per chunk of the table,
+ * so updates of keys falling in different chunks proceed in parallel.
+ */
+#define RTE_EFD_F_MULTI_WRITER	(1 << 0)
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Creates an EFD table like rte_efd_create(), with additional flags.
+ *
+ * @param name
+ *   EFD table name
+ * @param max_num_rules
+ *   Minimum number of rules the table should be sized to hold.
+ *   Will be rounded up to the next smallest valid table size
+ * @param key_len
+ *   Length of the key
+ * @param online_cpu_socket_bitmask
+ *   Bitmask specifying which sockets should get a copy of the online table.
+ *   LSB = socket 0, etc.
+ * @param offline_cpu_socket
+ *   Identifies the socket where the offline table will be allocated
+ *   (and most efficiently accessed in the case of updates/insertions)
+ * @param flags
+ *   Bitwise OR of RTE_EFD_F_* flags, 0 behaves like rte_efd_create()
+ *
+ * @return
+ *   EFD table, or NULL if table allocation failed or a parameter is invalid
+ */
+__rte_experimental
+struct rte_efd_table *
+rte_efd_create_flags(const char *name, uint32_t max_num_rules, uint32_t key_len,
+	uint64_t online_cpu_socket_bitmask, uint8_t offline_cpu_socket,
+	uint32_t flags);
+
 /**
  * Releases the resources from an EFD table
  *
@@ -173,7 +214,8 @@ rte_efd_find_existing(const char *name);
  * The update is then immediately applied to the provided table and
  * all socket-local copies of the chunks are updated.
  * This operation is not multi-thread safe
- * and should only be called one from thread.
+ * and should only be called one from thread,
+ * unless the table was created with RTE_EFD_F_MULTI_WRITER.
  *
  * @param table
  *   EFD table to reference
@@ -201,10 +243,48 @@ int
 rte_efd_update(struct rte_efd_table *table, unsigned int socket_id,
 	const void *key, efd_value_t value);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Inserts or updates several key/value pairs, with the same result
+ * as calling rte_efd_update() for each of them in order.
+ * The keys are hashed and their chunks prefetched up front,
+ * and on a multi-writer table the lock of a chunk is taken once
+ * for all the keys of the burst falling in it.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread,
+ * unless the table was created with RTE_EFD_F_MULTI_WRITER.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param socket_id
+ *   Socket ID to use to lookup existing values (ideally caller's socket id)
+ * @param num_keys
+ *   Number of keys in the key_list array, must be at most RTE_EFD_BURST_MAX
+ * @param key_list
+ *   Array of num_keys pointers to the keys to insert or update
+ * @param value_list
+ *   Array of num_keys values to associate with the keys
+ * @param status_list
+ *   If not NULL, array of num_keys where the value rte_efd_update() would
+ *   return for each key is stored
+ *
+ * @return
+ *   Number of keys inserted or updated, i.e. whose status is not
+ *   RTE_EFD_UPDATE_FAILED, or -EINVAL if a parameter is invalid
+ */
+__rte_experimental
+int
+rte_efd_update_bulk(struct rte_efd_table *table, unsigned int socket_id,
+	int num_keys, const void **key_list, const efd_value_t *value_list,
+	int *status_list);
+
 /**
  * Removes any value currently associated with the specified key from the table
  * This operation is not multi-thread safe
- * and should only be called from one thread.
+ * and should only be called from one thread,
+ * unless the table was created with RTE_EFD_F_MULTI_WRITER.
  *
  * @param table
  *   EFD table to reference
@@ -5,10 +5,12 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <rte_debug.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_log.h>
 #include <rte_vect.h>
 
 #include <rte_rib.h>
@@ -146,7 +148,7 @@ write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 }
 
 static int
-tbl8_get_idx(struct dir24_8_tbl *dp)
+tbl8_find_idx(struct dir24_8_tbl *dp)
 {
 	uint32_t i;
 	int bit_idx;
@@ -169,6 +171,86 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
 }
 
+static void
+tbl8_cleanup(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	/* Set tbl8 group invalid */
+	write_to_fib((uint8_t *)dp->tbl8 +
+		((tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz),
+		0, dp->nh_sz, DIR24_8_TBL8_GRP_NUM_ENT);
+	tbl8_free_idx(dp, tbl8_idx);
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct dir24_8_tbl *dp = p;
+	uint32_t *tbl8_idx = data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup(dp, *tbl8_idx);
+}
+
+/*
+ * Release the tbl8 groups waiting for a grace period of the readers.
+ * Returns the number of groups made available.
+ */
+static uint32_t
+tbl8_reclaim(struct dir24_8_tbl *dp)
+{
+	uint32_t i, n = 0;
+
+	if (dp->num_pend != 0) {
+		/* One grace period for all the groups of a bulk update. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		for (i = 0; i < dp->num_pend; i++)
+			tbl8_cleanup(dp, dp->tbl8_pend[i]);
+		n = dp->num_pend;
+		dp->num_pend = 0;
+	} else if (dp->dq != NULL) {
+		rte_rcu_qsbr_dq_reclaim(dp->dq, 1, &n, NULL, NULL);
+		/* Bulk updates wait for readers rather than fail. */
+		if ((n == 0) && dp->in_bulk) {
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			rte_rcu_qsbr_dq_reclaim(dp->dq, 1, &n, NULL, NULL);
+		}
+	}
+	return n;
+}
+
+static int
+tbl8_get_idx(struct dir24_8_tbl *dp)
+{
+	int idx;
+
+	idx = tbl8_find_idx(dp);
+	if ((idx < 0) && (dp->v != NULL) && (tbl8_reclaim(dp) != 0))
+		idx = tbl8_find_idx(dp);
+	return idx;
+}
+
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	dp->cur_tbl8s--;
+	if (dp->v == NULL) {
+		tbl8_cleanup(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
+		if (dp->in_bulk) {
+			dp->tbl8_pend[dp->num_pend++] = tbl8_idx;
+			return;
+		}
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup(dp, tbl8_idx);
+	} else if (rte_rcu_qsbr_dq_enqueue(dp->dq, &tbl8_idx) != 0) {
+		/* Defer queue is full, do not leak the group. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup(dp, tbl8_idx);
+	}
+}
+
 static int
 tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 {
@@ -210,8 +292,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint8_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr8[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_2B:
 		ptr16 = &((uint16_t *)dp->tbl8)[tbl8_idx *
@@ -223,8 +303,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint16_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -236,8 +314,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint32_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -249,12 +325,41 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint64_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
+	tbl8_free(dp, tbl8_idx);
+}
+
+/*
+ * Write a range of tbl24 entries, releasing the tbl8 groups of the
+ * extended entries being overwritten. Those are left behind by routes
+ * removed in the same bulk update.
+ */
+static void
+write_tbl24_range(struct dir24_8_tbl *dp, uint32_t ip, uint64_t val,
+	uint32_t len)
+{
+	uint32_t i, j;
+	uint64_t ent;
+
+	if (dp->cur_tbl8s == 0) {
+		write_to_fib(get_tbl24_p(dp, ip, dp->nh_sz), val,
+			dp->nh_sz, len);
+		return;
+	}
+
+	for (i = 0; i < len; i = j + 1) {
+		ent = 0;
+		for (j = i; j < len; j++) {
+			ent = get_tbl24(dp, ip + (j << 8), dp->nh_sz);
+			if (is_entry_extended(ent))
+				break;
+		}
+		write_to_fib(get_tbl24_p(dp, ip + (i << 8), dp->nh_sz), val,
+			dp->nh_sz, RTE_MIN(j + 1, len) - i);
+		if (j < len)
+			tbl8_free(dp, ent >> 1);
+	}
 }
 
 static int
@@ -306,8 +411,7 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 				dp->nh_sz, ROUNDUP(ledge, 24) - ledge);
 			tbl8_recycle(dp, ledge, tbl8_idx);
 		}
-		write_to_fib(get_tbl24_p(dp, ROUNDUP(ledge, 24), dp->nh_sz),
-			next_hop << 1, dp->nh_sz, len);
+		write_tbl24_range(dp, ROUNDUP(ledge, 24), next_hop << 1, len);
 		if (redge & ~DIR24_8_TBL24_MASK) {
 			tbl24_tmp = get_tbl24(dp, redge, dp->nh_sz);
 			if ((tbl24_tmp & DIR24_8_EXT_ENT) !=
@@ -492,6 +596,243 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	return -EINVAL;
 }
 
+struct route_change {
+	uint32_t	ip;
+	uint8_t		depth;
+};
+
+static int
+route_change_cmp(const void *a, const void *b)
+{
+	const struct route_change *ca = a;
+	const struct route_change *cb = b;
+
+	if (ca->ip != cb->ip)
+		return (ca->ip < cb->ip) ? -1 : 1;
+	return (int)ca->depth - (int)cb->depth;
+}
+
+/*
+ * Get the most specific route covering the whole prefix,
+ * its next hop and depth.
+ */
+static uint64_t
+get_cover_nh(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth, uint8_t *cover_depth)
+{
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint8_t node_depth;
+
+	node = rte_rib_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib_get_depth(node, &node_depth);
+		if (node_depth <= depth) {
+			rte_rib_get_nh(node, &nh);
+			*cover_depth = node_depth;
+			return nh;
+		}
+		node = rte_rib_lookup_parent(node);
+	}
+	*cover_depth = 0;
+	return dp->def_nh;
+}
+
+static inline int
+prefix_contains(const struct route_change *p, const struct route_change *c)
+{
+	return (p->depth <= c->depth) &&
+		((c->ip & rte_rib_depth_to_mask(p->depth)) == p->ip);
+}
+
+/*
+ * Rewrite the dataplane for the changed prefixes. The changes are sorted
+ * so that a prefix comes before the prefixes it contains. modify_fib()
+ * for a prefix rewrites all its addresses not covered by more specific
+ * routes, so a change is skipped when it lies inside an already written
+ * prefix with no route in between.
+ */
+static int
+commit_changes(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct route_change *chg, unsigned int n)
+{
+	struct route_change *stack[RTE_FIB_MAXDEPTH + 1];
+	unsigned int i, top = 0;
+	uint64_t nh;
+	uint8_t cover_depth;
+	int ret;
+
+	qsort(chg, n, sizeof(*chg), route_change_cmp);
+
+	for (i = 0; i < n; i++) {
+		while ((top != 0) && !prefix_contains(stack[top - 1], &chg[i]))
+			top--;
+		nh = get_cover_nh(dp, rib, chg[i].ip, chg[i].depth,
+			&cover_depth);
+		if ((top != 0) && (cover_depth <= stack[top - 1]->depth))
+			continue;
+		ret = modify_fib(dp, rib, chg[i].ip, chg[i].depth, nh);
+		if (ret != 0)
+			return ret;
+		stack[top++] = &chg[i];
+	}
+	return 0;
+}
+
+int
+dir24_8_modify_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n,
+	int op)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *tmp;
+	struct rte_rib_node *node;
+	struct route_change *chg;
+	unsigned int i, num_chg = 0;
+	uint32_t ip, rel_tbl8s = 0;
+	uint64_t node_nh;
+	uint8_t depth;
+	int ret, err = 0;
+
+	if ((fib == NULL) || (ips == NULL) || (depths == NULL) ||
+			((op == RTE_FIB_ADD) && (next_hops == NULL)) ||
+			((op != RTE_FIB_ADD) && (op != RTE_FIB_DEL)))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	chg = rte_malloc(NULL, sizeof(*chg) * RTE_MAX(n, 1U), 0);
+	if (chg == NULL)
+		return -ENOMEM;
+
+	/* Apply the routes to the RIB, keeping the tbl8 reservations. */
+	for (i = 0; i < n; i++) {
+		depth = depths[i];
+		if ((depth > RTE_FIB_MAXDEPTH) || ((op == RTE_FIB_ADD) &&
+				(next_hops[i] > get_max_nh(dp->nh_sz)))) {
+			err = EINVAL;
+			break;
+		}
+		ip = ips[i] & rte_rib_depth_to_mask(depth);
+		node = rte_rib_lookup_exact(rib, ip, depth);
+		if (op == RTE_FIB_ADD) {
+			if (node != NULL) {
+				rte_rib_get_nh(node, &node_nh);
+				if (node_nh == next_hops[i])
+					continue;
+				rte_rib_set_nh(node, next_hops[i]);
+			} else {
+				tmp = NULL;
+				/*
+				 * tbl8s released in this batch are only
+				 * reused once the dataplane is updated.
+				 */
+				if (depth > 24) {
+					tmp = rte_rib_get_nxt(rib, ip, 24,
+						NULL, RTE_RIB_GET_NXT_COVER);
+					if ((tmp == NULL) && (dp->rsvd_tbl8s +
+							rel_tbl8s >=
+							dp->number_tbl8s)) {
+						err = ENOSPC;
+						break;
+					}
+				}
+				node = rte_rib_insert(rib, ip, depth);
+				if (node == NULL) {
+					err = rte_errno;
+					break;
+				}
+				rte_rib_set_nh(node, next_hops[i]);
+				if ((depth > 24) && (tmp == NULL))
+					dp->rsvd_tbl8s++;
+			}
+		} else {
+			if (node == NULL) {
+				err = ENOENT;
+				break;
+			}
+			rte_rib_remove(rib, ip, depth);
+			if ((depth > 24) && (rte_rib_get_nxt(rib, ip, 24,
+					NULL, RTE_RIB_GET_NXT_COVER) == NULL)) {
+				dp->rsvd_tbl8s--;
+				rel_tbl8s++;
+			}
+		}
+		chg[num_chg].ip = ip;
+		chg[num_chg].depth = depth;
+		num_chg++;
+	}
+
+	dp->in_bulk = 1;
+	ret = commit_changes(dp, rib, chg, num_chg);
+	dp->in_bulk = 0;
+	if (dp->num_pend != 0)
+		tbl8_reclaim(dp);
+	rte_free(chg);
+
+	if (ret != 0)
+		return ret;
+	if (err != 0)
+		rte_errno = err;
+	return i;
+}
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((dp == NULL) || (cfg == NULL))
+		return -EINVAL;
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	switch (cfg->mode) {
+	case RTE_FIB_QSBR_MODE_DQ:
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+			"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return -rte_errno;
+		}
+		break;
+	case RTE_FIB_QSBR_MODE_SYNC:
+		/* tbl8s released by a bulk update share one grace period */
+		dp->tbl8_pend = rte_zmalloc(NULL,
+			sizeof(uint32_t) * dp->number_tbl8s, 0);
+		if (dp->tbl8_pend == NULL)
+			return -ENOMEM;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
+
 void *
 dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 {
@@ -563,6 +904,9 @@ dir24_8_free(void *p)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->tbl8_pend);
 	rte_free(dp->tbl8_idxes);
 	rte_free(dp->tbl8);
 	rte_free(dp);
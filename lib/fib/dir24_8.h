@@ -31,6 +31,12 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	struct rte_rcu_qsbr	*v;	/**< RCU QSBR variable */
+	enum rte_fib_qsbr_mode	rcu_mode;	/**< Blocking, defer queue */
+	struct rte_rcu_qsbr_dq	*dq;	/**< RCU QSBR defer queue */
+	uint32_t	*tbl8_pend;	/**< tbl8s released by a bulk update */
+	uint32_t	num_pend;	/**< Number of tbl8s in tbl8_pend */
+	uint32_t	in_bulk;	/**< Bulk update in progress */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -248,4 +254,13 @@ int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+int
+dir24_8_modify_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n,
+	int op);
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
 #endif /* _DIR24_8_H_ */
@@ -0,0 +1,796 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+
+#include <rte_rib6.h>
+#include <rte_fib6.h>
+#include "poptrie.h"
+
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+
+#include "poptrie_avx512.h"
+
+#endif /* CC_POPTRIE_AVX512_SUPPORT */
+
+#define POPTRIE_NAMESIZE		64
+
+/* Maximum depth value possible for IPv6 FIB. */
+#define POPTRIE_MAX_DEPTH		128
+
+enum poptrie_pool {
+	POOL_NODES,
+	POOL_LEAVES
+};
+
+static inline rte_fib6_lookup_fn_t
+get_vector_fn(void)
+{
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VPOPCNTDQ) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512))
+		return NULL;
+	return rte_poptrie_vec_lookup_bulk;
+#else
+	return NULL;
+#endif
+}
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	rte_fib6_lookup_fn_t ret_fn;
+
+	if (p == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_POPTRIE_SCALAR:
+		return rte_poptrie_lookup_bulk;
+	case RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512:
+		return get_vector_fn();
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn();
+		return (ret_fn != NULL) ? ret_fn : rte_poptrie_lookup_bulk;
+	default:
+		return NULL;
+	}
+	return NULL;
+}
+
+/*
+ * Node and leaf arrays are managed as blocks of 1 to 64 entries,
+ * rounded up to a power of 2. Free blocks are kept in per size lists,
+ * linked through their first entry.
+ */
+static inline uint32_t
+get_order(uint32_t n)
+{
+	return (n <= 1) ? 0 : 32 - __builtin_clz(n - 1);
+}
+
+static inline uint32_t *
+pool_free_list(struct rte_poptrie_tbl *dp, enum poptrie_pool pool)
+{
+	return (pool == POOL_NODES) ? dp->nodes_free : dp->leaves_free;
+}
+
+static inline uint32_t
+blk_get_link(struct rte_poptrie_tbl *dp, enum poptrie_pool pool, uint32_t idx)
+{
+	return (pool == POOL_NODES) ? dp->nodes[idx].base0 :
+		(uint32_t)dp->leaves[idx];
+}
+
+static inline void
+blk_push(struct rte_poptrie_tbl *dp, enum poptrie_pool pool, uint32_t idx,
+	uint32_t order)
+{
+	uint32_t *free_list = pool_free_list(dp, pool);
+
+	if (pool == POOL_NODES)
+		dp->nodes[idx].base0 = free_list[order];
+	else
+		dp->leaves[idx] = free_list[order];
+	free_list[order] = idx;
+}
+
+static uint32_t
+blk_alloc(struct rte_poptrie_tbl *dp, enum poptrie_pool pool, uint32_t n)
+{
+	uint32_t *free_list = pool_free_list(dp, pool);
+	uint32_t *top, *cur, total;
+	uint32_t order, k, idx;
+
+	if (pool == POOL_NODES) {
+		top = &dp->nodes_top;
+		cur = &dp->cur_nodes;
+		total = dp->number_nodes;
+	} else {
+		top = &dp->leaves_top;
+		cur = &dp->cur_leaves;
+		total = dp->number_leaves;
+	}
+
+	order = get_order(n);
+	idx = free_list[order];
+	if (idx != POPTRIE_NIL) {
+		free_list[order] = blk_get_link(dp, pool, idx);
+	} else if (total - *top >= (1U << order)) {
+		idx = *top;
+		*top += 1 << order;
+	} else {
+		/* split the smallest larger free block */
+		for (k = order + 1; k < POPTRIE_NUM_ORDERS; k++) {
+			if (free_list[k] != POPTRIE_NIL)
+				break;
+		}
+		if (k == POPTRIE_NUM_ORDERS)
+			return POPTRIE_NIL;
+		idx = free_list[k];
+		free_list[k] = blk_get_link(dp, pool, idx);
+		while (k-- > order)
+			blk_push(dp, pool, idx + (1 << k), k);
+	}
+	*cur += 1 << order;
+	return idx;
+}
+
+static void
+blk_free(struct rte_poptrie_tbl *dp, enum poptrie_pool pool, uint32_t idx,
+	uint32_t n)
+{
+	uint32_t order = get_order(n);
+
+	blk_push(dp, pool, idx, order);
+	if (pool == POOL_NODES)
+		dp->cur_nodes -= 1 << order;
+	else
+		dp->cur_leaves -= 1 << order;
+}
+
+static inline const struct poptrie_node *
+get_child(const struct rte_poptrie_tbl *dp, const struct poptrie_node *node,
+	uint32_t idx)
+{
+	return &dp->nodes[node->base1 +
+		__builtin_popcountll(node->vector & poptrie_msk(idx)) - 1];
+}
+
+static inline uint64_t
+get_leaf(const struct rte_poptrie_tbl *dp, const struct poptrie_node *node,
+	uint32_t idx)
+{
+	return dp->leaves[node->base0 +
+		__builtin_popcountll(node->leafvec & poptrie_msk(idx)) - 1];
+}
+
+/*
+ * Free the child and leaf blocks of the subtree rooted at a that are
+ * not shared with the subtree rooted at b.
+ */
+static void
+release(struct rte_poptrie_tbl *dp, const struct poptrie_node *a,
+	const struct poptrie_node *b)
+{
+	const struct poptrie_node *b_chld;
+	uint32_t na, nb, i;
+	uint64_t vec;
+
+	na = __builtin_popcountll(a->vector);
+	nb = (b != NULL) ? __builtin_popcountll(b->vector) : 0;
+	if ((na != 0) && ((nb == 0) || (a->base1 != b->base1))) {
+		for (vec = a->vector; vec != 0; vec &= vec - 1) {
+			i = __builtin_ctzll(vec);
+			b_chld = ((b != NULL) && (b->vector & (1ULL << i))) ?
+				get_child(dp, b, i) : NULL;
+			release(dp, get_child(dp, a, i), b_chld);
+		}
+		blk_free(dp, POOL_NODES, a->base1, na);
+	}
+
+	na = __builtin_popcountll(a->leafvec);
+	nb = (b != NULL) ? __builtin_popcountll(b->leafvec) : 0;
+	if ((na != 0) && ((nb == 0) || (a->base0 != b->base0)))
+		blk_free(dp, POOL_LEAVES, a->base0, na);
+}
+
+/*
+ * Lay out the children of a node into the node and leaf arrays.
+ * Blocks equal to the ones of old are shared instead of copied.
+ */
+static int
+pack_node(struct rte_poptrie_tbl *dp, const struct poptrie_node *old,
+	const struct poptrie_node *chld, const uint64_t *nh, uint64_t vector,
+	struct poptrie_node *new)
+{
+	struct poptrie_node nodes[POPTRIE_NODE_NUM_CHLD];
+	uint64_t leaves[POPTRIE_NODE_NUM_CHLD];
+	uint64_t leafvec = 0;
+	uint32_t i, nn = 0, nl = 0;
+
+	for (i = 0; i < POPTRIE_NODE_NUM_CHLD; i++) {
+		if (vector & (1ULL << i))
+			nodes[nn++] = chld[i];
+		else if ((nl == 0) || (nh[i] != leaves[nl - 1])) {
+			/* leaf compression, only the start of a run is kept */
+			leafvec |= 1ULL << i;
+			leaves[nl++] = nh[i];
+		}
+	}
+
+	new->vector = vector;
+	new->leafvec = leafvec;
+	new->base0 = 0;
+	new->base1 = 0;
+
+	if (nn != 0) {
+		if ((old != NULL) && (old->vector == vector) &&
+				(memcmp(&dp->nodes[old->base1], nodes,
+				nn * sizeof(nodes[0])) == 0))
+			new->base1 = old->base1;
+		else {
+			new->base1 = blk_alloc(dp, POOL_NODES, nn);
+			if (new->base1 == POPTRIE_NIL)
+				return -ENOSPC;
+			memcpy(&dp->nodes[new->base1], nodes,
+				nn * sizeof(nodes[0]));
+		}
+	}
+
+	if (nl != 0) {
+		if ((old != NULL) && (old->leafvec == leafvec) &&
+				(memcmp(&dp->leaves[old->base0], leaves,
+				nl * sizeof(leaves[0])) == 0))
+			new->base0 = old->base0;
+		else {
+			new->base0 = blk_alloc(dp, POOL_LEAVES, nl);
+			if (new->base0 == POPTRIE_NIL) {
+				if ((nn != 0) && ((old == NULL) ||
+						(new->base1 != old->base1)))
+					blk_free(dp, POOL_NODES, new->base1, nn);
+				return -ENOSPC;
+			}
+			memcpy(&dp->leaves[new->base0], leaves,
+				nl * sizeof(leaves[0]));
+		}
+	}
+
+	return 0;
+}
+
+static inline void
+addr_to_ip(uint64_t hi, uint64_t lo, uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE])
+{
+	*(unaligned_uint64_t *)&ip[0] = rte_cpu_to_be_64(hi);
+	*(unaligned_uint64_t *)&ip[8] = rte_cpu_to_be_64(lo);
+}
+
+static inline void
+ip_to_addr(const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint64_t *hi,
+	uint64_t *lo)
+{
+	*hi = rte_be_to_cpu_64(*(const unaligned_uint64_t *)&ip[0]);
+	*lo = rte_be_to_cpu_64(*(const unaligned_uint64_t *)&ip[8]);
+}
+
+/*
+ * The direct pointing table is handled as a node at bit offset 0
+ * with a stride of POPTRIE_DIR_BITS.
+ */
+static inline uint32_t
+get_stride(uint32_t off)
+{
+	return (off == 0) ? POPTRIE_DIR_BITS : POPTRIE_STRIDE;
+}
+
+static inline uint32_t
+get_idx(uint64_t hi, uint64_t lo, uint32_t off)
+{
+	return (off == 0) ? hi >> (64 - POPTRIE_DIR_BITS) :
+		poptrie_get_chunk(hi, lo, off);
+}
+
+/* Get the address of the child idx of a node at bit offset off. */
+static inline void
+set_idx(uint64_t *hi, uint64_t *lo, uint32_t off, uint32_t idx)
+{
+	if (off == 0)
+		*hi |= (uint64_t)idx << (64 - POPTRIE_DIR_BITS);
+	else if (off < 64)
+		*hi |= (uint64_t)idx << (64 - POPTRIE_STRIDE - off);
+	else if (off <= 128 - POPTRIE_STRIDE)
+		*lo |= (uint64_t)idx << (128 - POPTRIE_STRIDE - off);
+	else
+		*lo |= (uint64_t)idx >> (off - (128 - POPTRIE_STRIDE));
+}
+
+static inline uint8_t
+child_depth(uint32_t off)
+{
+	return RTE_MIN(off + get_stride(off), POPTRIE_MAX_DEPTH);
+}
+
+/* Check if the RIB has routes more specific than hi:lo/depth. */
+static inline int
+has_more_specific(struct rte_rib6 *rib, uint64_t hi, uint64_t lo,
+	uint8_t depth)
+{
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+
+	if (depth >= POPTRIE_MAX_DEPTH)
+		return 0;
+	addr_to_ip(hi, lo, ip);
+	return rte_rib6_get_nxt(rib, ip, depth, NULL,
+		RTE_RIB6_GET_NXT_COVER) != NULL;
+}
+
+/*
+ * Get the next hop of the longest route covering the whole prefix
+ * hi:lo/max_depth and the depth of that route; the default next hop is
+ * reported with depth 0.
+ */
+static inline uint64_t
+get_rib_nh(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib, uint64_t hi,
+	uint64_t lo, uint8_t max_depth, uint8_t *depth)
+{
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_rib6_node *node;
+	uint64_t nh;
+
+	addr_to_ip(hi, lo, ip);
+	node = rte_rib6_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib6_get_depth(node, depth);
+		if (*depth <= max_depth)
+			break;
+		node = rte_rib6_lookup_parent(node);
+	}
+	if (node == NULL) {
+		*depth = 0;
+		return dp->def_nh;
+	}
+	rte_rib6_get_nh(node, &nh);
+	return nh;
+}
+
+/*
+ * For the n children of node hi:lo/off starting at first, find the next
+ * hop of the longest route covering the whole child, the depth of this
+ * route and whether longer routes exist under the child. n is a power
+ * of 2 and first is aligned on it. For more than one child, the routes
+ * under the range are walked once instead of querying the RIB for every
+ * child.
+ */
+static void
+scan_chld(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib, uint64_t hi,
+	uint64_t lo, uint32_t off, uint32_t first, uint32_t n, uint64_t *nh,
+	uint8_t *nh_depth, uint8_t *ext)
+{
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_rib6_node *tmp = NULL;
+	uint64_t par_nh, r_hi, r_lo;
+	uint32_t i, j, m, stride;
+	uint8_t depth, c_depth, par_depth, tmp_depth;
+
+	stride = get_stride(off);
+	c_depth = child_depth(off);
+	set_idx(&hi, &lo, off, first);
+
+	if (n == 1) {
+		nh[0] = get_rib_nh(dp, rib, hi, lo, c_depth, &nh_depth[0]);
+		ext[0] = has_more_specific(rib, hi, lo, c_depth);
+		return;
+	}
+
+	depth = off + stride - __builtin_ctz(n);
+	par_nh = get_rib_nh(dp, rib, hi, lo, depth, &par_depth);
+	for (i = 0; i < n; i++) {
+		nh[i] = par_nh;
+		nh_depth[i] = par_depth;
+		ext[i] = 0;
+	}
+
+	addr_to_ip(hi, lo, ip);
+	while ((tmp = rte_rib6_get_nxt(rib, ip, depth, tmp,
+			RTE_RIB6_GET_NXT_ALL)) != NULL) {
+		rte_rib6_get_ip(tmp, ip);
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		ip_to_addr(ip, &r_hi, &r_lo);
+		addr_to_ip(hi, lo, ip);
+		i = get_idx(r_hi, r_lo, off) - first;
+		if (tmp_depth > c_depth) {
+			ext[i] = 1;
+			continue;
+		}
+		m = 1 << (off + stride - tmp_depth);
+		for (j = i; j < i + m; j++) {
+			if (tmp_depth > nh_depth[j]) {
+				nh_depth[j] = tmp_depth;
+				rte_rib6_get_nh(tmp, &nh[j]);
+			}
+		}
+	}
+}
+
+/* Build the node for prefix hi:lo/off from the RIB. */
+static int
+build_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib, uint64_t hi,
+	uint64_t lo, uint32_t off, struct poptrie_node *new)
+{
+	struct poptrie_node chld[POPTRIE_NODE_NUM_CHLD];
+	uint64_t nh[POPTRIE_NODE_NUM_CHLD];
+	uint8_t nh_depth[POPTRIE_NODE_NUM_CHLD];
+	uint8_t ext[POPTRIE_NODE_NUM_CHLD];
+	uint64_t vector = 0, vec, c_hi, c_lo;
+	uint32_t i;
+	int ret = 0;
+
+	scan_chld(dp, rib, hi, lo, off, 0, POPTRIE_NODE_NUM_CHLD, nh,
+		nh_depth, ext);
+
+	for (i = 0; i < POPTRIE_NODE_NUM_CHLD; i++) {
+		if (!ext[i])
+			continue;
+		c_hi = hi;
+		c_lo = lo;
+		set_idx(&c_hi, &c_lo, off, i);
+		ret = build_node(dp, rib, c_hi, c_lo, off + POPTRIE_STRIDE,
+			&chld[i]);
+		if (ret != 0)
+			goto err;
+		vector |= 1ULL << i;
+	}
+
+	ret = pack_node(dp, NULL, chld, nh, vector, new);
+	if (ret == 0)
+		return 0;
+err:
+	for (vec = vector; vec != 0; vec &= vec - 1)
+		release(dp, &chld[__builtin_ctzll(vec)], NULL);
+	return ret;
+}
+
+/*
+ * Rebuild the node old at bit offset off for the route r_hi:r_lo/depth.
+ * Children the route does not cover or that are covered by a more
+ * specific route are kept as they are, the others are rebuilt.
+ */
+static int
+modify_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const struct poptrie_node *old, uint64_t hi, uint64_t lo, uint32_t off,
+	uint64_t r_hi, uint64_t r_lo, uint8_t depth, struct poptrie_node *new)
+{
+	struct poptrie_node chld[POPTRIE_NODE_NUM_CHLD];
+	uint64_t nh[POPTRIE_NODE_NUM_CHLD];
+	uint8_t nh_depth[POPTRIE_NODE_NUM_CHLD];
+	uint8_t ext[POPTRIE_NODE_NUM_CHLD];
+	const struct poptrie_node *old_chld;
+	uint64_t vector = 0, vec, c_hi, c_lo;
+	uint32_t i, first, n;
+	int ret = 0;
+
+	if (depth <= off) {
+		first = 0;
+		n = POPTRIE_NODE_NUM_CHLD;
+	} else {
+		first = poptrie_get_chunk(r_hi, r_lo, off);
+		n = (depth < off + POPTRIE_STRIDE) ?
+			1 << (off + POPTRIE_STRIDE - depth) : 1;
+	}
+	scan_chld(dp, rib, hi, lo, off, first, n, &nh[first],
+		&nh_depth[first], &ext[first]);
+
+	for (i = 0; i < POPTRIE_NODE_NUM_CHLD; i++) {
+		old_chld = (old->vector & (1ULL << i)) ?
+			get_child(dp, old, i) : NULL;
+		if ((i < first) || (i >= first + n)) {
+			if (old_chld != NULL) {
+				chld[i] = *old_chld;
+				vector |= 1ULL << i;
+			} else
+				nh[i] = get_leaf(dp, old, i);
+			continue;
+		}
+		if (!ext[i])
+			continue;
+		if ((old_chld != NULL) && (nh_depth[i] > depth)) {
+			/* a longer route covering the child hides the change */
+			chld[i] = *old_chld;
+			vector |= 1ULL << i;
+			continue;
+		}
+
+		c_hi = hi;
+		c_lo = lo;
+		set_idx(&c_hi, &c_lo, off, i);
+		if (old_chld != NULL)
+			ret = modify_node(dp, rib, old_chld, c_hi, c_lo,
+				off + POPTRIE_STRIDE, r_hi, r_lo, depth,
+				&chld[i]);
+		else
+			ret = build_node(dp, rib, c_hi, c_lo,
+				off + POPTRIE_STRIDE, &chld[i]);
+		if (ret != 0)
+			goto err;
+		vector |= 1ULL << i;
+	}
+
+	ret = pack_node(dp, old, chld, nh, vector, new);
+	if (ret == 0)
+		return 0;
+err:
+	for (vec = vector; vec != 0; vec &= vec - 1) {
+		i = __builtin_ctzll(vec);
+		old_chld = (old->vector & (1ULL << i)) ?
+			get_child(dp, old, i) : NULL;
+		release(dp, &chld[i], old_chld);
+	}
+	return ret;
+}
+
+static inline int
+is_entry_extended(uint64_t ent)
+{
+	return (ent & POPTRIE_EXT_ENT) == POPTRIE_EXT_ENT;
+}
+
+static inline const struct poptrie_node *
+get_ent_node(const struct rte_poptrie_tbl *dp, uint64_t ent)
+{
+	return is_entry_extended(ent) ? &dp->nodes[ent >> 1] : NULL;
+}
+
+/*
+ * Bring the dataplane in line with the RIB for the route r_hi:r_lo/depth.
+ * New subtrees are built aside for every affected direct pointing entry,
+ * then published with a single store each, and the replaced blocks are
+ * freed afterwards.
+ */
+static int
+modify_dp(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib, uint64_t r_hi,
+	uint64_t r_lo, uint8_t depth)
+{
+	const struct poptrie_node *old_node;
+	struct poptrie_node tmp;
+	uint64_t ent, old_ent, d_hi;
+	uint64_t *new_ent, one_ent;
+	uint8_t *nh_depth, *ext, one_depth, one_ext;
+	uint32_t first, n, i, j, root;
+	int ret = 0;
+
+	first = r_hi >> (64 - POPTRIE_DIR_BITS);
+	n = (depth < POPTRIE_DIR_BITS) ? 1 << (POPTRIE_DIR_BITS - depth) : 1;
+	if (n == 1) {
+		new_ent = &one_ent;
+		nh_depth = &one_depth;
+		ext = &one_ext;
+	} else {
+		new_ent = rte_malloc(NULL, n * (sizeof(*new_ent) +
+			sizeof(*nh_depth) + sizeof(*ext)), 0);
+		if (new_ent == NULL)
+			return -ENOMEM;
+		nh_depth = (uint8_t *)(new_ent + n);
+		ext = nh_depth + n;
+	}
+
+	/* new_ent holds the next hops until the entries are rebuilt */
+	scan_chld(dp, rib, 0, 0, 0, first, n, new_ent, nh_depth, ext);
+
+	for (i = 0; i < n; i++) {
+		d_hi = (uint64_t)(first + i) << (64 - POPTRIE_DIR_BITS);
+		old_ent = dp->dir[first + i];
+		if (!ext[i]) {
+			new_ent[i] = new_ent[i] << 1;
+			continue;
+		}
+		old_node = get_ent_node(dp, old_ent);
+		if ((old_node != NULL) && (nh_depth[i] > depth)) {
+			/* a longer route covering the entry hides the change */
+			new_ent[i] = old_ent;
+			continue;
+		}
+		if (old_node != NULL)
+			ret = modify_node(dp, rib, old_node, d_hi, 0,
+				POPTRIE_DIR_BITS, r_hi, r_lo, depth, &tmp);
+		else
+			ret = build_node(dp, rib, d_hi, 0, POPTRIE_DIR_BITS,
+				&tmp);
+		if (ret != 0)
+			goto err;
+		if ((old_node != NULL) && (memcmp(&tmp, old_node,
+				sizeof(tmp)) == 0)) {
+			new_ent[i] = old_ent;
+			continue;
+		}
+		root = blk_alloc(dp, POOL_NODES, 1);
+		if (root == POPTRIE_NIL) {
+			release(dp, &tmp, old_node);
+			ret = -ENOSPC;
+			goto err;
+		}
+		dp->nodes[root] = tmp;
+		new_ent[i] = ((uint64_t)root << 1) | POPTRIE_EXT_ENT;
+	}
+
+	for (i = 0; i < n; i++) {
+		old_ent = dp->dir[first + i];
+		ent = new_ent[i];
+		if (ent == old_ent)
+			continue;
+		__atomic_store_n(&dp->dir[first + i], ent, __ATOMIC_RELEASE);
+		if (is_entry_extended(old_ent)) {
+			release(dp, get_ent_node(dp, old_ent),
+				get_ent_node(dp, ent));
+			blk_free(dp, POOL_NODES, old_ent >> 1, 1);
+		}
+	}
+	goto out;
+
+err:
+	for (j = 0; j < i; j++) {
+		ent = new_ent[j];
+		if (is_entry_extended(ent) && (ent != dp->dir[first + j])) {
+			release(dp, get_ent_node(dp, ent),
+				get_ent_node(dp, dp->dir[first + j]));
+			blk_free(dp, POOL_NODES, ent >> 1, 1);
+		}
+	}
+out:
+	if (new_ent != &one_ent)
+		rte_free(new_ent);
+	return ret;
+}
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op)
+{
+	struct rte_poptrie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	uint8_t	ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t hi, lo, node_nh;
+	int ret;
+
+	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH) ||
+			(next_hop > POPTRIE_MAX_NH))
+		return -EINVAL;
+
+	dp = rte_fib6_get_dp(fib);
+	RTE_ASSERT(dp);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT(rib);
+
+	ip_to_addr(ip, &hi, &lo);
+	if (depth == 0)
+		hi = lo = 0;
+	else if (depth <= 64) {
+		hi &= UINT64_MAX << (64 - depth);
+		lo = 0;
+	} else
+		lo &= UINT64_MAX << (128 - depth);
+	addr_to_ip(hi, lo, ip_masked);
+
+	/*
+	 * The dataplane is rebuilt from the RIB, so the RIB is updated
+	 * first and the change is reverted if the dataplane runs out
+	 * of space.
+	 */
+	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			rte_rib6_set_nh(node, next_hop);
+			ret = modify_dp(dp, rib, hi, lo, depth);
+			if (ret != 0)
+				rte_rib6_set_nh(node, node_nh);
+			return ret;
+		}
+
+		node = rte_rib6_insert(rib, ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		ret = modify_dp(dp, rib, hi, lo, depth);
+		if (ret != 0)
+			rte_rib6_remove(rib, ip_masked, depth);
+		return ret;
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		rte_rib6_get_nh(node, &node_nh);
+		rte_rib6_remove(rib, ip_masked, depth);
+		ret = modify_dp(dp, rib, hi, lo, depth);
+		if (ret != 0) {
+			node = rte_rib6_insert(rib, ip_masked, depth);
+			if (node != NULL)
+				rte_rib6_set_nh(node, node_nh);
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+void *
+poptrie_create(const char *name, int socket_id,
+	struct rte_fib6_conf *conf)
+{
+	char mem_name[POPTRIE_NAMESIZE];
+	struct rte_poptrie_tbl *dp = NULL;
+	uint32_t i;
+
+	if ((name == NULL) || (conf == NULL) ||
+			(conf->poptrie.num_nodes == 0) ||
+			(conf->poptrie.num_nodes >= POPTRIE_NIL) ||
+			(conf->poptrie.num_leaves == 0) ||
+			(conf->poptrie.num_leaves >= POPTRIE_NIL) ||
+			(conf->default_nh > POPTRIE_MAX_NH)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	dp = rte_zmalloc_socket(name, sizeof(struct rte_poptrie_tbl) +
+		POPTRIE_DIR_NUM_ENT * sizeof(uint64_t), RTE_CACHE_LINE_SIZE,
+		socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return dp;
+	}
+
+	for (i = 0; i < POPTRIE_DIR_NUM_ENT; i++)
+		dp->dir[i] = conf->default_nh << 1;
+
+	snprintf(mem_name, sizeof(mem_name), "NODES_%p", dp);
+	dp->nodes = rte_zmalloc_socket(mem_name, sizeof(struct poptrie_node) *
+		conf->poptrie.num_nodes, RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->nodes == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp);
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "LEAVES_%p", dp);
+	dp->leaves = rte_zmalloc_socket(mem_name, sizeof(uint64_t) *
+		conf->poptrie.num_leaves, RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->leaves == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp->nodes);
+		rte_free(dp);
+		return NULL;
+	}
+
+	dp->def_nh = conf->default_nh;
+	dp->number_nodes = conf->poptrie.num_nodes;
+	dp->number_leaves = conf->poptrie.num_leaves;
+	for (i = 0; i < POPTRIE_NUM_ORDERS; i++) {
+		dp->nodes_free[i] = POPTRIE_NIL;
+		dp->leaves_free[i] = POPTRIE_NIL;
+	}
+
+	return dp;
+}
+
+void
+poptrie_free(void *p)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+
+	rte_free(dp->leaves);
+	rte_free(dp->nodes);
+	rte_free(dp);
+}
@@ -0,0 +1,142 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _POPTRIE_H_
+#define _POPTRIE_H_
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+
+/**
+ * @file
+ * Poptrie based IPv6 Longest Prefix Match (LPM)
+ *
+ * The first 16 bits of the address index a direct pointing table,
+ * the rest is looked up in a multibit trie with a stride of 6 bits.
+ * The children of a node are stored contiguously, internal nodes and
+ * leaves in separate arrays. A child is found with the population count
+ * of the node bitmaps below its index, so empty or repeated children
+ * take no memory.
+ */
+
+/* @internal Number of bits of the direct pointing table index. */
+#define POPTRIE_DIR_BITS	16
+/* @internal Total number of direct pointing table entries. */
+#define POPTRIE_DIR_NUM_ENT	(1 << POPTRIE_DIR_BITS)
+/* @internal Number of address bits consumed by a node. */
+#define POPTRIE_STRIDE		6
+/* @internal Number of children of a node. */
+#define POPTRIE_NODE_NUM_CHLD	(1 << POPTRIE_STRIDE)
+/* @internal Direct pointing entry holds a node index. */
+#define POPTRIE_EXT_ENT		1
+/* @internal Number of allocation size classes, 1 to 64 entries. */
+#define POPTRIE_NUM_ORDERS	(POPTRIE_STRIDE + 1)
+/* @internal Marks an empty allocation free list. */
+#define POPTRIE_NIL		UINT32_MAX
+/* Maximum next hop value. */
+#define POPTRIE_MAX_NH		((1ULL << 63) - 1)
+
+struct poptrie_node {
+	uint64_t	vector;		/**< Bit set for each child node */
+	uint64_t	leafvec;	/**< Bit set where a leaf run starts */
+	uint32_t	base0;		/**< Index of the first leaf */
+	uint32_t	base1;		/**< Index of the first child node */
+};
+
+struct rte_poptrie_tbl {
+	uint32_t	number_nodes;	/**< Total number of nodes */
+	uint32_t	number_leaves;	/**< Total number of leaves */
+	uint32_t	cur_nodes;	/**< Current number of nodes */
+	uint32_t	cur_leaves;	/**< Current number of leaves */
+	uint32_t	nodes_top;	/**< First never allocated node */
+	uint32_t	leaves_top;	/**< First never allocated leaf */
+	/** Free lists of node blocks, one per size class */
+	uint32_t	nodes_free[POPTRIE_NUM_ORDERS];
+	/** Free lists of leaf blocks, one per size class */
+	uint32_t	leaves_free[POPTRIE_NUM_ORDERS];
+	uint64_t	def_nh;		/**< Default next hop */
+	struct poptrie_node	*nodes;	/**< Node array */
+	uint64_t	*leaves;	/**< Leaf (next hop) array */
+	/* Direct pointing table. */
+	__extension__ uint64_t	dir[0] __rte_cache_aligned;
+};
+
+/*
+ * Get the 6 bits of the address at bit offset off, the address being
+ * stored as two host order 64-bit halves. The offsets used are
+ * 16 + 6 * n, so a chunk never crosses the halves; the last one goes
+ * beyond the address and is padded with zeroes.
+ */
+static inline uint32_t
+poptrie_get_chunk(uint64_t hi, uint64_t lo, uint32_t off)
+{
+	if (off < 64)
+		return (hi >> (64 - POPTRIE_STRIDE - off)) &
+			(POPTRIE_NODE_NUM_CHLD - 1);
+	if (off <= 128 - POPTRIE_STRIDE)
+		return (lo >> (128 - POPTRIE_STRIDE - off)) &
+			(POPTRIE_NODE_NUM_CHLD - 1);
+	return (lo << (off - (128 - POPTRIE_STRIDE))) &
+		(POPTRIE_NODE_NUM_CHLD - 1);
+}
+
+/* Mask of the bitmap bits up to and including bit idx. */
+static inline uint64_t
+poptrie_msk(uint32_t idx)
+{
+	return (2ULL << idx) - 1;
+}
+
+static inline uint64_t
+poptrie_lookup(const struct rte_poptrie_tbl *dp,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE])
+{
+	const struct poptrie_node *node;
+	uint64_t hi, lo, ent, msk;
+	uint32_t idx, off;
+
+	hi = rte_be_to_cpu_64(*(const unaligned_uint64_t *)&ip[0]);
+	lo = rte_be_to_cpu_64(*(const unaligned_uint64_t *)&ip[8]);
+
+	ent = dp->dir[hi >> (64 - POPTRIE_DIR_BITS)];
+	if ((ent & POPTRIE_EXT_ENT) == 0)
+		return ent >> 1;
+
+	node = &dp->nodes[ent >> 1];
+	for (off = POPTRIE_DIR_BITS; ; off += POPTRIE_STRIDE) {
+		idx = poptrie_get_chunk(hi, lo, off);
+		msk = poptrie_msk(idx);
+		if ((node->vector & (1ULL << idx)) == 0)
+			return dp->leaves[node->base0 +
+				__builtin_popcountll(node->leafvec & msk) - 1];
+		node = &dp->nodes[node->base1 +
+			__builtin_popcountll(node->vector & msk) - 1];
+	}
+}
+
+static inline void
+rte_poptrie_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		next_hops[i] = poptrie_lookup(dp, ips[i]);
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib6_conf *conf);
+
+void
+poptrie_free(void *p);
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type);
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op);
+
+#endif /* _POPTRIE_H_ */
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "poptrie.h"
+#include "poptrie_avx512.h"
+
+/* Convert eight byte chunks of the addresses to host order. */
+static __rte_always_inline __m512i
+bswap_x8(__m512i x)
+{
+	const __m512i lsb_bytes = _mm512_set1_epi64(0x00FF00FF00FF00FFULL);
+
+	x = _mm512_or_si512(
+		_mm512_and_si512(_mm512_srli_epi64(x, 8), lsb_bytes),
+		_mm512_slli_epi64(_mm512_and_si512(x, lsb_bytes), 8));
+	x = _mm512_ror_epi32(x, 16);
+	return _mm512_ror_epi64(x, 32);
+}
+
+static __rte_always_inline __m512i
+get_chunk_x8(__m512i hi, __m512i lo, uint32_t off)
+{
+	const __m512i chunk_msk = _mm512_set1_epi64(POPTRIE_NODE_NUM_CHLD - 1);
+	__m512i chunk;
+
+	if (off < 64)
+		chunk = _mm512_srl_epi64(hi,
+			_mm_cvtsi32_si128(64 - POPTRIE_STRIDE - off));
+	else if (off <= 128 - POPTRIE_STRIDE)
+		chunk = _mm512_srl_epi64(lo,
+			_mm_cvtsi32_si128(128 - POPTRIE_STRIDE - off));
+	else
+		chunk = _mm512_sll_epi64(lo,
+			_mm_cvtsi32_si128(off - (128 - POPTRIE_STRIDE)));
+	return _mm512_and_si512(chunk, chunk_msk);
+}
+
+static __rte_always_inline void
+poptrie_vec_lookup_x8(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi64(0);
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i two = _mm512_set1_epi64(2);
+	const __m512i base0_msk = _mm512_set1_epi64(UINT32_MAX);
+	/* every address starts 2 eight byte words after the previous one */
+	const __m512i ip_idxes = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+	const uint8_t *nodes = (const uint8_t *)dp->nodes;
+	__m512i hi, lo, ent, res, idxes, chunk, msk;
+	__m512i vector, leafvec, bases, tmp;
+	__mmask8 msk_ext, msk_int;
+	uint32_t off;
+
+	hi = bswap_x8(_mm512_i64gather_epi64(ip_idxes,
+		(const void *)&ips[0][0], 8));
+	lo = bswap_x8(_mm512_i64gather_epi64(ip_idxes,
+		(const void *)&ips[0][8], 8));
+
+	/* lookup in the direct pointing table */
+	idxes = _mm512_srli_epi64(hi, 64 - POPTRIE_DIR_BITS);
+	ent = _mm512_i64gather_epi64(idxes, (const void *)dp->dir, 8);
+	msk_ext = _mm512_test_epi64_mask(ent, one);
+	res = _mm512_srli_epi64(ent, 1);
+	idxes = res;
+
+	/* walk the nodes until every lane reaches a leaf */
+	for (off = POPTRIE_DIR_BITS; msk_ext != 0; off += POPTRIE_STRIDE) {
+		chunk = get_chunk_x8(hi, lo, off);
+		/* a node takes 3 eight byte words */
+		idxes = _mm512_add_epi64(idxes, _mm512_slli_epi64(idxes, 1));
+		vector = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)nodes, 8);
+		leafvec = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)(nodes + 8), 8);
+		bases = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)(nodes + 16), 8);
+
+		msk_int = _mm512_mask_test_epi64_mask(msk_ext, vector,
+			_mm512_sllv_epi64(one, chunk));
+		msk = _mm512_sub_epi64(_mm512_sllv_epi64(two, chunk), one);
+
+		/* leaves[base0 + popcnt(leafvec & msk) - 1] */
+		tmp = _mm512_popcnt_epi64(_mm512_and_si512(leafvec, msk));
+		tmp = _mm512_add_epi64(tmp, _mm512_and_si512(bases, base0_msk));
+		tmp = _mm512_sub_epi64(tmp, one);
+		res = _mm512_mask_i64gather_epi64(res, msk_ext & ~msk_int, tmp,
+			(const void *)dp->leaves, 8);
+
+		/* nodes[base1 + popcnt(vector & msk) - 1] */
+		idxes = _mm512_popcnt_epi64(_mm512_and_si512(vector, msk));
+		idxes = _mm512_add_epi64(idxes, _mm512_srli_epi64(bases, 32));
+		idxes = _mm512_sub_epi64(idxes, one);
+		msk_ext = msk_int;
+	}
+
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_poptrie_vec_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		poptrie_vec_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8);
+	}
+	rte_poptrie_lookup_bulk(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _POPTRIE_AVX512_H_
+#define _POPTRIE_AVX512_H_
+
+void
+rte_poptrie_vec_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n);
+
+#endif /* _POPTRIE_AVX512_H_ */
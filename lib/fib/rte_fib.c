@@ -134,6 +134,60 @@ rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 	return fib->modify(fib, ip, depth, 0, RTE_FIB_DEL);
 }
 
+/* Apply the routes one by one, for dataplanes without bulk update. */
+static int
+modify_bulk(struct rte_fib *fib, const uint32_t *ips, const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n, int op)
+{
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < n; i++) {
+		ret = fib->modify(fib, ips[i], depths[i],
+			(next_hops != NULL) ? next_hops[i] : 0, op);
+		if (ret != 0) {
+			rte_errno = -ret;
+			break;
+		}
+	}
+	return i;
+}
+
+int
+rte_fib_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL) || (next_hops == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_modify_bulk(fib, ips, depths, next_hops, n,
+			RTE_FIB_ADD);
+	default:
+		return modify_bulk(fib, ips, depths, next_hops, n,
+			RTE_FIB_ADD);
+	}
+}
+
+int
+rte_fib_delete_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_modify_bulk(fib, ips, depths, NULL, n,
+			RTE_FIB_DEL);
+	default:
+		return modify_bulk(fib, ips, depths, NULL, n, RTE_FIB_DEL);
+	}
+}
+
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	uint64_t *next_hops, int n)
@@ -335,3 +389,17 @@ rte_fib_select_lookup(struct rte_fib *fib,
 		return -EINVAL;
 	}
 }
+
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg)
+{
+	if ((fib == NULL) || (cfg == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	default:
+		return -ENOTSUP;
+	}
+}
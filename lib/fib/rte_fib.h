@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +30,9 @@ struct rte_rib;
 /** Maximum depth value possible for IPv4 FIB. */
 #define RTE_FIB_MAXDEPTH	32
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
+
 /** Type of FIB struct */
 enum rte_fib_type {
 	RTE_FIB_DUMMY,		/**< RIB tree based FIB */
@@ -73,6 +78,14 @@ enum rte_fib_lookup_type {
 	/**< Vector implementation using AVX512 */
 };
 
+/** RCU reclamation modes */
+enum rte_fib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB_QSBR_MODE_SYNC
+};
+
 /** FIB configuration structure */
 struct rte_fib_conf {
 	enum rte_fib_type type; /**< Type of FIB struct */
@@ -89,6 +102,22 @@ struct rte_fib_conf {
 	};
 };
 
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8s.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Create FIB
  *
@@ -160,6 +189,73 @@ rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth, uint64_t next_hop);
 int
 rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple routes to the FIB.
+ * All the routes are first applied to the RIB, then the dataplane is
+ * updated in one pass over the changed prefixes: every address range is
+ * rewritten at most once, directly to its final next hop, instead of once
+ * per added route. Routes are applied in order, an existing route gets
+ * its next hop replaced. The batch as a whole is not atomic for readers.
+ *
+ * tbl8 groups released by routes deleted in the same batch can only be
+ * reused by the following batches.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPv4 prefix addresses to be added to the FIB
+ * @param depths
+ *   Array of prefix lengths
+ * @param next_hops
+ *   Array of next hops to be added to the FIB
+ * @param n
+ *   Number of routes in the arrays
+ * @return
+ *   Number of routes added. If it is less than n, processing stopped at
+ *   the route that could not be added and rte_errno is set to:
+ *   - EINVAL - invalid depth or next hop
+ *   - ENOSPC - no space left for the route
+ *   - ENOMEM - RIB node allocation failure
+ *   Negative value if the parameters are invalid or the dataplane
+ *   could not be updated.
+ */
+__rte_experimental
+int
+rte_fib_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete multiple routes from the FIB.
+ * The dataplane is updated in one pass after all the routes are removed
+ * from the RIB, see rte_fib_add_bulk().
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPv4 prefix addresses to be deleted from the FIB
+ * @param depths
+ *   Array of prefix lengths
+ * @param n
+ *   Number of routes in the arrays
+ * @return
+ *   Number of routes deleted. If it is less than n, processing stopped at
+ *   the route that could not be deleted and rte_errno is set to:
+ *   - EINVAL - invalid depth
+ *   - ENOENT - route does not exist
+ *   Negative value if the parameters are invalid or the dataplane
+ *   could not be updated.
+ */
+__rte_experimental
+int
+rte_fib_delete_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
@@ -219,6 +315,30 @@ rte_fib_get_rib(struct rte_fib *fib);
 int
 rte_fib_select_lookup(struct rte_fib *fib, enum rte_fib_lookup_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a FIB object.
+ * Once added, the tbl8 groups released by route updates are reused only
+ * after the lookup threads reporting to the QSBR variable have passed
+ * a quiescent state.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL - invalid pointer or mode
+ *   -EEXIST - already added QSBR
+ *   -ENOMEM - memory allocation failure
+ *   -ENOTSUP - FIB type does not use tbl8 groups
+ */
+__rte_experimental
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
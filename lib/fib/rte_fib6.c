@@ -17,6 +17,7 @@
 #include <rte_fib6.h>
 
 #include "trie.h"
+#include "poptrie.h"
 
 TAILQ_HEAD(rte_fib6_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_fib6_tailq = {
@@ -109,6 +110,14 @@ init_dataplane(struct rte_fib6 *fib, __rte_unused int socket_id,
 		fib->lookup = trie_get_lookup_fn(fib->dp, RTE_FIB6_LOOKUP_DEFAULT);
 		fib->modify = trie_modify;
 		return 0;
+	case RTE_FIB6_POPTRIE:
+		fib->dp = poptrie_create(dp_name, socket_id, conf);
+		if (fib->dp == NULL)
+			return -rte_errno;
+		fib->lookup = poptrie_get_lookup_fn(fib->dp,
+			RTE_FIB6_LOOKUP_DEFAULT);
+		fib->modify = poptrie_modify;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -135,6 +144,51 @@ rte_fib6_delete(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	return fib->modify(fib, ip, depth, 0, RTE_FIB6_DEL);
 }
 
+static int
+modify_bulk(struct rte_fib6 *fib, const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n,
+	int op)
+{
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < n; i++) {
+		if (depths[i] > RTE_FIB6_MAXDEPTH) {
+			rte_errno = EINVAL;
+			break;
+		}
+		ret = fib->modify(fib, ips[i], depths[i],
+			(next_hops != NULL) ? next_hops[i] : 0, op);
+		if (ret != 0) {
+			rte_errno = -ret;
+			break;
+		}
+	}
+	return i;
+}
+
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL) || (next_hops == NULL))
+		return -EINVAL;
+	return modify_bulk(fib, ips, depths, next_hops, n, RTE_FIB6_ADD);
+}
+
+int
+rte_fib6_delete_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL))
+		return -EINVAL;
+	return modify_bulk(fib, ips, depths, NULL, n, RTE_FIB6_DEL);
+}
+
 int
 rte_fib6_lookup_bulk(struct rte_fib6 *fib,
 	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
@@ -159,7 +213,7 @@ rte_fib6_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) || (conf->max_routes < 0) ||
-			(conf->type > RTE_FIB6_TRIE)) {
+			(conf->type > RTE_FIB6_POPTRIE)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -273,6 +327,10 @@ free_dataplane(struct rte_fib6 *fib)
 		return;
 	case RTE_FIB6_TRIE:
 		trie_free(fib->dp);
+		return;
+	case RTE_FIB6_POPTRIE:
+		poptrie_free(fib->dp);
+		return;
 	default:
 		return;
 	}
@@ -332,6 +390,12 @@ rte_fib6_select_lookup(struct rte_fib6 *fib,
 			return -EINVAL;
 		fib->lookup = fn;
 		return 0;
+	case RTE_FIB6_POPTRIE:
+		fn = poptrie_get_lookup_fn(fib->dp, type);
+		if (fn == NULL)
+			return -EINVAL;
+		fib->lookup = fn;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,7 +34,8 @@ struct rte_rib6;
 /** Type of FIB struct */
 enum rte_fib6_type {
 	RTE_FIB6_DUMMY,		/**< RIB6 tree based FIB */
-	RTE_FIB6_TRIE		/**< TRIE based fib  */
+	RTE_FIB6_TRIE,		/**< TRIE based fib  */
+	RTE_FIB6_POPTRIE	/**< Poptrie based fib */
 };
 
 /** Modify FIB function */
@@ -61,7 +64,11 @@ enum rte_fib6_lookup_type {
 	RTE_FIB6_LOOKUP_DEFAULT,
 	/**< Selects the best implementation based on the max simd bitwidth */
 	RTE_FIB6_LOOKUP_TRIE_SCALAR, /**< Scalar lookup function implementation*/
-	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512 /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512, /**< Vector implementation using AVX512 */
+	/** Scalar lookup function implementation for POPTRIE */
+	RTE_FIB6_LOOKUP_POPTRIE_SCALAR,
+	/** Vector implementation for POPTRIE using AVX512 VPOPCNTDQ */
+	RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512
 };
 
 /** FIB configuration structure */
@@ -77,6 +84,12 @@ struct rte_fib6_conf {
 			enum rte_fib_trie_nh_sz nh_sz;
 			uint32_t	num_tbl8;
 		} trie;
+		struct {
+			/** Number of internal nodes, 24 bytes each */
+			uint32_t	num_nodes;
+			/** Number of leaves, 8 bytes each */
+			uint32_t	num_leaves;
+		} poptrie;
 	};
 };
 
@@ -153,6 +166,62 @@ int
 rte_fib6_delete(struct rte_fib6 *fib,
 	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple routes to the FIB.
+ * Routes are applied in order, an existing route gets its next hop
+ * replaced. The batch as a whole is not atomic for readers.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPv6 prefix addresses to be added to the FIB
+ * @param depths
+ *   Array of prefix lengths
+ * @param next_hops
+ *   Array of next hops to be added to the FIB
+ * @param n
+ *   Number of routes in the arrays
+ * @return
+ *   Number of routes added. If it is less than n, processing stopped at
+ *   the route that could not be added and rte_errno is set to the reason,
+ *   as returned by rte_fib6_add().
+ *   -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete multiple routes from the FIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPv6 prefix addresses to be deleted from the FIB
+ * @param depths
+ *   Array of prefix lengths
+ * @param n
+ *   Number of routes in the arrays
+ * @return
+ *   Number of routes deleted. If it is less than n, processing stopped at
+ *   the route that could not be deleted and rte_errno is set to the
+ *   reason, as returned by rte_fib6_delete().
+ *   -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_fib6_delete_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
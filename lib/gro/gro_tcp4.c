@@ -15,7 +15,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 {
 	struct gro_tcp4_tbl *tbl;
 	size_t size;
-	uint32_t entries_num, i;
+	uint32_t entries_num;
 
 	entries_num = max_flow_num * max_item_per_flow;
 	entries_num = RTE_MIN(entries_num, GRO_TCP4_TBL_MAX_ITEM_NUM);
@@ -30,7 +30,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 	if (tbl == NULL)
 		return NULL;
 
-	size = sizeof(struct gro_tcp4_item) * entries_num;
+	size = sizeof(struct gro_tcp_item) * entries_num;
 	tbl->items = rte_zmalloc_socket(__func__,
 			size,
 			RTE_CACHE_LINE_SIZE,
@@ -51,14 +51,45 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
-	/* INVALID_ARRAY_INDEX indicates an empty flow */
-	for (i = 0; i < entries_num; i++)
-		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	size = sizeof(uint32_t) * rte_align32pow2(entries_num);
+	tbl->flow_hash = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_hash == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	gro_tcp4_tbl_init(tbl);
+
 	return tbl;
 }
 
+void
+gro_tcp4_tbl_init(struct gro_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/* An empty table still needs one bucket to look flows up. */
+	tbl->hash_mask = rte_align32pow2(RTE_MAX(tbl->max_flow_num, 1U)) - 1;
+	for (i = 0; i <= tbl->hash_mask; i++)
+		tbl->flow_hash[i] = INVALID_ARRAY_INDEX;
+	tbl->item_num = 0;
+	tbl->flow_num = 0;
+	/*
+	 * The free lists are empty, items and flows are taken from
+	 * the never used part of the arrays until it is exhausted.
+	 */
+	tbl->free_item = INVALID_ARRAY_INDEX;
+	tbl->free_flow = INVALID_ARRAY_INDEX;
+	tbl->item_top = 0;
+	tbl->flow_top = 0;
+}
+
 void
 gro_tcp4_tbl_destroy(void *tbl)
 {
@@ -67,6 +98,7 @@ gro_tcp4_tbl_destroy(void *tbl)
 	if (tcp_tbl) {
 		rte_free(tcp_tbl->items);
 		rte_free(tcp_tbl->flows);
+		rte_free(tcp_tbl->flow_hash);
 	}
 	rte_free(tcp_tbl);
 }
@@ -74,24 +106,43 @@ gro_tcp4_tbl_destroy(void *tbl)
 static inline uint32_t
 find_an_empty_item(struct gro_tcp4_tbl *tbl)
 {
-	uint32_t i;
-	uint32_t max_item_num = tbl->max_item_num;
+	uint32_t item_idx = tbl->free_item;
 
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].firstseg == NULL)
-			return i;
+	if (item_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_item = tbl->items[item_idx].next_pkt_idx;
+		return item_idx;
+	}
+	if (tbl->item_top < tbl->max_item_num)
+		return tbl->item_top++;
 	return INVALID_ARRAY_INDEX;
 }
 
 static inline uint32_t
 find_an_empty_flow(struct gro_tcp4_tbl *tbl)
 {
-	uint32_t i;
-	uint32_t max_flow_num = tbl->max_flow_num;
+	uint32_t flow_idx = tbl->free_flow;
 
-	for (i = 0; i < max_flow_num; i++)
-		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
-			return i;
+	if (flow_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_flow = tbl->flows[flow_idx].next_index;
+		return flow_idx;
+	}
+	if (tbl->flow_top < tbl->max_flow_num)
+		return tbl->flow_top++;
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+find_a_flow(struct gro_tcp4_tbl *tbl,
+		struct tcp4_flow_key *key,
+		uint32_t hash)
+{
+	uint32_t flow_idx = tbl->flow_hash[hash & tbl->hash_mask];
+
+	while (flow_idx != INVALID_ARRAY_INDEX) {
+		if (is_same_tcp4_flow(tbl->flows[flow_idx].key, *key))
+			return flow_idx;
+		flow_idx = tbl->flows[flow_idx].next_index;
+	}
 	return INVALID_ARRAY_INDEX;
 }
 
@@ -138,16 +189,25 @@ delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
 
 	/* NULL indicates an empty item */
 	tbl->items[item_idx].firstseg = NULL;
+	tbl->items[item_idx].next_pkt_idx = tbl->free_item;
+	tbl->free_item = item_idx;
 	tbl->item_num--;
 	if (prev_item_idx != INVALID_ARRAY_INDEX)
 		tbl->items[prev_item_idx].next_pkt_idx = next_idx;
 
+	/* All items are free, start again from the array beginning. */
+	if (tbl->item_num == 0) {
+		tbl->free_item = INVALID_ARRAY_INDEX;
+		tbl->item_top = 0;
+	}
+
 	return next_idx;
 }
 
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
+		uint32_t hash,
 		uint32_t item_idx)
 {
 	struct tcp4_flow_key *dst;
@@ -168,16 +228,43 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 	dst->dst_port = src->dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].next_index = tbl->flow_hash[hash & tbl->hash_mask];
+	tbl->flow_hash[hash & tbl->hash_mask] = flow_idx;
 	tbl->flow_num++;
 
 	return flow_idx;
 }
 
+static inline void
+delete_flow(struct gro_tcp4_tbl *tbl, uint32_t flow_idx)
+{
+	struct gro_tcp4_flow *flow = &tbl->flows[flow_idx];
+	uint32_t *prev;
+
+	/* Unlink the flow from its hash bucket. */
+	prev = &tbl->flow_hash[tcp4_flow_hash(&flow->key) & tbl->hash_mask];
+	while (*prev != flow_idx)
+		prev = &tbl->flows[*prev].next_index;
+	*prev = flow->next_index;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow */
+	flow->start_index = INVALID_ARRAY_INDEX;
+	flow->next_index = tbl->free_flow;
+	tbl->free_flow = flow_idx;
+	tbl->flow_num--;
+
+	/* All flows are free, start again from the array beginning. */
+	if (tbl->flow_num == 0) {
+		tbl->free_flow = INVALID_ARRAY_INDEX;
+		tbl->flow_top = 0;
+	}
+}
+
 /*
  * update the packet length for the flushed packet.
  */
 static inline void
-update_header(struct gro_tcp4_item *item)
+update_header(struct gro_tcp_item *item)
 {
 	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_mbuf *pkt = item->firstseg;
@@ -202,10 +289,9 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	uint8_t is_atomic;
 
 	struct tcp4_flow_key key;
-	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t cur_idx, prev_idx, item_idx, flow_idx;
+	uint32_t hash;
 	int cmp;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -257,30 +343,20 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.recv_ack = tcp_hdr->recv_ack;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	hash = tcp4_flow_hash(&key);
+	flow_idx = find_a_flow(tbl, &key, hash);
 
 	/*
 	 * Fail to find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (flow_idx == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, ip_id,
 				is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -296,14 +372,14 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	 * Check all packets in the flow and try to find a neighbor for
 	 * the input packet.
 	 */
-	cur_idx = tbl->flows[i].start_index;
+	cur_idx = tbl->flows[flow_idx].start_index;
 	prev_idx = cur_idx;
 	do {
 		cmp = check_seq_option(&(tbl->items[cur_idx]), tcp_hdr,
 				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
 				is_atomic);
 		if (cmp) {
-			if (merge_two_tcp4_packets(&(tbl->items[cur_idx]),
+			if (merge_two_tcp_packets(&(tbl->items[cur_idx]),
 						pkt, cmp, sent_seq, ip_id, 0))
 				return 1;
 			/*
@@ -337,9 +413,9 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 {
 	uint16_t k = 0;
 	uint32_t i, j;
-	uint32_t max_flow_num = tbl->max_flow_num;
 
-	for (i = 0; i < max_flow_num; i++) {
+	/* Flows from flow_top on have never been used. */
+	for (i = 0; i < tbl->flow_top; i++) {
 		if (unlikely(tbl->flow_num == 0))
 			return k;
 
@@ -356,7 +432,7 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
-					tbl->flow_num--;
+					delete_flow(tbl, i);
 
 				if (unlikely(k == nb_out))
 					return k;
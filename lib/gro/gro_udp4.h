@@ -6,6 +6,7 @@
 #define _GRO_UDP4_H_
 
 #include <rte_ip.h>
+#include <rte_jhash.h>
 
 #define INVALID_ARRAY_INDEX 0xffffffffUL
 #define GRO_UDP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
@@ -36,6 +37,11 @@ struct gro_udp4_flow {
 	 * INVALID_ARRAY_INDEX indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket,
+	 * or in the free flow list if the flow is empty.
+	 */
+	uint32_t next_index;
 };
 
 struct gro_udp4_item {
@@ -55,7 +61,8 @@ struct gro_udp4_item {
 	/*
 	 * next_pkt_idx is used to chain the packets that
 	 * are in the same flow but can't be merged together
-	 * (e.g. caused by packet reordering).
+	 * (e.g. caused by packet reordering). It also chains
+	 * the empty items in the free item list.
 	 */
 	uint32_t next_pkt_idx;
 	/* offset of IP fragment packet */
@@ -82,6 +89,18 @@ struct gro_udp4_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/* hash buckets, each one keeps the index of its first flow */
+	uint32_t *flow_hash;
+	/* hash bucket number minus one */
+	uint32_t hash_mask;
+	/* head of the free item list */
+	uint32_t free_item;
+	/* head of the free flow list */
+	uint32_t free_flow;
+	/* items from this index on have never been used */
+	uint32_t item_top;
+	/* flows from this index on have never been used */
+	uint32_t flow_top;
 };
 
 /**
@@ -102,6 +121,18 @@ void *gro_udp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function initializes the flow hash index and the free lists
+ * of a UDP/IPv4 reassembly table and empties it. The items, flows
+ * and flow_hash arrays and the maximum item and flow numbers must be
+ * set before. The flow_hash array must have at least
+ * rte_align32pow2(max_flow_num) entries, and one at least.
+ *
+ * @param tbl
+ *  Pointer pointing to the UDP/IPv4 reassembly table.
+ */
+void gro_udp4_tbl_init(struct gro_udp4_tbl *tbl);
+
 /**
  * This function destroys a UDP/IPv4 reassembly table.
  *
@@ -183,6 +214,17 @@ is_same_udp4_flow(struct udp4_flow_key k1, struct udp4_flow_key k2)
 			(k1.ip_id == k2.ip_id));
 }
 
+/*
+ * Calculate the hash of a UDP/IPv4 flow. The MAC addresses are
+ * left out, they rarely tell apart the flows of a table.
+ */
+static inline uint32_t
+udp4_flow_hash(const struct udp4_flow_key *k)
+{
+	return rte_jhash_3words(k->ip_src_addr, k->ip_dst_addr,
+			k->ip_id, 0);
+}
+
 /*
  * Merge two UDP/IPv4 packets without updating checksums.
  * If cmp is larger than 0, append the new packet to the
@@ -16,7 +16,7 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 {
 	struct gro_vxlan_tcp4_tbl *tbl;
 	size_t size;
-	uint32_t entries_num, i;
+	uint32_t entries_num;
 
 	entries_num = max_flow_num * max_item_per_flow;
 	entries_num = RTE_MIN(entries_num, GRO_VXLAN_TCP4_TBL_MAX_ITEM_NUM);
@@ -52,14 +52,45 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
-
-	for (i = 0; i < entries_num; i++)
-		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	size = sizeof(uint32_t) * rte_align32pow2(entries_num);
+	tbl->flow_hash = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_hash == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	gro_vxlan_tcp4_tbl_init(tbl);
+
 	return tbl;
 }
 
+void
+gro_vxlan_tcp4_tbl_init(struct gro_vxlan_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/* An empty table still needs one bucket to look flows up. */
+	tbl->hash_mask = rte_align32pow2(RTE_MAX(tbl->max_flow_num, 1U)) - 1;
+	for (i = 0; i <= tbl->hash_mask; i++)
+		tbl->flow_hash[i] = INVALID_ARRAY_INDEX;
+	tbl->item_num = 0;
+	tbl->flow_num = 0;
+	/*
+	 * The free lists are empty, items and flows are taken from
+	 * the never used part of the arrays until it is exhausted.
+	 */
+	tbl->free_item = INVALID_ARRAY_INDEX;
+	tbl->free_flow = INVALID_ARRAY_INDEX;
+	tbl->item_top = 0;
+	tbl->flow_top = 0;
+}
+
 void
 gro_vxlan_tcp4_tbl_destroy(void *tbl)
 {
@@ -68,6 +99,7 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->flow_hash);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -75,22 +107,28 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 static inline uint32_t
 find_an_empty_item(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_item_num = tbl->max_item_num, i;
+	uint32_t item_idx = tbl->free_item;
 
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].inner_item.firstseg == NULL)
-			return i;
+	if (item_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_item = tbl->items[item_idx].inner_item.next_pkt_idx;
+		return item_idx;
+	}
+	if (tbl->item_top < tbl->max_item_num)
+		return tbl->item_top++;
 	return INVALID_ARRAY_INDEX;
 }
 
 static inline uint32_t
 find_an_empty_flow(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_flow_num = tbl->max_flow_num, i;
+	uint32_t flow_idx = tbl->free_flow;
 
-	for (i = 0; i < max_flow_num; i++)
-		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
-			return i;
+	if (flow_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_flow = tbl->flows[flow_idx].next_index;
+		return flow_idx;
+	}
+	if (tbl->flow_top < tbl->max_flow_num)
+		return tbl->flow_top++;
 	return INVALID_ARRAY_INDEX;
 }
 
@@ -142,16 +180,25 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 
 	/* NULL indicates an empty item. */
 	tbl->items[item_idx].inner_item.firstseg = NULL;
+	tbl->items[item_idx].inner_item.next_pkt_idx = tbl->free_item;
+	tbl->free_item = item_idx;
 	tbl->item_num--;
 	if (prev_item_idx != INVALID_ARRAY_INDEX)
 		tbl->items[prev_item_idx].inner_item.next_pkt_idx = next_idx;
 
+	/* All items are free, start again from the array beginning. */
+	if (tbl->item_num == 0) {
+		tbl->free_item = INVALID_ARRAY_INDEX;
+		tbl->item_top = 0;
+	}
+
 	return next_idx;
 }
 
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 		struct vxlan_tcp4_flow_key *src,
+		uint32_t hash,
 		uint32_t item_idx)
 {
 	struct vxlan_tcp4_flow_key *dst;
@@ -183,6 +230,8 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 	dst->outer_dst_port = src->outer_dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].next_index = tbl->flow_hash[hash & tbl->hash_mask];
+	tbl->flow_hash[hash & tbl->hash_mask] = flow_idx;
 	tbl->flow_num++;
 
 	return flow_idx;
@@ -205,6 +254,58 @@ is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 			is_same_tcp4_flow(k1.inner_key, k2.inner_key));
 }
 
+/*
+ * Calculate the hash of a VxLAN flow. The outer MAC addresses and UDP
+ * ports are left out, they rarely tell apart the flows of a table.
+ */
+static inline uint32_t
+vxlan_tcp4_flow_hash(const struct vxlan_tcp4_flow_key *k)
+{
+	return rte_jhash_3words(k->outer_ip_src_addr, k->outer_ip_dst_addr,
+			k->vxlan_hdr.vx_vni, tcp4_flow_hash(&k->inner_key));
+}
+
+static inline uint32_t
+find_a_flow(struct gro_vxlan_tcp4_tbl *tbl,
+		struct vxlan_tcp4_flow_key *key,
+		uint32_t hash)
+{
+	uint32_t flow_idx = tbl->flow_hash[hash & tbl->hash_mask];
+
+	while (flow_idx != INVALID_ARRAY_INDEX) {
+		if (is_same_vxlan_tcp4_flow(tbl->flows[flow_idx].key, *key))
+			return flow_idx;
+		flow_idx = tbl->flows[flow_idx].next_index;
+	}
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline void
+delete_flow(struct gro_vxlan_tcp4_tbl *tbl, uint32_t flow_idx)
+{
+	struct gro_vxlan_tcp4_flow *flow = &tbl->flows[flow_idx];
+	uint32_t *prev;
+
+	/* Unlink the flow from its hash bucket. */
+	prev = &tbl->flow_hash[vxlan_tcp4_flow_hash(&flow->key) &
+		tbl->hash_mask];
+	while (*prev != flow_idx)
+		prev = &tbl->flows[*prev].next_index;
+	*prev = flow->next_index;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow. */
+	flow->start_index = INVALID_ARRAY_INDEX;
+	flow->next_index = tbl->free_flow;
+	tbl->free_flow = flow_idx;
+	tbl->flow_num--;
+
+	/* All flows are free, start again from the array beginning. */
+	if (tbl->flow_num == 0) {
+		tbl->free_flow = INVALID_ARRAY_INDEX;
+		tbl->flow_top = 0;
+	}
+}
+
 static inline int
 check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 		struct rte_tcp_hdr *tcp_hdr,
@@ -248,7 +349,7 @@ merge_two_vxlan_tcp4_packets(struct gro_vxlan_tcp4_item *item,
 		uint16_t outer_ip_id,
 		uint16_t ip_id)
 {
-	if (merge_two_tcp4_packets(&item->inner_item, pkt, cmp, sent_seq,
+	if (merge_two_tcp_packets(&item->inner_item, pkt, cmp, sent_seq,
 				ip_id, pkt->outer_l2_len +
 				pkt->outer_l3_len)) {
 		/* Update the outer IPv4 ID to the large value. */
@@ -300,11 +401,10 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	uint8_t outer_is_atomic, is_atomic;
 
 	struct vxlan_tcp4_flow_key key;
-	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t cur_idx, prev_idx, item_idx, flow_idx;
+	uint32_t hash;
 	int cmp;
 	uint16_t hdr_len;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -375,30 +475,20 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.outer_dst_port = udp_hdr->dst_port;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	hash = vxlan_tcp4_flow_hash(&key);
+	flow_idx = find_a_flow(tbl, &key, hash);
 
 	/*
 	 * Can't find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (flow_idx == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, outer_ip_id,
 				ip_id, outer_is_atomic, is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -411,7 +501,7 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	}
 
 	/* Check all packets in the flow and try to find a neighbor. */
-	cur_idx = tbl->flows[i].start_index;
+	cur_idx = tbl->flows[flow_idx].start_index;
 	prev_idx = cur_idx;
 	do {
 		cmp = check_vxlan_seq_option(&(tbl->items[cur_idx]), tcp_hdr,
@@ -456,9 +546,9 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 {
 	uint16_t k = 0;
 	uint32_t i, j;
-	uint32_t max_flow_num = tbl->max_flow_num;
 
-	for (i = 0; i < max_flow_num; i++) {
+	/* Flows from flow_top on have never been used. */
+	for (i = 0; i < tbl->flow_top; i++) {
 		if (unlikely(tbl->flow_num == 0))
 			return k;
 
@@ -476,7 +566,7 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
-					tbl->flow_num--;
+					delete_flow(tbl, i);
 
 				if (unlikely(k == nb_out))
 					return k;
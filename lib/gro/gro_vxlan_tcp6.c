@@ -0,0 +1,548 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+#include <rte_udp.h>
+
+#include "gro_vxlan_tcp6.h"
+
+void *
+gro_vxlan_tcp6_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow)
+{
+	struct gro_vxlan_tcp6_tbl *tbl;
+	size_t size;
+	uint32_t entries_num;
+
+	entries_num = max_flow_num * max_item_per_flow;
+	entries_num = RTE_MIN(entries_num, GRO_VXLAN_TCP6_TBL_MAX_ITEM_NUM);
+
+	if (entries_num == 0)
+		return NULL;
+
+	tbl = rte_zmalloc_socket(__func__,
+			sizeof(struct gro_vxlan_tcp6_tbl),
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl == NULL)
+		return NULL;
+
+	size = sizeof(struct gro_tcp_item) * entries_num;
+	tbl->items = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->items == NULL) {
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->max_item_num = entries_num;
+
+	size = sizeof(struct gro_vxlan_tcp6_flow) * entries_num;
+	tbl->flows = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flows == NULL) {
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->max_flow_num = entries_num;
+
+	size = sizeof(uint32_t) * rte_align32pow2(entries_num);
+	tbl->flow_hash = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_hash == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	gro_vxlan_tcp6_tbl_init(tbl);
+
+	return tbl;
+}
+
+void
+gro_vxlan_tcp6_tbl_init(struct gro_vxlan_tcp6_tbl *tbl)
+{
+	uint32_t i;
+
+	/* An empty table still needs one bucket to look flows up. */
+	tbl->hash_mask = rte_align32pow2(RTE_MAX(tbl->max_flow_num, 1U)) - 1;
+	for (i = 0; i <= tbl->hash_mask; i++)
+		tbl->flow_hash[i] = INVALID_ARRAY_INDEX;
+	tbl->item_num = 0;
+	tbl->flow_num = 0;
+	/*
+	 * The free lists are empty, items and flows are taken from
+	 * the never used part of the arrays until it is exhausted.
+	 */
+	tbl->free_item = INVALID_ARRAY_INDEX;
+	tbl->free_flow = INVALID_ARRAY_INDEX;
+	tbl->item_top = 0;
+	tbl->flow_top = 0;
+}
+
+void
+gro_vxlan_tcp6_tbl_destroy(void *tbl)
+{
+	struct gro_vxlan_tcp6_tbl *vxlan_tbl = tbl;
+
+	if (vxlan_tbl) {
+		rte_free(vxlan_tbl->items);
+		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->flow_hash);
+	}
+	rte_free(vxlan_tbl);
+}
+
+static inline uint32_t
+find_an_empty_item(struct gro_vxlan_tcp6_tbl *tbl)
+{
+	uint32_t item_idx = tbl->free_item;
+
+	if (item_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_item = tbl->items[item_idx].next_pkt_idx;
+		return item_idx;
+	}
+	if (tbl->item_top < tbl->max_item_num)
+		return tbl->item_top++;
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+find_an_empty_flow(struct gro_vxlan_tcp6_tbl *tbl)
+{
+	uint32_t flow_idx = tbl->free_flow;
+
+	if (flow_idx != INVALID_ARRAY_INDEX) {
+		tbl->free_flow = tbl->flows[flow_idx].next_index;
+		return flow_idx;
+	}
+	if (tbl->flow_top < tbl->max_flow_num)
+		return tbl->flow_top++;
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline uint32_t
+insert_new_item(struct gro_vxlan_tcp6_tbl *tbl,
+		struct rte_mbuf *pkt,
+		uint64_t start_time,
+		uint32_t prev_idx,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint8_t is_atomic)
+{
+	uint32_t item_idx;
+
+	item_idx = find_an_empty_item(tbl);
+	if (unlikely(item_idx == INVALID_ARRAY_INDEX))
+		return INVALID_ARRAY_INDEX;
+
+	tbl->items[item_idx].firstseg = pkt;
+	tbl->items[item_idx].lastseg = rte_pktmbuf_lastseg(pkt);
+	tbl->items[item_idx].start_time = start_time;
+	tbl->items[item_idx].next_pkt_idx = INVALID_ARRAY_INDEX;
+	tbl->items[item_idx].sent_seq = sent_seq;
+	tbl->items[item_idx].ip_id = ip_id;
+	tbl->items[item_idx].nb_merged = 1;
+	tbl->items[item_idx].is_atomic = is_atomic;
+	tbl->item_num++;
+
+	/* If the previous packet exists, chain the new one with it. */
+	if (prev_idx != INVALID_ARRAY_INDEX) {
+		tbl->items[item_idx].next_pkt_idx =
+			tbl->items[prev_idx].next_pkt_idx;
+		tbl->items[prev_idx].next_pkt_idx = item_idx;
+	}
+
+	return item_idx;
+}
+
+static inline uint32_t
+delete_item(struct gro_vxlan_tcp6_tbl *tbl,
+		uint32_t item_idx,
+		uint32_t prev_item_idx)
+{
+	uint32_t next_idx = tbl->items[item_idx].next_pkt_idx;
+
+	/* NULL indicates an empty item. */
+	tbl->items[item_idx].firstseg = NULL;
+	tbl->items[item_idx].next_pkt_idx = tbl->free_item;
+	tbl->free_item = item_idx;
+	tbl->item_num--;
+	if (prev_item_idx != INVALID_ARRAY_INDEX)
+		tbl->items[prev_item_idx].next_pkt_idx = next_idx;
+
+	/* All items are free, start again from the array beginning. */
+	if (tbl->item_num == 0) {
+		tbl->free_item = INVALID_ARRAY_INDEX;
+		tbl->item_top = 0;
+	}
+
+	return next_idx;
+}
+
+static inline uint32_t
+insert_new_flow(struct gro_vxlan_tcp6_tbl *tbl,
+		struct vxlan_tcp6_flow_key *src,
+		uint32_t hash,
+		uint32_t item_idx)
+{
+	uint32_t flow_idx;
+
+	flow_idx = find_an_empty_flow(tbl);
+	if (unlikely(flow_idx == INVALID_ARRAY_INDEX))
+		return INVALID_ARRAY_INDEX;
+
+	tbl->flows[flow_idx].key = *src;
+	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].next_index = tbl->flow_hash[hash & tbl->hash_mask];
+	tbl->flow_hash[hash & tbl->hash_mask] = flow_idx;
+	tbl->flow_num++;
+
+	return flow_idx;
+}
+
+static inline int
+is_same_vxlan_tcp6_flow(const struct vxlan_tcp6_flow_key *k1,
+		const struct vxlan_tcp6_flow_key *k2)
+{
+	return (rte_is_same_ether_addr(&k1->outer_eth_saddr,
+					&k2->outer_eth_saddr) &&
+			rte_is_same_ether_addr(&k1->outer_eth_daddr,
+				&k2->outer_eth_daddr) &&
+			(memcmp(k1->outer_src_addr, k2->outer_src_addr,
+				16) == 0) &&
+			(memcmp(k1->outer_dst_addr, k2->outer_dst_addr,
+				16) == 0) &&
+			(k1->outer_src_port == k2->outer_src_port) &&
+			(k1->outer_dst_port == k2->outer_dst_port) &&
+			(k1->vxlan_hdr.vx_flags == k2->vxlan_hdr.vx_flags) &&
+			(k1->vxlan_hdr.vx_vni == k2->vxlan_hdr.vx_vni) &&
+			is_same_tcp6_flow(&k1->inner_key, &k2->inner_key));
+}
+
+/*
+ * Calculate the hash of a VxLAN flow. The outer MAC addresses and UDP
+ * ports are left out, they rarely tell apart the flows of a table.
+ */
+static inline uint32_t
+vxlan_tcp6_flow_hash(const struct vxlan_tcp6_flow_key *k)
+{
+	return rte_jhash_3words(ipv6_addr_fold(k->outer_src_addr),
+			ipv6_addr_fold(k->outer_dst_addr),
+			k->vxlan_hdr.vx_vni, tcp6_flow_hash(&k->inner_key));
+}
+
+static inline uint32_t
+find_a_flow(struct gro_vxlan_tcp6_tbl *tbl,
+		struct vxlan_tcp6_flow_key *key,
+		uint32_t hash)
+{
+	uint32_t flow_idx = tbl->flow_hash[hash & tbl->hash_mask];
+
+	while (flow_idx != INVALID_ARRAY_INDEX) {
+		if (is_same_vxlan_tcp6_flow(&tbl->flows[flow_idx].key, key))
+			return flow_idx;
+		flow_idx = tbl->flows[flow_idx].next_index;
+	}
+	return INVALID_ARRAY_INDEX;
+}
+
+static inline void
+delete_flow(struct gro_vxlan_tcp6_tbl *tbl, uint32_t flow_idx)
+{
+	struct gro_vxlan_tcp6_flow *flow = &tbl->flows[flow_idx];
+	uint32_t *prev;
+
+	/* Unlink the flow from its hash bucket. */
+	prev = &tbl->flow_hash[vxlan_tcp6_flow_hash(&flow->key) &
+		tbl->hash_mask];
+	while (*prev != flow_idx)
+		prev = &tbl->flows[*prev].next_index;
+	*prev = flow->next_index;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow. */
+	flow->start_index = INVALID_ARRAY_INDEX;
+	flow->next_index = tbl->free_flow;
+	tbl->free_flow = flow_idx;
+	tbl->flow_num--;
+
+	/* All flows are free, start again from the array beginning. */
+	if (tbl->flow_num == 0) {
+		tbl->free_flow = INVALID_ARRAY_INDEX;
+		tbl->flow_top = 0;
+	}
+}
+
+static inline int
+is_inner_ipv6(uint32_t ptype)
+{
+	ptype &= RTE_PTYPE_INNER_L3_MASK;
+	return ptype == RTE_PTYPE_INNER_L3_IPV6 ||
+		ptype == RTE_PTYPE_INNER_L3_IPV6_EXT ||
+		ptype == RTE_PTYPE_INNER_L3_IPV6_EXT_UNKNOWN;
+}
+
+static inline void
+update_vxlan_header(struct gro_tcp_item *item)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_mbuf *pkt = item->firstseg;
+	uint16_t len;
+
+	/* Update the outer IPv6 header. */
+	len = pkt->pkt_len - pkt->outer_l2_len;
+	ipv6_hdr = (struct rte_ipv6_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			pkt->outer_l2_len);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(len -
+			sizeof(struct rte_ipv6_hdr));
+
+	/* Update the outer UDP header. */
+	len -= pkt->outer_l3_len;
+	udp_hdr = (struct rte_udp_hdr *)((char *)ipv6_hdr + pkt->outer_l3_len);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+
+	/* Update the inner IP header. */
+	len -= pkt->l2_len;
+	if (is_inner_ipv6(pkt->packet_type)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)((char *)udp_hdr +
+				pkt->l2_len);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(len -
+				sizeof(struct rte_ipv6_hdr));
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)((char *)udp_hdr +
+				pkt->l2_len);
+		ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+	}
+}
+
+int32_t
+gro_vxlan_tcp6_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t start_time)
+{
+	struct rte_ether_hdr *outer_eth_hdr, *eth_hdr;
+	struct rte_ipv6_hdr *outer_ipv6_hdr, *ipv6_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_vxlan_hdr *vxlan_hdr;
+	char *iph;
+	uint32_t sent_seq;
+	int32_t tcp_dl;
+	uint16_t frag_off, ip_id;
+	uint8_t is_atomic;
+
+	struct vxlan_tcp6_flow_key key;
+	uint32_t cur_idx, prev_idx, item_idx, flow_idx;
+	uint32_t hash;
+	int cmp;
+	uint16_t hdr_len, l2_offset;
+
+	/*
+	 * Don't process the packet whose TCP header length is greater
+	 * than 60 bytes or less than 20 bytes.
+	 */
+	if (unlikely(INVALID_TCP_HDRLEN(pkt->l4_len)))
+		return -1;
+
+	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
+	outer_ipv6_hdr = (struct rte_ipv6_hdr *)((char *)outer_eth_hdr +
+			pkt->outer_l2_len);
+	udp_hdr = (struct rte_udp_hdr *)((char *)outer_ipv6_hdr +
+			pkt->outer_l3_len);
+	vxlan_hdr = (struct rte_vxlan_hdr *)((char *)udp_hdr +
+			sizeof(struct rte_udp_hdr));
+	eth_hdr = (struct rte_ether_hdr *)((char *)vxlan_hdr +
+			sizeof(struct rte_vxlan_hdr));
+	iph = (char *)udp_hdr + pkt->l2_len;
+	tcp_hdr = (struct rte_tcp_hdr *)(iph + pkt->l3_len);
+
+	/*
+	 * Don't process the packet which has FIN, SYN, RST, PSH, URG,
+	 * ECE or CWR set.
+	 */
+	if (tcp_hdr->tcp_flags != RTE_TCP_ACK_FLAG)
+		return -1;
+
+	l2_offset = pkt->outer_l2_len + pkt->outer_l3_len;
+	hdr_len = l2_offset + pkt->l2_len + pkt->l3_len + pkt->l4_len;
+	/*
+	 * Don't process the packet whose payload length is less than or
+	 * equal to 0.
+	 */
+	tcp_dl = pkt->pkt_len - hdr_len;
+	if (tcp_dl <= 0)
+		return -1;
+
+	memset(&key, 0, sizeof(key));
+	if (is_inner_ipv6(pkt->packet_type)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)iph;
+		/* Don't process the packet with inner extension headers. */
+		if (ipv6_hdr->proto != IPPROTO_TCP ||
+				pkt->l3_len != sizeof(struct rte_ipv6_hdr))
+			return -1;
+		memcpy(key.inner_key.src_addr, ipv6_hdr->src_addr, 16);
+		memcpy(key.inner_key.dst_addr, ipv6_hdr->dst_addr, 16);
+		key.inner_key.vtc_flow = ipv6_hdr->vtc_flow;
+		/* IPv6 has no IP ID, the packets are always atomic. */
+		is_atomic = 1;
+		ip_id = 0;
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)iph;
+		memcpy(key.inner_key.src_addr, &ipv4_hdr->src_addr,
+				sizeof(ipv4_hdr->src_addr));
+		memcpy(key.inner_key.dst_addr, &ipv4_hdr->dst_addr,
+				sizeof(ipv4_hdr->dst_addr));
+		/*
+		 * Save IPv4 ID for the packet whose DF bit is 0. For the
+		 * packet whose DF bit is 1, IPv4 ID is ignored.
+		 */
+		frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+		is_atomic = (frag_off & RTE_IPV4_HDR_DF_FLAG) ==
+			RTE_IPV4_HDR_DF_FLAG;
+		ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	}
+
+	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
+
+	rte_ether_addr_copy(&(eth_hdr->src_addr), &(key.inner_key.eth_saddr));
+	rte_ether_addr_copy(&(eth_hdr->dst_addr), &(key.inner_key.eth_daddr));
+	key.inner_key.recv_ack = tcp_hdr->recv_ack;
+	key.inner_key.src_port = tcp_hdr->src_port;
+	key.inner_key.dst_port = tcp_hdr->dst_port;
+
+	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
+	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	rte_ether_addr_copy(&(outer_eth_hdr->src_addr), &(key.outer_eth_saddr));
+	rte_ether_addr_copy(&(outer_eth_hdr->dst_addr), &(key.outer_eth_daddr));
+	memcpy(key.outer_src_addr, outer_ipv6_hdr->src_addr, 16);
+	memcpy(key.outer_dst_addr, outer_ipv6_hdr->dst_addr, 16);
+	key.outer_src_port = udp_hdr->src_port;
+	key.outer_dst_port = udp_hdr->dst_port;
+
+	/* Search for a matched flow. */
+	hash = vxlan_tcp6_flow_hash(&key);
+	flow_idx = find_a_flow(tbl, &key, hash);
+
+	/*
+	 * Can't find a matched flow. Insert a new flow and store the
+	 * packet into the flow.
+	 */
+	if (flow_idx == INVALID_ARRAY_INDEX) {
+		item_idx = insert_new_item(tbl, pkt, start_time,
+				INVALID_ARRAY_INDEX, sent_seq, ip_id,
+				is_atomic);
+		if (item_idx == INVALID_ARRAY_INDEX)
+			return -1;
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
+				INVALID_ARRAY_INDEX) {
+			/*
+			 * Fail to insert a new flow, so
+			 * delete the inserted packet.
+			 */
+			delete_item(tbl, item_idx, INVALID_ARRAY_INDEX);
+			return -1;
+		}
+		return 0;
+	}
+
+	/* Check all packets in the flow and try to find a neighbor. */
+	cur_idx = tbl->flows[flow_idx].start_index;
+	prev_idx = cur_idx;
+	do {
+		cmp = check_seq_option(&(tbl->items[cur_idx]), tcp_hdr,
+				sent_seq, ip_id, pkt->l4_len, tcp_dl,
+				l2_offset, is_atomic);
+		if (cmp) {
+			if (merge_two_tcp_packets(&(tbl->items[cur_idx]),
+						pkt, cmp, sent_seq, ip_id,
+						l2_offset))
+				return 1;
+			/*
+			 * Can't merge two packets, as the packet
+			 * length will be greater than the max value.
+			 * Insert the packet into the flow.
+			 */
+			if (insert_new_item(tbl, pkt, start_time, prev_idx,
+						sent_seq, ip_id, is_atomic) ==
+					INVALID_ARRAY_INDEX)
+				return -1;
+			return 0;
+		}
+		prev_idx = cur_idx;
+		cur_idx = tbl->items[cur_idx].next_pkt_idx;
+	} while (cur_idx != INVALID_ARRAY_INDEX);
+
+	/* Can't find neighbor. Insert the packet into the flow. */
+	if (insert_new_item(tbl, pkt, start_time, prev_idx, sent_seq,
+				ip_id, is_atomic) == INVALID_ARRAY_INDEX)
+		return -1;
+
+	return 0;
+}
+
+uint16_t
+gro_vxlan_tcp6_tbl_timeout_flush(struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out)
+{
+	uint16_t k = 0;
+	uint32_t i, j;
+
+	/* Flows from flow_top on have never been used. */
+	for (i = 0; i < tbl->flow_top; i++) {
+		if (unlikely(tbl->flow_num == 0))
+			return k;
+
+		j = tbl->flows[i].start_index;
+		while (j != INVALID_ARRAY_INDEX) {
+			if (tbl->items[j].start_time <= flush_timestamp) {
+				out[k++] = tbl->items[j].firstseg;
+				if (tbl->items[j].nb_merged > 1)
+					update_vxlan_header(&(tbl->items[j]));
+				/*
+				 * Delete the item and get the next packet
+				 * index.
+				 */
+				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
+				tbl->flows[i].start_index = j;
+				if (j == INVALID_ARRAY_INDEX)
+					delete_flow(tbl, i);
+
+				if (unlikely(k == nb_out))
+					return k;
+			} else
+				/*
+				 * The left packets in the flow won't be
+				 * timeout. Go to check other flows.
+				 */
+				break;
+		}
+	}
+	return k;
+}
+
+uint32_t
+gro_vxlan_tcp6_tbl_pkt_count(void *tbl)
+{
+	struct gro_vxlan_tcp6_tbl *gro_tbl = tbl;
+
+	if (gro_tbl)
+		return gro_tbl->item_num;
+
+	return 0;
+}
@@ -0,0 +1,184 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _GRO_VXLAN_TCP6_H_
+#define _GRO_VXLAN_TCP6_H_
+
+#include "gro_tcp6.h"
+
+#define GRO_VXLAN_TCP6_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
+
+/*
+ * Header fields representing a VxLAN flow with an outer IPv6 header.
+ * The inner key holds either a TCP/IPv6 flow or a TCP/IPv4 one, whose
+ * addresses take the first 4 bytes of the address fields and whose
+ * vtc_flow is zero. A table only keeps flows of one inner IP version.
+ */
+struct vxlan_tcp6_flow_key {
+	struct tcp6_flow_key inner_key;
+	struct rte_vxlan_hdr vxlan_hdr;
+
+	struct rte_ether_addr outer_eth_saddr;
+	struct rte_ether_addr outer_eth_daddr;
+
+	uint8_t outer_src_addr[16];
+	uint8_t outer_dst_addr[16];
+
+	/* Outer UDP ports */
+	uint16_t outer_src_port;
+	uint16_t outer_dst_port;
+};
+
+struct gro_vxlan_tcp6_flow {
+	struct vxlan_tcp6_flow_key key;
+	/*
+	 * The index of the first packet in the flow. INVALID_ARRAY_INDEX
+	 * indicates an empty flow.
+	 */
+	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket,
+	 * or in the free flow list if the flow is empty.
+	 */
+	uint32_t next_index;
+};
+
+/*
+ * VxLAN (with an outer IPv6 header and an inner TCP/IPv4 or TCP/IPv6
+ * packet) reassembly table structure. The outer IPv6 header has no IP
+ * ID, so the items are plain TCP items of the inner packets.
+ */
+struct gro_vxlan_tcp6_tbl {
+	/* item array */
+	struct gro_tcp_item *items;
+	/* flow array */
+	struct gro_vxlan_tcp6_flow *flows;
+	/* current item number */
+	uint32_t item_num;
+	/* current flow number */
+	uint32_t flow_num;
+	/* the maximum item number */
+	uint32_t max_item_num;
+	/* the maximum flow number */
+	uint32_t max_flow_num;
+	/* hash buckets, each one keeps the index of its first flow */
+	uint32_t *flow_hash;
+	/* hash bucket number minus one */
+	uint32_t hash_mask;
+	/* head of the free item list */
+	uint32_t free_item;
+	/* head of the free flow list */
+	uint32_t free_flow;
+	/* items from this index on have never been used */
+	uint32_t item_top;
+	/* flows from this index on have never been used */
+	uint32_t flow_top;
+};
+
+/**
+ * This function creates a VxLAN reassembly table for VxLAN packets
+ * which have an outer IPv6 header and an inner TCP/IPv4 or TCP/IPv6
+ * packet.
+ *
+ * @param socket_id
+ *  Socket index for allocating the table
+ * @param max_flow_num
+ *  The maximum number of flows in the table
+ * @param max_item_per_flow
+ *  The maximum number of packets per flow
+ *
+ * @return
+ *  - Return the table pointer on success.
+ *  - Return NULL on failure.
+ */
+void *gro_vxlan_tcp6_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow);
+
+/**
+ * This function initializes the flow hash index and the free lists
+ * of a VxLAN reassembly table and empties it. The items, flows and
+ * flow_hash arrays and the maximum item and flow numbers must be set
+ * before. The flow_hash array must have at least
+ * rte_align32pow2(max_flow_num) entries, and one at least.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_tcp6_tbl_init(struct gro_vxlan_tcp6_tbl *tbl);
+
+/**
+ * This function destroys a VxLAN reassembly table.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_tcp6_tbl_destroy(void *tbl);
+
+/**
+ * This function merges a VxLAN packet which has an outer IPv6 header and
+ * an inner TCP/IPv4 or TCP/IPv6 packet. It doesn't process the packet,
+ * whose TCP header has SYN, FIN, RST, PSH, CWR, ECE or URG bit set, or
+ * which doesn't have payload, or whose inner IPv6 header is followed by
+ * extension headers.
+ *
+ * This function doesn't check if the packet has correct checksums and
+ * doesn't re-calculate checksums for the merged packet. Additionally,
+ * it assumes the inner IPv4 packets are complete (i.e., MF==0 &&
+ * frag_off==0), when IP fragmentation is possible (i.e., DF==0). It
+ * returns the packet, if the packet has invalid parameters (e.g. SYN bit
+ * is set) or there is no available space in the table.
+ *
+ * @param pkt
+ *  Packet to reassemble
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ * @start_time
+ *  The time when the packet is inserted into the table
+ *
+ * @return
+ *  - Return a positive value if the packet is merged.
+ *  - Return zero if the packet isn't merged but stored in the table.
+ *  - Return a negative value for invalid parameters or no available
+ *    space in the table.
+ */
+int32_t gro_vxlan_tcp6_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t start_time);
+
+/**
+ * This function flushes timeout packets in the VxLAN reassembly table,
+ * and without updating checksums.
+ *
+ * @param tbl
+ *  Pointer pointing to a VxLAN GRO table
+ * @param flush_timestamp
+ *  This function flushes packets which are inserted into the table
+ *  before or at the flush_timestamp.
+ * @param out
+ *  Pointer array used to keep flushed packets
+ * @param nb_out
+ *  The element number in 'out'. It also determines the maximum number of
+ *  packets that can be flushed finally.
+ *
+ * @return
+ *  The number of flushed packets
+ */
+uint16_t gro_vxlan_tcp6_tbl_timeout_flush(struct gro_vxlan_tcp6_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out);
+
+/**
+ * This function returns the number of the packets in a VxLAN
+ * reassembly table.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ *
+ * @return
+ *  The number of packets in the table
+ */
+uint32_t gro_vxlan_tcp6_tbl_pkt_count(void *tbl);
+#endif
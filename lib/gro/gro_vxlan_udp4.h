@@ -33,6 +33,11 @@ struct gro_vxlan_udp4_flow {
 	 * indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket,
+	 * or in the free flow list if the flow is empty.
+	 */
+	uint32_t next_index;
 };
 
 struct gro_vxlan_udp4_item {
@@ -61,6 +66,18 @@ struct gro_vxlan_udp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/* hash buckets, each one keeps the index of its first flow */
+	uint32_t *flow_hash;
+	/* hash bucket number minus one */
+	uint32_t hash_mask;
+	/* head of the free item list */
+	uint32_t free_item;
+	/* head of the free flow list */
+	uint32_t free_flow;
+	/* items from this index on have never been used */
+	uint32_t item_top;
+	/* flows from this index on have never been used */
+	uint32_t flow_top;
 };
 
 /**
@@ -82,6 +99,18 @@ void *gro_vxlan_udp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function initializes the flow hash index and the free lists
+ * of a VxLAN reassembly table and empties it. The items, flows and
+ * flow_hash arrays and the maximum item and flow numbers must be set
+ * before. The flow_hash array must have at least
+ * rte_align32pow2(max_flow_num) entries, and one at least.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_udp4_tbl_init(struct gro_vxlan_udp4_tbl *tbl);
+
 /**
  * This function destroys a VxLAN reassembly table.
  *
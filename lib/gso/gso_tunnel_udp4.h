@@ -8,8 +8,8 @@
 #include <stdint.h>
 
 /**
- * Segment a tunneling packet with inner UDP/IPv4 headers. This function
- * does not check if the input packet has correct checksums, and does not
+ * Segment a VxLAN packet with inner UDP/IPv4 headers and an outer IPv4
+ * or IPv6 header. This function does not check if the input packet has correct checksums, and does not
  * update checksums for output GSO segments. Furthermore, it does not
  * process IP fragment packets.
  *
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+#define IPV6_FRAG_HDR_LEN sizeof(struct rte_ipv6_fragment_ext)
+
+/*
+ * Insert a fragment extension header after the IPv6 header of a
+ * segment, moving the L2 and IPv6 headers to the headroom.
+ */
+static inline int
+insert_ipv6_frag_header(struct rte_mbuf *seg, uint16_t hdr_offset,
+		uint8_t next_header, uint32_t frag_id, uint16_t frag_data)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	char *hdr;
+
+	hdr = rte_pktmbuf_prepend(seg, IPV6_FRAG_HDR_LEN);
+	if (unlikely(hdr == NULL))
+		return -1;
+	memmove(hdr, hdr + IPV6_FRAG_HDR_LEN, hdr_offset);
+
+	ipv6_hdr = (struct rte_ipv6_hdr *)(hdr + seg->l2_len);
+	ipv6_hdr->proto = IPPROTO_FRAGMENT;
+
+	frag_hdr = (struct rte_ipv6_fragment_ext *)(hdr + hdr_offset);
+	frag_hdr->next_header = next_header;
+	frag_hdr->reserved = 0;
+	frag_hdr->frag_data = rte_cpu_to_be_16(frag_data);
+	frag_hdr->id = rte_cpu_to_be_32(frag_id);
+
+	seg->l3_len += IPV6_FRAG_HDR_LEN;
+	return 0;
+}
+
+static inline int
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t frag_offset = 0, is_mf;
+	uint16_t l2_hdrlen = pkt->l2_len;
+	uint16_t hdr_offset = l2_hdrlen + pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, length, i;
+	uint32_t frag_id;
+	uint8_t next_header;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			l2_hdrlen);
+	next_header = ipv6_hdr->proto;
+	/* All the fragments of the datagram share the identification. */
+	frag_id = (uint32_t)rte_rand();
+
+	for (i = 0; i < nb_segs; i++) {
+		length = segs[i]->pkt_len - hdr_offset;
+		is_mf = i < tail_idx ? RTE_IPV6_EHDR_MF_MASK : 0;
+		if (unlikely(insert_ipv6_frag_header(segs[i], hdr_offset,
+				next_header, frag_id,
+				RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf)) < 0))
+			return -1;
+		update_ipv6_header(segs[i], l2_hdrlen);
+		frag_offset += length;
+	}
+
+	return 0;
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	uint16_t i;
+	int ret;
+
+	/*
+	 * Don't process the packet with extension headers, the fragment
+	 * header must follow the ones which are not fragmentable. This
+	 * also leaves out the fragmented packets.
+	 */
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			pkt->l2_len);
+	if (unlikely(ipv6_hdr->proto != IPPROTO_UDP ||
+			pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers, followed by the fragment header.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* The headers may leave no room for the payload. */
+	if (unlikely(gso_size < hdr_offset + IPV6_FRAG_HDR_LEN +
+			RTE_IPV6_EHDR_FO_ALIGN))
+		return -EINVAL;
+
+	/* pyld_unit_size must be a multiple of 8 because the fragment
+	 * offset uses 8 bytes as unit.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - IPV6_FRAG_HDR_LEN) &
+		~(RTE_IPV6_EHDR_FO_ALIGN - 1);
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1 && update_ipv6_udp_headers(pkt, pkts_out, ret) < 0) {
+		/* No headroom left for the fragment header */
+		for (i = 0; i < ret; i++)
+			rte_pktmbuf_free(pkts_out[i]);
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
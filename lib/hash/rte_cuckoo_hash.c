@@ -32,7 +32,8 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -128,6 +129,72 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/* Same as above, for one of the bucket arrays of a resizable table. */
+static inline uint32_t
+tbl_prim_bucket_index(const struct rte_hash_bkt_tbl *t, const hash_sig_t hash)
+{
+	return hash & t->bucket_bitmask;
+}
+
+static inline uint32_t
+tbl_alt_bucket_index(const struct rte_hash_bkt_tbl *t,
+			uint32_t cur_bkt_idx, uint16_t sig)
+{
+	return (cur_bkt_idx ^ sig) & t->bucket_bitmask;
+}
+
+static struct rte_hash_bkt_tbl *
+resize_tbl_alloc(uint32_t num_buckets, int socket_id)
+{
+	struct rte_hash_bkt_tbl *t;
+
+	t = rte_zmalloc_socket(NULL, sizeof(*t), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (t == NULL)
+		return NULL;
+
+	t->buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (t->buckets == NULL) {
+		rte_free(t);
+		return NULL;
+	}
+	t->num_buckets = num_buckets;
+	t->bucket_bitmask = num_buckets - 1;
+
+	return t;
+}
+
+static void
+resize_tbl_free(struct rte_hash_bkt_tbl *t)
+{
+	if (t == NULL)
+		return;
+	rte_free(t->buckets);
+	rte_free(t);
+}
+
+/* Free all bucket arrays of a resizable table but the newest one. */
+static void
+resize_tbl_free_old(struct rte_hash_resize_state *rs)
+{
+	struct rte_hash_bkt_tbl *t, *next;
+
+	for (t = rs->tbl->prev; t != NULL; t = next) {
+		next = t->prev;
+		resize_tbl_free(t);
+	}
+	rs->tbl->prev = NULL;
+
+	for (t = rs->retired; t != NULL; t = next) {
+		next = t->next_retired;
+		resize_tbl_free(t);
+	}
+	rs->retired = NULL;
+	rs->migrate_idx = 0;
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -152,6 +219,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resize_support = 0;
+	struct rte_hash_resize_state *rs = NULL;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -187,6 +256,14 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE) &&
+	    (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: choose extendable bucket "
+			"table or resizable table\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -207,6 +284,9 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL)
 		no_free_on_del = 1;
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)
+		resize_support = 1;
+
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) {
 		readwrite_concur_lf_support = 1;
 		/* Enable not freeing internal memory/index on delete.
@@ -287,13 +367,35 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
-	buckets = rte_zmalloc_socket(NULL,
+	if (resize_support) {
+		/* Start small, the bucket array grows with the number of keys
+		 * up to the size a fixed table would have been given.
+		 */
+		rs = rte_zmalloc_socket(NULL, sizeof(*rs), RTE_CACHE_LINE_SIZE,
+					params->socket_id);
+		if (rs == NULL) {
+			RTE_LOG(ERR, HASH, "resize state memory allocation "
+							"failed\n");
+			goto err_unlock;
+		}
+		rs->max_buckets = num_buckets;
+		rs->min_buckets = RTE_MIN(num_buckets,
+					(uint32_t)RTE_HASH_RESIZE_MIN_BUCKETS);
+		rs->socket_id = params->socket_id;
+		rs->tbl = resize_tbl_alloc(rs->min_buckets, params->socket_id);
+		if (rs->tbl == NULL) {
+			RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+			goto err_unlock;
+		}
+	} else {
+		buckets = rte_zmalloc_socket(NULL,
 				num_buckets * sizeof(struct rte_hash_bucket),
 				RTE_CACHE_LINE_SIZE, params->socket_id);
 
-	if (buckets == NULL) {
-		RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
-		goto err_unlock;
+		if (buckets == NULL) {
+			RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+			goto err_unlock;
+		}
 	}
 
 	/* Allocate same number of extendable buckets */
@@ -429,6 +531,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resize_support = resize_support;
+	h->resize = rs;
 
 #if defined(RTE_ARCH_X86)
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
@@ -476,6 +580,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
 	rte_free(ext_bkt_to_free);
+	if (rs != NULL) {
+		resize_tbl_free(rs->tbl);
+		rte_free(rs);
+	}
 	return NULL;
 }
 
@@ -522,6 +630,11 @@ rte_hash_free(struct rte_hash *h)
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
 	rte_free(h->hash_rcu_cfg);
+	if (h->resize_support) {
+		resize_tbl_free_old(h->resize);
+		resize_tbl_free(h->resize->tbl);
+		rte_free(h->resize);
+	}
 	rte_free(h);
 	rte_free(te);
 }
@@ -635,7 +748,14 @@ rte_hash_reset(struct rte_hash *h)
 			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
 	}
 
-	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
+	if (h->resize_support) {
+		resize_tbl_free_old(h->resize);
+		memset(h->resize->tbl->buckets, 0, h->resize->tbl->num_buckets *
+						sizeof(struct rte_hash_bucket));
+		h->resize->num_keys = 0;
+	} else
+		memset(h->buckets, 0,
+			h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
 
@@ -1007,6 +1127,416 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+/* Inform the lock free readers that an entry is about to be removed from
+ * a bucket it was copied out of. Writer holds the lock.
+ */
+static inline void
+resize_inform_readers(const struct rte_hash *h)
+{
+	if (h->readwrite_concur_lf_support) {
+		/* Since there is one writer, load acquire on
+		 * tbl_chng_cnt is not required.
+		 */
+		__atomic_store_n(h->tbl_chng_cnt,
+				 *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+		/* The store to sig_current should not
+		 * move above the store to tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+}
+
+/* Shift entries along the cuckoo path ending at (@leaf, @leaf_slot) and
+ * store the new entry at the path head. Writer holds the lock, so the path
+ * cannot have been invalidated since it was found.
+ */
+static inline void
+resize_tbl_move_insert(const struct rte_hash *h, struct queue_node *leaf,
+			uint32_t leaf_slot, uint16_t sig, uint32_t new_idx)
+{
+	struct queue_node *prev_node, *curr_node = leaf;
+	struct rte_hash_bucket *prev_bkt, *curr_bkt = leaf->bkt;
+	uint32_t prev_slot, curr_slot = leaf_slot;
+
+	while (curr_node->prev != NULL) {
+		prev_node = curr_node->prev;
+		prev_bkt = prev_node->bkt;
+		prev_slot = curr_node->prev_slot;
+
+		/* Inform the previous move, the current one is present in
+		 * both its buckets.
+		 */
+		resize_inform_readers(h);
+		curr_bkt->sig_current[curr_slot] =
+			prev_bkt->sig_current[prev_slot];
+		/* Release the updated bucket entry */
+		__atomic_store_n(&curr_bkt->key_idx[curr_slot],
+			prev_bkt->key_idx[prev_slot],
+			__ATOMIC_RELEASE);
+
+		curr_slot = prev_slot;
+		curr_node = prev_node;
+		curr_bkt = curr_node->bkt;
+	}
+
+	resize_inform_readers(h);
+	curr_bkt->sig_current[curr_slot] = sig;
+	/* Release the new bucket entry */
+	__atomic_store_n(&curr_bkt->key_idx[curr_slot],
+			 new_idx,
+			 __ATOMIC_RELEASE);
+}
+
+/* Make space for a new entry in bucket @bkt_idx of array @t using bfs
+ * Cuckoo search. Writer holds the lock.
+ * return 0 if the entry was inserted, -ENOSPC otherwise.
+ */
+static inline int
+resize_tbl_make_space(const struct rte_hash *h, struct rte_hash_bkt_tbl *t,
+			uint32_t bkt_idx, uint16_t sig, uint32_t new_idx)
+{
+	unsigned int i;
+	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
+	struct queue_node *tail, *head;
+	struct rte_hash_bucket *curr_bkt;
+	uint32_t alt_idx;
+
+	tail = queue;
+	head = queue + 1;
+	tail->bkt = &t->buckets[bkt_idx];
+	tail->prev = NULL;
+	tail->prev_slot = -1;
+	tail->cur_bkt_idx = bkt_idx;
+
+	/* Cuckoo bfs Search */
+	while (likely(tail != head && head <
+					queue + RTE_HASH_BFS_QUEUE_MAX_LEN -
+					RTE_HASH_BUCKET_ENTRIES)) {
+		curr_bkt = tail->bkt;
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (curr_bkt->key_idx[i] == EMPTY_SLOT) {
+				resize_tbl_move_insert(h, tail, i, sig,
+							new_idx);
+				return 0;
+			}
+
+			/* Enqueue new node and keep prev node info */
+			alt_idx = tbl_alt_bucket_index(t, tail->cur_bkt_idx,
+						curr_bkt->sig_current[i]);
+			head->bkt = &t->buckets[alt_idx];
+			head->cur_bkt_idx = alt_idx;
+			head->prev = tail;
+			head->prev_slot = i;
+			head++;
+		}
+		tail++;
+	}
+
+	return -ENOSPC;
+}
+
+/* Insert key index @new_idx into bucket array @t. Writer holds the lock.
+ * return 0 on success, -ENOSPC if both buckets are full and no entry
+ * could be pushed away.
+ */
+static inline int
+resize_tbl_insert(const struct rte_hash *h, struct rte_hash_bkt_tbl *t,
+			hash_sig_t hash, uint32_t new_idx)
+{
+	uint16_t sig = get_short_sig(hash);
+	uint32_t prim_idx = tbl_prim_bucket_index(t, hash);
+	uint32_t sec_idx = tbl_alt_bucket_index(t, prim_idx, sig);
+	struct rte_hash_bucket *bkt;
+	unsigned int i;
+
+	bkt = &t->buckets[prim_idx];
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->key_idx[i] == EMPTY_SLOT)
+			goto insert;
+	}
+
+	bkt = &t->buckets[sec_idx];
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->key_idx[i] == EMPTY_SLOT)
+			goto insert;
+	}
+
+	if (resize_tbl_make_space(h, t, prim_idx, sig, new_idx) == 0)
+		return 0;
+	return resize_tbl_make_space(h, t, sec_idx, sig, new_idx);
+
+insert:
+	bkt->sig_current[i] = sig;
+	/* Store to signature and key should not leak after the store
+	 * to key_idx. i.e. key_idx is the guard variable for signature
+	 * and key.
+	 */
+	__atomic_store_n(&bkt->key_idx[i], new_idx, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/* Free drained bucket arrays no reader can reference anymore.
+ * Writer holds the lock.
+ */
+static void
+resize_reclaim(const struct rte_hash *h)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	struct rte_hash_bkt_tbl *t, **pt;
+
+	if (h->hash_rcu_cfg == NULL)
+		return;
+
+	pt = &rs->retired;
+	while ((t = *pt) != NULL) {
+		if (t->rcu_token_valid &&
+				rte_rcu_qsbr_check(h->hash_rcu_cfg->v,
+						t->rcu_token, false) == 1) {
+			*pt = t->next_retired;
+			resize_tbl_free(t);
+		} else
+			pt = &t->next_retired;
+	}
+}
+
+/* Free a drained bucket array once readers are done with it.
+ * Writer holds the lock.
+ */
+static void
+resize_tbl_retire(const struct rte_hash *h, struct rte_hash_bkt_tbl *t)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+
+	/* Readers take the lock or do not run concurrently with writers */
+	if (!h->readwrite_concur_lf_support) {
+		resize_tbl_free(t);
+		return;
+	}
+
+	if (h->hash_rcu_cfg != NULL) {
+		t->rcu_token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+		t->rcu_token_valid = 1;
+	}
+	t->next_retired = rs->retired;
+	rs->retired = t;
+}
+
+/* Move all entries of bucket @bkt of a draining array into the newest
+ * array. Writer holds the lock.
+ * return 0 if the bucket is empty, -ENOSPC if an entry could not be moved.
+ */
+static int
+resize_migrate_bkt(const struct rte_hash *h, struct rte_hash_bucket *bkt)
+{
+	struct rte_hash_key *k, *keys = h->key_store;
+	uint32_t key_idx;
+	unsigned int i;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		key_idx = bkt->key_idx[i];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		/* Only the short signature is stored, the full hash is
+		 * needed to find the buckets in the new array.
+		 */
+		k = (struct rte_hash_key *) ((char *)keys +
+				key_idx * h->key_entry_size);
+		if (resize_tbl_insert(h, h->resize->tbl,
+				rte_hash_hash(h, k->key), key_idx) != 0)
+			return -ENOSPC;
+
+		/* The entry is now in both arrays, readers which missed it
+		 * in the new one must retry before it leaves the old one.
+		 */
+		resize_inform_readers(h);
+		bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT,
+				 __ATOMIC_RELEASE);
+	}
+
+	return 0;
+}
+
+/* Publish a new bucket array of @num_buckets buckets, the current ones are
+ * migrated into it incrementally. Writer holds the lock.
+ */
+static int
+resize_start(const struct rte_hash *h, uint32_t num_buckets)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	struct rte_hash_bkt_tbl *t;
+
+	t = resize_tbl_alloc(num_buckets, rs->socket_id);
+	if (t == NULL) {
+		RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+		return -ENOMEM;
+	}
+	t->prev = rs->tbl;
+	/* Buckets and bitmask of the new array are released to readers */
+	__atomic_store_n(&rs->tbl, t, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/* Migrate up to @n buckets of the oldest bucket array into the newest
+ * one, unlinking the arrays which get drained. Writer holds the lock.
+ */
+static void
+resize_migrate(const struct rte_hash *h, uint32_t n)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	struct rte_hash_bkt_tbl *newer, *oldest;
+
+	while (n > 0 && rs->tbl->prev != NULL) {
+		newer = rs->tbl;
+		while (newer->prev->prev != NULL)
+			newer = newer->prev;
+		oldest = newer->prev;
+
+		for (; n > 0 && rs->migrate_idx < oldest->num_buckets; n--) {
+			if (resize_migrate_bkt(h,
+					&oldest->buckets[rs->migrate_idx]) != 0) {
+				/* Newest array is full, grow it. If it cannot
+				 * grow, retry once keys were deleted.
+				 */
+				if (rs->tbl->num_buckets >= rs->max_buckets ||
+						resize_start(h,
+						rs->tbl->num_buckets << 1) != 0)
+					return;
+				continue;
+			}
+			rs->migrate_idx++;
+		}
+
+		if (rs->migrate_idx < oldest->num_buckets)
+			return;
+
+		/* Readers may still be walking the drained array */
+		__atomic_store_n(&newer->prev, NULL, __ATOMIC_RELEASE);
+		rs->migrate_idx = 0;
+		resize_tbl_retire(h, oldest);
+	}
+}
+
+/* Number of buckets not migrated yet. Writer holds the lock. */
+static uint32_t
+resize_pending(const struct rte_hash_resize_state *rs)
+{
+	const struct rte_hash_bkt_tbl *t;
+	uint32_t pending = 0;
+
+	for (t = rs->tbl->prev; t != NULL; t = t->prev)
+		pending += t->num_buckets;
+
+	return pending == 0 ? 0 : pending - rs->migrate_idx;
+}
+
+/* Grow the bucket array above 3/4 load and shrink it below 1/8 load,
+ * leaving room in both directions so that it does not flip-flop.
+ * Writer holds the lock.
+ */
+static void
+resize_check(const struct rte_hash *h)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	const struct rte_hash_bkt_tbl *t = rs->tbl;
+	const uint64_t slots = (uint64_t)t->num_buckets *
+					RTE_HASH_BUCKET_ENTRIES;
+
+	/* Let the ongoing migration complete first */
+	if (t->prev != NULL)
+		return;
+
+	if (rs->num_keys * 4ULL > slots * 3 &&
+			t->num_buckets < rs->max_buckets)
+		resize_start(h, t->num_buckets << 1);
+	else if (rs->num_keys * 8ULL < slots &&
+			t->num_buckets > rs->min_buckets)
+		resize_start(h, t->num_buckets >> 1);
+}
+
+static inline int32_t
+__rte_hash_add_key_resizable(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	struct rte_hash_bkt_tbl *t;
+	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct lcore_cache *cached_free_slots = NULL;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	uint32_t slot_id;
+	int32_t ret;
+
+	short_sig = get_short_sig(sig);
+
+	/* The bucket arrays can change as soon as the lock is released,
+	 * so the whole insertion is done with the lock held.
+	 */
+	__hash_rw_writer_lock(h);
+	resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BKTS);
+	resize_reclaim(h);
+
+	/* Check if key is already inserted in any of the bucket arrays */
+	for (t = rs->tbl; t != NULL; t = t->prev) {
+		prim_bucket_idx = tbl_prim_bucket_index(t, sig);
+		sec_bucket_idx = tbl_alt_bucket_index(t, prim_bucket_idx,
+							short_sig);
+		ret = search_and_update(h, data, key,
+				&t->buckets[prim_bucket_idx], short_sig);
+		if (ret != -1)
+			goto out;
+		ret = search_and_update(h, data, key,
+				&t->buckets[sec_bucket_idx], short_sig);
+		if (ret != -1)
+			goto out;
+	}
+
+	/* Did not find a match, so get a new slot for storing the new key */
+	if (h->use_local_cache)
+		cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT && h->dq != NULL &&
+			rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->max_reclaim_size,
+				NULL, NULL, NULL) == 0)
+		slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
+	/* The store to application data (by the application) at *data should
+	 * not leak after the store of pdata in the key store. i.e. pdata is
+	 * the guard variable. Release the application data to the readers.
+	 */
+	__atomic_store_n(&new_k->pdata,
+		data,
+		__ATOMIC_RELEASE);
+	/* Copy key */
+	memcpy(new_k->key, key, h->key_len);
+
+	/* If the newest array is full, grow it rather than failing */
+	ret = resize_tbl_insert(h, rs->tbl, sig, slot_id);
+	if (ret != 0 && rs->tbl->num_buckets < rs->max_buckets &&
+			resize_start(h, rs->tbl->num_buckets << 1) == 0)
+		ret = resize_tbl_insert(h, rs->tbl, sig, slot_id);
+	if (ret != 0) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		goto out;
+	}
+
+	rs->num_keys++;
+	resize_check(h);
+	ret = slot_id - 1;
+out:
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1024,6 +1554,9 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
+	if (h->resize_support)
+		return __rte_hash_add_key_resizable(h, key, sig, data);
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
@@ -1412,11 +1945,72 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+static inline int32_t
+__rte_hash_lookup_resizable(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_bkt_tbl *t;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t cnt_b, cnt_a;
+	int32_t ret;
+	uint16_t short_sig;
+
+	short_sig = get_short_sig(sig);
+
+	__hash_rw_reader_lock(h);
+	do {
+		/* Load the table change counter before the lookup
+		 * starts. Acquire semantics will make sure that
+		 * loads in search_one_bucket are not hoisted.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+				__ATOMIC_ACQUIRE);
+
+		/* Search the newest bucket array first, then the arrays
+		 * which are being migrated into it.
+		 */
+		for (t = __atomic_load_n(&h->resize->tbl, __ATOMIC_ACQUIRE);
+				t != NULL;
+				t = __atomic_load_n(&t->prev, __ATOMIC_ACQUIRE)) {
+			prim_bucket_idx = tbl_prim_bucket_index(t, sig);
+			sec_bucket_idx = tbl_alt_bucket_index(t,
+					prim_bucket_idx, short_sig);
+
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&t->buckets[prim_bucket_idx]);
+			if (ret != -1)
+				goto out;
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&t->buckets[sec_bucket_idx]);
+			if (ret != -1)
+				goto out;
+		}
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		/* Re-read the table change counter to check if an entry
+		 * was moved during search. It only changes with lock free
+		 * readers, otherwise the search is done once.
+		 */
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	ret = -ENOENT;
+out:
+	__hash_rw_reader_unlock(h);
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resize_support)
+		return __rte_hash_lookup_resizable(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1679,6 +2273,75 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Hand a deleted key index over to the internal RCU QSBR.
+ * Writer holds the lock.
+ */
+static inline void
+__hash_rcu_qsbr_free_key(const struct rte_hash *h, uint32_t key_idx,
+				uint32_t ext_bkt_idx)
+{
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	rcu_dq_entry.key_idx = key_idx;
+	rcu_dq_entry.ext_bkt_idx = ext_bkt_idx;
+	if (h->dq == NULL) {
+		/* Wait for quiescent state change if using
+		 * RTE_HASH_QSBR_MODE_SYNC
+		 */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+		__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+					      &rcu_dq_entry, 1);
+	} else if (h->dq)
+		/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
+		if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
+			RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+}
+
+static inline int32_t
+__rte_hash_del_key_resizable(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	struct rte_hash_resize_state *rs = h->resize;
+	struct rte_hash_bkt_tbl *t;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret = -1;
+	int pos;
+
+	short_sig = get_short_sig(sig);
+
+	__hash_rw_writer_lock(h);
+	resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BKTS);
+	resize_reclaim(h);
+
+	for (t = rs->tbl; t != NULL && ret == -1; t = t->prev) {
+		prim_bucket_idx = tbl_prim_bucket_index(t, sig);
+		sec_bucket_idx = tbl_alt_bucket_index(t, prim_bucket_idx,
+							short_sig);
+		ret = search_and_remove(h, key, &t->buckets[prim_bucket_idx],
+					short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+					&t->buckets[sec_bucket_idx],
+					short_sig, &pos);
+	}
+
+	if (ret == -1) {
+		__hash_rw_writer_unlock(h);
+		return -ENOENT;
+	}
+
+	rs->num_keys--;
+	/* Using internal RCU QSBR */
+	if (h->hash_rcu_cfg)
+		/* Key index where key is stored, adding the first dummy index */
+		__hash_rcu_qsbr_free_key(h, ret + 1, EMPTY_SLOT);
+	resize_check(h);
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
@@ -1690,7 +2353,9 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret, i;
 	uint16_t short_sig;
 	uint32_t index = EMPTY_SLOT;
-	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	if (h->resize_support)
+		return __rte_hash_del_key_resizable(h, key, sig);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1763,23 +2428,9 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 
 return_key:
 	/* Using internal RCU QSBR */
-	if (h->hash_rcu_cfg) {
+	if (h->hash_rcu_cfg)
 		/* Key index where key is stored, adding the first dummy index */
-		rcu_dq_entry.key_idx = ret + 1;
-		rcu_dq_entry.ext_bkt_idx = index;
-		if (h->dq == NULL) {
-			/* Wait for quiescent state change if using
-			 * RTE_HASH_QSBR_MODE_SYNC
-			 */
-			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
-						 RTE_QSBR_THRID_INVALID);
-			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
-						      &rcu_dq_entry, 1);
-		} else if (h->dq)
-			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
-	}
+		__hash_rcu_qsbr_free_key(h, ret + 1, index);
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
@@ -2315,12 +2966,56 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		positions, hit_mask, data);
 }
 
+/* Bulk lookup in a resizable table. The buckets of the newest array are
+ * prefetched for the whole burst before the keys are searched one by one.
+ * @prim_hash is NULL if the hashes must be computed.
+ */
+static inline void
+__rte_hash_lookup_bulk_resizable(const struct rte_hash *h, const void **keys,
+			hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bkt_tbl *t;
+	uint32_t prim_index, sec_index;
+	uint64_t hits = 0;
+	int32_t i;
+
+	/* The newest array cannot be freed while it is prefetched */
+	__hash_rw_reader_lock(h);
+	t = __atomic_load_n(&h->resize->tbl, __ATOMIC_ACQUIRE);
+	for (i = 0; i < num_keys; i++) {
+		rte_prefetch0(keys[i]);
+		hash[i] = (prim_hash != NULL) ? prim_hash[i] :
+						rte_hash_hash(h, keys[i]);
+		prim_index = tbl_prim_bucket_index(t, hash[i]);
+		sec_index = tbl_alt_bucket_index(t, prim_index,
+						get_short_sig(hash[i]));
+		rte_prefetch0(&t->buckets[prim_index]);
+		rte_prefetch0(&t->buckets[sec_index]);
+	}
+	__hash_rw_reader_unlock(h);
+
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_lookup_resizable(h, keys[i], hash[i],
+					(data != NULL) ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resize_support)
+		__rte_hash_lookup_bulk_resizable(h, keys, NULL, num_keys,
+					positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2432,7 +3127,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resize_support)
+		__rte_hash_lookup_bulk_resizable(h, keys, prim_hash, num_keys,
+					positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2473,6 +3171,201 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/* Hash a burst of keys to be added or removed and prefetch their
+ * buckets. The bucket pointers are not filled for resizable tables, as
+ * their bucket arrays may be replaced by any write.
+ */
+static inline void
+__bulk_write_prefetching_loop(const struct rte_hash *h,
+	const void **keys, int32_t num_keys,
+	hash_sig_t *hash,
+	const struct rte_hash_bucket **primary_bkt,
+	const struct rte_hash_bucket **secondary_bkt)
+{
+	const struct rte_hash_bkt_tbl *t;
+	uint32_t prim_index, sec_index;
+	int32_t i;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	if (h->resize_support) {
+		/* The newest array cannot be freed while it is prefetched */
+		__hash_rw_writer_lock(h);
+		t = h->resize->tbl;
+		for (i = 0; i < num_keys; i++) {
+			if (i + PREFETCH_OFFSET < num_keys)
+				rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+			hash[i] = rte_hash_hash(h, keys[i]);
+			prim_index = tbl_prim_bucket_index(t, hash[i]);
+			sec_index = tbl_alt_bucket_index(t, prim_index,
+						get_short_sig(hash[i]));
+			rte_prefetch0(&t->buckets[prim_index]);
+			rte_prefetch0(&t->buckets[sec_index]);
+		}
+		__hash_rw_writer_unlock(h);
+		return;
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		hash[i] = rte_hash_hash(h, keys[i]);
+		prim_index = get_prim_bucket_index(h, hash[i]);
+		sec_index = get_alt_bucket_index(h, prim_index,
+						get_short_sig(hash[i]));
+
+		primary_bkt[i] = &h->buckets[prim_index];
+		secondary_bkt[i] = &h->buckets[sec_index];
+
+		rte_prefetch0(primary_bkt[i]);
+		rte_prefetch0(secondary_bkt[i]);
+	}
+}
+
+/* Prefetch the key of the first signature match of each key in a burst,
+ * so that the key comparisons of the removals hit the cache.
+ */
+static inline void
+__bulk_del_prefetch_keys(const struct rte_hash *h, const hash_sig_t *hash,
+	int32_t num_keys,
+	const struct rte_hash_bucket **primary_bkt,
+	const struct rte_hash_bucket **secondary_bkt)
+{
+	const struct rte_hash_bucket *bkt;
+	uint32_t prim_hitmask, sec_hitmask;
+	uint32_t hit_index, key_idx;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		prim_hitmask = 0;
+		sec_hitmask = 0;
+		compare_signatures(&prim_hitmask, &sec_hitmask,
+				primary_bkt[i], secondary_bkt[i],
+				get_short_sig(hash[i]), h->sig_cmp_fn);
+
+		if (prim_hitmask) {
+			bkt = primary_bkt[i];
+			hit_index = __builtin_ctzl(prim_hitmask) >> 1;
+		} else if (sec_hitmask) {
+			bkt = secondary_bkt[i];
+			hit_index = __builtin_ctzl(sec_hitmask) >> 1;
+		} else
+			continue;
+
+		key_idx = __atomic_load_n(&bkt->key_idx[hit_index],
+					  __ATOMIC_RELAXED);
+		rte_prefetch0((const char *)h->key_store +
+				key_idx * h->key_entry_size);
+	}
+}
+
+int
+rte_hash_add_key_bulk(const struct rte_hash *h, const void **keys,
+		void *data[], uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i;
+	int added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, hash,
+		primary_bkt, secondary_bkt);
+
+	/* Cuckoo displacements depend on the keys inserted before,
+	 * so the insertions themselves are done in order.
+	 */
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_add_key_with_hash(h, keys[i], hash[i],
+					(data != NULL) ? data[i] : NULL);
+		if (positions[i] >= 0)
+			added++;
+	}
+
+	return added;
+}
+
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i;
+	int deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, hash,
+		primary_bkt, secondary_bkt);
+	if (!h->resize_support)
+		__bulk_del_prefetch_keys(h, hash, num_keys,
+			primary_bkt, secondary_bkt);
+
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_with_hash(h, keys[i],
+							hash[i]);
+		if (positions[i] >= 0)
+			deleted++;
+	}
+
+	return deleted;
+}
+
+/* Iterate through the bucket arrays of a resizable table, newest first.
+ * Positions of an older array follow the ones of the newer arrays.
+ */
+static int32_t
+__rte_hash_iterate_resizable(const struct rte_hash *h, const void **key,
+			void **data, uint32_t *next)
+{
+	const struct rte_hash_bkt_tbl *t;
+	struct rte_hash_key *next_key;
+	uint32_t base = 0, idx, position;
+
+	__hash_rw_reader_lock(h);
+	for (t = __atomic_load_n(&h->resize->tbl, __ATOMIC_ACQUIRE); t != NULL;
+			t = __atomic_load_n(&t->prev, __ATOMIC_ACQUIRE)) {
+		const uint32_t total_entries = t->num_buckets *
+							RTE_HASH_BUCKET_ENTRIES;
+
+		for (; *next < base + total_entries; (*next)++) {
+			idx = *next - base;
+			position = __atomic_load_n(&t->buckets[idx /
+					RTE_HASH_BUCKET_ENTRIES].key_idx[idx %
+					RTE_HASH_BUCKET_ENTRIES],
+					__ATOMIC_ACQUIRE);
+			if (position == EMPTY_SLOT)
+				continue;
+
+			next_key = (struct rte_hash_key *) ((char *)h->key_store +
+					position * h->key_entry_size);
+			/* Return key and data */
+			*key = next_key->key;
+			*data = next_key->pdata;
+			__hash_rw_reader_unlock(h);
+
+			/* Increment iterator */
+			(*next)++;
+			return position - 1;
+		}
+		base += total_entries;
+	}
+	__hash_rw_reader_unlock(h);
+
+	return -ENOENT;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2481,6 +3374,9 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
+	if (h->resize_support)
+		return __rte_hash_iterate_resizable(h, key, data, next);
+
 	const uint32_t total_entries_main = h->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
 	const uint32_t total_entries = total_entries_main << 1;
@@ -2548,3 +3444,51 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_resize_state *rs;
+	uint32_t num_buckets;
+	int ret = 0;
+
+	if (h == NULL || entries == 0 || entries > h->entries)
+		return -EINVAL;
+	if (!h->resize_support)
+		return -ENOTSUP;
+
+	rs = h->resize;
+	num_buckets = rte_align32pow2(entries) / RTE_HASH_BUCKET_ENTRIES;
+	num_buckets = RTE_MAX(num_buckets, rs->min_buckets);
+	num_buckets = RTE_MIN(num_buckets, rs->max_buckets);
+
+	__hash_rw_writer_lock(h);
+	if ((uint64_t)num_buckets * RTE_HASH_BUCKET_ENTRIES * 3 <
+			rs->num_keys * 4ULL)
+		/* The keys would not fit */
+		ret = -ENOSPC;
+	else if (num_buckets != rs->tbl->num_buckets)
+		ret = resize_start(h, num_buckets);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+int
+rte_hash_resize_migrate(struct rte_hash *h, uint32_t n)
+{
+	uint32_t pending;
+
+	if (h == NULL)
+		return -EINVAL;
+	if (!h->resize_support)
+		return -ENOTSUP;
+
+	__hash_rw_writer_lock(h);
+	resize_migrate(h, n);
+	resize_reclaim(h);
+	pending = resize_pending(h->resize);
+	__hash_rw_writer_unlock(h);
+
+	return pending;
+}
@@ -128,6 +128,12 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Number of old buckets migrated by each write while a resize is ongoing. */
+#define RTE_HASH_RESIZE_MIGRATE_BKTS	4
+
+/** Smallest bucket array a resizable table is created with or shrinks to. */
+#define RTE_HASH_RESIZE_MIN_BUCKETS	64
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -162,6 +168,35 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/** Bucket array of a resizable hash table. */
+struct rte_hash_bkt_tbl {
+	struct rte_hash_bucket *buckets; /**< Buckets of this array. */
+	uint32_t num_buckets;           /**< Number of buckets in the array. */
+	uint32_t bucket_bitmask;
+	/**< Bitmask for getting bucket index from hash signature. */
+	struct rte_hash_bkt_tbl *prev;
+	/**< Older array still being migrated into this one, NULL if none. */
+	struct rte_hash_bkt_tbl *next_retired;
+	/**< Next array in the list of drained arrays waiting to be freed. */
+	uint64_t rcu_token;             /**< QSBR token taken on retirement. */
+	uint8_t rcu_token_valid;
+	/**< If rcu_token was taken while an RCU QSBR variable was attached. */
+};
+
+/** Online resize state of a hash table. */
+struct rte_hash_resize_state {
+	struct rte_hash_bkt_tbl *tbl;
+	/**< Newest bucket array, new keys are always inserted into it. */
+	struct rte_hash_bkt_tbl *retired;
+	/**< Drained arrays that readers may still be referencing. */
+	uint32_t migrate_idx;
+	/**< Next bucket of the oldest array to migrate. */
+	uint32_t num_keys;              /**< Number of keys in the buckets. */
+	uint32_t min_buckets;           /**< Smallest allowed array size. */
+	uint32_t max_buckets;           /**< Largest allowed array size. */
+	int socket_id;                  /**< NUMA socket of the arrays. */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -202,6 +237,8 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resize_support;
+	/**< If the bucket array is resized online */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -231,6 +268,8 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_resize_state *resize;
+	/**< Bucket arrays and migration state of a resizable table. */
 } __rte_cache_aligned;
 
 struct queue_node {
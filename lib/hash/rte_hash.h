@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <rte_compat.h>
 #include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
@@ -55,6 +56,20 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the bucket array grow and shrink online with the number of
+ * keys stored. The 'entries' parameter becomes the maximum number of keys.
+ * Buckets are migrated incrementally by the writers, readers keep their
+ * concurrency guarantees. Cannot be combined with
+ * RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ * Keys are rehashed with the table hash function when they are migrated,
+ * so the *_with_hash APIs must be given values returned by rte_hash_hash().
+ * With RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, drained bucket arrays are
+ * freed once the RCU QSBR variable attached with rte_hash_rcu_qsbr_add()
+ * reports a grace period, or on rte_hash_reset()/rte_hash_free() if no
+ * variable is attached.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -381,6 +396,70 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple keys to an existing hash table.
+ * The signatures of the whole burst are computed and their buckets are
+ * prefetched before the keys are inserted one after another, hiding the
+ * bucket cache misses of the insertions.
+ * Each key is added with the same semantics as rte_hash_add_key_data(),
+ * including the multi-thread safety given by the table creation flags.
+ * The burst as a whole is not atomic.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A list of data to add with the keys, or NULL to add no data.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the same value rte_hash_add_key()
+ *   would return: the position of the key, or -ENOSPC if there was no
+ *   space in the hash for it.
+ * @return
+ *   -EINVAL if the parameters are invalid, otherwise the number of keys
+ *   added or updated.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk(const struct rte_hash *h, const void **keys,
+		void *data[], uint32_t num_keys, int32_t *positions);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove multiple keys from an existing hash table.
+ * The signatures of the whole burst are computed and their buckets and
+ * candidate keys are prefetched before the keys are removed one after
+ * another.
+ * Each key is removed with the same semantics as rte_hash_del_key(),
+ * including the multi-thread safety given by the table creation flags
+ * and the rules for freeing the key index. The burst as a whole is not
+ * atomic.
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the position the key was stored at,
+ *   or -ENOENT if the key was not found.
+ * @return
+ *   -EINVAL if the parameters are invalid, otherwise the number of keys
+ *   removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -675,6 +754,57 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
  */
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start resizing the bucket array of a resizable hash table so it fits
+ * the given number of entries. The buckets of the current array are
+ * migrated incrementally by the following add and delete operations,
+ * or explicitly with rte_hash_resize_migrate().
+ * Resizing also happens automatically as keys are added or deleted,
+ * this API allows the application to do it ahead of time.
+ * This operation has the same thread safety as rte_hash_add_key().
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ * @param entries
+ *   Number of entries the new bucket array should hold. It is rounded
+ *   in the same way as the 'entries' creation parameter and clamped
+ *   to the supported range.
+ * @return
+ *   - 0 if the resize was started or the array already has this size.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table was not created resizable.
+ *   - -ENOSPC if the keys currently stored would not fit.
+ *   - -ENOMEM if the new bucket array could not be allocated.
+ */
+__rte_experimental
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate buckets of an ongoing resize of a resizable hash table into
+ * its newest bucket array. This allows a control thread to complete
+ * a resize while no keys are being added or deleted.
+ * This operation has the same thread safety as rte_hash_add_key().
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ * @param n
+ *   Maximum number of buckets to migrate.
+ * @return
+ *   - Number of buckets still to be migrated, 0 once the resize completed.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table was not created resizable.
+ */
+__rte_experimental
+int
+rte_hash_resize_migrate(struct rte_hash *h, uint32_t n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,9 +12,13 @@
 #include <rte_eal_memconfig.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_net.h>
 
 #define THASH_NAME_LEN		64
 #define TOEPLITZ_HASH_LEN	32
+/* Number of packets hashed at once by rte_thash_mbuf_bulk() */
+#define THASH_MBUF_BATCH	32
 
 #define RETA_SZ_IN_RANGE(reta_sz)	((reta_sz >= RTE_THASH_RETA_SZ_MIN) &&\
 					(reta_sz <= RTE_THASH_RETA_SZ_MAX))
@@ -88,6 +92,8 @@ struct rte_thash_ctx {
 	uint32_t	flags;
 	uint64_t	*matrices;
 	/**< matrices used with rte_thash_gfni implementation */
+	uint32_t	*lut;
+	/**< per byte lookup table used by rte_thash_mbuf_bulk without GFNI */
 	uint8_t		hash_key[0];
 };
 
@@ -121,6 +127,37 @@ rte_thash_complete_matrix(uint64_t *matrixes, const uint8_t *rss_key, int size)
 	}
 }
 
+/*
+ * Fill the per byte lookup table of the Toeplitz hash: entry [i][v] is
+ * the hash contribution of the byte value v at offset i of the tuple.
+ * The key must be at least RTE_THASH_MBUF_TUPLE_MAX + 4 bytes long.
+ */
+static void
+thash_complete_lut(uint32_t *lut, const uint8_t *rss_key)
+{
+	unsigned int i, j, v;
+	uint64_t window;
+	uint32_t val;
+
+	for (i = 0; i < RTE_THASH_MBUF_TUPLE_MAX; i++) {
+		/* 40 bits of the key starting at the byte i */
+		window = (uint64_t)rss_key[i] << 32 |
+			(uint64_t)rss_key[i + 1] << 24 |
+			(uint64_t)rss_key[i + 2] << 16 |
+			(uint64_t)rss_key[i + 3] << 8 |
+			(uint64_t)rss_key[i + 4];
+		for (v = 0; v < 256; v++) {
+			val = 0;
+			for (j = 0; j < CHAR_BIT; j++) {
+				if (v & (0x80 >> j))
+					val ^= (uint32_t)(window >>
+						(CHAR_BIT - j));
+			}
+			lut[i * 256 + v] = val;
+		}
+	}
+}
+
 static inline uint32_t
 get_bit_lfsr(struct thash_lfsr *lfsr)
 {
@@ -279,6 +316,16 @@ rte_thash_init_ctx(const char *name, uint32_t key_len, uint32_t reta_sz,
 
 		rte_thash_complete_matrix(ctx->matrices, ctx->hash_key,
 			key_len);
+	} else if (key_len >= RTE_THASH_MBUF_TUPLE_MAX + sizeof(uint32_t)) {
+		ctx->lut = rte_zmalloc(NULL, RTE_THASH_MBUF_TUPLE_MAX * 256 *
+			sizeof(uint32_t), RTE_CACHE_LINE_SIZE);
+		if (ctx->lut == NULL) {
+			RTE_LOG(ERR, HASH, "Cannot allocate lookup table\n");
+			rte_errno = ENOMEM;
+			goto free_ctx;
+		}
+
+		thash_complete_lut(ctx->lut, ctx->hash_key);
 	}
 
 	te->data = (void *)ctx;
@@ -353,6 +400,8 @@ rte_thash_free_ctx(struct rte_thash_ctx *ctx)
 		rte_free(tmp);
 	}
 
+	rte_free(ctx->matrices);
+	rte_free(ctx->lut);
 	rte_free(ctx);
 	rte_free(te);
 }
@@ -406,6 +455,8 @@ generate_subkey(struct rte_thash_ctx *ctx, struct thash_lfsr *lfsr,
 	if (ctx->matrices != NULL)
 		rte_thash_complete_matrix(ctx->matrices, ctx->hash_key,
 			ctx->key_len);
+	if (ctx->lut != NULL)
+		thash_complete_lut(ctx->lut, ctx->hash_key);
 
 	return 0;
 }
@@ -824,3 +875,126 @@ rte_thash_adjust_tuple(struct rte_thash_ctx *ctx,
 
 	return ret;
 }
+
+/*
+ * Extract the RSS tuple of a packet in network byte order:
+ * source and destination addresses, then source and destination ports.
+ * Returns the length of the tuple, 0 if the packet is not IP.
+ */
+static uint32_t
+thash_mbuf_tuple(const struct rte_mbuf *m, uint8_t *tuple, uint32_t flags)
+{
+	struct rte_net_hdr_lens hdr_lens;
+	const struct rte_ipv4_hdr *ipv4_hdr;
+	const struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv4_hdr ipv4_copy;
+	struct rte_ipv6_hdr ipv6_copy;
+	const uint32_t *ports;
+	uint32_t ports_copy;
+	uint32_t ptype, l4_type, len;
+
+	ptype = rte_net_get_ptype(m, &hdr_lens,
+		RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK | RTE_PTYPE_L4_MASK);
+
+	if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+		ipv4_hdr = rte_pktmbuf_read(m, hdr_lens.l2_len,
+			sizeof(*ipv4_hdr), &ipv4_copy);
+		if (ipv4_hdr == NULL)
+			return 0;
+		memcpy(tuple, &ipv4_hdr->src_addr, 2 * sizeof(uint32_t));
+		len = RTE_THASH_V4_L3_LEN * sizeof(uint32_t);
+	} else if (RTE_ETH_IS_IPV6_HDR(ptype)) {
+		ipv6_hdr = rte_pktmbuf_read(m, hdr_lens.l2_len,
+			sizeof(*ipv6_hdr), &ipv6_copy);
+		if (ipv6_hdr == NULL)
+			return 0;
+		memcpy(tuple, ipv6_hdr->src_addr, 2 * sizeof(ipv6_hdr->src_addr));
+		len = RTE_THASH_V6_L3_LEN * sizeof(uint32_t);
+	} else
+		return 0;
+
+	if ((flags & RTE_THASH_MBUF_L4) == 0)
+		return len;
+
+	/* Fragments are hashed on the addresses only */
+	l4_type = ptype & RTE_PTYPE_L4_MASK;
+	if (l4_type != RTE_PTYPE_L4_TCP && l4_type != RTE_PTYPE_L4_UDP &&
+			l4_type != RTE_PTYPE_L4_SCTP)
+		return len;
+
+	/* TCP, UDP and SCTP headers all start with the two ports */
+	ports = rte_pktmbuf_read(m, hdr_lens.l2_len + hdr_lens.l3_len,
+		sizeof(*ports), &ports_copy);
+	if (ports == NULL)
+		return len;
+	memcpy(tuple + len, ports, sizeof(*ports));
+
+	return len + sizeof(*ports);
+}
+
+/* Toeplitz hash of a tuple using the per byte lookup table */
+static inline uint32_t
+thash_lut(const uint32_t *lut, const uint8_t *tuple, uint32_t len)
+{
+	uint32_t i, val = 0;
+
+	for (i = 0; i < len; i++)
+		val ^= lut[i * 256 + tuple[i]];
+
+	return val;
+}
+
+int
+rte_thash_mbuf_bulk(struct rte_thash_ctx *ctx, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint32_t flags)
+{
+	uint8_t tuples[THASH_MBUF_BATCH][RTE_THASH_MBUF_TUPLE_MAX];
+	uint8_t *tuple_ptrs[THASH_MBUF_BATCH];
+	struct rte_mbuf *hashed[THASH_MBUF_BATCH];
+	uint32_t tuple_len[THASH_MBUF_BATCH];
+	uint32_t val[THASH_MBUF_BATCH];
+	uint32_t i, j, n, len, max_len;
+	int ret = 0;
+
+	if ((ctx == NULL) || ((pkts == NULL) && (nb_pkts != 0)) ||
+			(ctx->key_len < RTE_THASH_MBUF_TUPLE_MAX +
+			sizeof(uint32_t)))
+		return -EINVAL;
+
+	for (i = 0; i < nb_pkts; i += THASH_MBUF_BATCH) {
+		n = 0;
+		max_len = 0;
+		for (j = i; j < RTE_MIN(i + THASH_MBUF_BATCH, nb_pkts); j++) {
+			len = thash_mbuf_tuple(pkts[j], tuples[n], flags);
+			if (len == 0) {
+				pkts[j]->ol_flags &= ~RTE_MBUF_F_RX_RSS_HASH;
+				continue;
+			}
+			tuple_ptrs[n] = tuples[n];
+			tuple_len[n] = len;
+			hashed[n++] = pkts[j];
+			max_len = RTE_MAX(max_len, len);
+		}
+
+		if (ctx->matrices != NULL) {
+			/* Zero padding does not change the hash value */
+			for (j = 0; j < n; j++)
+				memset(tuples[j] + tuple_len[j], 0,
+					max_len - tuple_len[j]);
+			rte_thash_gfni_bulk(ctx->matrices, max_len, tuple_ptrs,
+				val, n);
+		} else {
+			for (j = 0; j < n; j++)
+				val[j] = thash_lut(ctx->lut, tuples[j],
+					tuple_len[j]);
+		}
+
+		for (j = 0; j < n; j++) {
+			hashed[j]->hash.rss = val[j];
+			hashed[j]->ol_flags |= RTE_MBUF_F_RX_RSS_HASH;
+		}
+		ret += n;
+	}
+
+	return ret;
+}
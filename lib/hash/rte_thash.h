@@ -493,6 +493,51 @@ rte_thash_adjust_tuple(struct rte_thash_ctx *ctx,
 	uint32_t desired_value, unsigned int attempts,
 	rte_thash_check_tuple_t fn, void *userdata);
 
+/**
+ * Maximum length in bytes of the tuples hashed by rte_thash_mbuf_bulk(),
+ * i.e. IPv6 addresses and L4 ports.
+ */
+#define RTE_THASH_MBUF_TUPLE_MAX	(RTE_THASH_V6_L4_LEN * 4)
+
+/**
+ * Make rte_thash_mbuf_bulk() hash the TCP, UDP and SCTP ports
+ * along with the IP addresses.
+ */
+#define RTE_THASH_MBUF_L4	0x1
+
+struct rte_mbuf;
+
+/**
+ * Compute the Toeplitz hash of a burst of packets, the way a NIC does RSS.
+ * The IPv4 or IPv6 tuple of each packet is extracted according to its
+ * headers: source and destination addresses, followed by source and
+ * destination ports if RTE_THASH_MBUF_L4 is set and the packet is a
+ * non-fragmented TCP, UDP or SCTP one.
+ * The hash is written into mbuf->hash.rss and RTE_MBUF_F_RX_RSS_HASH
+ * is set. The flag is cleared on packets which are not IP.
+ * GFNI is used when supported, a per byte lookup table otherwise.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @param ctx
+ *  Thash context, whose key must be at least
+ *  RTE_THASH_MBUF_TUPLE_MAX + 4 bytes long.
+ * @param pkts
+ *  Array of packets to hash.
+ * @param nb_pkts
+ *  Number of packets in the array.
+ * @param flags
+ *  0 or RTE_THASH_MBUF_L4.
+ * @return
+ *  Number of packets hashed on success,
+ *  -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_thash_mbuf_bulk(struct rte_thash_ctx *ctx, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint32_t flags);
+
 #ifdef __cplusplus
 }
 #endif
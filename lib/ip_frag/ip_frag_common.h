@@ -34,6 +34,19 @@
 #define	IP_FRAG_TBL_STAT_UPDATE(s, f, v)	do {} while (0)
 #endif /* IP_FRAG_TBL_STAT */
 
+/* number of fragments hashed and prefetched at once by the bulk API */
+#define IP_FRAG_BULK_SIZE	32
+
+/* fragment fields gathered by the first pass of the bulk reassembly */
+struct ip_frag_info {
+	struct ip_frag_key key; /* fragmentation key */
+	uint32_t sig[2];        /* hash values of the two buckets */
+	int32_t len;            /* length of fragment */
+	int32_t trim;           /* padding after the fragment */
+	uint16_t ofs;           /* offset into the packet */
+	uint16_t more_frags;    /* more fragments follow */
+};
+
 /* internal functions declarations */
 struct rte_mbuf * ip_frag_process(struct ip_frag_pkt *fp,
 		struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb,
@@ -47,6 +60,11 @@ struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
 
+uint32_t ip_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+	struct ip_frag_info *info, uint32_t num, uint64_t tms,
+	struct rte_mbuf **out);
+
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf *ipv4_frag_reassemble(struct ip_frag_pkt *fp);
 struct rte_mbuf *ipv6_frag_reassemble(struct ip_frag_pkt *fp);
@@ -6,6 +6,7 @@
 
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
+#include <rte_prefetch.h>
 
 #include "ip_frag_common.h"
 
@@ -14,6 +15,13 @@
 #define	IP_FRAG_TBL_POS(tbl, sig)	\
 	((tbl)->pkt + ((sig) & (tbl)->entry_mask))
 
+/* number of entries of each bucket prefetched by the bulk API */
+#define	IP_FRAG_PREFETCH_ENTRIES	4
+
+static struct ip_frag_pkt *ip_frag_lookup_sig(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
+
 static inline void
 ip_frag_tbl_add(struct rte_ip_frag_tbl *tbl,  struct ip_frag_pkt *fp,
 	const struct ip_frag_key *key, uint64_t tms)
@@ -87,6 +95,37 @@ ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
 	*v2 = (v << 7) + (v >> 14);
 }
 
+/* different hashing methods for IPv4 and IPv6 */
+static inline void
+ip_frag_key_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
+{
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, v1, v2);
+	else
+		ipv6_frag_hash(key, v1, v2);
+}
+
+/*
+ * Prefetch the keys of the first entries of the two buckets of a
+ * fragment, new entries are added at the first free place.
+ */
+static inline void
+ip_frag_tbl_prefetch(const struct rte_ip_frag_tbl *tbl, uint32_t sig1,
+	uint32_t sig2)
+{
+	const struct ip_frag_pkt *p1, *p2;
+	uint32_t i, n;
+
+	p1 = IP_FRAG_TBL_POS(tbl, sig1);
+	p2 = IP_FRAG_TBL_POS(tbl, sig2);
+	n = RTE_MIN(tbl->bucket_entries, (uint32_t)IP_FRAG_PREFETCH_ENTRIES);
+
+	for (i = 0; i != n; i++) {
+		rte_prefetch0(&p1[i].key);
+		rte_prefetch0(&p2[i].key);
+	}
+}
+
 struct rte_mbuf *
 ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 	struct rte_mbuf *mb, uint16_t ofs, uint16_t len, uint16_t more_frags)
@@ -218,9 +257,9 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
  * If such entry is not present, then allocate a new one.
  * If the entry is stale, then free and reuse it.
  */
-struct ip_frag_pkt *
-ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	const struct ip_frag_key *key, uint64_t tms)
+static inline struct ip_frag_pkt *
+ip_frag_find_sig(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, const uint32_t *sig, uint64_t tms)
 {
 	struct ip_frag_pkt *pkt, *free, *stale, *lru;
 	uint64_t max_cycles;
@@ -235,7 +274,17 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 
 	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
 
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	/* the bulk API hashed the key before */
+	if (sig == NULL)
+		pkt = ip_frag_lookup(tbl, key, tms, &free, &stale);
+	else if (tbl->last != NULL &&
+			ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		pkt = tbl->last;
+	else
+		pkt = ip_frag_lookup_sig(tbl, key, sig[0], sig[1], tms,
+			&free, &stale);
+
+	if (pkt == NULL) {
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
@@ -252,6 +301,8 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 			lru = TAILQ_FIRST(&tbl->lru);
 			if (max_cycles + lru->start < tms) {
 				ip_frag_tbl_del(tbl, dr, lru);
+				IP_FRAG_TBL_STAT_UPDATE(&tbl->stat,
+					lru_evict_num, 1);
 			} else {
 				free = NULL;
 				IP_FRAG_TBL_STAT_UPDATE(&tbl->stat,
@@ -280,15 +331,90 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 	return pkt;
 }
 
+struct ip_frag_pkt *
+ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint64_t tms)
+{
+	return ip_frag_find_sig(tbl, dr, key, NULL, tms);
+}
+
 struct ip_frag_pkt *
 ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
+{
+	uint32_t sig1, sig2;
+
+	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		return tbl->last;
+
+	ip_frag_key_hash(key, &sig1, &sig2);
+
+	return ip_frag_lookup_sig(tbl, key, sig1, sig2, tms, free, stale);
+}
+
+/*
+ * Process a burst of fragments, whose keys and lengths are in info.
+ * All the keys are hashed and their buckets prefetched first, then
+ * the fragments are processed in order.
+ */
+uint32_t
+ip_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+	struct ip_frag_info *info, uint32_t num, uint64_t tms,
+	struct rte_mbuf **out)
+{
+	struct ip_frag_pkt *fp;
+	struct rte_mbuf *m;
+	uint32_t i, k;
+
+	for (i = 0; i != num; i++) {
+		ip_frag_key_hash(&info[i].key, &info[i].sig[0],
+			&info[i].sig[1]);
+		ip_frag_tbl_prefetch(tbl, info[i].sig[0], info[i].sig[1]);
+	}
+
+	k = 0;
+	for (i = 0; i != num; i++) {
+		m = mb[i];
+
+		/* check that fragment length is greater then zero. */
+		if (info[i].len <= 0) {
+			IP_FRAG_MBUF2DR(dr, m);
+			continue;
+		}
+
+		if (unlikely(info[i].trim > 0))
+			rte_pktmbuf_trim(m, info[i].trim);
+
+		/* try to find/add entry into the fragment's table. */
+		fp = ip_frag_find_sig(tbl, dr, &info[i].key, info[i].sig, tms);
+		if (fp == NULL) {
+			IP_FRAG_MBUF2DR(dr, m);
+			continue;
+		}
+
+		/* process the fragmented packet. */
+		m = ip_frag_process(fp, dr, m, info[i].ofs, info[i].len,
+			info[i].more_frags);
+		ip_frag_inuse(tbl, fp);
+
+		if (m != NULL)
+			out[k++] = m;
+	}
+
+	return k;
+}
+
+static struct ip_frag_pkt *
+ip_frag_lookup_sig(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc;
 
 	empty = NULL;
 	old = NULL;
@@ -296,15 +422,6 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	max_cycles = tbl->max_cycles;
 	assoc = tbl->bucket_entries;
 
-	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
-		return tbl->last;
-
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
-
 	p1 = IP_FRAG_TBL_POS(tbl, sig1);
 	p2 = IP_FRAG_TBL_POS(tbl, sig2);
 
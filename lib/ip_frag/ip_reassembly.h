@@ -67,6 +67,7 @@ struct ip_frag_tbl_stat {
 	uint64_t add_num;      /* # of add ops. */
 	uint64_t del_num;      /* # of del ops. */
 	uint64_t reuse_num;    /* # of reuse (del/add) ops. */
+	uint64_t lru_evict_num; /* # of del ops of the LRU head to add. */
 	uint64_t fail_total;   /* total # of add failures. */
 	uint64_t fail_nospace; /* # of 'no space' add failures. */
 } __rte_cache_aligned;
@@ -83,7 +84,13 @@ struct rte_ip_frag_tbl {
 	struct ip_frag_pkt *last;     /* last used entry. */
 	struct ip_pkt_list lru;       /* LRU list for table entries. */
 	struct ip_frag_tbl_stat stat; /* statistics counters. */
+	RTE_TAILQ_ENTRY(rte_ip_frag_tbl) next; /* list of all tables. */
+	uint32_t id;             /* table id for telemetry. */
+	int socket_id;           /* socket the table is allocated on. */
 	__extension__ struct ip_frag_pkt pkt[]; /* hash table. */
 };
 
+/* list of all fragmentation tables */
+RTE_TAILQ_HEAD(ip_frag_tbl_list, rte_ip_frag_tbl);
+
 #endif /* _IP_REASSEMBLY_H_ */
@@ -129,6 +129,43 @@ struct rte_mbuf *rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv6_hdr *ip_hdr,
 		struct rte_ipv6_fragment_ext *frag_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function implements reassembly of a burst of fragmented IPv6
+ * packets. The fragment keys of the burst are hashed and the table
+ * buckets prefetched before the fragments are processed, in the order
+ * of the burst, like with rte_ipv6_frag_reassemble_packet().
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly,
+ * the fragment extension header must immediately follow the IPv6 header
+ * and be included in l3_len.
+ *
+ * The death row must have room for (RTE_LIBRTE_IP_FRAG_MAX_FRAG + 1) mbufs
+ * per fragment of the burst, e.g. it must be emptied every
+ * RTE_IP_FRAG_DEATH_ROW_LEN fragments.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param mb
+ *   Array of incoming mbufs with IPv6 fragments.
+ * @param nb_pkts
+ *   Number of mbufs in the mb array.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @param out
+ *   Array where to store the reassembled packets. It has room for
+ *   nb_pkts mbufs, and can be the mb array.
+ * @return
+ *   Number of reassembled packets stored in out.
+ */
+__rte_experimental
+uint16_t rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+		uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
 /**
  * Return a pointer to the packet's fragment header, if found.
  * It only looks at the extension header that's right after the fixed IPv6
@@ -236,6 +273,41 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv4_hdr *ip_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function implements reassembly of a burst of fragmented IPv4
+ * packets. The fragment keys of the burst are hashed and the table
+ * buckets prefetched before the fragments are processed, in the order
+ * of the burst, like with rte_ipv4_frag_reassemble_packet().
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ *
+ * The death row must have room for (RTE_LIBRTE_IP_FRAG_MAX_FRAG + 1) mbufs
+ * per fragment of the burst, e.g. it must be emptied every
+ * RTE_IP_FRAG_DEATH_ROW_LEN fragments.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param mb
+ *   Array of incoming mbufs with IPv4 fragments.
+ * @param nb_pkts
+ *   Number of mbufs in the mb array.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @param out
+ *   Array where to store the reassembled packets. It has room for
+ *   nb_pkts mbufs, and can be the mb array.
+ * @return
+ *   Number of reassembled packets stored in out.
+ */
+__rte_experimental
+uint16_t rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+		uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
 /**
  * Check if the IPv4 packet is fragmented
  *
@@ -279,6 +351,47 @@ void rte_ip_frag_free_death_row(struct rte_ip_frag_death_row *dr,
 void
 rte_ip_frag_table_statistics_dump(FILE * f, const struct rte_ip_frag_tbl *tbl);
 
+/**
+ * IP fragmentation table statistics.
+ *
+ * The counters are only maintained when the library is built with
+ * RTE_LIBRTE_IP_FRAG_TBL_STAT, the number of entries always are.
+ */
+struct rte_ip_frag_tbl_stats {
+	uint32_t max_entries;   /**< Maximum number of entries. */
+	uint32_t use_entries;   /**< Number of entries in use. */
+	uint64_t find_num;      /**< Number of find/insert attempts. */
+	uint64_t add_num;       /**< Number of entries added. */
+	uint64_t del_num;       /**< Number of entries deleted by timeout. */
+	uint64_t reuse_num;     /**< Number of entries reused by timeout. */
+	/**
+	 * Number of timed out entries deleted from the head of the LRU
+	 * list to add a new one, when the table is full. They are also
+	 * counted in del_num.
+	 */
+	uint64_t lru_evict_num;
+	uint64_t fail_total;    /**< Number of add failures. */
+	uint64_t fail_nospace;  /**< Number of add failures for lack of space. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of a fragmentation table.
+ *
+ * @param tbl
+ *   Fragmentation table to get statistics from
+ * @param stats
+ *   Structure to fill with the statistics
+ * @return
+ *   0 on success, -EINVAL if a parameter is NULL.
+ */
+__rte_experimental
+int
+rte_ip_frag_table_stats_get(const struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_tbl_stats *stats);
+
 /**
  * Delete expired fragments
  *
@@ -2,15 +2,25 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <rte_log.h>
+#include <rte_spinlock.h>
+#include <rte_telemetry.h>
 
 #include "ip_frag_common.h"
 
 #define	IP_FRAG_HASH_FNUM	2
 
+/* tables of the process, listed by telemetry */
+static struct ip_frag_tbl_list ip_frag_tbl_list =
+	TAILQ_HEAD_INITIALIZER(ip_frag_tbl_list);
+static rte_spinlock_t ip_frag_tbl_lock = RTE_SPINLOCK_INITIALIZER;
+static uint32_t ip_frag_tbl_next_id;
+
 /* free mbufs from death row */
 void
 rte_ip_frag_free_death_row(struct rte_ip_frag_death_row *dr,
@@ -75,7 +85,15 @@ rte_ip_frag_table_create(uint32_t bucket_num, uint32_t bucket_entries,
 	tbl->bucket_entries = bucket_entries;
 	tbl->entry_mask = (tbl->nb_entries - 1) & ~(tbl->bucket_entries  - 1);
 
+	tbl->socket_id = socket_id;
+
 	TAILQ_INIT(&(tbl->lru));
+
+	rte_spinlock_lock(&ip_frag_tbl_lock);
+	tbl->id = ip_frag_tbl_next_id++;
+	TAILQ_INSERT_TAIL(&ip_frag_tbl_list, tbl, next);
+	rte_spinlock_unlock(&ip_frag_tbl_lock);
+
 	return tbl;
 }
 
@@ -85,6 +103,13 @@ rte_ip_frag_table_destroy(struct rte_ip_frag_tbl *tbl)
 {
 	struct ip_frag_pkt *fp;
 
+	if (tbl == NULL)
+		return;
+
+	rte_spinlock_lock(&ip_frag_tbl_lock);
+	TAILQ_REMOVE(&ip_frag_tbl_list, tbl, next);
+	rte_spinlock_unlock(&ip_frag_tbl_lock);
+
 	TAILQ_FOREACH(fp, &tbl->lru, lru) {
 		ip_frag_free_immediate(fp);
 	}
@@ -107,6 +132,7 @@ rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
 		"entries added:\t%" PRIu64 ";\n"
 		"entries deleted by timeout:\t%" PRIu64 ";\n"
 		"entries reused by timeout:\t%" PRIu64 ";\n"
+		"entries evicted from LRU:\t%" PRIu64 ";\n"
 		"total add failures:\t%" PRIu64 ";\n"
 		"add no-space failures:\t%" PRIu64 ";\n"
 		"add hash-collisions failures:\t%" PRIu64 ";\n",
@@ -116,11 +142,33 @@ rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
 		tbl->stat.add_num,
 		tbl->stat.del_num,
 		tbl->stat.reuse_num,
+		tbl->stat.lru_evict_num,
 		fail_total,
 		fail_nospace,
 		fail_total - fail_nospace);
 }
 
+/* get frag table statistics */
+int
+rte_ip_frag_table_stats_get(const struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_tbl_stats *stats)
+{
+	if (tbl == NULL || stats == NULL)
+		return -EINVAL;
+
+	stats->max_entries = tbl->max_entries;
+	stats->use_entries = tbl->use_entries;
+	stats->find_num = tbl->stat.find_num;
+	stats->add_num = tbl->stat.add_num;
+	stats->del_num = tbl->stat.del_num;
+	stats->reuse_num = tbl->stat.reuse_num;
+	stats->lru_evict_num = tbl->stat.lru_evict_num;
+	stats->fail_total = tbl->stat.fail_total;
+	stats->fail_nospace = tbl->stat.fail_nospace;
+
+	return 0;
+}
+
 /* Delete expired fragments */
 void
 rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
@@ -142,3 +190,77 @@ rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
 		} else
 			return;
 }
+
+static int
+ip_frag_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct rte_ip_frag_tbl *tbl;
+
+	rte_tel_data_start_array(d, RTE_TEL_UINT_VAL);
+	rte_spinlock_lock(&ip_frag_tbl_lock);
+	TAILQ_FOREACH(tbl, &ip_frag_tbl_list, next)
+		rte_tel_data_add_array_uint(d, tbl->id);
+	rte_spinlock_unlock(&ip_frag_tbl_lock);
+
+	return 0;
+}
+
+static int
+ip_frag_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_ip_frag_tbl_stats stats;
+	struct rte_ip_frag_tbl *tbl;
+	unsigned long id;
+	char *end;
+	int ret = -ENOENT;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	errno = 0;
+	id = strtoul(params, &end, 0);
+	if (errno != 0 || *end != '\0' || id > UINT32_MAX)
+		return -EINVAL;
+
+	rte_spinlock_lock(&ip_frag_tbl_lock);
+	TAILQ_FOREACH(tbl, &ip_frag_tbl_list, next) {
+		if (tbl->id != id)
+			continue;
+
+		rte_ip_frag_table_stats_get(tbl, &stats);
+		rte_tel_data_start_dict(d);
+		rte_tel_data_add_dict_uint(d, "id", tbl->id);
+		rte_tel_data_add_dict_int(d, "socket_id", tbl->socket_id);
+		rte_tel_data_add_dict_uint(d, "nb_entries", tbl->nb_entries);
+		rte_tel_data_add_dict_uint(d, "nb_buckets", tbl->nb_buckets);
+		rte_tel_data_add_dict_uint(d, "bucket_entries",
+			tbl->bucket_entries);
+		rte_tel_data_add_dict_uint(d, "max_cycles", tbl->max_cycles);
+		rte_tel_data_add_dict_uint(d, "max_entries", stats.max_entries);
+		rte_tel_data_add_dict_uint(d, "use_entries", stats.use_entries);
+		rte_tel_data_add_dict_uint(d, "find_num", stats.find_num);
+		rte_tel_data_add_dict_uint(d, "add_num", stats.add_num);
+		rte_tel_data_add_dict_uint(d, "del_num", stats.del_num);
+		rte_tel_data_add_dict_uint(d, "reuse_num", stats.reuse_num);
+		rte_tel_data_add_dict_uint(d, "lru_evict_num",
+			stats.lru_evict_num);
+		rte_tel_data_add_dict_uint(d, "fail_total", stats.fail_total);
+		rte_tel_data_add_dict_uint(d, "fail_nospace",
+			stats.fail_nospace);
+		ret = 0;
+		break;
+	}
+	rte_spinlock_unlock(&ip_frag_tbl_lock);
+
+	return ret;
+}
+
+RTE_INIT(ip_frag_init_telemetry)
+{
+	rte_telemetry_register_cmd("/ip_frag/list", ip_frag_handle_list,
+		"Returns list of IP fragmentation table ids. Takes no parameters");
+	rte_telemetry_register_cmd("/ip_frag/info", ip_frag_handle_info,
+		"Returns IP fragmentation table info and statistics. Parameters: table id");
+}
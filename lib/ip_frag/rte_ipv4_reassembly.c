@@ -171,3 +171,63 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Process a burst of mbufs with fragments of IPV4 packets.
+ * The IPv4 headers of the whole burst are read and the keys hashed
+ * first, so that the table buckets are prefetched before the
+ * fragments are processed.
+ */
+uint16_t
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	struct ip_frag_info info[IP_FRAG_BULK_SIZE];
+	const unaligned_uint64_t *psd;
+	struct rte_ipv4_hdr *ip_hdr;
+	struct rte_mbuf *m;
+	uint16_t flag_offset;
+	uint32_t i, n, base, k;
+
+	k = 0;
+	for (base = 0; base < nb_pkts; base += n) {
+		n = RTE_MIN(nb_pkts - base, (uint32_t)IP_FRAG_BULK_SIZE);
+
+		for (i = 0; i != n; i++) {
+			m = mb[base + i];
+			rte_prefetch0(rte_pktmbuf_mtod_offset(m, void *,
+				m->l2_len));
+		}
+
+		for (i = 0; i != n; i++) {
+			m = mb[base + i];
+			ip_hdr = rte_pktmbuf_mtod_offset(m,
+				struct rte_ipv4_hdr *, m->l2_len);
+
+			flag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
+			info[i].ofs = (uint16_t)(flag_offset &
+				RTE_IPV4_HDR_OFFSET_MASK) *
+				RTE_IPV4_HDR_OFFSET_UNITS;
+			info[i].more_frags = (uint16_t)(flag_offset &
+				RTE_IPV4_HDR_MF_FLAG);
+
+			psd = (unaligned_uint64_t *)&ip_hdr->src_addr;
+			/* use first 8 bytes only */
+			info[i].key.src_dst[0] = psd[0];
+			info[i].key.id = ip_hdr->packet_id;
+			info[i].key.key_len = IPV4_KEYLEN;
+
+			info[i].len = rte_be_to_cpu_16(ip_hdr->total_length) -
+				m->l3_len;
+			info[i].trim = m->pkt_len -
+				(info[i].len + m->l3_len + m->l2_len);
+		}
+
+		/* out may be mb, it never gets ahead of the next burst. */
+		k += ip_frag_reassemble_bulk(tbl, dr, &mb[base], info, n, tms,
+			&out[k]);
+	}
+
+	return k;
+}
@@ -216,3 +216,60 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Process a burst of mbufs with fragments of IPV6 datagrams.
+ * The IPv6 headers of the whole burst are read and the keys hashed
+ * first, so that the table buckets are prefetched before the
+ * fragments are processed.
+ */
+uint16_t
+rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mb,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	struct ip_frag_info info[IP_FRAG_BULK_SIZE];
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ip_hdr;
+	struct rte_mbuf *m;
+	uint32_t i, n, base, k;
+
+	k = 0;
+	for (base = 0; base < nb_pkts; base += n) {
+		n = RTE_MIN(nb_pkts - base, (uint32_t)IP_FRAG_BULK_SIZE);
+
+		for (i = 0; i != n; i++) {
+			m = mb[base + i];
+			rte_prefetch0(rte_pktmbuf_mtod_offset(m, void *,
+				m->l2_len));
+		}
+
+		for (i = 0; i != n; i++) {
+			m = mb[base + i];
+			ip_hdr = rte_pktmbuf_mtod_offset(m,
+				struct rte_ipv6_hdr *, m->l2_len);
+			/* only the fragment header may follow the IPv6 one */
+			frag_hdr = (struct rte_ipv6_fragment_ext *)(ip_hdr + 1);
+
+			rte_memcpy(&info[i].key.src_dst[0], ip_hdr->src_addr,
+				16);
+			rte_memcpy(&info[i].key.src_dst[2], ip_hdr->dst_addr,
+				16);
+			info[i].key.id = frag_hdr->id;
+			info[i].key.key_len = IPV6_KEYLEN;
+
+			info[i].ofs = FRAG_OFFSET(frag_hdr->frag_data) * 8;
+			info[i].more_frags = MORE_FRAGS(frag_hdr->frag_data);
+			info[i].len = rte_be_to_cpu_16(ip_hdr->payload_len) -
+				sizeof(*frag_hdr);
+			info[i].trim = m->pkt_len -
+				(info[i].len + m->l3_len + m->l2_len);
+		}
+
+		/* out may be mb, it never gets ahead of the next burst. */
+		k += ip_frag_reassemble_bulk(tbl, dr, &mb[base], info, n, tms,
+			&out[k]);
+	}
+
+	return k;
+}
@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "lpm6_vec.h"
+
+#define LPM6_AVX2_IPS	8
+
+/*
+ * Load 8 IPs and transpose them, so that chunk[j] holds the j-th
+ * 4-byte chunk of every IP. The lanes come out in 0,2,4,6,1,3,5,7 IP order.
+ */
+static __rte_always_inline void
+transpose_x8(uint8_t ips[LPM6_AVX2_IPS][RTE_LPM6_IPV6_ADDR_SIZE],
+	__m256i chunk[4])
+{
+	__m256i r0, r1, r2, r3, t0, t1, t2, t3;
+
+	r0 = _mm256_loadu_si256((const __m256i *)ips[0]);
+	r1 = _mm256_loadu_si256((const __m256i *)ips[2]);
+	r2 = _mm256_loadu_si256((const __m256i *)ips[4]);
+	r3 = _mm256_loadu_si256((const __m256i *)ips[6]);
+
+	t0 = _mm256_unpacklo_epi32(r0, r1);
+	t1 = _mm256_unpackhi_epi32(r0, r1);
+	t2 = _mm256_unpacklo_epi32(r2, r3);
+	t3 = _mm256_unpackhi_epi32(r2, r3);
+
+	chunk[0] = _mm256_unpacklo_epi64(t0, t2);
+	chunk[1] = _mm256_unpackhi_epi64(t0, t2);
+	chunk[2] = _mm256_unpacklo_epi64(t1, t3);
+	chunk[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+static __rte_always_inline void
+lookup_x8(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[LPM6_AVX2_IPS][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops)
+{
+	uint32_t i;
+	__m256i chunk[4];
+	__m256i bytes, ext, idx, res;
+
+	const __m256i byte_msk = _mm256_set1_epi32(UINT8_MAX);
+	const __m256i ext_msk = _mm256_set1_epi32(
+		RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m256i nh_msk = _mm256_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m256i hit_msk = _mm256_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	const __m256i miss = _mm256_set1_epi32(-1);
+	const __m256i lane_order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	const __m256i bswap = _mm256_setr_epi8(
+		2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1,
+		2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+
+	transpose_x8(ips, chunk);
+
+	/* tbl24 index is made of the first 3 bytes in network order. */
+	idx = _mm256_shuffle_epi8(chunk[0], bswap);
+	res = _mm256_i32gather_epi32((const int *)tbl24, idx, 4);
+
+	/* walk down tbl8s, all extended entries are at the same level. */
+	ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, ext_msk), ext_msk);
+	for (i = 3; i != RTE_LPM6_IPV6_ADDR_SIZE &&
+			_mm256_testz_si256(ext, ext) == 0; i++) {
+
+		bytes = _mm256_srl_epi32(chunk[i / 4],
+			_mm_cvtsi32_si128((i % 4) * CHAR_BIT));
+		bytes = _mm256_and_si256(bytes, byte_msk);
+
+		idx = _mm256_slli_epi32(_mm256_and_si256(res, nh_msk), 8);
+		idx = _mm256_add_epi32(idx, bytes);
+
+		res = _mm256_mask_i32gather_epi32(res, (const int *)tbl8, idx,
+			ext, 4);
+		ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, ext_msk),
+			ext_msk);
+	}
+
+	/* next hop on hit, -1 on miss. */
+	res = _mm256_blendv_epi8(miss, _mm256_and_si256(res, nh_msk),
+		_mm256_cmpeq_epi32(_mm256_and_si256(res, hit_msk), hit_msk));
+
+	res = _mm256_permutevar8x32_epi32(res, lane_order);
+	_mm256_storeu_si256((__m256i *)next_hops, res);
+}
+
+uint32_t
+lpm6_lookup_bulk_avx2(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i + LPM6_AVX2_IPS <= n; i += LPM6_AVX2_IPS)
+		lookup_x8(tbl24, tbl8, ips + i, next_hops + i);
+
+	return i;
+}
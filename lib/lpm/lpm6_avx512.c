@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "lpm6_vec.h"
+
+#define LPM6_AVX512_IPS	16
+
+/*
+ * Load 16 IPs and transpose them, so that chunk[j] holds the j-th
+ * 4-byte chunk of every IP. Lane 4 * k + m comes from IP 4 * m + k.
+ */
+static __rte_always_inline void
+transpose_x16(uint8_t ips[LPM6_AVX512_IPS][RTE_LPM6_IPV6_ADDR_SIZE],
+	__m512i chunk[4])
+{
+	__m512i r0, r1, r2, r3, t0, t1, t2, t3;
+
+	r0 = _mm512_loadu_si512(ips[0]);
+	r1 = _mm512_loadu_si512(ips[4]);
+	r2 = _mm512_loadu_si512(ips[8]);
+	r3 = _mm512_loadu_si512(ips[12]);
+
+	t0 = _mm512_unpacklo_epi32(r0, r1);
+	t1 = _mm512_unpackhi_epi32(r0, r1);
+	t2 = _mm512_unpacklo_epi32(r2, r3);
+	t3 = _mm512_unpackhi_epi32(r2, r3);
+
+	chunk[0] = _mm512_unpacklo_epi64(t0, t2);
+	chunk[1] = _mm512_unpackhi_epi64(t0, t2);
+	chunk[2] = _mm512_unpacklo_epi64(t1, t3);
+	chunk[3] = _mm512_unpackhi_epi64(t1, t3);
+}
+
+static __rte_always_inline void
+lookup_x16(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[LPM6_AVX512_IPS][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops)
+{
+	uint32_t i;
+	__mmask16 ext, hit;
+	__m512i chunk[4];
+	__m512i bytes, idx, res;
+
+	const __m512i byte_msk = _mm512_set1_epi32(UINT8_MAX);
+	const __m512i ext_msk = _mm512_set1_epi32(
+		RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m512i nh_msk = _mm512_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m512i hit_msk = _mm512_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	const __m512i miss = _mm512_set1_epi32(-1);
+	const __m512i lane_order = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13,
+		2, 6, 10, 14, 3, 7, 11, 15);
+
+	transpose_x16(ips, chunk);
+
+	/* tbl24 index is made of the first 3 bytes in network order. */
+	idx = _mm512_or_si512(
+		_mm512_slli_epi32(_mm512_and_si512(chunk[0], byte_msk), 16),
+		_mm512_and_si512(chunk[0], _mm512_set1_epi32(0xff00)));
+	idx = _mm512_or_si512(idx,
+		_mm512_and_si512(_mm512_srli_epi32(chunk[0], 16), byte_msk));
+	res = _mm512_i32gather_epi32(idx, tbl24, 4);
+
+	/* walk down tbl8s, all extended entries are at the same level. */
+	ext = _mm512_cmpeq_epi32_mask(_mm512_and_si512(res, ext_msk), ext_msk);
+	for (i = 3; i != RTE_LPM6_IPV6_ADDR_SIZE && ext != 0; i++) {
+
+		bytes = _mm512_srl_epi32(chunk[i / 4],
+			_mm_cvtsi32_si128((i % 4) * CHAR_BIT));
+		bytes = _mm512_and_si512(bytes, byte_msk);
+
+		idx = _mm512_slli_epi32(_mm512_and_si512(res, nh_msk), 8);
+		idx = _mm512_add_epi32(idx, bytes);
+
+		res = _mm512_mask_i32gather_epi32(res, ext, idx, tbl8, 4);
+		ext = _mm512_mask_cmpeq_epi32_mask(ext,
+			_mm512_and_si512(res, ext_msk), ext_msk);
+	}
+
+	/* next hop on hit, -1 on miss. */
+	hit = _mm512_test_epi32_mask(res, hit_msk);
+	res = _mm512_mask_and_epi32(miss, hit, res, nh_msk);
+
+	res = _mm512_permutexvar_epi32(lane_order, res);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+uint32_t
+lpm6_lookup_bulk_avx512(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i + LPM6_AVX512_IPS <= n; i += LPM6_AVX512_IPS)
+		lookup_x16(tbl24, tbl8, ips + i, next_hops + i);
+
+	return i;
+}
@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _LPM6_VEC_H_
+#define _LPM6_VEC_H_
+
+/**
+ * @file
+ * Internal definitions shared by the scalar and vector LPM6 lookups.
+ */
+
+#include <stdint.h>
+
+#include "rte_lpm6.h"
+
+#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
+
+#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
+#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
+#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
+
+/*
+ * Vector bulk lookups: process the IPs in groups of the vector width,
+ * return the number of IPs processed, the rest is left to the caller.
+ * tbl24 and tbl8 point to the tables of struct rte_lpm6 entries,
+ * taken as raw 32-bit values.
+ */
+uint32_t
+lpm6_lookup_bulk_avx2(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	uint32_t n);
+
+uint32_t
+lpm6_lookup_bulk_avx512(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops,
+	uint32_t n);
+
+#endif /* _LPM6_VEC_H_ */
@@ -18,17 +18,15 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
 
 #include "rte_lpm6.h"
+#include "lpm6_vec.h"
 
 #define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
-#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
 #define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
 
-#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
-#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
-#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
-
 #define ADD_FIRST_BYTE                            3
 #define LOOKUP_FIRST_BYTE                         4
 #define BYTE_SIZE                                 8
@@ -94,6 +92,7 @@ struct rte_lpm6 {
 	uint32_t max_rules;              /**< Max number of rules. */
 	uint32_t used_rules;             /**< Used rules so far. */
 	uint32_t number_tbl8s;           /**< Number of tbl8s to allocate. */
+	enum rte_lpm6_lookup_type lookup_type; /**< Bulk lookup method. */
 
 	/* LPM Tables. */
 	struct rte_hash *rules_tbl; /**< LPM rules. */
@@ -352,6 +351,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	lpm->rules_tbl = rules_tbl;
 	lpm->tbl8_pool = tbl8_pool;
 	lpm->tbl8_hdrs = tbl8_hdrs;
+	rte_lpm6_select_lookup(lpm, RTE_LPM6_LOOKUP_DEFAULT);
 
 	/* init the stack */
 	tbl8_pool_init(lpm);
@@ -985,7 +985,26 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
-	for (i = 0; i < n; i++) {
+	/* vector methods leave the tail of the burst to the scalar loop */
+	switch (lpm->lookup_type) {
+#ifdef CC_LPM6_AVX512_SUPPORT
+	case RTE_LPM6_LOOKUP_VECTOR_AVX512:
+		i = lpm6_lookup_bulk_avx512((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, n);
+		break;
+#endif
+#ifdef CC_LPM6_AVX2_SUPPORT
+	case RTE_LPM6_LOOKUP_VECTOR_AVX2:
+		i = lpm6_lookup_bulk_avx2((const uint32_t *)lpm->tbl24,
+			(const uint32_t *)lpm->tbl8, ips, next_hops, n);
+		break;
+#endif
+	default:
+		i = 0;
+		break;
+	}
+
+	for (; i < n; i++) {
 		first_byte = LOOKUP_FIRST_BYTE;
 		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
 				(ips[i][1] << BYTE_SIZE) | ips[i][2];
@@ -1011,6 +1030,57 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 	return 0;
 }
 
+/*
+ * Checks that the bulk lookup method can run on this machine.
+ */
+static int
+lookup_type_supported(enum rte_lpm6_lookup_type type)
+{
+	switch (type) {
+	case RTE_LPM6_LOOKUP_SCALAR:
+		return 1;
+#ifdef CC_LPM6_AVX2_SUPPORT
+	case RTE_LPM6_LOOKUP_VECTOR_AVX2:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256;
+#endif
+#ifdef CC_LPM6_AVX512_SUPPORT
+	case RTE_LPM6_LOOKUP_VECTOR_AVX512:
+		return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512;
+#endif
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Sets the bulk lookup method, the default one is the widest available.
+ */
+int
+rte_lpm6_select_lookup(struct rte_lpm6 *lpm, enum rte_lpm6_lookup_type type)
+{
+	static const enum rte_lpm6_lookup_type def[] = {
+		RTE_LPM6_LOOKUP_VECTOR_AVX512,
+		RTE_LPM6_LOOKUP_VECTOR_AVX2,
+		RTE_LPM6_LOOKUP_SCALAR,
+	};
+	uint32_t i;
+
+	if (lpm == NULL)
+		return -EINVAL;
+
+	if (type == RTE_LPM6_LOOKUP_DEFAULT) {
+		for (i = 0; !lookup_type_supported(def[i]); i++)
+			;
+		type = def[i];
+	} else if (!lookup_type_supported(type))
+		return -EINVAL;
+
+	lpm->lookup_type = type;
+	return 0;
+}
+
 /*
  * Look for a rule in the high-level rules table
  */
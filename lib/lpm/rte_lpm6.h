@@ -11,6 +11,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,6 +26,18 @@ extern "C" {
 /** LPM structure. */
 struct rte_lpm6;
 
+/** Bulk lookup implementations, see rte_lpm6_select_lookup(). */
+enum rte_lpm6_lookup_type {
+	/** Widest vector implementation the CPU supports. */
+	RTE_LPM6_LOOKUP_DEFAULT,
+	/** Generic implementation. */
+	RTE_LPM6_LOOKUP_SCALAR,
+	/** Looks up 8 IPs at once, requires AVX2 support. */
+	RTE_LPM6_LOOKUP_VECTOR_AVX2,
+	/** Looks up 16 IPs at once, requires AVX512F support. */
+	RTE_LPM6_LOOKUP_VECTOR_AVX512,
+};
+
 /** LPM configuration structure. */
 struct rte_lpm6_config {
 	uint32_t max_rules;      /**< Max number of rules. */
@@ -192,6 +206,27 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
 		int32_t *next_hops, unsigned int n);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the implementation used by rte_lpm6_lookup_bulk_func().
+ * The vector ones process the IPs in groups and give the same results
+ * as the scalar one. rte_lpm6_create() selects RTE_LPM6_LOOKUP_DEFAULT.
+ * This function is not multi-thread safe with respect to the lookups.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param type
+ *   Lookup implementation to use
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments or if the implementation
+ *   is not supported by the build, the CPU or the max SIMD bitwidth
+ */
+__rte_experimental
+int
+rte_lpm6_select_lookup(struct rte_lpm6 *lpm, enum rte_lpm6_lookup_type type);
+
 #ifdef __cplusplus
 }
 #endif
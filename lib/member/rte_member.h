@@ -94,6 +94,14 @@ typedef uint16_t member_set_t;
 #define RTE_MEMBER_SKETCH_ALWAYS_BOUNDED 0x01
 /** For sketch, use the flag if to count packet size instead of packet count */
 #define RTE_MEMBER_SKETCH_COUNT_BYTE 0x02
+/**
+ * For sketch, use the flag to count the packets or bytes of the last
+ * num_windows windows only, the window being advanced by the user with
+ * rte_member_advance_window(). Older counts decay out of the sketch.
+ */
+#define RTE_MEMBER_SKETCH_SLIDING_WINDOW 0x04
+/** Maximum number of windows of a sliding window sketch. */
+#define RTE_MEMBER_SKETCH_WINDOWS_MAX 16
 
 /** @internal Hash function used by membership library. */
 #if defined(RTE_ARCH_X86) || defined(__ARM_FEATURE_CRC32)
@@ -186,6 +194,7 @@ struct rte_member_setsum {
 	double converge_thresh;
 	uint32_t topk;
 	uint32_t count_byte;
+	uint32_t num_windows;	/* Number of windows, 0 if not sliding. */
 	uint64_t *hash_seeds;
 	sketch_update_fn_t sketch_update; /* Pointer to the sketch update function */
 	sketch_lookup_fn_t sketch_lookup; /* Pointer to the sketch lookup function */
@@ -348,6 +357,16 @@ struct rte_member_parameters {
 	uint32_t extra_flag;
 
 	int socket_id;			/**< NUMA Socket ID for memory. */
+
+	/**
+	 * num_windows is only used for sketch, when the
+	 * RTE_MEMBER_SKETCH_SLIDING_WINDOW flag is set in extra_flag.
+	 *
+	 * It is the number of windows counted by the sketch, between 2 and
+	 * RTE_MEMBER_SKETCH_WINDOWS_MAX. Each counter keeps one count per
+	 * window, so the sketch memory is multiplied by num_windows + 2.
+	 */
+	uint32_t num_windows;
 } __rte_cache_aligned;
 
 /**
@@ -584,6 +603,26 @@ rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
 			      void **keys, uint64_t *counts);
 
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Advance the window of a sliding window sketch.
+ *
+ * The counts added from now on go to a new window, and the counts of the
+ * oldest window are no longer reported. This does not depend on the size
+ * of the sketch, the top-k heavy hitters are refreshed with their
+ * new counts. It is typically called at a fixed time interval.
+ *
+ * @param setsum
+ *   Pointer of a set-summary created with RTE_MEMBER_SKETCH_SLIDING_WINDOW.
+ * @return
+ *   Return -EINVAL for invalid parameters, otherwise return 0.
+ */
+__rte_experimental
+int
+rte_member_advance_window(const struct rte_member_setsum *setsum);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
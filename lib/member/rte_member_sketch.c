@@ -30,8 +30,90 @@ struct sketch_runtime {
 	struct node *report_array;
 	void *key_slots;
 	struct rte_ring *free_key_slots;
+	uint64_t epoch;		/* Current window of a sliding window sketch. */
+	uint32_t cur_pane;	/* Pane of the current window, epoch % num_windows. */
 } __rte_cache_aligned;
 
+/*
+ * In a sliding window sketch, each counter is a cell keeping the window of
+ * its last update, the sum of its panes, and one pane per window indexed by
+ * the window number modulo num_windows. The panes of the windows which went
+ * out of the sliding window since the last update are expired lazily when
+ * the cell is next touched, so that advancing the window is O(1).
+ */
+#define WINDOW_CELL_EPOCH 0
+#define WINDOW_CELL_TOTAL 1
+#define WINDOW_CELL_PANES 2
+
+static __rte_always_inline uint64_t *
+window_cell(const struct rte_member_setsum *ss, uint32_t row, uint32_t col)
+{
+	uint64_t *count_array = ss->table;
+
+	return &count_array[((size_t)row * ss->num_col + col) *
+			(ss->num_windows + WINDOW_CELL_PANES)];
+}
+
+/* count of a cell over the windows still in the sliding window */
+static __rte_always_inline uint64_t
+window_cell_count(const struct rte_member_setsum *ss, const uint64_t *cell)
+{
+	const struct sketch_runtime *runtime_var = ss->runtime_var;
+	uint64_t age = runtime_var->epoch - cell[WINDOW_CELL_EPOCH];
+	uint64_t count = cell[WINDOW_CELL_TOTAL];
+	uint32_t pane;
+
+	if (likely(age == 0))
+		return count;
+	if (age >= ss->num_windows)
+		return 0;
+
+	/* the panes following the last updated one hold expired windows */
+	pane = cell[WINDOW_CELL_EPOCH] % ss->num_windows;
+	while (age-- > 0) {
+		if (++pane == ss->num_windows)
+			pane = 0;
+		count -= cell[WINDOW_CELL_PANES + pane];
+	}
+
+	return count;
+}
+
+static void
+window_cell_expire(const struct rte_member_setsum *ss, uint64_t *cell)
+{
+	const struct sketch_runtime *runtime_var = ss->runtime_var;
+	uint64_t age = runtime_var->epoch - cell[WINDOW_CELL_EPOCH];
+	uint32_t pane;
+
+	if (age >= ss->num_windows) {
+		memset(&cell[WINDOW_CELL_TOTAL], 0,
+			sizeof(uint64_t) * (ss->num_windows + 1));
+	} else {
+		pane = cell[WINDOW_CELL_EPOCH] % ss->num_windows;
+		while (age-- > 0) {
+			if (++pane == ss->num_windows)
+				pane = 0;
+			cell[WINDOW_CELL_TOTAL] -= cell[WINDOW_CELL_PANES + pane];
+			cell[WINDOW_CELL_PANES + pane] = 0;
+		}
+	}
+	cell[WINDOW_CELL_EPOCH] = runtime_var->epoch;
+}
+
+static __rte_always_inline void
+window_cell_add(const struct rte_member_setsum *ss, uint64_t *cell,
+		uint64_t count)
+{
+	const struct sketch_runtime *runtime_var = ss->runtime_var;
+
+	if (unlikely(cell[WINDOW_CELL_EPOCH] != runtime_var->epoch))
+		window_cell_expire(ss, cell);
+
+	cell[WINDOW_CELL_PANES + runtime_var->cur_pane] += count;
+	cell[WINDOW_CELL_TOTAL] += count;
+}
+
 /*
  * Geometric sampling to calculate how many packets needs to be
  * skipped until next update. This method can mitigate the CPU
@@ -107,6 +189,34 @@ medianof5(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t e)
 		return b > c ? c : b;
 }
 
+/* size of a counter, a cell of panes for a sliding window sketch */
+static size_t
+sketch_cell_size(const struct rte_member_setsum *ss)
+{
+	if (ss->num_windows != 0)
+		return sizeof(uint64_t) * (ss->num_windows + WINDOW_CELL_PANES);
+
+	return sizeof(uint64_t);
+}
+
+/* median of the row counts, used when rows are sampled */
+static uint64_t
+count_median(const struct rte_member_setsum *ss, uint64_t *count_row)
+{
+	if (ss->num_row == 5)
+		return medianof5(count_row[0], count_row[1],
+				count_row[2], count_row[3], count_row[4]);
+
+	isort(count_row, ss->num_row);
+
+	if (ss->num_row % 2 == 0)
+		return (count_row[ss->num_row / 2] +
+			count_row[ss->num_row / 2 - 1]) / 2;
+
+	/* ss->num_row % 2 != 0 */
+	return count_row[ss->num_row / 2];
+}
+
 int
 rte_member_create_sketch(struct rte_member_setsum *ss,
 			 const struct rte_member_parameters *params,
@@ -126,8 +236,19 @@ rte_member_create_sketch(struct rte_member_setsum *ss,
 	if (params->extra_flag & RTE_MEMBER_SKETCH_COUNT_BYTE)
 		ss->count_byte = 1;
 
+	if (params->extra_flag & RTE_MEMBER_SKETCH_SLIDING_WINDOW) {
+		if (params->num_windows < 2 ||
+				params->num_windows > RTE_MEMBER_SKETCH_WINDOWS_MAX) {
+			rte_errno = EINVAL;
+			RTE_MEMBER_LOG(ERR,
+				"Membership Sketch created with invalid number of windows\n");
+			return -EINVAL;
+		}
+		ss->num_windows = params->num_windows;
+	}
+
 #ifdef RTE_ARCH_X86
-	if (ss->count_byte == 1 &&
+	if (ss->count_byte == 1 && ss->num_windows == 0 &&
 		rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
 		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) == 1 &&
 		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512IFMA) == 1) {
@@ -149,7 +270,14 @@ rte_member_create_sketch(struct rte_member_setsum *ss,
 #endif
 	} else
 #endif
-	{
+	if (ss->num_windows != 0) {
+		ss->num_row = NUM_ROW_SCALAR;
+		RTE_MEMBER_LOG(NOTICE,
+			"Membership Sketch sliding window update/lookup/delete ops is selected\n");
+		ss->sketch_update = sketch_update_window;
+		ss->sketch_lookup = sketch_lookup_window;
+		ss->sketch_delete = sketch_delete_window;
+	} else {
 		ss->num_row = NUM_ROW_SCALAR;
 		RTE_MEMBER_LOG(NOTICE,
 			"Membership Sketch SCALAR update/lookup/delete ops is selected\n");
@@ -170,7 +298,7 @@ rte_member_create_sketch(struct rte_member_setsum *ss,
 		num_col = 4.0 / params->error_rate;
 
 	ss->table = rte_zmalloc_socket(NULL,
-			sizeof(uint64_t) * num_col * ss->num_row,
+			sketch_cell_size(ss) * num_col * ss->num_row,
 			RTE_CACHE_LINE_SIZE, ss->socket_id);
 	if (ss->table == NULL) {
 		RTE_MEMBER_LOG(ERR, "Sketch Table memory allocation failed\n");
@@ -241,7 +369,8 @@ rte_member_create_sketch(struct rte_member_setsum *ss,
 	}
 
 	RTE_MEMBER_LOG(DEBUG, "Sketch created, "
-		"the total memory required is %u Bytes\n",  ss->num_col * ss->num_row * 8);
+		"the total memory required is %zu Bytes\n",
+		ss->num_col * ss->num_row * sketch_cell_size(ss));
 
 	return 0;
 
@@ -263,7 +392,6 @@ sketch_lookup_scalar(const struct rte_member_setsum *ss, const void *key)
 	uint32_t col[ss->num_row];
 	uint64_t count_row[ss->num_row];
 	uint32_t cur_row;
-	uint64_t count;
 
 	for (cur_row = 0; cur_row < ss->num_row; cur_row++) {
 		col[cur_row] = MEMBER_HASH_FUNC(key, ss->key_len,
@@ -282,20 +410,36 @@ sketch_lookup_scalar(const struct rte_member_setsum *ss, const void *key)
 	for (cur_row = 0; cur_row < ss->num_row; cur_row++)
 		count_row[cur_row] = count_array[cur_row * ss->num_col + col[cur_row]];
 
-	if (ss->num_row == 5)
-		return medianof5(count_row[0], count_row[1],
-				count_row[2], count_row[3], count_row[4]);
+	return count_median(ss, count_row);
+}
 
-	isort(count_row, ss->num_row);
+uint64_t
+sketch_lookup_window(const struct rte_member_setsum *ss, const void *key)
+{
+	uint64_t count_row[ss->num_row];
+	uint64_t *cells[ss->num_row];
+	uint64_t min = UINT64_MAX;
+	uint32_t cur_row;
+	uint32_t col;
 
-	if (ss->num_row % 2 == 0) {
-		count = (count_row[ss->num_row / 2] + count_row[ss->num_row / 2 - 1]) / 2;
-		return count;
+	for (cur_row = 0; cur_row < ss->num_row; cur_row++) {
+		col = MEMBER_HASH_FUNC(key, ss->key_len,
+			ss->hash_seeds[cur_row]) % ss->num_col;
+		cells[cur_row] = window_cell(ss, cur_row, col);
+
+		rte_prefetch0(cells[cur_row]);
 	}
-	/* ss->num_row % 2 != 0 */
-	count = count_row[ss->num_row / 2];
 
-	return count;
+	for (cur_row = 0; cur_row < ss->num_row; cur_row++) {
+		count_row[cur_row] = window_cell_count(ss, cells[cur_row]);
+		if (count_row[cur_row] < min)
+			min = count_row[cur_row];
+	}
+
+	if (ss->sample_rate == 1 || ss->count_byte == 1)
+		return min;
+
+	return count_median(ss, count_row);
 }
 
 void
@@ -314,6 +458,26 @@ sketch_delete_scalar(const struct rte_member_setsum *ss, const void *key)
 	}
 }
 
+void
+sketch_delete_window(const struct rte_member_setsum *ss, const void *key)
+{
+	const struct sketch_runtime *runtime_var = ss->runtime_var;
+	uint32_t cur_row;
+	uint64_t *cell;
+	uint32_t col;
+
+	for (cur_row = 0; cur_row < ss->num_row; cur_row++) {
+		col = MEMBER_HASH_FUNC(key, ss->key_len,
+			ss->hash_seeds[cur_row]) % ss->num_col;
+		cell = window_cell(ss, cur_row, col);
+
+		/* set the corresponding counter to 0 in all windows */
+		memset(&cell[WINDOW_CELL_TOTAL], 0,
+			sizeof(uint64_t) * (ss->num_windows + 1));
+		cell[WINDOW_CELL_EPOCH] = runtime_var->epoch;
+	}
+}
+
 int
 rte_member_query_sketch(const struct rte_member_setsum *ss,
 			const void *key,
@@ -398,8 +562,12 @@ sketch_update_row(const struct rte_member_setsum *ss, const void *key,
 			ss->hash_seeds[cur_row]) % ss->num_col;
 
 	/* sketch counter update */
-	count_array[cur_row * ss->num_col + col] +=
-			ceil(count / (ss->sample_rate));
+	if (ss->num_windows != 0)
+		window_cell_add(ss, window_cell(ss, cur_row, col),
+				ceil(count / (ss->sample_rate)));
+	else
+		count_array[cur_row * ss->num_col + col] +=
+				ceil(count / (ss->sample_rate));
 }
 
 void
@@ -418,6 +586,27 @@ sketch_update_scalar(const struct rte_member_setsum *ss,
 	}
 }
 
+void
+sketch_update_window(const struct rte_member_setsum *ss,
+		     const void *key,
+		     uint32_t count)
+{
+	uint64_t *cells[ss->num_row];
+	uint32_t cur_row;
+	uint32_t col;
+
+	for (cur_row = 0; cur_row < ss->num_row; cur_row++) {
+		col = MEMBER_HASH_FUNC(key, ss->key_len,
+				ss->hash_seeds[cur_row]) % ss->num_col;
+		cells[cur_row] = window_cell(ss, cur_row, col);
+
+		rte_prefetch0(cells[cur_row]);
+	}
+
+	for (cur_row = 0; cur_row < ss->num_row; cur_row++)
+		window_cell_add(ss, cells[cur_row], count);
+}
+
 static void
 heap_update(const struct rte_member_setsum *ss, const void *key)
 {
@@ -566,6 +755,41 @@ rte_member_delete_sketch(const struct rte_member_setsum *ss,
 		(&runtime_var->heap, key, runtime_var->key_slots, runtime_var->free_key_slots);
 }
 
+/*
+ * Move to the next window. The cells expire their old panes when they are
+ * next touched, only the counts of the top-k heap are refreshed here, so
+ * that the keys whose flows stopped leave room to the new heavy hitters.
+ */
+int
+rte_member_advance_window_sketch(const struct rte_member_setsum *ss)
+{
+	struct sketch_runtime *runtime_var = ss->runtime_var;
+	struct minheap *hp = &runtime_var->heap;
+	uint32_t i;
+
+	if (ss->num_windows == 0) {
+		RTE_MEMBER_LOG(ERR, "Sketch is not a sliding window sketch\n");
+		return -EINVAL;
+	}
+
+	runtime_var->epoch++;
+	if (++runtime_var->cur_pane == ss->num_windows)
+		runtime_var->cur_pane = 0;
+
+	rte_member_update_heap(ss);
+
+	for (i = hp->size; i-- > 0; ) {
+		if (hp->elem[i].count == 0)
+			rte_member_minheap_delete_node(hp, hp->elem[i].key,
+				runtime_var->key_slots, runtime_var->free_key_slots);
+	}
+
+	for (i = hp->size / 2; i-- > 0; )
+		rte_member_heapify(hp, i, true);
+
+	return 0;
+}
+
 void
 rte_member_free_sketch(struct rte_member_setsum *ss)
 {
@@ -585,7 +809,9 @@ rte_member_reset_sketch(const struct rte_member_setsum *ss)
 	uint64_t *sketch = ss->table;
 	uint32_t i;
 
-	memset(sketch, 0, sizeof(uint64_t) * ss->num_col * ss->num_row);
+	memset(sketch, 0, sketch_cell_size(ss) * ss->num_col * ss->num_row);
+	runtime_var->epoch = 0;
+	runtime_var->cur_pane = 0;
 	rte_member_minheap_reset(&runtime_var->heap);
 	rte_ring_reset(runtime_var->free_key_slots);
 
@@ -71,6 +71,22 @@ rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *setsum,
 void
 rte_member_update_heap(const struct rte_member_setsum *ss);
 
+int
+rte_member_advance_window_sketch(const struct rte_member_setsum *ss);
+
+void
+sketch_update_window(const struct rte_member_setsum *ss,
+		     const void *key,
+		     uint32_t count);
+
+uint64_t
+sketch_lookup_window(const struct rte_member_setsum *ss,
+		     const void *key);
+
+void
+sketch_delete_window(const struct rte_member_setsum *ss,
+		     const void *key);
+
 static __rte_always_inline uint64_t
 count_min(const struct rte_member_setsum *ss, const uint32_t *hash_results)
 {
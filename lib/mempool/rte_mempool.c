@@ -52,6 +52,9 @@ mempool_event_callback_invoke(enum rte_mempool_event event,
 #define CALC_CACHE_FLUSHTHRESH(c)	\
 	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
 
+/* size of a socket cache, in default cache sizes */
+#define SOCKET_CACHE_SIZE_MULTIPLIER 4
+
 #if defined(RTE_ARCH_X86)
 /*
  * return the greatest common divisor between a and b (fast algorithm)
@@ -712,6 +715,112 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+/* get the distinct socket caches of the default caches */
+static unsigned int
+mempool_socket_cache_list(const struct rte_mempool *mp,
+	struct rte_mempool_socket_cache *sc[RTE_MAX_NUMA_NODES])
+{
+	struct rte_mempool_socket_cache *cur;
+	unsigned int lcore_id, i, nb = 0;
+
+	if (mp->cache_size == 0 ||
+			(mp->flags & RTE_MEMPOOL_F_SOCKET_CACHE) == 0)
+		return 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		cur = mp->local_cache[lcore_id].socket_cache;
+		if (cur == NULL)
+			continue;
+		for (i = 0; i < nb; i++) {
+			if (sc[i] == cur)
+				break;
+		}
+		if (i == nb && nb < RTE_MAX_NUMA_NODES)
+			sc[nb++] = cur;
+	}
+	return nb;
+}
+
+/* return the number of objects in the socket caches */
+static unsigned int
+mempool_socket_cache_count(const struct rte_mempool *mp)
+{
+	struct rte_mempool_socket_cache *sc[RTE_MAX_NUMA_NODES];
+	unsigned int i, nb, count = 0;
+
+	nb = mempool_socket_cache_list(mp, sc);
+	for (i = 0; i < nb; i++)
+		count += sc[i]->len;
+	return count;
+}
+
+/* allocate a socket cache per socket and attach the default caches to it */
+static int
+mempool_socket_cache_create(struct rte_mempool *mp)
+{
+	struct rte_mempool_socket_cache *sc[RTE_MAX_NUMA_NODES];
+	unsigned int nb_sockets, lcore_id, size, i;
+	size_t sc_size;
+	int socket_id;
+
+	nb_sockets = RTE_MAX(rte_socket_count(), 1U);
+	nb_sockets = RTE_MIN(nb_sockets, (unsigned int)RTE_MAX_NUMA_NODES);
+
+	/* objects kept in the socket caches stay below half of the pool */
+	size = RTE_MIN(mp->cache_size * SOCKET_CACHE_SIZE_MULTIPLIER,
+		mp->size / (2 * nb_sockets));
+	/* room for a flush or a refill above the size */
+	sc_size = sizeof(**sc) +
+		sizeof(void *) * (size + 2 * RTE_MEMPOOL_CACHE_MAX_SIZE);
+
+	for (i = 0; i < nb_sockets; i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		sc[i] = rte_zmalloc_socket("MEMPOOL_SOCKET_CACHE", sc_size,
+			RTE_CACHE_LINE_SIZE, socket_id);
+		if (sc[i] == NULL)
+			sc[i] = rte_zmalloc("MEMPOOL_SOCKET_CACHE", sc_size,
+				RTE_CACHE_LINE_SIZE);
+		if (sc[i] == NULL) {
+			RTE_LOG(ERR, MEMPOOL,
+				"Cannot allocate mempool socket cache.\n");
+			while (i-- > 0)
+				rte_free(sc[i]);
+			rte_errno = ENOMEM;
+			return -1;
+		}
+		rte_spinlock_init(&sc[i]->lock);
+		sc[i]->size = size;
+		sc[i]->objs = (void **)&sc[i][1];
+	}
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		for (i = 0; i < nb_sockets; i++) {
+			if (rte_socket_id_by_idx(i) == socket_id)
+				break;
+		}
+		/* lcores of unknown socket share the first socket cache */
+		if (i == nb_sockets)
+			i = 0;
+		mp->local_cache[lcore_id].socket_cache = sc[i];
+	}
+	return 0;
+}
+
+/* free the socket caches */
+static void
+mempool_socket_cache_free(struct rte_mempool *mp)
+{
+	struct rte_mempool_socket_cache *sc[RTE_MAX_NUMA_NODES];
+	unsigned int lcore_id, i, nb;
+
+	nb = mempool_socket_cache_list(mp, sc);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE && nb != 0; lcore_id++)
+		mp->local_cache[lcore_id].socket_cache = NULL;
+	for (i = 0; i < nb; i++)
+		rte_free(sc[i]);
+}
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -740,6 +849,7 @@ rte_mempool_free(struct rte_mempool *mp)
 	rte_mempool_trace_free(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
+	mempool_socket_cache_free(mp);
 	rte_memzone_free(mp->mz);
 }
 
@@ -929,6 +1039,22 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 					   cache_size);
 	}
 
+	/* Adaptive caches start at the configured size. */
+	if (cache_size != 0 && (flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE)) {
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			struct rte_mempool_cache *cache;
+
+			cache = &mp->local_cache[lcore_id];
+			cache->size_max = cache_size;
+			cache->burst_avg = cache_size * 16 /
+				RTE_MEMPOOL_CACHE_ADAPT_BURSTS;
+		}
+	}
+
+	if (cache_size != 0 && (flags & RTE_MEMPOOL_F_SOCKET_CACHE) &&
+			mempool_socket_cache_create(mp) < 0)
+		goto exit_unlock;
+
 	te->data = mp;
 
 	rte_mcfg_tailq_write_lock();
@@ -1014,6 +1140,7 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 		count += mp->local_cache[lcore_id].len;
+	count += mempool_socket_cache_count(mp);
 
 	/*
 	 * due to race condition (access to len is not locked), the
@@ -1051,6 +1178,11 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 			lcore_id, cache_count);
 		count += cache_count;
 	}
+	if (mp->flags & RTE_MEMPOOL_F_SOCKET_CACHE) {
+		cache_count = mempool_socket_cache_count(mp);
+		fprintf(f, "    socket_cache_count=%u\n", cache_count);
+		count += cache_count;
+	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
 }
@@ -1204,6 +1336,22 @@ mempool_audit_cache(const struct rte_mempool *mp)
 				lcore_id);
 			rte_panic("MEMPOOL: invalid cache len\n");
 		}
+		if (cache->socket_cache != NULL) {
+			struct rte_mempool_socket_cache *sc;
+			uint32_t len;
+
+			/* the length is above the size during a flush */
+			sc = cache->socket_cache;
+			rte_spinlock_lock(&sc->lock);
+			len = sc->len;
+			rte_spinlock_unlock(&sc->lock);
+			if (len > sc->size) {
+				RTE_LOG(CRIT, MEMPOOL,
+					"badness on socket cache of cache[%u]\n",
+					lcore_id);
+				rte_panic("MEMPOOL: invalid socket cache len\n");
+			}
+		}
 	}
 }
 
@@ -1520,6 +1668,7 @@ mempool_info_cb(struct rte_mempool *mp, void *arg)
 		int lcore_id;
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			cache_count += mp->local_cache[lcore_id].len;
+		cache_count += mempool_socket_cache_count(mp);
 	}
 	rte_tel_data_add_dict_uint(info->d, "total_cache_count", cache_count);
 	common_count = rte_mempool_ops_get_count(mp);
@@ -81,6 +81,17 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * A structure that stores the objects shared by the per-core caches
+ * of the lcores of a NUMA socket, see RTE_MEMPOOL_F_SOCKET_CACHE.
+ */
+struct rte_mempool_socket_cache {
+	rte_spinlock_t lock; /**< Lock protecting the socket cache */
+	uint32_t size;       /**< Count above which objects go to the backend */
+	uint32_t len;        /**< Current socket cache count */
+	void **objs;         /**< Socket cache objects, following the structure */
+} __rte_cache_aligned;
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -101,6 +112,10 @@ struct rte_mempool_cache {
 		uint64_t get_success_objs;  /**< Objects successfully allocated. */
 	} stats;                        /**< Statistics */
 #endif
+	uint32_t size_max;    /**< Maximum size of an adaptive cache, 0 if fixed */
+	uint32_t burst_avg;   /**< Average request size, in 1/16 of object */
+	/** Socket cache between this cache and the backend, may be NULL */
+	struct rte_mempool_socket_cache *socket_cache;
 	/**
 	 * Cache objects
 	 *
@@ -300,6 +315,15 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/** Default caches adapt their size to the size of the requests. */
+#define RTE_MEMPOOL_F_ADAPTIVE_CACHE	0x0080
+/** Default caches of a socket exchange objects with the backend in batches. */
+#define RTE_MEMPOOL_F_SOCKET_CACHE	0x0100
+
+/** Number of requests an adaptive cache is sized for. */
+#define RTE_MEMPOOL_CACHE_ADAPT_BURSTS	16
+/** Minimum size of an adaptive cache, unless the configured size is lower. */
+#define RTE_MEMPOOL_CACHE_ADAPT_MIN	32
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -309,6 +333,8 @@ struct rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_ADAPTIVE_CACHE \
+	| RTE_MEMPOOL_F_SOCKET_CACHE \
 	)
 
 /**
@@ -1065,6 +1091,14 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - RTE_MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - RTE_MEMPOOL_F_ADAPTIVE_CACHE: If set, the size of each default cache
+ *     follows the average size of the requests it serves, between
+ *     RTE_MEMPOOL_CACHE_ADAPT_MIN and *cache_size* objects.
+ *   - RTE_MEMPOOL_F_SOCKET_CACHE: If set, the default caches of the lcores
+ *     of a NUMA socket are flushed to and refilled from a per-socket cache,
+ *     which exchanges objects with the pool backend in large batches.
+ *     It reduces the accesses to the backend when objects are allocated
+ *     on one socket and freed on another.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1325,6 +1359,116 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @internal Update the average request size of an adaptive cache
+ * and resize the cache accordingly. It is called only when the cache
+ * is flushed or refilled, so the common path is not slowed down.
+ * The cache length may be above the new flush threshold.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param n
+ *   The number of objects of the request.
+ */
+static __rte_always_inline void
+rte_mempool_cache_adapt(struct rte_mempool_cache *cache, unsigned int n)
+{
+	uint32_t size;
+
+	if (cache->size_max == 0)
+		return;
+
+	/* moving average with a weight of 1/8 for the new request */
+	n = RTE_MIN(n, cache->size_max);
+	cache->burst_avg = cache->burst_avg - cache->burst_avg / 8 + n * 2;
+
+	size = cache->burst_avg * RTE_MEMPOOL_CACHE_ADAPT_BURSTS / 16;
+	size = RTE_MAX(size, (uint32_t)RTE_MEMPOOL_CACHE_ADAPT_MIN);
+	size = RTE_MIN(size, cache->size_max);
+	cache->size = size;
+	cache->flushthresh = size + size / 2;
+}
+
+/**
+ * @internal Put objects in a socket cache. When the socket cache is above
+ * its size, the objects above half of its size are enqueued to the backend
+ * at once.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param sc
+ *   A pointer to the socket cache.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects, at most 2 * RTE_MEMPOOL_CACHE_MAX_SIZE.
+ */
+static __rte_always_inline void
+rte_mempool_socket_cache_put(struct rte_mempool *mp,
+			     struct rte_mempool_socket_cache *sc,
+			     void * const *obj_table, unsigned int n)
+{
+	uint32_t keep;
+
+	rte_spinlock_lock(&sc->lock);
+	rte_memcpy(&sc->objs[sc->len], obj_table, sizeof(void *) * n);
+	sc->len += n;
+	if (sc->len > sc->size) {
+		keep = sc->size / 2;
+		rte_mempool_ops_enqueue_bulk(mp, &sc->objs[keep],
+				sc->len - keep);
+		sc->len = keep;
+	}
+	rte_spinlock_unlock(&sc->lock);
+}
+
+/**
+ * @internal Get objects from a socket cache. When the socket cache has
+ * not enough objects, it is refilled from the backend, up to half of
+ * its size above the request if possible.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param sc
+ *   A pointer to the socket cache.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects, at most 2 * RTE_MEMPOOL_CACHE_MAX_SIZE.
+ * @return
+ *   - 0: Success; objects taken.
+ *   - <0: Error; code of driver dequeue function, no object is taken.
+ */
+static __rte_always_inline int
+rte_mempool_socket_cache_get(struct rte_mempool *mp,
+			     struct rte_mempool_socket_cache *sc,
+			     void **obj_table, unsigned int n)
+{
+	uint32_t fill;
+	int ret = 0;
+
+	rte_spinlock_lock(&sc->lock);
+	if (sc->len < n) {
+		fill = n - sc->len + sc->size / 2;
+		ret = rte_mempool_ops_dequeue_bulk(mp, &sc->objs[sc->len],
+				fill);
+		if (ret < 0) {
+			/* only take what is missing */
+			fill = n - sc->len;
+			ret = rte_mempool_ops_dequeue_bulk(mp,
+					&sc->objs[sc->len], fill);
+		}
+		if (ret < 0)
+			goto out;
+		sc->len += fill;
+	}
+	sc->len -= n;
+	rte_memcpy(obj_table, &sc->objs[sc->len], sizeof(void *) * n);
+out:
+	rte_spinlock_unlock(&sc->lock);
+	return ret;
+}
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1342,7 +1486,11 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	if (cache == NULL || cache->len == 0)
 		return;
 	rte_mempool_trace_cache_flush(cache, mp);
-	rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
+	if (cache->socket_cache != NULL)
+		rte_mempool_socket_cache_put(mp, cache->socket_cache,
+				cache->objs, cache->len);
+	else
+		rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
 	cache->len = 0;
 }
 
@@ -1373,8 +1521,10 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
 
 	/* The request itself is too big for the cache */
-	if (unlikely(n > cache->flushthresh))
+	if (unlikely(n > cache->flushthresh)) {
+		rte_mempool_cache_adapt(cache, n);
 		goto driver_enqueue_stats_incremented;
+	}
 
 	/*
 	 * The cache follows the following algorithm:
@@ -1388,8 +1538,14 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		cache->len += n;
 	} else {
 		cache_objs = &cache->objs[0];
-		rte_mempool_ops_enqueue_bulk(mp, cache_objs, cache->len);
+		if (cache->socket_cache != NULL)
+			rte_mempool_socket_cache_put(mp, cache->socket_cache,
+					cache_objs, cache->len);
+		else
+			rte_mempool_ops_enqueue_bulk(mp, cache_objs,
+					cache->len);
 		cache->len = n;
+		rte_mempool_cache_adapt(cache, n);
 	}
 
 	/* Add the objects to the cache. */
@@ -1521,9 +1677,15 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 	if (unlikely(remaining > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto driver_dequeue;
 
+	rte_mempool_cache_adapt(cache, n);
+
 	/* Fill the cache from the backend; fetch size + remaining objects. */
-	ret = rte_mempool_ops_dequeue_bulk(mp, cache->objs,
-			cache->size + remaining);
+	if (cache->socket_cache != NULL)
+		ret = rte_mempool_socket_cache_get(mp, cache->socket_cache,
+				cache->objs, cache->size + remaining);
+	else
+		ret = rte_mempool_ops_dequeue_bulk(mp, cache->objs,
+				cache->size + remaining);
 	if (unlikely(ret < 0)) {
 		/*
 		 * We are buffer constrained, and not able to allocate
@@ -1549,7 +1711,12 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 driver_dequeue:
 
 	/* Get remaining objects directly from the backend. */
-	ret = rte_mempool_ops_dequeue_bulk(mp, obj_table, remaining);
+	if (cache != NULL && cache->socket_cache != NULL &&
+			remaining <= 2 * RTE_MEMPOOL_CACHE_MAX_SIZE)
+		ret = rte_mempool_socket_cache_get(mp, cache->socket_cache,
+				obj_table, remaining);
+	else
+		ret = rte_mempool_ops_dequeue_bulk(mp, obj_table, remaining);
 
 	if (ret < 0) {
 		if (likely(cache != NULL)) {
@@ -10,17 +10,35 @@
  * by the user of this library.
  */
 
+#include <sys/queue.h>
+
+#include <rte_lcore.h>
 #include <rte_ring.h>
 #include <rte_ring_elem.h>
 
 #include "rte_rcu_qsbr.h"
 
+/* Defer queue of an lcore, with RTE_RCU_QSBR_DQ_PER_LCORE.
+ * The resources are enqueued in batches sharing a token.
+ */
+struct __rte_rcu_qsbr_dq_lcore {
+	struct rte_ring *r;     /**< Batches waiting for their grace period. */
+	void *batch;            /**< Batch being filled, without a token. */
+	uint32_t nb_batch;      /**< Number of resources in the batch. */
+	/* Statistics, only the reclaimed counter is updated by other threads */
+	uint64_t enqueued;
+	uint64_t tokens;
+	uint64_t full;
+	uint64_t reclaimed;
+} __rte_cache_aligned;
+
 /* Defer queue structure.
  * This structure holds the defer queue. The defer queue is used to
  * hold the deleted entries from the data structure that are not
  * yet freed.
  */
 struct rte_rcu_qsbr_dq {
+	TAILQ_ENTRY(rte_rcu_qsbr_dq) next; /**< Next in the list of queues. */
 	struct rte_rcu_qsbr *v; /**< RCU QSBR variable used by this queue.*/
 	struct rte_ring *r;     /**< RCU QSBR defer queue. */
 	uint32_t size;
@@ -44,6 +62,21 @@ struct rte_rcu_qsbr_dq {
 	 *   pointer to the data structure to which the resource to free
 	 *   belongs.
 	 */
+	uint32_t flags;
+	/**< Flags provided when creating the defer queue. */
+	uint32_t batch_size;
+	/**< Number of resources per batch of the lcore defer queues. */
+	uint32_t lcore_esize;
+	/**< Size (in bytes) of a batch, including its header. */
+	uint32_t service_id;
+	/**< Reclamation service, with RTE_RCU_QSBR_DQ_RECLAIM_SERVICE. */
+	/* Statistics of the shared defer queue */
+	uint64_t enqueued;
+	uint64_t tokens;
+	uint64_t full;
+	uint64_t reclaimed;
+	struct __rte_rcu_qsbr_dq_lcore *lcores[RTE_MAX_LCORE];
+	/**< Defer queues of the lcores, with RTE_RCU_QSBR_DQ_PER_LCORE. */
 };
 
 /* Internal structure to represent the element on the defer queue.
@@ -55,4 +88,12 @@ typedef struct {
 	uint8_t elem[0]; /**< Pointer to user element */
 } __attribute__((__may_alias__)) __rte_rcu_qsbr_dq_elem_t;
 
+/* Internal structure to represent a batch on an lcore defer queue. */
+typedef struct {
+	uint64_t token;  /**< Token */
+	uint32_t n;      /**< Number of user elements */
+	uint32_t pad;
+	uint8_t elem[0]; /**< Array of user elements */
+} __attribute__((__may_alias__)) __rte_rcu_qsbr_dq_batch_t;
+
 #endif /* _RTE_RCU_QSBR_PVT_H_ */
@@ -14,11 +14,21 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_pause.h>
 #include <rte_ring_elem.h>
+#include <rte_service_component.h>
+#include <rte_spinlock.h>
+#include <rte_string_fns.h>
+#include <rte_telemetry.h>
 
 #include "rte_rcu_qsbr.h"
 #include "rcu_qsbr_pvt.h"
 
+/* List of the defer queues, for telemetry */
+TAILQ_HEAD(rcu_qsbr_dq_list, rte_rcu_qsbr_dq);
+static struct rcu_qsbr_dq_list dq_list = TAILQ_HEAD_INITIALIZER(dq_list);
+static rte_spinlock_t dq_list_lock = RTE_SPINLOCK_INITIALIZER;
+
 /* Get the memory size of QSBR variable */
 size_t
 rte_rcu_qsbr_get_memsize(uint32_t max_threads)
@@ -268,6 +278,242 @@ rte_rcu_qsbr_dump(FILE *f, struct rte_rcu_qsbr *v)
 	return 0;
 }
 
+/* Reclaim up to n resources from the shared defer queue. */
+static uint32_t
+rcu_qsbr_dq_shared_reclaim(struct rte_rcu_qsbr_dq *dq, uint32_t n,
+			   unsigned int *available)
+{
+	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	uint32_t cnt = 0;
+
+	char data[dq->esize];
+	/* Check reader threads quiescent state and reclaim resources */
+	while (cnt < n &&
+		rte_ring_dequeue_bulk_elem_start(dq->r, &data,
+					dq->esize, 1, available) != 0) {
+		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
+
+		/* Reclaim the resource */
+		if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) != 1) {
+			rte_ring_dequeue_elem_finish(dq->r, 0);
+			break;
+		}
+		rte_ring_dequeue_elem_finish(dq->r, 1);
+
+		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
+			"%s(): Reclaimed token = %" PRIu64 "\n",
+			__func__, dq_elem->token);
+
+		dq->free_fn(dq->p, dq_elem->elem, 1);
+
+		cnt++;
+	}
+
+	if (cnt != 0)
+		__atomic_fetch_add(&dq->reclaimed, cnt, __ATOMIC_RELAXED);
+
+	return cnt;
+}
+
+/* Reclaim batches of at most n resources from the defer queue of an lcore.
+ * The resources are freed in the ring, without copying the batches.
+ */
+static uint32_t
+rcu_qsbr_dq_lcore_reclaim(struct rte_rcu_qsbr_dq *dq,
+			  struct __rte_rcu_qsbr_dq_lcore *lq, uint32_t n)
+{
+	const uint32_t esize = dq->esize - __RTE_QSBR_TOKEN_SIZE;
+	__rte_rcu_qsbr_dq_batch_t *b;
+	struct rte_ring_zc_data zcd;
+	uint32_t cnt = 0, i;
+
+	while (cnt < n &&
+		rte_ring_dequeue_zc_bulk_elem_start(lq->r, dq->lcore_esize,
+					1, &zcd, NULL) != 0) {
+		b = zcd.ptr1;
+
+		if (rte_rcu_qsbr_check(dq->v, b->token, false) != 1) {
+			rte_ring_dequeue_zc_elem_finish(lq->r, 0);
+			break;
+		}
+
+		for (i = 0; i < b->n; i++)
+			dq->free_fn(dq->p, b->elem + i * esize, 1);
+		cnt += b->n;
+
+		rte_ring_dequeue_zc_elem_finish(lq->r, 1);
+	}
+
+	if (cnt != 0)
+		__atomic_fetch_add(&lq->reclaimed, cnt, __ATOMIC_RELAXED);
+
+	return cnt;
+}
+
+/* Start the grace period of the batch being filled by an lcore
+ * and move it to the defer queue of the lcore.
+ */
+static int
+rcu_qsbr_dq_lcore_flush(struct rte_rcu_qsbr_dq *dq,
+			struct __rte_rcu_qsbr_dq_lcore *lq)
+{
+	__rte_rcu_qsbr_dq_batch_t *b = lq->batch;
+
+	if (lq->nb_batch == 0)
+		return 0;
+
+	/* The token covers all the resources of the batch */
+	b->token = rte_rcu_qsbr_start(dq->v);
+	b->n = lq->nb_batch;
+	if (rte_ring_enqueue_elem(lq->r, b, dq->lcore_esize) != 0)
+		return 1;
+
+	lq->tokens++;
+	lq->nb_batch = 0;
+
+	return 0;
+}
+
+/* Create the defer queue of an lcore on its first enqueue. */
+static struct __rte_rcu_qsbr_dq_lcore *
+rcu_qsbr_dq_lcore_create(struct rte_rcu_qsbr_dq *dq, unsigned int lcore_id)
+{
+	struct __rte_rcu_qsbr_dq_lcore *lq;
+	char name[RTE_RING_NAMESIZE];
+	uint32_t count, batch_sz;
+	ssize_t ring_sz;
+
+	/* Room for 'size' resources, plus a partial batch */
+	count = rte_align32pow2((dq->size + dq->batch_size - 1) /
+				dq->batch_size + 2);
+	ring_sz = rte_ring_get_memsize_elem(dq->lcore_esize, count);
+	if (ring_sz < 0)
+		return NULL;
+	batch_sz = RTE_ALIGN_CEIL(dq->lcore_esize, RTE_CACHE_LINE_SIZE);
+
+	lq = rte_zmalloc_socket(NULL, sizeof(*lq) + batch_sz + ring_sz,
+				RTE_CACHE_LINE_SIZE,
+				rte_lcore_to_socket_id(lcore_id));
+	if (lq == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): lcore %u defer queue create failed\n",
+			__func__, lcore_id);
+		return NULL;
+	}
+
+	lq->batch = lq + 1;
+	lq->r = RTE_PTR_ADD(lq->batch, batch_sz);
+	snprintf(name, sizeof(name), "RCU_DQ_LC%u", lcore_id);
+	if (rte_ring_init(lq->r, name, count,
+			  RING_F_SP_ENQ | RING_F_MC_HTS_DEQ) != 0) {
+		rte_free(lq);
+		return NULL;
+	}
+
+	/* Publish the queue to the threads reclaiming resources */
+	__atomic_store_n(&dq->lcores[lcore_id], lq, __ATOMIC_RELEASE);
+
+	return lq;
+}
+
+/* Enqueue one resource to the batch of the calling lcore. */
+static int
+rcu_qsbr_dq_lcore_enqueue(struct rte_rcu_qsbr_dq *dq,
+			  struct __rte_rcu_qsbr_dq_lcore *lq, void *e)
+{
+	const uint32_t esize = dq->esize - __RTE_QSBR_TOKEN_SIZE;
+	__rte_rcu_qsbr_dq_batch_t *b = lq->batch;
+
+	/* A full batch is left when the defer queue of the lcore was full,
+	 * reclaim resources to make room for it.
+	 */
+	if (lq->nb_batch == dq->batch_size &&
+	    rcu_qsbr_dq_lcore_flush(dq, lq) != 0) {
+		rcu_qsbr_dq_lcore_reclaim(dq, lq, dq->size);
+		if (rcu_qsbr_dq_lcore_flush(dq, lq) != 0) {
+			lq->full++;
+			rte_errno = ENOSPC;
+			return 1;
+		}
+	}
+
+	memcpy(b->elem + lq->nb_batch * esize, e, esize);
+	lq->nb_batch++;
+	lq->enqueued++;
+
+	if (lq->nb_batch == dq->batch_size) {
+		/* Reclaim resources if the queue size has hit the reclaim
+		 * limit, unless a service does it.
+		 */
+		if (!(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) &&
+		    rte_ring_count(lq->r) * dq->batch_size >
+		    dq->trigger_reclaim_limit)
+			rcu_qsbr_dq_lcore_reclaim(dq, lq,
+						  dq->max_reclaim_size);
+		/* On failure, the batch is moved on the next enqueue */
+		rcu_qsbr_dq_lcore_flush(dq, lq);
+	}
+
+	return 0;
+}
+
+/* Number of resources waiting on the defer queue of an lcore */
+static uint64_t
+rcu_qsbr_dq_lcore_pending(const struct __rte_rcu_qsbr_dq_lcore *lq)
+{
+	return __atomic_load_n(&lq->enqueued, __ATOMIC_RELAXED) -
+		__atomic_load_n(&lq->reclaimed, __ATOMIC_RELAXED);
+}
+
+/* Service callback reclaiming the resources of all the defer queues. */
+static int32_t
+rcu_qsbr_dq_service_run(void *arg)
+{
+	struct rte_rcu_qsbr_dq *dq = arg;
+	unsigned int freed = 0;
+
+	rte_rcu_qsbr_dq_reclaim(dq, ~0, &freed, NULL, NULL);
+
+	return freed != 0 ? 0 : -EAGAIN;
+}
+
+static int
+rcu_qsbr_dq_service_register(struct rte_rcu_qsbr_dq *dq)
+{
+	struct rte_service_spec service;
+	int ret;
+
+	memset(&service, 0, sizeof(service));
+	snprintf(service.name, sizeof(service.name), "rcu_dq_%s",
+		 dq->r->name);
+	service.callback = rcu_qsbr_dq_service_run;
+	service.callback_userdata = dq;
+	service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
+	service.socket_id = SOCKET_ID_ANY;
+
+	ret = rte_service_component_register(&service, &dq->service_id);
+	if (ret != 0) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): reclamation service register failed\n",
+			__func__);
+		rte_errno = -ret;
+		return 1;
+	}
+	rte_service_component_runstate_set(dq->service_id, 1);
+
+	return 0;
+}
+
+static void
+rcu_qsbr_dq_service_unregister(struct rte_rcu_qsbr_dq *dq)
+{
+	rte_service_component_runstate_set(dq->service_id, 0);
+	/* Wait for the service lcores to leave the service */
+	while (rte_service_may_be_active(dq->service_id) == 1)
+		rte_pause();
+	rte_service_component_unregister(dq->service_id);
+}
+
 /* Create a queue used to store the data structure elements that can
  * be freed later. This queue is referred to as 'defer queue'.
  */
@@ -301,6 +547,17 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 
 		return NULL;
 	}
+	/* Several writers or a reclamation service need MT safety */
+	if ((params->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE) &&
+	    (params->flags & (RTE_RCU_QSBR_DQ_PER_LCORE |
+			      RTE_RCU_QSBR_DQ_RECLAIM_SERVICE))) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter, flags = 0x%x\n",
+			__func__, params->flags);
+		rte_errno = EINVAL;
+
+		return NULL;
+	}
 
 	dq = rte_zmalloc(NULL, sizeof(struct rte_rcu_qsbr_dq),
 			 RTE_CACHE_LINE_SIZE);
@@ -341,6 +598,23 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 	dq->max_reclaim_size = params->max_reclaim_size;
 	dq->free_fn = params->free_fn;
 	dq->p = params->p;
+	dq->flags = params->flags;
+	dq->batch_size = params->lcore_batch_size;
+	if (dq->batch_size == 0)
+		dq->batch_size = RTE_RCU_QSBR_DQ_LCORE_BATCH_SIZE;
+	dq->lcore_esize = sizeof(__rte_rcu_qsbr_dq_batch_t) +
+		dq->batch_size * params->esize;
+
+	if (params->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE &&
+	    rcu_qsbr_dq_service_register(dq) != 0) {
+		rte_ring_free(dq->r);
+		rte_free(dq);
+		return NULL;
+	}
+
+	rte_spinlock_lock(&dq_list_lock);
+	TAILQ_INSERT_TAIL(&dq_list, dq, next);
+	rte_spinlock_unlock(&dq_list_lock);
 
 	return dq;
 }
@@ -351,6 +625,8 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 {
 	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	struct __rte_rcu_qsbr_dq_lcore *lq;
+	unsigned int lcore_id;
 	uint32_t cur_size;
 
 	if (dq == NULL || e == NULL) {
@@ -361,6 +637,17 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 		return 1;
 	}
 
+	/* Use the defer queue of the lcore, non-EAL threads share one */
+	lcore_id = rte_lcore_id();
+	if ((dq->flags & RTE_RCU_QSBR_DQ_PER_LCORE) &&
+	    lcore_id < RTE_MAX_LCORE) {
+		lq = dq->lcores[lcore_id];
+		if (lq == NULL)
+			lq = rcu_qsbr_dq_lcore_create(dq, lcore_id);
+		if (lq != NULL)
+			return rcu_qsbr_dq_lcore_enqueue(dq, lq, e);
+	}
+
 	char data[dq->esize];
 	dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
 	/* Start the grace period */
@@ -371,7 +658,8 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 	 * allows time for reader threads to report their quiescent state.
 	 */
 	cur_size = rte_ring_count(dq->r);
-	if (cur_size > dq->trigger_reclaim_limit) {
+	if (cur_size > dq->trigger_reclaim_limit &&
+	    !(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE)) {
 		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
 			"%s(): Triggering reclamation\n", __func__);
 		rte_rcu_qsbr_dq_reclaim(dq, dq->max_reclaim_size,
@@ -390,7 +678,11 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 	 * might have used up the freed space.
 	 * Enqueue uses the configured flags when the DQ was created.
 	 */
-	if (rte_ring_enqueue_elem(dq->r, data, dq->esize) != 0) {
+	if (rte_ring_enqueue_elem(dq->r, data, dq->esize) != 0 &&
+	    ((dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) == 0 ||
+	     rcu_qsbr_dq_shared_reclaim(dq, dq->size, NULL) == 0 ||
+	     rte_ring_enqueue_elem(dq->r, data, dq->esize) != 0)) {
+		__atomic_fetch_add(&dq->full, 1, __ATOMIC_RELAXED);
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
 			"%s(): Enqueue failed\n", __func__);
 		/* Note that the token generated above is not used.
@@ -405,6 +697,9 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 		return 1;
 	}
 
+	__atomic_fetch_add(&dq->enqueued, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&dq->tokens, 1, __ATOMIC_RELAXED);
+
 	rte_log(RTE_LOG_INFO, rte_rcu_log_type,
 		"%s(): Enqueued token = %" PRIu64 "\n",
 		__func__, dq_elem->token);
@@ -418,8 +713,10 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 			unsigned int *freed, unsigned int *pending,
 			unsigned int *available)
 {
+	struct __rte_rcu_qsbr_dq_lcore *lq, *own = NULL;
+	unsigned int lcore_id, i;
+	uint64_t cnt_pending;
 	uint32_t cnt;
-	__rte_rcu_qsbr_dq_elem_t *dq_elem;
 
 	if (dq == NULL || n == 0) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
@@ -431,27 +728,34 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 
 	cnt = 0;
 
-	char data[dq->esize];
-	/* Check reader threads quiescent state and reclaim resources */
-	while (cnt < n &&
-		rte_ring_dequeue_bulk_elem_start(dq->r, &data,
-					dq->esize, 1, available) != 0) {
-		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
-
-		/* Reclaim the resource */
-		if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) != 1) {
-			rte_ring_dequeue_elem_finish(dq->r, 0);
-			break;
+	/* Start with the defer queue of the calling lcore, moving
+	 * its last resources to it.
+	 */
+	lcore_id = rte_lcore_id();
+	if ((dq->flags & RTE_RCU_QSBR_DQ_PER_LCORE) &&
+	    lcore_id < RTE_MAX_LCORE) {
+		own = dq->lcores[lcore_id];
+		if (own != NULL) {
+			rcu_qsbr_dq_lcore_flush(dq, own);
+			cnt += rcu_qsbr_dq_lcore_reclaim(dq, own, n);
 		}
-		rte_ring_dequeue_elem_finish(dq->r, 1);
-
-		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
-			"%s(): Reclaimed token = %" PRIu64 "\n",
-			__func__, dq_elem->token);
-
-		dq->free_fn(dq->p, dq_elem->elem, 1);
+	}
 
-		cnt++;
+	if (cnt < n)
+		cnt += rcu_qsbr_dq_shared_reclaim(dq, n - cnt,
+					own == NULL ? available : NULL);
+
+	cnt_pending = rte_ring_count(dq->r);
+	if (dq->flags & RTE_RCU_QSBR_DQ_PER_LCORE) {
+		for (i = 0; i < RTE_MAX_LCORE; i++) {
+			lq = __atomic_load_n(&dq->lcores[i], __ATOMIC_ACQUIRE);
+			if (lq == NULL)
+				continue;
+			if (lq != own && cnt < n)
+				cnt += rcu_qsbr_dq_lcore_reclaim(dq, lq,
+								 n - cnt);
+			cnt_pending += rcu_qsbr_dq_lcore_pending(lq);
+		}
 	}
 
 	rte_log(RTE_LOG_INFO, rte_rcu_log_type,
@@ -460,7 +764,10 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	if (freed != NULL)
 		*freed = cnt;
 	if (pending != NULL)
-		*pending = rte_ring_count(dq->r);
+		*pending = RTE_MIN(cnt_pending, (uint64_t)UINT_MAX);
+	if (available != NULL && own != NULL)
+		*available = rte_ring_free_count(own->r) * dq->batch_size -
+			own->nb_batch;
 
 	return 0;
 }
@@ -469,7 +776,7 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 {
-	unsigned int pending;
+	unsigned int pending, i;
 
 	if (dq == NULL) {
 		rte_log(RTE_LOG_DEBUG, rte_rcu_log_type,
@@ -478,6 +785,13 @@ rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 		return 0;
 	}
 
+	/* Start the grace period of the resources still in the batches
+	 * of the lcores, the writers are done.
+	 */
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		if (dq->lcores[i] != NULL)
+			rcu_qsbr_dq_lcore_flush(dq, dq->lcores[i]);
+
 	/* Reclaim all the resources */
 	rte_rcu_qsbr_dq_reclaim(dq, ~0, NULL, &pending, NULL);
 	if (pending != 0) {
@@ -486,10 +800,151 @@ rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 		return 1;
 	}
 
+	rte_spinlock_lock(&dq_list_lock);
+	TAILQ_REMOVE(&dq_list, dq, next);
+	rte_spinlock_unlock(&dq_list_lock);
+
+	if (dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE)
+		rcu_qsbr_dq_service_unregister(dq);
+
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		rte_free(dq->lcores[i]);
 	rte_ring_free(dq->r);
 	rte_free(dq);
 
 	return 0;
 }
 
+/* Get the statistics of a defer queue. */
+int
+rte_rcu_qsbr_dq_stats_get(struct rte_rcu_qsbr_dq *dq,
+			  struct rte_rcu_qsbr_dq_stats *stats)
+{
+	struct __rte_rcu_qsbr_dq_lcore *lq;
+	unsigned int i;
+
+	if (dq == NULL || stats == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	stats->enqueued = __atomic_load_n(&dq->enqueued, __ATOMIC_RELAXED);
+	stats->reclaimed = __atomic_load_n(&dq->reclaimed, __ATOMIC_RELAXED);
+	stats->tokens = __atomic_load_n(&dq->tokens, __ATOMIC_RELAXED);
+	stats->full = __atomic_load_n(&dq->full, __ATOMIC_RELAXED);
+	stats->pending = rte_ring_count(dq->r);
+	stats->nb_lcores = 0;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		lq = __atomic_load_n(&dq->lcores[i], __ATOMIC_ACQUIRE);
+		if (lq == NULL)
+			continue;
+		stats->enqueued += __atomic_load_n(&lq->enqueued,
+						   __ATOMIC_RELAXED);
+		stats->reclaimed += __atomic_load_n(&lq->reclaimed,
+						    __ATOMIC_RELAXED);
+		stats->tokens += __atomic_load_n(&lq->tokens,
+						 __ATOMIC_RELAXED);
+		stats->full += __atomic_load_n(&lq->full, __ATOMIC_RELAXED);
+		stats->pending += rcu_qsbr_dq_lcore_pending(lq);
+		stats->nb_lcores++;
+	}
+
+	return 0;
+}
+
+/* Get the ID of the reclamation service of a defer queue. */
+int
+rte_rcu_qsbr_dq_service_id_get(const struct rte_rcu_qsbr_dq *dq,
+			       uint32_t *service_id)
+{
+	if (dq == NULL || service_id == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	if (!(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE)) {
+		rte_errno = ESRCH;
+
+		return 1;
+	}
+
+	*service_id = dq->service_id;
+
+	return 0;
+}
+
+static int
+rcu_qsbr_dq_handle_list(const char *cmd __rte_unused,
+			const char *params __rte_unused,
+			struct rte_tel_data *d)
+{
+	struct rte_rcu_qsbr_dq *dq;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_spinlock_lock(&dq_list_lock);
+	TAILQ_FOREACH(dq, &dq_list, next)
+		rte_tel_data_add_array_string(d, dq->r->name);
+	rte_spinlock_unlock(&dq_list_lock);
+
+	return 0;
+}
+
+static int
+rcu_qsbr_dq_handle_info(const char *cmd __rte_unused, const char *params,
+			struct rte_tel_data *d)
+{
+	struct rte_rcu_qsbr_dq_stats stats;
+	struct rte_rcu_qsbr_dq *dq;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	rte_tel_data_start_dict(d);
+	rte_spinlock_lock(&dq_list_lock);
+	TAILQ_FOREACH(dq, &dq_list, next) {
+		if (strncmp(dq->r->name, params, RTE_RCU_QSBR_DQ_NAMESIZE))
+			continue;
+
+		rte_rcu_qsbr_dq_stats_get(dq, &stats);
+		rte_tel_data_add_dict_string(d, "name", dq->r->name);
+		rte_tel_data_add_dict_uint(d, "flags", dq->flags);
+		rte_tel_data_add_dict_uint(d, "size", dq->size);
+		rte_tel_data_add_dict_uint(d, "esize",
+					   dq->esize - __RTE_QSBR_TOKEN_SIZE);
+		if (dq->flags & RTE_RCU_QSBR_DQ_PER_LCORE)
+			rte_tel_data_add_dict_uint(d, "lcore_batch_size",
+						   dq->batch_size);
+		if (dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE)
+			rte_tel_data_add_dict_uint(d, "service_id",
+						   dq->service_id);
+		rte_tel_data_add_dict_uint(d, "enqueued", stats.enqueued);
+		rte_tel_data_add_dict_uint(d, "reclaimed", stats.reclaimed);
+		rte_tel_data_add_dict_uint(d, "tokens", stats.tokens);
+		rte_tel_data_add_dict_uint(d, "full", stats.full);
+		rte_tel_data_add_dict_uint(d, "pending", stats.pending);
+		rte_tel_data_add_dict_uint(d, "nb_lcores", stats.nb_lcores);
+		break;
+	}
+	rte_spinlock_unlock(&dq_list_lock);
+
+	return 0;
+}
+
+RTE_INIT(rcu_qsbr_init_telemetry)
+{
+	rte_telemetry_register_cmd("/rcu_qsbr/dq_list",
+		rcu_qsbr_dq_handle_list,
+		"Returns list of RCU defer queues. Takes no parameters");
+	rte_telemetry_register_cmd("/rcu_qsbr/dq_info",
+		rcu_qsbr_dq_handle_info,
+		"Returns RCU defer queue statistics. Parameters: dq_name");
+}
+
 RTE_LOG_REGISTER_DEFAULT(rte_rcu_log_type, ERR);
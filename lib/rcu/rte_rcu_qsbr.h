@@ -145,6 +145,24 @@ typedef void (*rte_rcu_qsbr_free_resource_t)(void *p, void *e, unsigned int n);
  *   Set this flag if multi-thread safety is not required.
  */
 #define RTE_RCU_QSBR_DQ_MT_UNSAFE 1
+/**< Give each lcore enqueuing resources its own defer queue, created on its
+ *   first enqueue, so that writers on several lcores do not contend.
+ *   The resources enqueued by an lcore are batched and a single grace
+ *   period is started for a batch of 'lcore_batch_size' resources, or for
+ *   a smaller batch when the lcore reclaims resources.
+ *   Resources enqueued by non-EAL threads go to the shared defer queue.
+ *   Resources are reclaimed a batch at a time, so a reclamation can free
+ *   more resources than requested, by less than a batch.
+ *   Not supported with RTE_RCU_QSBR_DQ_MT_UNSAFE.
+ */
+#define RTE_RCU_QSBR_DQ_PER_LCORE 2
+/**< Register a service reclaiming the resources of the defer queue.
+ *   The application maps it to a service lcore, see
+ *   rte_rcu_qsbr_dq_service_id_get(). Enqueue does not trigger automatic
+ *   reclamation then, it only reclaims from a full defer queue.
+ *   Not supported with RTE_RCU_QSBR_DQ_MT_UNSAFE.
+ */
+#define RTE_RCU_QSBR_DQ_RECLAIM_SERVICE 4
 
 /**
  * Parameters used when creating the defer queue.
@@ -190,6 +208,34 @@ struct rte_rcu_qsbr_dq_parameters {
 	 */
 	struct rte_rcu_qsbr *v;
 	/**< RCU QSBR variable to use for this defer queue */
+	uint32_t lcore_batch_size;
+	/**< With RTE_RCU_QSBR_DQ_PER_LCORE, number of resources sharing
+	 *   a grace period in the defer queue of an lcore.
+	 *   If this is set to 0, RTE_RCU_QSBR_DQ_LCORE_BATCH_SIZE is used.
+	 */
+};
+
+/** Default number of resources per grace period of the lcore defer queues. */
+#define RTE_RCU_QSBR_DQ_LCORE_BATCH_SIZE 32
+
+/**
+ * Statistics of a defer queue.
+ */
+struct rte_rcu_qsbr_dq_stats {
+	uint64_t enqueued;
+	/**< Number of resources enqueued. */
+	uint64_t reclaimed;
+	/**< Number of resources freed. */
+	uint64_t tokens;
+	/**< Number of grace periods started for the enqueued resources. */
+	uint64_t full;
+	/**< Number of enqueues which failed as the defer queue was full. */
+	uint64_t pending;
+	/**< Number of resources waiting on the defer queue. This number
+	 *   might not be accurate while resources are enqueued or reclaimed.
+	 */
+	uint32_t nb_lcores;
+	/**< Number of lcores with their own defer queue. */
 };
 
 /* RTE defer queue structure.
@@ -837,6 +883,54 @@ __rte_experimental
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the statistics of a defer queue.
+ *
+ * The statistics are also reported by the /rcu_qsbr/dq_info telemetry
+ * command.
+ *
+ * @param dq
+ *   Defer queue.
+ * @param stats
+ *   Structure to fill with the statistics.
+ * @return
+ *   On success - 0
+ *   On error - 1 with rte_errno set to
+ *   - EINVAL - NULL parameters are passed
+ */
+__rte_experimental
+int
+rte_rcu_qsbr_dq_stats_get(struct rte_rcu_qsbr_dq *dq,
+	struct rte_rcu_qsbr_dq_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the ID of the service reclaiming the resources of a defer queue
+ * created with RTE_RCU_QSBR_DQ_RECLAIM_SERVICE.
+ *
+ * The application maps the service to a service lcore
+ * and sets its run state with the service API.
+ *
+ * @param dq
+ *   Defer queue.
+ * @param service_id
+ *   Location to store the service ID.
+ * @return
+ *   On success - 0
+ *   On error - 1 with rte_errno set to
+ *   - EINVAL - NULL parameters are passed
+ *   - ESRCH - The defer queue has no reclamation service
+ */
+__rte_experimental
+int
+rte_rcu_qsbr_dq_service_id_get(const struct rte_rcu_qsbr_dq *dq,
+	uint32_t *service_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,10 +50,19 @@ struct rte_reorder_buffer {
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
 	int is_initialized;
+	int is_mp; /**< multi-producer insert, see rte_reorder_create_mp() */
+	/**
+	 * Sequence number up to which the multi-producer drain skips the
+	 * missing mbufs, raised by the inserts of early mbufs.
+	 */
+	uint32_t skip_seqn __rte_cache_aligned;
 } __rte_cache_aligned;
 
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
+static struct rte_reorder_buffer *
+reorder_create(const char *name, unsigned int socket_id, unsigned int size,
+		int is_mp);
 
 struct rte_reorder_buffer *
 rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
@@ -147,6 +156,20 @@ rte_reorder_entry_insert(struct rte_tailq_entry *new_te)
 
 struct rte_reorder_buffer*
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 0);
+}
+
+struct rte_reorder_buffer *
+rte_reorder_create_mp(const char *name, unsigned int socket_id,
+		unsigned int size)
+{
+	return reorder_create(name, socket_id, size, 1);
+}
+
+static struct rte_reorder_buffer *
+reorder_create(const char *name, unsigned int socket_id, unsigned int size,
+		int is_mp)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te, *te_inserted;
@@ -188,6 +211,11 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 			rte_free(te);
 			return NULL;
 		}
+		if (is_mp) {
+			/* the window starts at 0 or at rte_reorder_min_seqn_set() */
+			b->is_mp = 1;
+			b->is_initialized = 1;
+		}
 		te->data = (void *)b;
 	}
 
@@ -205,11 +233,14 @@ void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
 	char name[RTE_REORDER_NAMESIZE];
+	int is_mp = b->is_mp;
 
 	rte_reorder_free_mbufs(b);
 	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
 	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	b->is_mp = is_mp;
+	b->is_initialized = is_mp;
 }
 
 static void
@@ -339,6 +370,73 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	return order_head_adv;
 }
 
+/*
+ * Multi-producer insert: the mbuf of sequence number seqn is stored in
+ * order_buf entry (seqn & mask), claimed with an atomic compare and swap.
+ * The single consumer clears the entries it drains before moving
+ * min_seqn forward, so the entries of the window are free or hold
+ * an mbuf of the window.
+ */
+static int
+reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	struct rte_mbuf *empty, **entry;
+	uint32_t seqn, offset, skip, target;
+
+	seqn = *rte_reorder_seqn(mbuf);
+	offset = seqn - __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+
+	if (offset >= 2 * order_buf->size) {
+		/* late, or vastly out of the window */
+		rte_errno = ERANGE;
+		return -1;
+	}
+
+	if (offset >= order_buf->size) {
+		/*
+		 * Early mbuf: the producers cannot move the window, ask the
+		 * consumer to skip the missing mbufs up to the one making
+		 * room for this mbuf on its next drain.
+		 */
+		target = seqn - order_buf->size + 1;
+		skip = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+		while ((int32_t)(target - skip) > 0 &&
+				!__atomic_compare_exchange_n(&b->skip_seqn,
+					&skip, target, 1, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED))
+			;
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	entry = &order_buf->entries[seqn & order_buf->mask];
+	empty = NULL;
+	if (!__atomic_compare_exchange_n(entry, &empty, mbuf, 0,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		/*
+		 * The entry still holds a late mbuf of the previous window,
+		 * it is released by the next drain.
+		 */
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	/*
+	 * The consumer may have skipped over this sequence number meanwhile,
+	 * take the mbuf back unless it got drained.
+	 */
+	offset = seqn - __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+	if (offset >= order_buf->size &&
+			__atomic_compare_exchange_n(entry, &mbuf, NULL, 0,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		rte_errno = ERANGE;
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 {
@@ -350,6 +448,9 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 		return -1;
 	}
 
+	if (b->is_mp)
+		return reorder_insert_mp(b, mbuf);
+
 	order_buf = &b->order_buf;
 	if (!b->is_initialized) {
 		b->min_seqn = *rte_reorder_seqn(mbuf);
@@ -405,6 +506,61 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	return 0;
 }
 
+/*
+ * Multi-producer drain, run by a single consumer. The ready buffer is
+ * not used, the missing mbufs are skipped up to skip_seqn instead.
+ */
+static unsigned int
+reorder_drain_mp(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	struct rte_mbuf *m, **entry;
+	unsigned int drain_cnt = 0;
+	uint32_t seqn, skip;
+
+	/* only the consumer writes min_seqn */
+	seqn = b->min_seqn;
+	skip = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+
+	while (drain_cnt < max_mbufs) {
+		entry = &order_buf->entries[seqn & order_buf->mask];
+		m = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+		if (m == NULL) {
+			/* wait for the missing mbuf, unless asked to skip it */
+			if ((int32_t)(skip - seqn) <= 0)
+				break;
+			seqn++;
+			continue;
+		}
+
+		if (unlikely(*rte_reorder_seqn(m) != seqn)) {
+			/*
+			 * Late mbuf stored while the window skipped over its
+			 * sequence number, its producer may be taking it back.
+			 */
+			if (__atomic_compare_exchange_n(entry, &m, NULL, 0,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				mbufs[drain_cnt++] = m;
+			continue;
+		}
+
+		__atomic_store_n(entry, NULL, __ATOMIC_RELAXED);
+		mbufs[drain_cnt++] = m;
+		seqn++;
+	}
+
+	/* hand the drained entries back to the producers */
+	__atomic_store_n(&b->min_seqn, seqn, __ATOMIC_RELEASE);
+
+	/* keep skip_seqn close to the window for the wrap around compare */
+	if ((int32_t)(seqn - skip) > 0)
+		__atomic_compare_exchange_n(&b->skip_seqn, &skip, seqn, 0,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+	return drain_cnt;
+}
+
 unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs)
@@ -414,6 +570,9 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->is_mp)
+		return reorder_drain_mp(b, mbufs, max_mbufs);
+
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
@@ -473,6 +632,10 @@ rte_reorder_drain_up_to_seqn(struct rte_reorder_buffer *b, struct rte_mbuf **mbu
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	/* Not supported by multi-producer buffers */
+	if (b->is_mp)
+		return 0;
+
 	/* Seqn in Ready buffer */
 	if (seqn < b->min_seqn) {
 		/* All sequence numbers are higher then given */
@@ -540,6 +703,7 @@ rte_reorder_min_seqn_set(struct rte_reorder_buffer *b, rte_reorder_seqn_t min_se
 		return -ENOTEMPTY;
 
 	b->min_seqn = min_seqn;
+	b->skip_seqn = min_seqn;
 	b->is_initialized = true;
 
 	return 0;
@@ -67,6 +67,41 @@ rte_reorder_seqn(struct rte_mbuf *mbuf)
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new multi-producer reorder buffer instance
+ *
+ * Several threads can insert mbufs concurrently into the reorder buffer
+ * returned, with rte_reorder_insert(), while a single thread drains it
+ * with rte_reorder_drain().
+ * The mbufs are stored at the position of their sequence number,
+ * claimed with an atomic operation, and the ready buffer is not used:
+ * an early mbuf cannot be inserted until the next drain moves the
+ * sequence window, skipping the missing mbufs, so that it fits.
+ * The sequence window starts at 0, or at the sequence number given
+ * to rte_reorder_min_seqn_set().
+ * rte_reorder_drain_up_to_seqn() is not supported.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_mp(const char *name, unsigned int socket_id,
+		unsigned int size);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -131,6 +166,10 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  * packets can later be taken from the buffer using the rte_reorder_drain()
  * API.
  *
+ * This function is multi-thread safe with reorder buffers created by
+ * rte_reorder_create_mp(). An mbuf inserted while the drain skips over its
+ * sequence number is either returned with ERANGE or drained out of order.
+ *
  * @param b
  *   Reorder buffer where the mbuf has to be inserted.
  * @param mbuf
@@ -141,6 +180,8 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  *   On error case, rte_errno will be set appropriately:
  *    - ENOSPC - Cannot move existing mbufs from reorder buffer to accommodate
  *      early mbuf, but it can be accommodated by performing drain and then insert.
+ *      With a multi-producer reorder buffer, the insert can be retried
+ *      after the next drain.
  *    - ERANGE - Too early or late mbuf which is vastly out of range of expected
  *      window should be ignored without any handling.
  */
@@ -25,6 +25,7 @@
 
 #include "rte_ring.h"
 #include "rte_ring_elem.h"
+#include "rte_ring_bytes.h"
 
 TAILQ_HEAD(rte_ring_list, rte_tailq_entry);
 
@@ -235,10 +236,13 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	return 0;
 }
 
-/* create the ring for a given element size */
-struct rte_ring *
-rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
-		int socket_id, unsigned int flags)
+/*
+ * create the ring for a given element size, followed by an overflow area
+ * for the records of rec_max bytes of a byte ring
+ */
+static struct rte_ring *
+ring_create(const char *name, unsigned int esize, unsigned int count,
+		unsigned int rec_max, int socket_id, unsigned int flags)
 {
 	char mz_name[RTE_MEMZONE_NAMESIZE];
 	struct rte_ring *r;
@@ -261,6 +265,9 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		rte_errno = -ring_size;
 		return NULL;
 	}
+	if (rec_max != 0)
+		ring_size += RTE_CACHE_LINE_ROUNDUP(RTE_RING_BYTES_ALIGN *
+			(RTE_RING_BYTES_SLOTS(rec_max) - 1));
 
 	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
 		RTE_RING_MZ_PREFIX, name);
@@ -292,6 +299,7 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 
 		te->data = (void *) r;
 		r->memzone = mz;
+		r->rec_max = rec_max;
 
 		TAILQ_INSERT_TAIL(ring_list, te, next);
 	} else {
@@ -304,6 +312,14 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	return r;
 }
 
+/* create the ring for a given element size */
+struct rte_ring *
+rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
+		int socket_id, unsigned int flags)
+{
+	return ring_create(name, esize, count, 0, socket_id, flags);
+}
+
 /* create the ring */
 struct rte_ring *
 rte_ring_create(const char *name, unsigned int count, int socket_id,
@@ -313,6 +329,42 @@ rte_ring_create(const char *name, unsigned int count, int socket_id,
 		flags);
 }
 
+/* create a ring of variable-sized records */
+struct rte_ring *
+rte_ring_bytes_create(const char *name, unsigned int size,
+		unsigned int rec_max, int socket_id, unsigned int flags)
+{
+	const unsigned int count = size / RTE_RING_BYTES_ALIGN;
+	const unsigned int cons = flags &
+		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
+
+	/* the consumer walks the records, it cannot be MC or MC_RTS */
+	if (cons != RING_F_SC_DEQ && cons != RING_F_MC_HTS_DEQ) {
+		RTE_LOG(ERR, RING,
+			"Byte ring requires a single or HTS consumer\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (size % RTE_RING_BYTES_ALIGN != 0 || !POWEROF2(count) ||
+			count < 2 || (flags & RING_F_EXACT_SZ)) {
+		RTE_LOG(ERR, RING,
+			"Requested byte ring size is not a power of 2 slots\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (rec_max == 0 || rec_max > (count - 2) * RTE_RING_BYTES_ALIGN) {
+		RTE_LOG(ERR, RING,
+			"Max record length does not fit in the ring\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	return ring_create(name, RTE_RING_BYTES_ALIGN, count, rec_max,
+		socket_id, flags);
+}
+
 /* free the ring */
 void
 rte_ring_free(struct rte_ring *r)
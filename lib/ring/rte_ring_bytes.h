@@ -0,0 +1,434 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _RTE_RING_BYTES_H_
+#define _RTE_RING_BYTES_H_
+
+/**
+ * @file
+ * RTE Ring of variable-sized records
+ *
+ * A byte ring passes records of variable length between threads,
+ * for example log messages or telemetry samples.
+ * A producer reserves room for a burst of records, fills the records
+ * directly in the ring memory and commits them.
+ * A consumer peeks at a burst of contiguous records, processes them
+ * in place and releases them.
+ *
+ * The ring storage is made of 8B slots, each record takes one slot for
+ * its header plus its length rounded up to 8B, so every record is 8B aligned.
+ * A record crossing the end of the ring storage is not split:
+ * it continues in an overflow area following the ring storage,
+ * sized at creation for the largest record.
+ *
+ * The head/tail synchronization is the one of the regular rings,
+ * the producer can be of any sync type (ST, MT, MT_HTS or MT_RTS),
+ * the consumer must be single (ST) or serialized (MT_HTS).
+ *
+ * Example of producer:
+ *
+ * struct rte_ring_bytes_zc zc;
+ * uint32_t len = snprintf(NULL, 0, ...) + 1;
+ * void *data;
+ *
+ * if (rte_ring_bytes_enqueue_reserve(r, &len, 1, &data, &zc, NULL) != 0) {
+ *	snprintf(data, len, ...);
+ *	rte_ring_bytes_enqueue_commit(r, &zc);
+ * }
+ *
+ * Example of consumer:
+ *
+ * n = rte_ring_bytes_dequeue_peek(r, data, lens, RTE_DIM(data), &zc, NULL);
+ * for (i = 0; i != n; i++)
+ *	fwrite(data[i], lens[i], 1, f);
+ * rte_ring_bytes_dequeue_release(r, &zc);
+ *
+ * For MT_HTS and MT_RTS producers, as for the MT consumers of the
+ * zero-copy peek API, other producers wait until the records are committed,
+ * so the records should be filled quickly.
+ * With MT producers, the commits of the producers are done in order of
+ * reservation.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_compat.h>
+#include <rte_ring.h>
+
+/** Alignment and granularity of the records of a byte ring, in bytes. */
+#define RTE_RING_BYTES_ALIGN	8
+
+/** Number of slots taken by a record of *len* bytes, header included. */
+#define RTE_RING_BYTES_SLOTS(len)	\
+	(((len) + 2 * RTE_RING_BYTES_ALIGN - 1) / RTE_RING_BYTES_ALIGN)
+
+/**
+ * Byte ring zero-copy information structure.
+ *
+ * It is filled by the reserve and peek functions and given back
+ * to the matching commit and release functions.
+ */
+struct rte_ring_bytes_zc {
+	uint32_t head; /**< Position of the first slot, internal. */
+	uint32_t num;  /**< Number of slots, internal. */
+};
+
+/** @internal Header preceding the data of a record in a byte ring. */
+struct __rte_ring_bytes_hdr {
+	uint32_t len;  /**< Length of the record data, in bytes. */
+	uint32_t rsvd; /**< Reserved. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a new byte ring named *name*.
+ *
+ * The ring is allocated with ``memzone_reserve()``, it is added to the
+ * RTE_TAILQ_RING list and it is freed with rte_ring_free().
+ * The usable size is *size* minus 8 bytes, to differentiate a full ring
+ * from an empty ring. The ring counters such as rte_ring_count() or
+ * rte_ring_free_count() are in slots of RTE_RING_BYTES_ALIGN bytes.
+ *
+ * @param name
+ *   The name of the ring.
+ * @param size
+ *   The size of the ring storage in bytes,
+ *   RTE_RING_BYTES_ALIGN times a power of 2.
+ * @param rec_max
+ *   The maximum length of a record, in bytes. A record and its header
+ *   must fit in the usable size of the ring.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of
+ *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA
+ *   constraint for the reserved zone.
+ * @param flags
+ *   An OR of the following:
+ *   - One of mutually exclusive flags that define producer behavior:
+ *      - RING_F_SP_ENQ: single producer.
+ *      - RING_F_MP_RTS_ENQ: multi-producer RTS mode.
+ *      - RING_F_MP_HTS_ENQ: multi-producer HTS mode.
+ *     If none of these flags is set, then multi-producer mode is selected.
+ *   - One of mutually exclusive flags that define consumer behavior:
+ *      - RING_F_SC_DEQ: single consumer.
+ *      - RING_F_MC_HTS_DEQ: multi-consumer HTS mode.
+ *     One of these flags must be set.
+ * @return
+ *   On success, the pointer to the new allocated ring. NULL on error with
+ *    rte_errno set appropriately. Possible errno values include:
+ *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
+ *    - EINVAL - invalid size, record length or flags
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_ring *rte_ring_bytes_create(const char *name, unsigned int size,
+	unsigned int rec_max, int socket_id, unsigned int flags);
+
+/**
+ * @internal Fills the data pointers and the lengths of the records
+ * committed from *head*, up to *n* records and *avail* slots.
+ * Returns the number of slots of the records found, *n* is set to the
+ * number of records.
+ */
+static __rte_always_inline uint32_t
+__rte_ring_bytes_walk(struct rte_ring *r, uint32_t head, uint32_t avail,
+	void **data, uint32_t *lens, unsigned int *n)
+{
+	struct __rte_ring_bytes_hdr *hdr;
+	uint64_t *slots = (uint64_t *)&r[1];
+	uint32_t i, len, num, off = 0;
+
+	for (i = 0; i != *n && off != avail; i++) {
+		hdr = (struct __rte_ring_bytes_hdr *)
+			&slots[(head + off) & r->mask];
+		len = hdr->len;
+		num = RTE_RING_BYTES_SLOTS(len);
+		/* only seen if another consumer took the records meanwhile */
+		if (unlikely(num > avail - off))
+			break;
+		data[i] = hdr + 1;
+		lens[i] = len;
+		off += num;
+	}
+
+	*n = i;
+	return off;
+}
+
+/**
+ * @internal Moves the consumer head of a byte ring in MT_HTS mode
+ * over the records found.
+ */
+static __rte_always_inline uint32_t
+__rte_ring_bytes_hts_move_cons_head(struct rte_ring *r, void **data,
+	uint32_t *lens, unsigned int *n, uint32_t *old_head, uint32_t *entries)
+{
+	union __rte_ring_hts_pos np, op;
+	const unsigned int max = *n;
+	uint32_t num;
+
+	op.raw = __atomic_load_n(&r->hts_cons.ht.raw, __ATOMIC_ACQUIRE);
+
+	do {
+		*n = max;
+
+		/* wait for the other consumers to release their records */
+		__rte_ring_hts_head_wait(&r->hts_cons, &op);
+
+		*entries = __atomic_load_n(&r->prod.tail, __ATOMIC_ACQUIRE) -
+			op.pos.head;
+		num = __rte_ring_bytes_walk(r, op.pos.head, *entries, data,
+			lens, n);
+		if (unlikely(num == 0))
+			break;
+
+		np.pos.tail = op.pos.tail;
+		np.pos.head = op.pos.head + num;
+
+	/*
+	 * The records were read before the head was taken, the CAS fails
+	 * if another consumer took them meanwhile.
+	 */
+	} while (__atomic_compare_exchange_n(&r->hts_cons.ht.raw,
+			&op.raw, np.raw,
+			0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) == 0);
+
+	*old_head = op.pos.head;
+	return num;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reserve room for a burst of records in a byte ring.
+ *
+ * Either all the records are reserved or none of them.
+ * On success, the records must be filled through the *data* pointers
+ * and then made visible to the consumer with rte_ring_bytes_enqueue_commit().
+ *
+ * @param r
+ *   A pointer to the ring structure, created with rte_ring_bytes_create().
+ * @param lens
+ *   An array of *n* record lengths, in bytes. No length may exceed the
+ *   maximum record length of the ring.
+ * @param n
+ *   The number of records to reserve.
+ * @param data
+ *   An array of *n* pointers filled with the data area of each record,
+ *   aligned on RTE_RING_BYTES_ALIGN bytes.
+ * @param zc
+ *   A structure filled with the reservation, for the commit.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   reservation has finished, in bytes.
+ * @return
+ *   The number of records reserved, either 0 or n.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_bytes_enqueue_reserve(struct rte_ring *r, const uint32_t *lens,
+	unsigned int n, void **data, struct rte_ring_bytes_zc *zc,
+	unsigned int *free_space)
+{
+	struct __rte_ring_bytes_hdr *hdr;
+	uint64_t *slots = (uint64_t *)&r[1];
+	uint32_t free, head, next, i, num = 0;
+
+	for (i = 0; i != n; i++) {
+		if (unlikely(lens[i] > r->rec_max)) {
+			zc->num = 0;
+			if (free_space != NULL)
+				*free_space = rte_ring_free_count(r) *
+					RTE_RING_BYTES_ALIGN;
+			return 0;
+		}
+		num += RTE_RING_BYTES_SLOTS(lens[i]);
+	}
+
+	switch (r->prod.sync_type) {
+	case RTE_RING_SYNC_MT:
+	case RTE_RING_SYNC_ST:
+		num = __rte_ring_move_prod_head(r, r->prod.sync_type, num,
+			RTE_RING_QUEUE_FIXED, &head, &next, &free);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		num = __rte_ring_hts_move_prod_head(r, num,
+			RTE_RING_QUEUE_FIXED, &head, &free);
+		break;
+	case RTE_RING_SYNC_MT_RTS:
+		num = __rte_ring_rts_move_prod_head(r, num,
+			RTE_RING_QUEUE_FIXED, &head, &free);
+		break;
+	default:
+		/* valid ring should never reach this point */
+		RTE_ASSERT(0);
+		num = 0;
+		free = 0;
+		head = 0;
+	}
+
+	if (num == 0)
+		n = 0;
+
+	/* a record crossing the end of the ring goes on in the overflow area */
+	for (i = 0, next = head; i != n; i++) {
+		hdr = (struct __rte_ring_bytes_hdr *)&slots[next & r->mask];
+		hdr->len = lens[i];
+		data[i] = hdr + 1;
+		next += RTE_RING_BYTES_SLOTS(lens[i]);
+	}
+
+	zc->head = head;
+	zc->num = num;
+	if (free_space != NULL)
+		*free_space = (free - num) * RTE_RING_BYTES_ALIGN;
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Commit the records reserved by rte_ring_bytes_enqueue_reserve(),
+ * making them visible to the consumer.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param zc
+ *   The reservation filled by rte_ring_bytes_enqueue_reserve().
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_ring_bytes_enqueue_commit(struct rte_ring *r,
+	const struct rte_ring_bytes_zc *zc)
+{
+	/* nothing was reserved */
+	if (zc->num == 0)
+		return;
+
+	switch (r->prod.sync_type) {
+	case RTE_RING_SYNC_MT:
+	case RTE_RING_SYNC_ST:
+		__rte_ring_update_tail(&r->prod, zc->head, zc->head + zc->num,
+			r->prod.sync_type, 1);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		__rte_ring_hts_update_tail(&r->hts_prod, zc->head, zc->num, 1);
+		break;
+	case RTE_RING_SYNC_MT_RTS:
+		__rte_ring_rts_update_tail(&r->rts_prod);
+		break;
+	default:
+		/* valid ring should never reach this point */
+		RTE_ASSERT(0);
+	}
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get a burst of records from a byte ring, without copying them.
+ *
+ * The records stay in the ring until they are released with
+ * rte_ring_bytes_dequeue_release(). With an MT_HTS consumer,
+ * the other consumers wait until the records are released.
+ *
+ * @param r
+ *   A pointer to the ring structure, created with rte_ring_bytes_create().
+ * @param data
+ *   An array of at least *n* pointers filled with the data of the records.
+ * @param lens
+ *   An array of at least *n* lengths filled with the length of the records.
+ * @param n
+ *   The maximum number of records to get.
+ * @param zc
+ *   A structure filled with the records taken, for the release.
+ * @param available
+ *   If non-NULL, returns the amount of data remaining in the ring
+ *   after the records taken, in bytes.
+ * @return
+ *   The number of records taken, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_bytes_dequeue_peek(struct rte_ring *r, void **data, uint32_t *lens,
+	unsigned int n, struct rte_ring_bytes_zc *zc, unsigned int *available)
+{
+	uint32_t entries, head, num;
+
+	switch (r->cons.sync_type) {
+	case RTE_RING_SYNC_ST:
+		head = r->cons.head;
+		entries = __atomic_load_n(&r->prod.tail, __ATOMIC_ACQUIRE) -
+			head;
+		num = __rte_ring_bytes_walk(r, head, entries, data, lens, &n);
+		r->cons.head = head + num;
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		num = __rte_ring_bytes_hts_move_cons_head(r, data, lens, &n,
+			&head, &entries);
+		break;
+	default:
+		/* valid ring should never reach this point */
+		RTE_ASSERT(0);
+		head = 0;
+		num = 0;
+		entries = 0;
+		n = 0;
+	}
+
+	zc->head = head;
+	zc->num = num;
+	if (available != NULL)
+		*available = (entries - num) * RTE_RING_BYTES_ALIGN;
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release the records taken by rte_ring_bytes_dequeue_peek(),
+ * giving their room back to the producers.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param zc
+ *   The records filled by rte_ring_bytes_dequeue_peek().
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_ring_bytes_dequeue_release(struct rte_ring *r,
+	const struct rte_ring_bytes_zc *zc)
+{
+	/* nothing was taken */
+	if (zc->num == 0)
+		return;
+
+	switch (r->cons.sync_type) {
+	case RTE_RING_SYNC_ST:
+		__rte_ring_update_tail(&r->cons, zc->head, zc->head + zc->num,
+			1, 0);
+		break;
+	case RTE_RING_SYNC_MT_HTS:
+		__rte_ring_hts_update_tail(&r->hts_cons, zc->head, zc->num, 0);
+		break;
+	default:
+		/* valid ring should never reach this point */
+		RTE_ASSERT(0);
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_BYTES_H_ */
@@ -126,6 +126,7 @@ struct rte_ring {
 	uint32_t size;           /**< Size of ring. */
 	uint32_t mask;           /**< Mask (size-1) of ring. */
 	uint32_t capacity;       /**< Usable size of ring */
+	uint32_t rec_max;        /**< Max record length of a byte ring */
 
 	char pad0 __rte_cache_aligned; /**< empty cache line */
 
@@ -18,9 +18,37 @@
 #include <rte_random.h>
 #include <rte_pause.h>
 #include <rte_memzone.h>
+#include <rte_malloc.h>
 
 #include "rte_timer.h"
 
+/* Number of bits of the tick indexing one level of a timing wheel. */
+#define TIMER_WHEEL_BITS	6
+/* Number of slots in a timing wheel level. */
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+/* Number of levels needed to cover 64-bit ticks. */
+#define TIMER_WHEEL_LEVELS	((64 + TIMER_WHEEL_BITS - 1) / TIMER_WHEEL_BITS)
+
+/**
+ * Per-lcore hierarchical timing wheel.
+ *
+ * A level l slot holds the timers whose tick differs from the current
+ * tick in bits [6 * l, 6 * l + 6) but not above. When the current tick
+ * enters a slot of an upper level, its timers are cascaded to the lower
+ * levels. The timers of a slot are linked in a doubly linked list
+ * reusing the skiplist pointers of the timer: sl_next[0] points to the
+ * next timer and sl_next[1] holds the address of the pointer to the
+ * timer itself, so a timer is unlinked without knowing its slot.
+ */
+struct timer_wheel {
+	uint64_t cur;                 /**< first tick not processed yet */
+	uint32_t shift;               /**< log2 of cycles per tick */
+	uint32_t nb_timers;           /**< number of timers in the wheel */
+	uint64_t bitmap[TIMER_WHEEL_LEVELS]; /**< non-empty slots */
+	struct rte_timer *slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -40,6 +68,9 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timing wheel, NULL if the timers are kept in the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -50,6 +81,7 @@ struct priv_timer {
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
 	uint8_t internal_flags;
+	struct timer_wheel *wheels; /**< per-lcore wheels of a wheel backend */
 };
 
 #define RTE_MAX_DATA_ELS 64
@@ -84,6 +116,22 @@ timer_data_valid(uint32_t id)
 	timer_data = &rte_timer_data_arr[id];				\
 } while (0)
 
+static void
+timer_data_free_wheels(struct rte_timer_data *data)
+{
+	unsigned int lcore_id;
+
+	if (data->wheels == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		data->priv_timer[lcore_id].wheel = NULL;
+		data->priv_timer[lcore_id].pending_head.expire = 0;
+	}
+	rte_free(data->wheels);
+	data->wheels = NULL;
+}
+
 int
 rte_timer_data_alloc(uint32_t *id_ptr)
 {
@@ -114,11 +162,68 @@ rte_timer_data_dealloc(uint32_t id)
 	struct rte_timer_data *timer_data;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	timer_data_free_wheels(timer_data);
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
 }
 
+int
+rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			  const struct rte_timer_data_conf *conf)
+{
+	struct rte_timer_data *data;
+	uint64_t resolution;
+	uint32_t id, shift;
+	unsigned int lcore_id;
+	uint64_t cur_tick;
+	int ret;
+
+	if (conf == NULL)
+		return -EINVAL;
+
+	switch (conf->backend) {
+	case RTE_TIMER_BACKEND_SKIPLIST:
+		return rte_timer_data_alloc(id_ptr);
+	case RTE_TIMER_BACKEND_WHEEL:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	resolution = conf->wheel_resolution;
+	if (resolution == 0)
+		resolution = rte_get_timer_hz() / US_PER_S;
+	if (resolution > (UINT64_C(1) << 63))
+		return -EINVAL;
+	shift = rte_log2_u64(resolution);
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret != 0)
+		return ret;
+	data = &rte_timer_data_arr[id];
+
+	data->wheels = rte_zmalloc("rte_timer_wheel",
+		sizeof(*data->wheels) * RTE_MAX_LCORE, RTE_CACHE_LINE_SIZE);
+	if (data->wheels == NULL) {
+		data->internal_flags &= ~(FL_ALLOCATED);
+		return -ENOMEM;
+	}
+
+	cur_tick = rte_get_timer_cycles() >> shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		data->wheels[lcore_id].cur = cur_tick;
+		data->wheels[lcore_id].shift = shift;
+		data->priv_timer[lcore_id].wheel = &data->wheels[lcore_id];
+		data->priv_timer[lcore_id].pending_head.expire = UINT64_MAX;
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
 /* Init the timer library. Allocate an array of timer data structs in shared
  * memory, and allocate the zeroth entry for use with original timer
  * APIs. Since the intersection of the sets of lcore ids in primary and
@@ -194,8 +299,13 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		int i;
+
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			timer_data_free_wheels(&rte_timer_data_arr[i]);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -382,6 +492,293 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/*
+ * Append the timers of list tim, linked by sl_next[0], to the run list
+ * ending at tail, marking them as running. Timers detached from wheel w
+ * are marked as not being in a slot. Return the new end of the run list.
+ */
+static struct rte_timer **
+timer_run_list_append(struct rte_timer **tail, struct rte_timer *tim,
+		      struct timer_wheel *w)
+{
+	struct rte_timer *next_tim;
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		if (w != NULL) {
+			tim->sl_next[1] = NULL;
+			w->nb_timers--;
+		}
+
+		/* if another core is trying to re-config this one,
+		 * leave it out of the run list
+		 */
+		if (likely(timer_set_running_state(tim) == 0)) {
+			*tail = tim;
+			tail = &tim->sl_next[0];
+		}
+	}
+	*tail = NULL;
+
+	return tail;
+}
+
+/*
+ * Tick of the wheel slot where a timer expiring at cycle expire is run,
+ * rounded up so that a timer never runs before its expiry time.
+ */
+static inline uint64_t
+wheel_tick(const struct timer_wheel *w, uint64_t expire)
+{
+	return (expire >> w->shift) +
+		((expire & ((UINT64_C(1) << w->shift) - 1)) != 0);
+}
+
+/* First cycle of a tick, saturated on overflow. */
+static inline uint64_t
+wheel_tick_cycles(const struct timer_wheel *w, uint64_t tick)
+{
+	if (tick > (UINT64_MAX >> w->shift))
+		return UINT64_MAX;
+	return tick << w->shift;
+}
+
+/* Link a timer in the slot matching its tick. */
+static void
+wheel_link(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **head;
+	uint64_t tick;
+	uint32_t lvl, idx;
+
+	tick = RTE_MAX(wheel_tick(w, tim->expire), w->cur);
+	lvl = (tick == w->cur) ? 0 :
+		(rte_fls_u64(tick ^ w->cur) - 1) / TIMER_WHEEL_BITS;
+	idx = (tick >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+
+	head = &w->slot[lvl][idx];
+	tim->sl_next[0] = *head;
+	if (*head != NULL)
+		(*head)->sl_next[1] = (struct rte_timer *)&tim->sl_next[0];
+	tim->sl_next[1] = (struct rte_timer *)head;
+	*head = tim;
+	w->bitmap[lvl] |= UINT64_C(1) << idx;
+}
+
+/*
+ * Unlink a timer from its slot. A timer detached from the wheel to run
+ * has no slot, and is left untouched.
+ */
+static void
+wheel_unlink(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = (struct rte_timer **)tim->sl_next[1];
+	struct rte_timer *next = tim->sl_next[0];
+	uintptr_t slot;
+
+	if (pprev == NULL)
+		return;
+	w->nb_timers--;
+	tim->sl_next[1] = NULL;
+
+	*pprev = next;
+	if (next != NULL) {
+		next->sl_next[1] = (struct rte_timer *)pprev;
+		return;
+	}
+
+	/* the slot is empty if the timer was its only entry */
+	slot = (uintptr_t)pprev - (uintptr_t)&w->slot[0][0];
+	if (slot < sizeof(w->slot)) {
+		slot /= sizeof(w->slot[0][0]);
+		w->bitmap[slot / TIMER_WHEEL_SLOTS] &=
+			~(UINT64_C(1) << (slot % TIMER_WHEEL_SLOTS));
+	}
+}
+
+/* Detach the list of timers of a slot. */
+static struct rte_timer *
+wheel_detach_slot(struct timer_wheel *w, uint32_t lvl, uint32_t idx)
+{
+	struct rte_timer *tim = w->slot[lvl][idx];
+
+	w->slot[lvl][idx] = NULL;
+	w->bitmap[lvl] &= ~(UINT64_C(1) << idx);
+	return tim;
+}
+
+/*
+ * The current tick has just entered new slots of the upper levels:
+ * spread their timers on the lower levels, the highest level first.
+ * The timers expired at tick now are appended to the run list ending
+ * at tail instead. Return the new end of the run list.
+ */
+static struct rte_timer **
+wheel_cascade(struct timer_wheel *w, uint64_t now, struct rte_timer **tail)
+{
+	struct rte_timer *tim, *next_tim;
+	uint32_t lvl, idx;
+
+	for (lvl = TIMER_WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+		if ((w->cur & ((UINT64_C(1) << (lvl * TIMER_WHEEL_BITS)) - 1))
+				!= 0)
+			continue;
+		idx = (w->cur >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+		if ((w->bitmap[lvl] & (UINT64_C(1) << idx)) == 0)
+			continue;
+		for (tim = wheel_detach_slot(w, lvl, idx); tim != NULL;
+				tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			if (wheel_tick(w, tim->expire) <= now) {
+				tim->sl_next[0] = NULL;
+				tail = timer_run_list_append(tail, tim, w);
+			} else {
+				wheel_link(w, tim);
+			}
+		}
+	}
+
+	return tail;
+}
+
+/*
+ * Return the first tick of the first non-empty slot, or UINT64_MAX if
+ * the wheel is empty. All timers of a level expire before those of the
+ * level above, and the slots of the upper levels containing the current
+ * tick are always empty.
+ */
+static uint64_t
+wheel_next_tick(const struct timer_wheel *w, uint32_t first_lvl)
+{
+	uint64_t bm, hi_mask;
+	uint32_t lvl, idx, sh;
+
+	if (first_lvl == 0) {
+		bm = w->bitmap[0] & (UINT64_MAX << (w->cur & TIMER_WHEEL_MASK));
+		if (bm != 0)
+			return (w->cur & ~(uint64_t)TIMER_WHEEL_MASK) |
+				rte_bsf64(bm);
+		first_lvl = 1;
+	}
+
+	for (lvl = first_lvl; lvl < TIMER_WHEEL_LEVELS; lvl++) {
+		sh = lvl * TIMER_WHEEL_BITS;
+		idx = (w->cur >> sh) & TIMER_WHEEL_MASK;
+		bm = w->bitmap[lvl] & ((UINT64_MAX << idx) << 1);
+		if (bm == 0)
+			continue;
+		hi_mask = (sh + TIMER_WHEEL_BITS >= 64) ? 0 :
+			UINT64_MAX << (sh + TIMER_WHEEL_BITS);
+		return (w->cur & hi_mask) | ((uint64_t)rte_bsf64(bm) << sh);
+	}
+
+	return UINT64_MAX;
+}
+
+/* call with lock held as necessary, add a timer in the wheel */
+static void
+wheel_add(struct rte_timer *tim, struct priv_timer *priv_timer)
+{
+	struct timer_wheel *w = priv_timer->wheel;
+	uint64_t first;
+
+	wheel_link(w, tim);
+	w->nb_timers++;
+
+	/* keep the expire field of the dummy hdr as a lower bound of the
+	 * next expiry time, for the lockless check of the manage functions
+	 */
+	first = wheel_tick_cycles(w, RTE_MAX(wheel_tick(w, tim->expire),
+		w->cur));
+	if (first < priv_timer->pending_head.expire)
+		priv_timer->pending_head.expire = first;
+}
+
+/* call with lock held as necessary, remove a timer from the wheel */
+static void
+wheel_del(struct rte_timer *tim, struct priv_timer *priv_timer)
+{
+	struct timer_wheel *w = priv_timer->wheel;
+
+	wheel_unlink(w, tim);
+}
+
+/*
+ * Advance the wheel up to cur_time and return the expired timers marked
+ * as running, linked by sl_next[0]. The timers are collected slot by slot
+ * without being sorted: an upper level slot expired as a whole is moved
+ * at once, and the expired timers of a slot expired in part are moved
+ * while cascading the others. Call with lock held.
+ */
+static struct rte_timer *
+wheel_get_expired(struct priv_timer *priv_timer, uint64_t cur_time)
+{
+	struct timer_wheel *w = priv_timer->wheel;
+	uint64_t now = cur_time >> w->shift;
+	struct rte_timer *run_first_tim = NULL;
+	struct rte_timer **tail = &run_first_tim;
+	uint64_t tick, span;
+	uint32_t lvl;
+
+	while (w->cur <= now) {
+		tick = wheel_next_tick(w, 0);
+		if (tick > now) {
+			w->cur = now + 1;
+			/* a slot may start right after now */
+			if ((w->cur & TIMER_WHEEL_MASK) == 0)
+				tail = wheel_cascade(w, now, tail);
+			break;
+		}
+
+		lvl = (tick == w->cur) ? 0 :
+			(rte_fls_u64(tick ^ w->cur) - 1) / TIMER_WHEEL_BITS;
+		span = UINT64_C(1) << (lvl * TIMER_WHEEL_BITS);
+		if (lvl != 0 && tick + span - 1 > now) {
+			/* the slot expires in part */
+			w->cur = tick;
+			tail = wheel_cascade(w, now, tail);
+			continue;
+		}
+
+		tail = timer_run_list_append(tail, wheel_detach_slot(w, lvl,
+			(tick >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK),
+			w);
+
+		w->cur = tick + span;
+		if ((w->cur & TIMER_WHEEL_MASK) == 0)
+			tail = wheel_cascade(w, now, tail);
+	}
+
+	/* update the next to expire timer value */
+	priv_timer->pending_head.expire =
+		wheel_tick_cycles(w, wheel_next_tick(w, 0));
+
+	return run_first_tim;
+}
+
+/* call with lock held as necessary, return the earliest expiry time */
+static uint64_t
+wheel_first_expire(const struct timer_wheel *w)
+{
+	const struct rte_timer *tim;
+	uint64_t tick, first = UINT64_MAX;
+	uint32_t lvl, idx;
+
+	tick = wheel_next_tick(w, 0);
+	if (tick == UINT64_MAX)
+		return UINT64_MAX;
+
+	/* all timers of a slot are before those of the next slots */
+	lvl = (tick == w->cur) ? 0 :
+		(rte_fls_u64(tick ^ w->cur) - 1) / TIMER_WHEEL_BITS;
+	idx = (tick >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+	for (tim = w->slot[lvl][idx]; tim != NULL; tim = tim->sl_next[0])
+		first = RTE_MIN(first, tim->expire);
+
+	return first;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -394,6 +791,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		wheel_add(tim, &priv_timer[tim_lcore]);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -439,6 +841,11 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
 
+	if (priv_timer[prev_owner].wheel != NULL) {
+		wheel_del(tim, &priv_timer[prev_owner]);
+		goto unlock;
+	}
+
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -459,6 +866,7 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		else
 			break;
 
+unlock:
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
@@ -650,85 +1058,93 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Detach the expired timers of the list of lcore tim_lcore and mark them
+ * as running. Return the list of timers to run, linked by sl_next[0].
+ */
+static struct rte_timer *
+timer_get_expired(unsigned int tim_lcore, struct priv_timer *priv_timer)
 {
-	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim;
-	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *privp = &priv_timer[tim_lcore];
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
+	struct rte_timer *tim, *run_first_tim;
 	uint64_t cur_time;
-	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
-
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	int i;
 
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
+	if (privp->wheel != NULL ? privp->wheel->nb_timers == 0 :
+			privp->pending_head.sl_next[0] == NULL)
+		return NULL;
 	cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
 	/* on 64-bit the value cached in the pending_head.expired will be
 	 * updated atomically, so we can consult that for a quick check here
 	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+	if (likely(privp->pending_head.expire > cur_time))
+		return NULL;
 #endif
 
 	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_lock(&privp->list_lock);
+
+	if (privp->wheel != NULL) {
+		run_first_tim = wheel_get_expired(privp, cur_time);
+		rte_spinlock_unlock(&privp->list_lock);
+		return run_first_tim;
+	}
 
 	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time) {
+		rte_spinlock_unlock(&privp->list_lock);
+		return NULL;
 	}
 
 	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+	tim = privp->pending_head.sl_next[0];
 
 	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
+	timer_get_prev_entries(cur_time, tim_lcore, prev, priv_timer);
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
 			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
 		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
 	}
 
 	/* transition run-list from PENDING to RUNNING */
-	run_first_tim = tim;
-	pprev = &run_first_tim;
+	timer_run_list_append(&run_first_tim, tim, NULL);
 
-	for ( ; tim != NULL; tim = next_tim) {
-		next_tim = tim->sl_next[0];
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
 
-		ret = timer_set_running_state(tim);
-		if (likely(ret == 0)) {
-			pprev = &tim->sl_next[0];
-		} else {
-			/* another core is trying to re-config this one,
-			 * remove it from local expired list
-			 */
-			*pprev = next_tim;
-		}
-	}
+	rte_spinlock_unlock(&privp->list_lock);
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	return run_first_tim;
+}
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+	run_first_tim = timer_get_expired(lcore_id, priv_timer);
+	if (run_first_tim == NULL)
+		return;
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -797,16 +1213,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -821,75 +1233,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_expired(poll_lcores[i], data->priv_timer);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -980,6 +1326,7 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 	uint32_t walk_lcore;
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer_data *timer_data;
+	uint32_t slot;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
 
@@ -987,6 +1334,24 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		if (priv_timer->wheel != NULL) {
+			for (slot = 0; slot < TIMER_WHEEL_LEVELS *
+					TIMER_WHEEL_SLOTS; slot++) {
+				tim = priv_timer->wheel->slot
+					[slot / TIMER_WHEEL_SLOTS]
+					[slot % TIMER_WHEEL_SLOTS];
+				for ( ; tim != NULL; tim = next_tim) {
+					next_tim = tim->sl_next[0];
+
+					__rte_timer_stop(tim, timer_data);
+
+					if (f)
+						f(tim, f_arg);
+				}
+			}
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
@@ -1009,7 +1374,7 @@ rte_timer_next_ticks(void)
 	struct rte_timer_data *timer_data;
 	struct priv_timer *priv_timer;
 	const struct rte_timer *tm;
-	uint64_t cur_time;
+	uint64_t cur_time, expire;
 	int64_t left = -ENOENT;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(default_data_id, timer_data, -EINVAL);
@@ -1018,11 +1383,20 @@ rte_timer_next_ticks(void)
 	cur_time = rte_get_timer_cycles();
 
 	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
-	tm = priv_timer[lcore_id].pending_head.sl_next[0];
-	if (tm) {
-		left = tm->expire - cur_time;
-		if (left < 0)
-			left = 0;
+	if (priv_timer[lcore_id].wheel != NULL) {
+		expire = wheel_first_expire(priv_timer[lcore_id].wheel);
+		if (expire != UINT64_MAX) {
+			left = expire - cur_time;
+			if (left < 0)
+				left = 0;
+		}
+	} else {
+		tm = priv_timer[lcore_id].pending_head.sl_next[0];
+		if (tm) {
+			left = tm->expire - cur_time;
+			if (left < 0)
+				left = 0;
+		}
 	}
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
@@ -145,6 +145,62 @@ struct rte_timer
  */
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * Data structure keeping the pending timers of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Skiplist ordered by expiry time, O(log n) reset and stop. */
+	RTE_TIMER_BACKEND_SKIPLIST,
+	/** Hierarchical timing wheel, O(1) reset and stop. */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Configuration of a timer data instance.
+ */
+struct rte_timer_data_conf {
+	enum rte_timer_backend backend; /**< Pending timers structure. */
+	/**
+	 * Width in timer cycles of a slot of the timing wheel, rounded up to
+	 * a power of two. A timer runs up to one slot after its expiry time.
+	 * 0 selects a width of about one microsecond.
+	 * Ignored by the skiplist backend.
+	 */
+	uint64_t wheel_resolution;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance in shared memory to track a set of pending
+ * timer lists, using the given pending timers structure.
+ *
+ * With the RTE_TIMER_BACKEND_WHEEL backend, the pending timers of each lcore
+ * are kept in a hierarchical timing wheel: arming and stopping a timer take
+ * a constant time whatever the number of pending timers, and the expired
+ * timers are collected slot by slot. Unlike with the skiplist, the timers
+ * expired at one call of rte_timer_alt_manage() run in no particular order.
+ * The timers of an instance are managed with rte_timer_alt_reset(),
+ * rte_timer_alt_stop() and rte_timer_alt_manage() as for the skiplist
+ * backend.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param conf
+ *   Configuration of the timer data instance.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid configuration
+ *   - -ENOMEM: unable to allocate the timing wheels
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			      const struct rte_timer_data_conf *conf);
+
 /**
  * Deallocate a timer data instance.
  *